@@ -5,7 +5,7 @@ set(BOOST_REQUESTED_VERSION 1.69.0 CACHE STRING "")
 set(BOOST_SHA1 8f32d4617390d1c2d16f26a27ab60d97807b35440d45891fa340fc2648b04406 CACHE STRING "")
 set(BOOST_USE_STATIC_LIBS true CACHE BOOL "")
 
-set(BOOST_COMPONENTS program_options system thread)
+set(BOOST_COMPONENTS filesystem program_options system thread)
 
 # These components are only needed for Windows
 if(WIN32)
@@ -111,9 +111,15 @@ endif()
 set(onnxruntime_server_lib_srcs
   "${ONNXRUNTIME_ROOT}/server/http/json_handling.cc"
   "${ONNXRUNTIME_ROOT}/server/http/predict_request_handler.cc"
+  "${ONNXRUNTIME_ROOT}/server/http/metrics_request_handler.cc"
+  "${ONNXRUNTIME_ROOT}/server/http/shared_memory_request_handler.cc"
   "${ONNXRUNTIME_ROOT}/server/http/util.cc"
   "${ONNXRUNTIME_ROOT}/server/environment.cc"
   "${ONNXRUNTIME_ROOT}/server/executor.cc"
+  "${ONNXRUNTIME_ROOT}/server/metrics.cc"
+  "${ONNXRUNTIME_ROOT}/server/model_repository.cc"
+  "${ONNXRUNTIME_ROOT}/server/request_scheduler.cc"
+  "${ONNXRUNTIME_ROOT}/server/shared_memory.cc"
   "${ONNXRUNTIME_ROOT}/server/converter.cc"
   "${ONNXRUNTIME_ROOT}/server/util.cc"
   "${ONNXRUNTIME_ROOT}/server/core/request_id.cc"
@@ -180,6 +186,11 @@ target_link_libraries(onnxruntime_server_lib PRIVATE
   onnxruntime
 )
 
+if(NOT WIN32 AND NOT APPLE)
+  # shm_open
+  target_link_libraries(onnxruntime_server_lib PRIVATE rt)
+endif()
+
 if (onnxruntime_USE_SYSLOG)
   target_compile_definitions(onnxruntime_server_lib PUBLIC USE_SYSLOG="1")
 endif()
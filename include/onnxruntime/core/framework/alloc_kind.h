@@ -27,7 +27,10 @@ enum class AllocKind {
   kPreExisting = 2,
   kAllocateStatically = 3,
   kAllocateOutput = 4,
-  kShare = 5
+  kShare = 5,
+  // the value occupies a range of another value's buffer, e.g. a Concat input
+  // that is written directly into the Concat output.
+  kSubBuffer = 6
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
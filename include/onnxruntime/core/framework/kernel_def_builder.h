@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -64,6 +65,14 @@ class KernelDef {
     return alias_map_;
   }
 
+  const std::vector<std::pair<int, int>>& MayStridedOutput() const {
+    return strided_output_map_;
+  }
+
+  bool MayStridedInput(int input_index) const {
+    return std::find(strided_inputs_.begin(), strided_inputs_.end(), input_index) != strided_inputs_.end();
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -118,6 +127,12 @@ class KernelDef {
   // An element <i, j> means that output j is an alias of input i.
   std::vector<std::pair<int, int>> alias_map_;
 
+  // An element <i, j> means that output j may be a strided view of input i. j is -1 for every output.
+  std::vector<std::pair<int, int>> strided_output_map_;
+
+  // Inputs that may be strided views.
+  std::vector<int> strided_inputs_;
+
   // The memory types of inputs/outputs of this kernel
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
@@ -201,6 +216,21 @@ class KernelDefBuilder {
   KernelDefBuilder& Alias(const std::vector<std::pair<int, int>>& aliases);
   KernelDefBuilder& Alias(int input_index, int output_index);
 
+  /**
+     Specify that the kernel can read an input that is a strided view of another
+     tensor's buffer, instead of requiring contiguous data.
+  */
+  KernelDefBuilder& MayStridedInput(int input_index);
+
+  /**
+     Strided view mapping from inputs to outputs. If every consumer of the output
+     accepts strided input, the output is placed in the input's buffer and the kernel
+     describes it with Tensor::SetShapeAndStrides instead of copying the data.
+     Such a kernel detects the view by comparing the output's buffer with the input's.
+     An output_index of -1 applies to every output, for kernels with variadic outputs.
+  */
+  KernelDefBuilder& MayStridedOutput(int input_index, int output_index);
+
   /**
      Specify that this kernel requires an input arg
      in certain memory type (instead of the default, device memory).
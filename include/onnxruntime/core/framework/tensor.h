@@ -166,9 +166,35 @@ class Tensor final {
     ORT_ENFORCE(shape_.Size() == new_shape.Size(),
                 "Tensor size (" + std::to_string(shape_.Size()) +
                     ") != new size (" + std::to_string(new_shape.Size()) + ")");
+    ORT_ENFORCE(IsContiguous(), "A strided tensor can not be reshaped");
     shape_ = new_shape;
   }
 
+  /**
+     Returns the offset in bytes of the first element from the start of the buffer.
+  */
+  int64_t ByteOffset() const noexcept { return byte_offset_; }
+
+  /**
+     Returns the distance in elements between consecutive indices of each dimension.
+     Strides of a tensor that is not a view are computed from its shape.
+  */
+  std::vector<int64_t> Strides() const;
+
+  /**
+     Returns true if the elements are stored densely in row-major order.
+  */
+  bool IsContiguous() const noexcept { return strides_.empty(); }
+
+  /**
+   * Makes the tensor a strided view of its buffer, with its first element byte_offset bytes from the start.
+   * Strides are in elements and may be negative. Only kernels registered with MayStridedInput may
+   * be given a tensor that is not contiguous.
+   * @warning this function is NOT thread-safe.
+   */
+  void SetShapeAndStrides(const TensorShape& new_shape, const std::vector<int64_t>& new_strides,
+                          int64_t byte_offset);
+
   /**
   The number of bytes of data.
   */
@@ -196,6 +222,8 @@ class Tensor final {
   MLDataType dtype_;
   OrtMemoryInfo alloc_info_;
   int64_t byte_offset_;
+  // empty unless the tensor is a view whose elements are not contiguous
+  std::vector<int64_t> strides_;
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
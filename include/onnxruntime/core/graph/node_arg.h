@@ -67,6 +67,10 @@ class NodeArg {
   @returns Success unless there is existing type or shape info that can't be cleanly updated. */
   common::Status UpdateTypeAndShape(const NodeArg& node_arg);
 
+  /** Clears the type and shape so they are inferred again from the producing Node on the next Graph::Resolve.
+  @remarks Used by graph transformations that change the kind of value a NodeArg holds. */
+  void ClearType();
+
   /** Gets this NodeArg as a ValueInfoProto. */
   const NodeArgInfo& ToProto() const noexcept { return node_arg_info_; }
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <functional>
@@ -51,6 +52,42 @@ class ThreadPool {
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Run fn(i) for every i in [0, total), splitting the interval into num_batches
+  contiguous batches that execute in parallel. A num_batches of 0 uses one batch
+  per pool thread plus one for the calling thread. If tp is nullptr the loop runs
+  serially on the calling thread.
+  */
+  template <typename F>
+  static void TryBatchParallelFor(ThreadPool* tp, int32_t total, F&& fn, int32_t num_batches = 0) {
+    if (total <= 0) {
+      return;
+    }
+
+    if (tp != nullptr && num_batches <= 0) {
+      num_batches = tp->NumThreads() + 1;
+    }
+
+    if (tp == nullptr || num_batches <= 1 || total == 1) {
+      for (int32_t i = 0; i < total; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    num_batches = std::min(num_batches, total);
+    const int32_t work_per_batch = total / num_batches;
+    const int32_t work_remainder = total % num_batches;
+
+    tp->ParallelFor(num_batches, [&](int32_t batch_index) {
+      const int32_t start = batch_index * work_per_batch + std::min(batch_index, work_remainder);
+      const int32_t end = start + work_per_batch + (batch_index < work_remainder ? 1 : 0);
+      for (int32_t i = start; i < end; ++i) {
+        fn(i);
+      }
+    });
+  }
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
@@ -179,6 +179,13 @@ typedef enum GraphOptimizationLevel {
   ORT_ENABLE_ALL = 99
 } GraphOptimizationLevel;
 
+typedef enum OrtWeightStorageType {
+  ORT_WEIGHT_STORAGE_FLOAT = 0,
+  ORT_WEIGHT_STORAGE_FLOAT16 = 1,
+  ORT_WEIGHT_STORAGE_BFLOAT16 = 2,
+  ORT_WEIGHT_STORAGE_INT8 = 3
+} OrtWeightStorageType;
+
 struct OrtKernelInfo;
 typedef struct OrtKernelInfo OrtKernelInfo;
 struct OrtKernelContext;
@@ -611,6 +618,66 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  // Bypass ZipMap nodes that produce graph outputs so those outputs return the dense probability tensor
+  // instead of a sequence of maps. The class labels are recorded in the model metadata under
+  // "<output name>.labels" as a JSON array.
+  OrtStatus*(ORT_API_CALL* EnableZipMapBypass)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableZipMapBypass)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  // Collect per-node and per-op-type kernel time histograms (count, total, p50, p99). This is cheap enough to
+  // leave enabled in production and is independent of EnableProfiling.
+  OrtStatus*(ORT_API_CALL* EnableProfilingSummary)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  // Record the profiling trace for one out of every sampling_rate graph executions. Default is 1.
+  OrtStatus*(ORT_API_CALL* SetProfilingSamplingRate)(_Inout_ OrtSessionOptions* options, int sampling_rate)NO_EXCEPTION;
+
+  /**
+   * Get the kernel time histograms collected since the session was created, in JSON format.
+   * \param out is a null terminated string allocated with 'allocator'. The caller is responsible for freeing it.
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetProfilingSummary)(_In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                                                       _Outptr_ char** out)NO_EXCEPTION;
+
+  // Measure hardware performance counters (cycles, instructions, LLC misses, branch misses) around each kernel and
+  // report them with IPC and bytes per FLOP estimates in the profiling trace and summary. Linux only, and only with
+  // sequential execution. The counters include the intra-op thread pool and any other thread of the process, so
+  // measure one Run at a time.
+  OrtStatus*(ORT_API_CALL* EnableProfilingHardwareCounters)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  // Get the memory usage in bytes of the arena allocator that serves 'info' in the session.
+  // Fails if that memory is not allocated by an arena.
+  OrtStatus*(ORT_API_CALL* SessionGetArenaStats)(_In_ const OrtSession* sess, _In_ const OrtMemoryInfo* info,
+                                                 _Out_ size_t* bytes_in_use, _Out_ size_t* total_allocated_bytes,
+                                                 _Out_ size_t* max_bytes_in_use)NO_EXCEPTION;
+
+  // Share CPU initializers with other sessions in the process that load identical weights, so they are stored once.
+  OrtStatus*(ORT_API_CALL* EnableInitializerSharing)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableInitializerSharing)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Use 'val' for the model's initializer 'name' instead of a copy owned by the session. Sessions created with
+   * these options reference 'val' read-only. 'val' must hold the same data as the model's initializer and must
+   * outlive the sessions, as must its buffer if it was created with CreateTensorWithDataAsOrtValue.
+   */
+  OrtStatus*(ORT_API_CALL* AddSharedInitializer)(_Inout_ OrtSessionOptions* options, _In_ const char* name,
+                                                 _In_ const OrtValue* val)NO_EXCEPTION;
+
+  /**
+   * Create a session that shares the model, kernels, execution plan and initializers of 'sess' but has its own
+   * memory arena and thread pools, without loading and optimizing the model again. 'sess' must be released after
+   * the clone. Only sessions that use just the CPU execution provider can be cloned.
+   */
+  OrtStatus*(ORT_API_CALL* CloneSession)(_In_ const OrtSession* sess, _Outptr_ OrtSession** out)NO_EXCEPTION;
+
+  /**
+   * Store the large constant weights of MatMul and Gemm nodes run on CPU in float16, bfloat16 or int8 (with a scale
+   * per output channel). The weights are converted back to float a panel at a time inside the matrix multiply, so
+   * no float copy is kept. Results change within the precision of the storage type. Default is
+   * ORT_WEIGHT_STORAGE_FLOAT, which keeps the weights as they are.
+   */
+  OrtStatus*(ORT_API_CALL* SetWeightStorageType)(_Inout_ OrtSessionOptions* options,
+                                                 OrtWeightStorageType storage_type)NO_EXCEPTION;
 };
 
 typedef struct OrtApi OrtApi;
@@ -154,10 +154,22 @@ struct SessionOptions : Base<OrtSessionOptions> {
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
   SessionOptions& DisableProfiling();
+  SessionOptions& EnableProfilingSummary();
+  SessionOptions& SetProfilingSamplingRate(int sampling_rate);
+  SessionOptions& EnableProfilingHardwareCounters();
 
   SessionOptions& EnableMemPattern();
   SessionOptions& DisableMemPattern();
 
+  SessionOptions& EnableZipMapBypass();
+  SessionOptions& DisableZipMapBypass();
+
+  SessionOptions& EnableInitializerSharing();
+  SessionOptions& DisableInitializerSharing();
+  SessionOptions& AddSharedInitializer(const char* name, const OrtValue* value);
+
+  SessionOptions& SetWeightStorageType(OrtWeightStorageType storage_type);
+
   SessionOptions& EnableSequentialExecution();
   SessionOptions& DisableSequentialExecution();
 
@@ -170,6 +182,10 @@ struct Session : Base<OrtSession> {
   explicit Session(nullptr_t) {}
   Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options);
   Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options);
+  explicit Session(OrtSession* p) : Base<OrtSession>{p} {}
+
+  // A session sharing the model, kernels and initializers of this one. This session must outlive it.
+  Session Clone() const;
 
   // Run that will allocate the output values
   std::vector<Value> Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
@@ -185,6 +201,9 @@ struct Session : Base<OrtSession> {
   char* GetInputName(size_t index, OrtAllocator* allocator) const;
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
+  char* GetProfilingSummary(OrtAllocator* allocator) const;
+  void GetArenaStats(const OrtMemoryInfo* info, size_t& bytes_in_use, size_t& total_allocated_bytes,
+                     size_t& max_bytes_in_use) const;
 
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
@@ -182,6 +182,21 @@ inline SessionOptions& SessionOptions::DisableProfiling() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableProfilingSummary() {
+  ThrowOnError(g_api->EnableProfilingSummary(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetProfilingSamplingRate(int sampling_rate) {
+  ThrowOnError(g_api->SetProfilingSamplingRate(p_, sampling_rate));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableProfilingHardwareCounters() {
+  ThrowOnError(g_api->EnableProfilingHardwareCounters(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableMemPattern() {
   ThrowOnError(g_api->EnableMemPattern(p_));
   return *this;
@@ -192,6 +207,36 @@ inline SessionOptions& SessionOptions::DisableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableZipMapBypass() {
+  ThrowOnError(g_api->EnableZipMapBypass(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableZipMapBypass() {
+  ThrowOnError(g_api->DisableZipMapBypass(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableInitializerSharing() {
+  ThrowOnError(g_api->EnableInitializerSharing(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableInitializerSharing() {
+  ThrowOnError(g_api->DisableInitializerSharing(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::AddSharedInitializer(const char* name, const OrtValue* value) {
+  ThrowOnError(g_api->AddSharedInitializer(p_, name, value));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetWeightStorageType(OrtWeightStorageType storage_type) {
+  ThrowOnError(g_api->SetWeightStorageType(p_, storage_type));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableCpuMemArena() {
   ThrowOnError(g_api->EnableCpuMemArena(p_));
   return *this;
@@ -282,6 +327,23 @@ inline char* Session::GetOverridableInitializerName(size_t index, OrtAllocator*
   return out;
 }
 
+inline char* Session::GetProfilingSummary(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(g_api->SessionGetProfilingSummary(p_, allocator, &out));
+  return out;
+}
+
+inline void Session::GetArenaStats(const OrtMemoryInfo* info, size_t& bytes_in_use, size_t& total_allocated_bytes,
+                                   size_t& max_bytes_in_use) const {
+  ThrowOnError(g_api->SessionGetArenaStats(p_, info, &bytes_in_use, &total_allocated_bytes, &max_bytes_in_use));
+}
+
+inline Session Session::Clone() const {
+  OrtSession* out;
+  ThrowOnError(g_api->CloneSession(p_, &out));
+  return Session{out};
+}
+
 inline TypeInfo Session::GetInputTypeInfo(size_t index) const {
   OrtTypeInfo* out;
   ThrowOnError(g_api->SessionGetInputTypeInfo(p_, index, &out));
@@ -3,6 +3,7 @@
 
 #include "bahdanau_attention.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
+#include "core/mlas/inc/mlas.h"
 
 #include <stdexcept>
 #include <memory.h>
@@ -103,6 +104,11 @@ static void SoftmaxInplace(const gsl::span<T>& alignments) {
   }
 }
 
+template <>
+void SoftmaxInplace<float>(const gsl::span<float>& alignments) {
+  MlasComputeSoftmax(alignments.data(), alignments.data(), 1, alignments.size(), false, nullptr);
+}
+
 /**
   * Args:
   *     queries: Tensor, shape `[batch_size_, query_depth_]` to compare to keys.
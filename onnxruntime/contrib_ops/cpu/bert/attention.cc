@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/attention.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "gsl/gsl"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The scores of a block of query rows are kept within this many bytes, so they stay in cache between the
+// softmax and the GEMM with V.
+constexpr int64_t kAttentionBlockBytes = 64 * 1024;
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    Attention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Attention<float>);
+
+template <typename T>
+Attention<T>::Attention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+  mask_filter_value_ = info.GetAttrOrDefault<float>("mask_filter_value", -10000.0f);
+}
+
+template <typename T>
+Status Attention<T>::Compute(OpKernelContext* context) const {
+  // Input and output shapes:
+  //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
+  //   Input 1 - weights     : (hidden_size, 3 * hidden_size)
+  //   Input 2 - bias        : (3 * hidden_size)
+  //   Input 3 - mask_index  : (batch_size) or (batch_size, sequence_length), optional
+  //   Output                : (batch_size, sequence_length, hidden_size)
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask_index = context->Input<Tensor>(3);
+
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 is expected to have 3 dimensions, got ", dims.size());
+  }
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+  const int64_t hidden_size = dims[2];
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 dimension 2 should be divisible by value of the num_heads attribute.");
+  }
+  const int64_t head_size = hidden_size / num_heads_;
+
+  if (weights->Shape() != TensorShape({hidden_size, 3 * hidden_size})) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 is expected to have shape (", hidden_size, ", ", 3 * hidden_size, "), got ",
+                           weights->Shape());
+  }
+  if (bias->Shape() != TensorShape({3 * hidden_size})) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 2 is expected to have shape (", 3 * hidden_size, "), got ", bias->Shape());
+  }
+  const bool is_raw_mask = mask_index != nullptr && mask_index->Shape().NumDimensions() == 2;
+  if (mask_index != nullptr && mask_index->Shape() != TensorShape({batch_size}) &&
+      mask_index->Shape() != TensorShape({batch_size, sequence_length})) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 3 is expected to have shape (", batch_size, ") or (", batch_size, ", ",
+                           sequence_length, "), got ", mask_index->Shape());
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  // Project the input to Q, K and V with one GEMM. Each row of qkv is (Q, K, V), and each of them is the
+  // concatenation of the heads.
+  const int64_t rows = batch_size * sequence_length;
+  const int64_t qkv_width = 3 * hidden_size;
+  auto* qkv_buffer = alloc->Alloc(sizeof(T) * rows * qkv_width);
+  BufferUniquePtr qkv_buffer_ptr(qkv_buffer, BufferDeleter(alloc));
+  T* qkv = static_cast<T*>(qkv_buffer);
+
+  const T* bias_data = bias->template Data<T>();
+  for (int64_t r = 0; r < rows; ++r) {
+    std::copy_n(bias_data, qkv_width, qkv + r * qkv_width);
+  }
+  MlasGemm(CblasNoTrans, CblasNoTrans,
+           static_cast<size_t>(rows), static_cast<size_t>(qkv_width), static_cast<size_t>(hidden_size),
+           1.f, input->template Data<T>(), static_cast<size_t>(hidden_size),
+           weights->template Data<T>(), static_cast<size_t>(qkv_width),
+           1.f, qkv, static_cast<size_t>(qkv_width), tp);
+
+  // The additive mask of each key, (1 - mask) * mask_filter_value. With a mask of sequence lengths,
+  // sequences that attend to at least one key only compute the scores of those keys instead.
+  const int32_t* mask_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
+  BufferUniquePtr mask_bias_buffer_ptr;
+  T* mask_bias = nullptr;
+  if (mask_data != nullptr) {
+    auto* mask_bias_buffer = alloc->Alloc(sizeof(T) * batch_size * sequence_length);
+    mask_bias_buffer_ptr = BufferUniquePtr(mask_bias_buffer, BufferDeleter(alloc));
+    mask_bias = static_cast<T*>(mask_bias_buffer);
+    for (int64_t b = 0; b < batch_size; ++b) {
+      for (int64_t s = 0; s < sequence_length; ++s) {
+        const int32_t mask = is_raw_mask ? mask_data[b * sequence_length + s] : (s < mask_data[b] ? 1 : 0);
+        mask_bias[b * sequence_length + s] = static_cast<T>((1.f - static_cast<float>(mask)) * mask_filter_value_);
+      }
+    }
+  }
+
+  // Each task computes the context of one head of one sequence, a block of query rows at a time. The tasks are
+  // split into one batch per thread, and each batch has its own scores buffer.
+  const int64_t num_tasks = batch_size * num_heads_;
+  const int64_t block_rows = std::max<int64_t>(
+      1, std::min<int64_t>(sequence_length, kAttentionBlockBytes / (sequence_length * sizeof(T))));
+  const int64_t num_batches = tp != nullptr ? std::min<int64_t>(num_tasks, tp->NumThreads() + 1) : 1;
+  auto* scores_buffer = alloc->Alloc(sizeof(T) * num_batches * block_rows * sequence_length);
+  BufferUniquePtr scores_buffer_ptr(scores_buffer, BufferDeleter(alloc));
+
+  T* output_data = output->template MutableData<T>();
+  const T scale = static_cast<T>(1.f / std::sqrt(static_cast<float>(head_size)));
+  const int64_t num_heads = num_heads_;
+
+  auto compute_task = [&](int64_t task, T* scores) {
+    const int64_t b = task / num_heads;
+    const int64_t n = task % num_heads;
+    const T* q = qkv + b * sequence_length * qkv_width + n * head_size;
+    const T* k = q + hidden_size;
+    const T* v = k + hidden_size;
+    T* context_data = output_data + b * sequence_length * hidden_size + n * head_size;
+
+    int64_t key_length = sequence_length;
+    const T* key_bias = mask_bias != nullptr ? mask_bias + b * sequence_length : nullptr;
+    if (mask_data != nullptr && !is_raw_mask && mask_data[b] > 0) {
+      key_length = std::min<int64_t>(sequence_length, mask_data[b]);
+      key_bias = nullptr;
+    }
+
+    for (int64_t row = 0; row < sequence_length; row += block_rows) {
+      const int64_t count = std::min(block_rows, sequence_length - row);
+
+      // P = softmax(Q K^T / sqrt(head_size) + mask)
+      MlasGemm(CblasNoTrans, CblasTrans,
+               static_cast<size_t>(count), static_cast<size_t>(key_length), static_cast<size_t>(head_size),
+               scale, q + row * qkv_width, static_cast<size_t>(qkv_width),
+               k, static_cast<size_t>(qkv_width),
+               0.f, scores, static_cast<size_t>(key_length), nullptr);
+      if (key_bias != nullptr) {
+        for (int64_t r = 0; r < count; ++r) {
+          T* row_scores = scores + r * key_length;
+          for (int64_t s = 0; s < key_length; ++s) {
+            row_scores[s] += key_bias[s];
+          }
+        }
+      }
+      MlasComputeSoftmax(scores, scores, static_cast<size_t>(count), static_cast<size_t>(key_length),
+                         false, nullptr);
+
+      // context = P V
+      MlasGemm(CblasNoTrans, CblasNoTrans,
+               static_cast<size_t>(count), static_cast<size_t>(head_size), static_cast<size_t>(key_length),
+               1.f, scores, static_cast<size_t>(key_length),
+               v, static_cast<size_t>(qkv_width),
+               0.f, context_data + row * hidden_size, static_cast<size_t>(hidden_size), nullptr);
+    }
+  };
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, gsl::narrow<int32_t>(num_batches),
+      [&](int32_t batch) {
+        T* scores = static_cast<T*>(scores_buffer) + batch * block_rows * sequence_length;
+        const int64_t tasks_per_batch = num_tasks / num_batches;
+        const int64_t remainder = num_tasks % num_batches;
+        const int64_t start = batch * tasks_per_batch + std::min<int64_t>(batch, remainder);
+        const int64_t end = start + tasks_per_batch + (batch < remainder ? 1 : 0);
+        for (int64_t task = start; task < end; ++task) {
+          compute_task(task, scores);
+        }
+      },
+      gsl::narrow<int32_t>(num_batches));
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
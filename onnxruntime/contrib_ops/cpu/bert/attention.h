@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Multi-head self attention with the Q, K and V projections packed in one weight. See the Attention schema.
+template <typename T>
+class Attention final : public OpKernel {
+ public:
+  explicit Attention(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int num_heads_;            // number of attention heads
+  float mask_filter_value_;  // added to the scores of the keys that are masked out
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
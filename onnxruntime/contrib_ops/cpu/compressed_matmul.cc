@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/compressed_matmul.h"
+
+#include <algorithm>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    CompressedMatMul,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<MLFloat16>(),
+                               DataTypeImpl::GetTensorType<BFloat16>(),
+                               DataTypeImpl::GetTensorType<int8_t>()}),
+    CompressedMatMul<float>);
+
+template <typename T>
+CompressedMatMul<T>::CompressedMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+  alpha_ = info.GetAttrOrDefault<float>("alpha", 1.f);
+}
+
+template <typename T>
+Status CompressedMatMul<T>::Compute(OpKernelContext* context) const {
+  const auto* A = context->Input<Tensor>(0);
+  const auto* B = context->Input<Tensor>(1);
+  const auto* scales = context->Input<Tensor>(2);
+  const auto* bias = context->Input<Tensor>(3);
+
+  const auto& b_shape = B->Shape();
+  if (b_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "B must be 2-D. Got ", b_shape);
+  }
+  const int64_t K = b_shape[trans_b_ ? 1 : 0];
+  const int64_t N = b_shape[trans_b_ ? 0 : 1];
+
+  const auto& a_shape = A->Shape();
+  if (a_shape.NumDimensions() < 1 || a_shape[a_shape.NumDimensions() - 1] != K) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A must have shape (..., ", K, "). Got ", a_shape);
+  }
+  if (bias != nullptr && bias->Shape().Size() != N) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "bias must have ", N, " elements. Got ", bias->Shape());
+  }
+
+  MLAS_SGEMM_COMPRESSED_B compressed_b;
+  compressed_b.Data = B->DataRaw();
+  compressed_b.Scales = nullptr;
+  if (B->DataType() == DataTypeImpl::GetType<MLFloat16>()) {
+    compressed_b.Format = MlasSgemmBFormatFloat16;
+  } else if (B->DataType() == DataTypeImpl::GetType<BFloat16>()) {
+    compressed_b.Format = MlasSgemmBFormatBFloat16;
+  } else {
+    if (scales == nullptr || scales->Shape().Size() != N) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "An int8 B requires ", N, " scales");
+    }
+    compressed_b.Format = MlasSgemmBFormatInt8;
+    compressed_b.Scales = scales->Data<float>();
+  }
+
+  std::vector<int64_t> y_dims(a_shape.GetDims());
+  y_dims.back() = N;
+  auto* Y = context->Output(0, TensorShape(y_dims));
+  const int64_t M = a_shape.SizeToDimension(a_shape.NumDimensions() - 1);
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // The bias is added by starting from it with a beta of 1.
+  T* y_data = Y->template MutableData<T>();
+  if (bias != nullptr) {
+    const T* bias_data = bias->template Data<T>();
+    for (int64_t m = 0; m < M; ++m) {
+      std::copy_n(bias_data, N, y_data + m * N);
+    }
+  } else if (K == 0) {
+    std::fill_n(y_data, M * N, T(0));
+  }
+  if (K == 0) {
+    return Status::OK();
+  }
+
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  MlasGemm(CblasNoTrans, trans_b_ ? CblasTrans : CblasNoTrans,
+           static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+           alpha_, A->template Data<T>(), static_cast<size_t>(K),
+           &compressed_b, static_cast<size_t>(trans_b_ ? K : N),
+           bias != nullptr ? 1.f : 0.f, y_data, static_cast<size_t>(N), tp);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
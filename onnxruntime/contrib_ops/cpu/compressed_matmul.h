@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = alpha * A * op(B) + bias, with B stored in float16, bfloat16 or int8 and converted to float while the GEMM
+// packs it.
+template <typename T>
+class CompressedMatMul final : public OpKernel {
+ public:
+  explicit CompressedMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool trans_b_;
+  float alpha_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
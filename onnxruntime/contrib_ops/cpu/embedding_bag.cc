@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag<float>);
+
+// Number of rows ahead of the one being reduced to prefetch.
+constexpr int64_t kEmbeddingBagPrefetchDistance = 8;
+
+template <typename T>
+EmbeddingBag<T>::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  if (mode == "sum") {
+    mode_ = EmbeddingBagMode::kSum;
+  } else if (mode == "mean") {
+    mode_ = EmbeddingBagMode::kMean;
+  } else if (mode == "max") {
+    mode_ = EmbeddingBagMode::kMax;
+  } else {
+    ORT_THROW("Invalid EmbeddingBag mode: ", mode);
+  }
+}
+
+template <typename T>
+Status EmbeddingBag<T>::Compute(OpKernelContext* context) const {
+  const auto* weight = context->Input<Tensor>(0);
+  const auto* indices = context->Input<Tensor>(1);
+  const auto* offsets = context->Input<Tensor>(2);
+
+  const auto& weight_shape = weight->Shape();
+  const auto& indices_shape = indices->Shape();
+  if (weight_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "weight must be 2-D. Got ", weight_shape);
+  }
+  if (indices_shape.NumDimensions() != (offsets != nullptr ? 1u : 2u)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "indices must be 1-D with offsets and 2-D without. Got ", indices_shape);
+  }
+  if (offsets != nullptr && offsets->Shape().NumDimensions() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "offsets must be 1-D. Got ", offsets->Shape());
+  }
+
+  const int64_t num_bags = offsets != nullptr ? offsets->Shape()[0] : indices_shape[0];
+  auto* output = context->Output(0, {num_bags, weight_shape[1]});
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  if (indices->DataType() == DataTypeImpl::GetType<int32_t>()) {
+    return ComputeImpl<int32_t>(*weight, *indices, offsets, *output, tp);
+  }
+  return ComputeImpl<int64_t>(*weight, *indices, offsets, *output, tp);
+}
+
+template <typename T>
+template <typename Tind>
+Status EmbeddingBag<T>::ComputeImpl(const Tensor& weight, const Tensor& indices, const Tensor* offsets,
+                                    Tensor& output, concurrency::ThreadPool* tp) const {
+  const int64_t num_embeddings = weight.Shape()[0];
+  const int64_t embedding_dim = weight.Shape()[1];
+  const int64_t num_indices = indices.Shape().Size();
+  const int64_t num_bags = output.Shape()[0];
+  const Tind* indices_data = indices.Data<Tind>();
+  const Tind* offsets_data = offsets != nullptr ? offsets->Data<Tind>() : nullptr;
+
+  // Check the indices and offsets first as we can't return from the parallel loop below.
+  for (int64_t i = 0; i < num_indices; ++i) {
+    Tind idx = indices_data[i];
+    if (idx < -num_embeddings || idx >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_embeddings, ",", num_embeddings - 1, "]");
+    }
+  }
+  for (int64_t i = 0; offsets_data != nullptr && i < num_bags; ++i) {
+    Tind offset = offsets_data[i];
+    Tind previous = i > 0 ? offsets_data[i - 1] : 0;
+    if (offset < previous || offset > num_indices) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "offsets must be non-decreasing and within [0, ",
+                             num_indices, "]. Got ", offset, " at ", i);
+    }
+  }
+
+  const int64_t bag_size = offsets_data == nullptr ? indices.Shape()[1] : 0;
+  const T* weight_data = weight.Data<T>();
+  T* output_data = output.MutableData<T>();
+
+  auto row = [&](int64_t i) {
+    Tind idx = indices_data[i];
+    idx = idx < 0 ? idx + static_cast<Tind>(num_embeddings) : idx;
+    return weight_data + idx * embedding_dim;
+  };
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      num_bags > 1 ? tp : nullptr, gsl::narrow<int32_t>(num_bags),
+      [&](int32_t bag) {
+        int64_t begin = offsets_data != nullptr ? offsets_data[bag] : bag * bag_size;
+        int64_t end = offsets_data == nullptr ? begin + bag_size
+                                              : (bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices);
+
+        EigenVectorArrayMap<T> out(output_data + bag * embedding_dim, embedding_dim);
+        if (begin == end) {
+          out.setZero();
+          return;
+        }
+
+        out = ConstEigenVectorArrayMap<T>(row(begin), embedding_dim);
+        for (int64_t i = begin + 1; i < end; ++i) {
+          if (i + kEmbeddingBagPrefetchDistance < end) {
+            PrefetchRow(row(i + kEmbeddingBagPrefetchDistance), static_cast<size_t>(embedding_dim * sizeof(T)));
+          }
+
+          ConstEigenVectorArrayMap<T> in(row(i), embedding_dim);
+          if (mode_ == EmbeddingBagMode::kMax) {
+            out = out.max(in);
+          } else {
+            out += in;
+          }
+        }
+
+        if (mode_ == EmbeddingBagMode::kMean) {
+          out /= static_cast<T>(end - begin);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+namespace contrib {
+
+enum class EmbeddingBagMode {
+  kSum,
+  kMean,
+  kMax
+};
+
+template <typename T>
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(const Tensor& weight, const Tensor& indices, const Tensor* offsets, Tensor& output,
+                     concurrency::ThreadPool* tp) const;
+
+  EmbeddingBagMode mode_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "gsl/gsl"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Number of elements of each value in a tile, so that a tile of every value of a program of a few dozen
+// instructions fits in L1.
+constexpr int64_t kFusedElementwiseTileSize = 256;
+
+// Number of tiles computed by each task of the thread pool.
+constexpr int64_t kFusedElementwiseTilesPerTask = 64;
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise<float>);
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  static const std::vector<std::pair<std::string, Opcode>> opcodes{
+      {"Add", Opcode::Add}, {"Sub", Opcode::Sub}, {"Mul", Opcode::Mul}, {"Div", Opcode::Div},
+      {"Max", Opcode::Max}, {"Min", Opcode::Min}, {"Neg", Opcode::Neg}, {"Abs", Opcode::Abs},
+      {"Relu", Opcode::Relu}, {"LeakyRelu", Opcode::LeakyRelu}, {"Sigmoid", Opcode::Sigmoid},
+      {"Tanh", Opcode::Tanh}, {"Exp", Opcode::Exp}, {"Log", Opcode::Log}, {"Sqrt", Opcode::Sqrt},
+      {"Reciprocal", Opcode::Reciprocal}, {"Erf", Opcode::Erf}};
+
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK() && !ops.empty(), "ops must be given");
+  ORT_ENFORCE(info.GetAttrs<int64_t>("operands", operands).IsOK() && operands.size() == 2 * ops.size(),
+              "operands must have two elements for each op");
+  const auto alphas = info.GetAttrsOrDefault<float>("alphas");
+  ORT_ENFORCE(alphas.empty() || alphas.size() == ops.size(), "alphas must have an element for each op");
+  num_inputs_ = static_cast<int64_t>(info.GetInputCount());
+
+  for (size_t i = 0; i < ops.size(); ++i) {
+    auto opcode = std::find_if(opcodes.begin(), opcodes.end(),
+                               [&ops, i](const std::pair<std::string, Opcode>& entry) { return entry.first == ops[i]; });
+    ORT_ENFORCE(opcode != opcodes.end(), "Unsupported op ", ops[i]);
+
+    Instruction instruction;
+    instruction.opcode = opcode->second;
+    instruction.alpha = alphas.empty() ? 0.f : alphas[i];
+
+    // each instruction may only use the inputs and the results of the previous instructions
+    const bool is_binary = instruction.opcode <= Opcode::Min;
+    const int64_t num_values = num_inputs_ + static_cast<int64_t>(i);
+    for (int j = 0; j < 2; ++j) {
+      instruction.operands[j] = operands[2 * i + j];
+      if (j == 0 || is_binary) {
+        ORT_ENFORCE(instruction.operands[j] >= 0 && instruction.operands[j] < num_values,
+                    "Invalid operand ", instruction.operands[j], " of instruction ", i);
+      } else {
+        ORT_ENFORCE(instruction.operands[j] == -1, "The second operand of the unary op ", ops[i], " must be -1");
+      }
+    }
+    program_.push_back(instruction);
+  }
+}
+
+// Checks that shape, without its leading dimensions of 1, is a suffix of output_shape.
+static bool IsBroadcastSuffix(const TensorShape& shape, const TensorShape& output_shape) {
+  size_t first = 0;
+  while (first < shape.NumDimensions() && shape[first] == 1) {
+    ++first;
+  }
+  const size_t rank = shape.NumDimensions() - first;
+  if (rank > output_shape.NumDimensions()) {
+    return false;
+  }
+  for (size_t i = 0; i < rank; ++i) {
+    if (shape[first + i] != output_shape[output_shape.NumDimensions() - rank + i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void RunInstruction(const FusedElementwise<float>::Instruction& instruction,
+                           const float* a, const float* b, float* y, size_t count) {
+  using Opcode = FusedElementwise<float>::Opcode;
+  switch (instruction.opcode) {
+    case Opcode::Add:
+      for (size_t i = 0; i < count; ++i) y[i] = a[i] + b[i];
+      break;
+    case Opcode::Sub:
+      for (size_t i = 0; i < count; ++i) y[i] = a[i] - b[i];
+      break;
+    case Opcode::Mul:
+      for (size_t i = 0; i < count; ++i) y[i] = a[i] * b[i];
+      break;
+    case Opcode::Div:
+      for (size_t i = 0; i < count; ++i) y[i] = a[i] / b[i];
+      break;
+    case Opcode::Max:
+      for (size_t i = 0; i < count; ++i) y[i] = std::max(a[i], b[i]);
+      break;
+    case Opcode::Min:
+      for (size_t i = 0; i < count; ++i) y[i] = std::min(a[i], b[i]);
+      break;
+    case Opcode::Neg:
+      for (size_t i = 0; i < count; ++i) y[i] = -a[i];
+      break;
+    case Opcode::Abs:
+      for (size_t i = 0; i < count; ++i) y[i] = std::abs(a[i]);
+      break;
+    case Opcode::Relu:
+      for (size_t i = 0; i < count; ++i) y[i] = std::max(a[i], 0.f);
+      break;
+    case Opcode::LeakyRelu:
+      for (size_t i = 0; i < count; ++i) y[i] = a[i] >= 0.f ? a[i] : a[i] * instruction.alpha;
+      break;
+    case Opcode::Sigmoid:
+      MlasComputeLogistic(a, y, count);
+      break;
+    case Opcode::Tanh:
+      MlasComputeTanh(a, y, count);
+      break;
+    case Opcode::Exp:
+      MlasComputeExp(a, y, count);
+      break;
+    case Opcode::Log:
+      for (size_t i = 0; i < count; ++i) y[i] = std::log(a[i]);
+      break;
+    case Opcode::Sqrt:
+      for (size_t i = 0; i < count; ++i) y[i] = std::sqrt(a[i]);
+      break;
+    case Opcode::Reciprocal:
+      for (size_t i = 0; i < count; ++i) y[i] = 1.f / a[i];
+      break;
+    case Opcode::Erf:
+      MlasComputeErf(a, y, count);
+      break;
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::Compute(OpKernelContext* context) const {
+  // The output has the shape of the largest input, and the other inputs are broadcast along its leading dimensions.
+  std::vector<const Tensor*> inputs(static_cast<size_t>(num_inputs_));
+  const Tensor* largest = nullptr;
+  for (int64_t i = 0; i < num_inputs_; ++i) {
+    inputs[i] = context->Input<Tensor>(static_cast<int>(i));
+    const auto& shape = inputs[i]->Shape();
+    if (largest == nullptr || shape.Size() > largest->Shape().Size() ||
+        (shape.Size() == largest->Shape().Size() && shape.NumDimensions() > largest->Shape().NumDimensions())) {
+      largest = inputs[i];
+    }
+  }
+  const TensorShape output_shape = largest->Shape();
+  for (int64_t i = 0; i < num_inputs_; ++i) {
+    if (!IsBroadcastSuffix(inputs[i]->Shape(), output_shape)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input ", i, " of shape ", inputs[i]->Shape(), " can't be broadcast to ", output_shape,
+                             ". Inputs must have the shape of the output, a suffix of it or a single element.");
+    }
+  }
+
+  Tensor* output = context->Output(0, output_shape);
+  const int64_t size = output_shape.Size();
+  if (size == 0) {
+    return Status::OK();
+  }
+
+  T* output_data = output->template MutableData<T>();
+  const int64_t num_values = num_inputs_ + static_cast<int64_t>(program_.size());
+  const int64_t task_size = kFusedElementwiseTileSize * kFusedElementwiseTilesPerTask;
+  const int64_t num_tasks = (size + task_size - 1) / task_size;
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, gsl::narrow<int32_t>(num_tasks),
+      [&](int32_t task) {
+        // a tile of each input that is broadcast and of each intermediate result
+        std::vector<T> tiles(static_cast<size_t>(num_values * kFusedElementwiseTileSize));
+        std::vector<const T*> values(static_cast<size_t>(num_values));
+        for (int64_t i = 0; i < num_inputs_; ++i) {
+          if (inputs[i]->Shape().Size() == 1) {
+            std::fill_n(tiles.data() + i * kFusedElementwiseTileSize, kFusedElementwiseTileSize,
+                        *inputs[i]->template Data<T>());
+          }
+        }
+
+        const int64_t task_end = std::min(size, (task + 1) * task_size);
+        for (int64_t start = task * task_size; start < task_end; start += kFusedElementwiseTileSize) {
+          const int64_t count = std::min(kFusedElementwiseTileSize, task_end - start);
+
+          for (int64_t i = 0; i < num_inputs_; ++i) {
+            const T* data = inputs[i]->template Data<T>();
+            const int64_t input_size = inputs[i]->Shape().Size();
+            T* tile = tiles.data() + i * kFusedElementwiseTileSize;
+            if (input_size == size) {
+              values[i] = data + start;
+            } else if (input_size == 1) {
+              values[i] = tile;
+            } else {
+              // an input repeated along the leading dimensions of the output
+              int64_t offset = start % input_size;
+              if (offset + count <= input_size) {
+                values[i] = data + offset;
+              } else {
+                for (int64_t copied = 0; copied < count; offset = 0) {
+                  const int64_t n = std::min(count - copied, input_size - offset);
+                  std::copy_n(data + offset, n, tile + copied);
+                  copied += n;
+                }
+                values[i] = tile;
+              }
+            }
+          }
+
+          for (size_t k = 0; k < program_.size(); ++k) {
+            const auto& instruction = program_[k];
+            const int64_t value_index = num_inputs_ + static_cast<int64_t>(k);
+            T* result = k + 1 == program_.size() ? output_data + start
+                                                 : tiles.data() + value_index * kFusedElementwiseTileSize;
+            RunInstruction(instruction, values[instruction.operands[0]],
+                           instruction.operands[1] >= 0 ? values[instruction.operands[1]] : nullptr,
+                           result, static_cast<size_t>(count));
+            values[value_index] = result;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
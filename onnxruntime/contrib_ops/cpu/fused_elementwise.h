@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Runs a program of elementwise ops a tile of the output at a time, so that the intermediate values of the program
+// stay in L1 and each input and the output are accessed once.
+template <typename T>
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class Opcode {
+    // binary ops
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Max,
+    Min,
+    // unary ops
+    Neg,
+    Abs,
+    Relu,
+    LeakyRelu,
+    Sigmoid,
+    Tanh,
+    Exp,
+    Log,
+    Sqrt,
+    Reciprocal,
+    Erf,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    // indices of the values used, the inputs and then the results of the previous instructions
+    int64_t operands[2];
+    float alpha;
+  };
+
+ private:
+  int64_t num_inputs_;
+  std::vector<Instruction> program_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -1,9 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/framework/tensor.h"
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
+#include "gsl/gsl"
 #include "layer_norm.h"
 
 namespace onnxruntime {
@@ -23,6 +28,39 @@ namespace contrib {
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 
+// Single pass mean and variance of a row. The sums are kept in independent lanes so the compiler can vectorize
+// the loop without reassociating the floating point additions.
+template <typename T>
+static void ComputeRowMoments(const T* x, int64_t count, T& mean, T& variance) {
+  constexpr int64_t kLanes = 8;
+  T sum[kLanes] = {};
+  T sum_squares[kLanes] = {};
+
+  int64_t j = 0;
+  for (; j + kLanes <= count; j += kLanes) {
+    for (int64_t lane = 0; lane < kLanes; ++lane) {
+      const T value = x[j + lane];
+      sum[lane] += value;
+      sum_squares[lane] += value * value;
+    }
+  }
+  for (; j < count; ++j) {
+    sum[0] += x[j];
+    sum_squares[0] += x[j] * x[j];
+  }
+
+  T total = T(0);
+  T total_squares = T(0);
+  for (int64_t lane = 0; lane < kLanes; ++lane) {
+    total += sum[lane];
+    total_squares += sum_squares[lane];
+  }
+
+  mean = total / static_cast<T>(count);
+  // rounding can make E[x^2] - E[x]^2 slightly negative for a constant row
+  variance = std::max(total_squares / static_cast<T>(count) - mean * mean, T(0));
+}
+
 template <typename T>
 LayerNorm<T>::LayerNorm(const OpKernelInfo& op_kernel_info)
     : OpKernel(op_kernel_info) {
@@ -44,6 +82,10 @@ Status LayerNorm<T>::Compute(OpKernelContext* p_op_kernel_context) const {
   const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
   auto N = x_shape.SizeToDimension(axis);
   auto M = x_shape.SizeFromDimension(axis);
+  if (scale->Shape().Size() != M || bias->Shape().Size() != M) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "scale and B must have ", M, " elements. Got ",
+                           scale->Shape(), " and ", bias->Shape());
+  }
 
   std::vector<int64_t> mean_inv_std_var_dim;
   mean_inv_std_var_dim.reserve(x_shape.NumDimensions());
@@ -82,29 +124,30 @@ Status LayerNorm<T>::Compute(OpKernelContext* p_op_kernel_context) const {
     inv_std_var_data = static_cast<T*>(inv_std_var_data_buf_ptr.get());
   }
 
-  std::memset(mean_data, 0, sizeof(T) * N);
-  std::memset(inv_std_var_data, 0, sizeof(T) * N);
-
-  ConstEigenArrayMap<T> X_arr(X_data, M, N);
-  for (int i = 0; i < N; ++i) {
-    mean_data[i] = X_arr.col(i).mean();
-    inv_std_var_data[i] = X_arr.col(i).square().mean() - mean_data[i] * mean_data[i];
-  }
-
-  // Compute Y = ((x - mean) * (inv_var) * scale + bias
+  // Compute Y = (x - mean) * inv_std_var * scale + bias a row at a time, with the rows spread over the thread pool.
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
   auto Y_data = Y->template MutableData<T>();
-  EigenArrayMap<T> Y_arr(Y_data, M, N);
-
-  ConstEigenVectorArrayMap<T> mean_arr(mean_data, N);
-  EigenVectorArrayMap<T> inv_std_var_arr(inv_std_var_data, N);
-  inv_std_var_arr = (inv_std_var_arr + epsilon_).sqrt().inverse();
-
-  Y_arr = (X_arr.rowwise() - mean_arr.transpose()).rowwise() * inv_std_var_arr.transpose();
 
-  ConstEigenVectorArrayMap<T> scale_arr(scale_data, M);
-  ConstEigenVectorArrayMap<T> bias_arr(bias_data, M);
-  Y_arr = (Y_arr.colwise() * scale_arr).colwise() + bias_arr;
+  auto* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, gsl::narrow<int32_t>(N),
+      [&](int32_t task) {
+        const int64_t i = task;
+        const T* x = X_data + i * M;
+        T* y = Y_data + i * M;
+
+        T mean_value;
+        T variance;
+        ComputeRowMoments(x, M, mean_value, variance);
+        const T inv_std_var_value = T(1) / std::sqrt(variance + static_cast<T>(epsilon_));
+
+        for (int64_t j = 0; j < M; ++j) {
+          y[j] = (x[j] - mean_value) * inv_std_var_value * scale_data[j] + bias_data[j];
+        }
+
+        mean_data[i] = mean_value;
+        inv_std_var_data[i] = inv_std_var_value;
+      });
 
   return Status::OK();
 }
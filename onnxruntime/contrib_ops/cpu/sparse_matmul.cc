@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/sparse_matmul.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    SparseMatMul,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    SparseMatMul<float>);
+
+// Rows of A are processed in tiles of about this many bytes, so a tile stays in cache while every row of W is
+// applied to it.
+constexpr int64_t kSparseMatMulTileBytes = 64 * 1024;
+
+// Dot product of a dense row with the blocks [begin, end) of a row of W. The products are accumulated per lane of a
+// block so that a fixed BlockSize vectorizes, and summed once at the end. A BlockSize of 0 handles any block size.
+template <typename T, int BlockSize>
+static T SparseRowDot(const T* a_row, const T* values, const int32_t* cols, int32_t begin, int32_t end,
+                      int64_t block_size) {
+  if (BlockSize == 0) {
+    T sum = 0;
+    for (int32_t j = begin; j < end; ++j) {
+      sum += (ConstEigenVectorArrayMap<T>(a_row + cols[j] * block_size, block_size) *
+              ConstEigenVectorArrayMap<T>(values + j * block_size, block_size))
+                 .sum();
+    }
+    return sum;
+  }
+
+  constexpr int kLanes = BlockSize == 0 ? 1 : BlockSize;
+  T acc[kLanes] = {};
+  for (int32_t j = begin; j < end; ++j) {
+    const T* a = a_row + static_cast<int64_t>(cols[j]) * kLanes;
+    const T* v = values + static_cast<int64_t>(j) * kLanes;
+    for (int i = 0; i < kLanes; ++i) {
+      acc[i] += a[i] * v[i];
+    }
+  }
+
+  T sum = 0;
+  for (int i = 0; i < kLanes; ++i) {
+    sum += acc[i];
+  }
+  return sum;
+}
+
+template <typename T>
+SparseMatMul<T>::SparseMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<int64_t> dense_shape;
+  ORT_ENFORCE(info.GetAttrs<int64_t>("dense_shape", dense_shape).IsOK() && dense_shape.size() == 2,
+              "dense_shape must have 2 elements");
+  K_ = dense_shape[0];
+  N_ = dense_shape[1];
+  block_size_ = info.GetAttrOrDefault<int64_t>("block_size", 1);
+  ORT_ENFORCE(K_ >= 0 && N_ >= 0, "Invalid dense_shape");
+  ORT_ENFORCE(block_size_ > 0 && K_ % block_size_ == 0, "block_size must be positive and divide K");
+}
+
+template <typename T>
+Status SparseMatMul<T>::Compute(OpKernelContext* context) const {
+  const auto* A = context->Input<Tensor>(0);
+  const auto* values = context->Input<Tensor>(1);
+  const auto* col_indices = context->Input<Tensor>(2);
+  const auto* row_ptr = context->Input<Tensor>(3);
+  const auto* bias = context->Input<Tensor>(4);
+
+  const auto& a_shape = A->Shape();
+  if (a_shape.NumDimensions() < 1 || a_shape[a_shape.NumDimensions() - 1] != K_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A must have shape (..., ", K_, "). Got ", a_shape);
+  }
+
+  const int64_t num_blocks = col_indices->Shape().Size();
+  if (values->Shape().Size() != num_blocks * block_size_ || row_ptr->Shape().Size() != N_ + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "values, col_indices and row_ptr have inconsistent sizes");
+  }
+  if (bias != nullptr && bias->Shape().Size() != N_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "bias must have ", N_, " elements. Got ", bias->Shape());
+  }
+
+  // Check the sparse structure first as we can't return from the parallel loop below.
+  const int32_t* col_data = col_indices->Data<int32_t>();
+  const int32_t* row_ptr_data = row_ptr->Data<int32_t>();
+  const int64_t block_cols = K_ / block_size_;
+  if (row_ptr_data[0] != 0 || row_ptr_data[N_] != num_blocks) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "row_ptr must start at 0 and end at ", num_blocks);
+  }
+  for (int64_t n = 0; n < N_; ++n) {
+    if (row_ptr_data[n] > row_ptr_data[n + 1]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "row_ptr must be non-decreasing");
+    }
+  }
+  for (int64_t j = 0; j < num_blocks; ++j) {
+    if (col_data[j] < 0 || col_data[j] >= block_cols) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "col_indices element out of range, col=", col_data[j],
+                             " must be within [0, ", block_cols - 1, "]");
+    }
+  }
+
+  std::vector<int64_t> y_dims(a_shape.GetDims());
+  y_dims.back() = N_;
+  auto* Y = context->Output(0, TensorShape(y_dims));
+  const int64_t M = a_shape.SizeToDimension(a_shape.NumDimensions() - 1);
+  if (M == 0 || N_ == 0) {
+    return Status::OK();
+  }
+
+  const T* a_data = A->template Data<T>();
+  const T* value_data = values->template Data<T>();
+  const T* bias_data = bias != nullptr ? bias->template Data<T>() : nullptr;
+  T* y_data = Y->template MutableData<T>();
+
+  const int64_t K = K_;
+  const int64_t N = N_;
+  const int64_t block_size = block_size_;
+  const int64_t row_bytes = std::max<int64_t>(1, K * static_cast<int64_t>(sizeof(T)));
+  const int64_t tile_rows = std::max<int64_t>(1, std::min<int64_t>(M, kSparseMatMulTileBytes / row_bytes));
+  const int64_t num_tiles = (M + tile_rows - 1) / tile_rows;
+
+  // Each task computes one output row n of W for a tile of rows of A, so a thread's batch of consecutive tasks
+  // applies many rows of W to the same tile.
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, gsl::narrow<int32_t>(num_tiles * N),
+      [&](int32_t task) {
+        const int64_t n = task % N;
+        const int64_t m_begin = (task / N) * tile_rows;
+        const int64_t m_end = std::min(m_begin + tile_rows, M);
+        const int32_t block_begin = row_ptr_data[n];
+        const int32_t block_end = row_ptr_data[n + 1];
+        const T initial = bias_data != nullptr ? bias_data[n] : T(0);
+
+        for (int64_t m = m_begin; m < m_end; ++m) {
+          const T* a_row = a_data + m * K;
+          T sum = initial;
+          switch (block_size) {
+            case 1:
+              sum += SparseRowDot<T, 1>(a_row, value_data, col_data, block_begin, block_end, block_size);
+              break;
+            case 4:
+              sum += SparseRowDot<T, 4>(a_row, value_data, col_data, block_begin, block_end, block_size);
+              break;
+            case 8:
+              sum += SparseRowDot<T, 8>(a_row, value_data, col_data, block_begin, block_end, block_size);
+              break;
+            case 16:
+              sum += SparseRowDot<T, 16>(a_row, value_data, col_data, block_begin, block_end, block_size);
+              break;
+            default:
+              sum += SparseRowDot<T, 0>(a_row, value_data, col_data, block_begin, block_end, block_size);
+              break;
+          }
+          y_data[m * N + n] = sum;
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = A * B + bias, with B given as the block-sparse rows of B^T. See the SparseMatMul schema for the format.
+template <typename T>
+class SparseMatMul final : public OpKernel {
+ public:
+  explicit SparseMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t K_;
+  int64_t N_;
+  int64_t block_size_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
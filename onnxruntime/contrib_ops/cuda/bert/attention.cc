@@ -88,6 +88,9 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   }
 
   const Tensor* mask_index = context->Input<Tensor>(3);
+  if (mask_index == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Input 3 is required by the CUDA kernel");
+  }
   const auto mask_dims = mask_index->Shape().GetDims();
   if (mask_dims.size() != 1) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counters.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#if defined(__linux__)
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+#if defined(__linux__)
+
+static int OpenPerfEvent(uint64_t config, long tid, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  // count user space only so this works with the default perf_event_paranoid setting
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+
+  // measure the thread on any CPU
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, static_cast<pid_t>(tid), -1, group_fd, 0));
+}
+
+// Lists the ids of the threads of the process.
+static std::vector<long> GetThreadIds() {
+  std::vector<long> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return tids;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    char* end = nullptr;
+    const long tid = strtol(entry->d_name, &end, 10);
+    if (end != entry->d_name && *end == '\0') {
+      tids.push_back(tid);
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+
+// Reads the start time of a thread of the process, field 22 of its stat file.
+static bool GetThreadStartTime(long tid, unsigned long long& start_time) {
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/task/%ld/stat", tid);
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char stat[1024];
+  const size_t size = fread(stat, 1, sizeof(stat) - 1, file);
+  fclose(file);
+  stat[size] = '\0';
+
+  // the command name in field 2 is in parentheses and may contain spaces, so parse from the last ')'
+  const char* fields = strrchr(stat, ')');
+  return fields != nullptr &&
+         sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+                &start_time) == 1;
+}
+
+bool HardwareCounters::ReadThread(const ThreadCounters& thread, HardwareCounterValues& values) {
+  // PERF_FORMAT_GROUP layout: the number of counters followed by their values. The counters of a thread
+  // that has exited keep their final values.
+  uint64_t buffer[1 + HW_COUNTER_MAX];
+  const ssize_t size = read(thread.group_fd, buffer, sizeof(buffer));
+  if (size < static_cast<ssize_t>(sizeof(uint64_t) * (1 + thread.num_slots))) {
+    return false;
+  }
+
+  for (int i = 0; i < HW_COUNTER_MAX; i++) {
+    values.values[i] += thread.slots[i] >= 0 ? buffer[1 + thread.slots[i]] : 0;
+  }
+  return true;
+}
+
+void HardwareCounters::CloseThread(const ThreadCounters& thread) {
+  for (int i = 0; i < HW_COUNTER_MAX; i++) {
+    if (thread.fds[i] >= 0) {
+      close(thread.fds[i]);
+    }
+  }
+}
+
+void HardwareCounters::RefreshThreads(bool force) {
+  static constexpr uint64_t configs[HW_COUNTER_MAX] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+
+  const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(kRefreshInterval).count();
+  auto last_refresh = last_refresh_.load(std::memory_order_relaxed);
+  if (!force && now - last_refresh < interval) {
+    return;
+  }
+  // only one of the threads that find the interval elapsed rescans
+  if (!last_refresh_.compare_exchange_strong(last_refresh, now) && !force) {
+    return;
+  }
+
+  struct ListedThread {
+    long tid;
+    unsigned long long start_time;
+  };
+  std::vector<ListedThread> listed;
+  for (const long tid : GetThreadIds()) {
+    unsigned long long start_time = 0;
+    // the thread may have exited since it was listed
+    if (GetThreadStartTime(tid, start_time)) {
+      listed.push_back({tid, start_time});
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  // close the counters of the threads that have exited, including the ones whose id was reused
+  auto exited = std::partition(threads_.begin(), threads_.end(), [&listed](const ThreadCounters& thread) {
+    return std::any_of(listed.begin(), listed.end(), [&thread](const ListedThread& listed_thread) {
+      return listed_thread.tid == thread.tid && listed_thread.start_time == thread.start_time;
+    });
+  });
+  for (auto it = exited; it != threads_.end(); ++it) {
+    ReadThread(*it, exited_values_);
+    CloseThread(*it);
+  }
+  threads_.erase(exited, threads_.end());
+
+  for (const auto& listed_thread : listed) {
+    if (std::any_of(threads_.begin(), threads_.end(),
+                    [&listed_thread](const ThreadCounters& thread) { return thread.tid == listed_thread.tid; })) {
+      continue;
+    }
+
+    ThreadCounters thread;
+    thread.tid = listed_thread.tid;
+    thread.start_time = listed_thread.start_time;
+    for (int i = 0; i < HW_COUNTER_MAX; i++) {
+      thread.fds[i] = OpenPerfEvent(configs[i], thread.tid, thread.group_fd);
+      if (thread.fds[i] >= 0) {
+        if (thread.group_fd < 0) {
+          thread.group_fd = thread.fds[i];
+        }
+        thread.slots[i] = thread.num_slots++;
+      } else {
+        thread.slots[i] = -1;
+      }
+    }
+
+    // the thread may have exited since it was listed
+    if (thread.group_fd >= 0) {
+      threads_.push_back(thread);
+    }
+  }
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (const auto& thread : threads_) {
+    CloseThread(thread);
+  }
+}
+
+bool HardwareCounters::Read(HardwareCounterValues& values) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  values = exited_values_;
+  bool any_read = false;
+  for (const auto& thread : threads_) {
+    any_read |= ReadThread(thread, values);
+  }
+  return any_read;
+}
+
+HardwareCounters* HardwareCounters::Get() {
+  static std::unique_ptr<HardwareCounters> counters = []() {
+    std::unique_ptr<HardwareCounters> result(new HardwareCounters());
+    result->RefreshThreads(true);
+    if (result->threads_.empty()) {
+      result.reset();
+    }
+    return result;
+  }();
+
+  return counters.get();
+}
+
+#else
+
+void HardwareCounters::RefreshThreads(bool /*force*/) {
+}
+
+HardwareCounters::~HardwareCounters() {
+}
+
+bool HardwareCounters::Read(HardwareCounterValues& /*values*/) const {
+  return false;
+}
+
+HardwareCounters* HardwareCounters::Get() {
+  return nullptr;
+}
+
+#endif
+
+}  // namespace profiling
+}  // namespace onnxruntime
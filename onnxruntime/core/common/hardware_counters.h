@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+enum HardwareCounter {
+  HW_CPU_CYCLES = 0,
+  HW_INSTRUCTIONS,
+  HW_LLC_MISSES,
+  HW_BRANCH_MISSES,
+  HW_COUNTER_MAX
+};
+
+static constexpr const char* hardware_counter_names_[HW_COUNTER_MAX] = {
+    "cycles",
+    "instructions",
+    "llc_misses",
+    "branch_misses"};
+
+struct HardwareCounterValues {
+  uint64_t values[HW_COUNTER_MAX]{};
+};
+
+/*
+Hardware performance counters of the threads of the process. On Linux these are read through
+perf_event_open; counters the kernel or the CPU does not provide read as zero.
+
+A counter group is opened for every thread of the process, so the work a kernel hands to the intra-op
+thread pool is counted along with the calling thread. The values are totals over all threads: work that
+other threads do at the same time, such as a concurrent Run or the parallel executor, is counted too, so
+the per kernel figures are only meaningful for one Run at a time with the sequential executor.
+*/
+class HardwareCounters {
+ public:
+  /*
+  Get the counters of the process, opening them on first use.
+  Returns nullptr if hardware counters are not available on this platform.
+  */
+  static HardwareCounters* Get();
+
+  /*
+  Rescan the threads of the process: open counters for the threads started since the last scan, and close
+  the counters of the threads that have exited, keeping their final values in the totals. Unless force is
+  true, the scan is skipped if the last one was less than kRefreshInterval ago, so this is cheap enough
+  to call for every graph execution.
+  */
+  void RefreshThreads(bool force = false);
+
+  /*
+  Read the current counter values summed over all threads. These are running totals, so callers
+  measure a region by taking the difference of two reads.
+  */
+  bool Read(HardwareCounterValues& values) const;
+
+  ~HardwareCounters();
+
+ private:
+  HardwareCounters() = default;
+  HardwareCounters(const HardwareCounters&) = delete;
+  HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+  static constexpr std::chrono::seconds kRefreshInterval{1};
+
+  struct ThreadCounters {
+    long tid;
+    // start time of the thread, which tells a new thread that reuses the id of an exited one apart
+    unsigned long long start_time;
+    int group_fd{-1};
+    int fds[HW_COUNTER_MAX];
+    // position of the counter in the group read, or -1 if the counter could not be opened
+    int slots[HW_COUNTER_MAX];
+    int num_slots{0};
+  };
+
+  static bool ReadThread(const ThreadCounters& thread, HardwareCounterValues& values);
+  static void CloseThread(const ThreadCounters& thread);
+
+  mutable OrtMutex mutex_;
+  std::vector<ThreadCounters> threads_;
+  // final values of the threads that have exited
+  HardwareCounterValues exited_values_;
+  std::atomic<std::chrono::steady_clock::rep> last_refresh_{0};
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
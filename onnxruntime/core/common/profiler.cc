@@ -3,10 +3,113 @@
 
 #include "profiler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "gsl/gsl"
+#include "core/common/make_unique.h"
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
 
+static int HighestBitIndex(uint64_t value) {
+  int index = 0;
+  if (value >= (uint64_t{1} << 32)) {
+    value >>= 32;
+    index += 32;
+  }
+  if (value >= (uint64_t{1} << 16)) {
+    value >>= 16;
+    index += 16;
+  }
+  if (value >= (uint64_t{1} << 8)) {
+    value >>= 8;
+    index += 8;
+  }
+  if (value >= (uint64_t{1} << 4)) {
+    value >>= 4;
+    index += 4;
+  }
+  if (value >= (uint64_t{1} << 2)) {
+    value >>= 2;
+    index += 2;
+  }
+  if (value >= (uint64_t{1} << 1)) {
+    index += 1;
+  }
+  return index;
+}
+
+LatencyHistogram::LatencyHistogram() {
+  Reset();
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  const int msb = HighestBitIndex(value);
+  const uint64_t sub_bucket = (value >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+  return static_cast<size_t>((msb - kSubBucketBits + 1) * kSubBuckets + sub_bucket);
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const size_t group = index / kSubBuckets;
+  const uint64_t sub_bucket = index % kSubBuckets;
+  return (kSubBuckets + sub_bucket) << (group - 1);
+}
+
+void LatencyHistogram::Record(long long nanoseconds) {
+  const uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+  buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  total_.fetch_add(value, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  uint64_t count = 0;
+  for (const auto& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count)));
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    cumulative += buckets_[i].load(std::memory_order_relaxed);
+    if (cumulative >= rank) {
+      // report the midpoint of the bucket
+      const uint64_t lower = BucketLowerBound(i);
+      const uint64_t upper = (i + 1 < kBucketCount) ? BucketLowerBound(i + 1) : lower;
+      return lower + (upper - lower) / 2;
+    }
+  }
+  return BucketLowerBound(kBucketCount - 1);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  total_.store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+}
+
+std::atomic<uint64_t> Profiler::next_profiler_id_{1};
+
+Profiler::ThreadEventBuffer::ThreadEventBuffer(int thread_id)
+    : tid(thread_id), events(new ProfilerEvent[max_num_events_per_thread_]), count(0), writing(false) {
+}
+
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
 Profiler* Profiler::instance_ = nullptr;
 
@@ -40,6 +143,9 @@ void Profiler::StartProfiling(const logging::Logger* custom_logger) {
   profile_with_logger_ = true;
   custom_logger_ = custom_logger;
   profiling_start_time_ = StartTime();
+  if (hardware_counters_enabled_) {
+    HardwareCounters::Get()->RefreshThreads(true);
+  }
 }
 
 template <typename T>
@@ -48,6 +154,9 @@ void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
   profile_stream_.open(file_name, std::ios::out | std::ios::trunc);
   profile_stream_file_ = ToMBString(file_name);
   profiling_start_time_ = StartTime();
+  if (hardware_counters_enabled_) {
+    HardwareCounters::Get()->RefreshThreads(true);
+  }
 }
 
 template void Profiler::StartProfiling<char>(const std::basic_string<char>& file_name);
@@ -55,6 +164,199 @@ template void Profiler::StartProfiling<char>(const std::basic_string<char>& file
 template void Profiler::StartProfiling<wchar_t>(const std::basic_string<wchar_t>& file_name);
 #endif
 
+void Profiler::SetSamplingRate(uint32_t sampling_rate) {
+  sampling_rate_ = std::max<uint32_t>(sampling_rate, 1);
+}
+
+void Profiler::EnableSummary() {
+  summary_enabled_ = true;
+}
+
+bool Profiler::EnableHardwareCounters() {
+  hardware_counters_enabled_ = HardwareCounters::Get() != nullptr;
+  return hardware_counters_enabled_;
+}
+
+uint32_t Profiler::InternString(const std::string& value) {
+  // caller must hold mutex_
+  auto it = string_ids_.find(value);
+  if (it != string_ids_.end()) {
+    return it->second;
+  }
+  const auto id = gsl::narrow<uint32_t>(strings_.size());
+  strings_.push_back(value);
+  string_ids_.emplace(value, id);
+  return id;
+}
+
+std::string Profiler::FormatArgs(const std::vector<std::pair<std::string, std::string>>& args) {
+  std::string formatted;
+  for (const auto& arg : args) {
+    if (!formatted.empty()) formatted += ",";
+    formatted += "\"" + arg.first + "\" : \"" + arg.second + "\"";
+  }
+  return formatted;
+}
+
+static std::string FormatRatio(uint64_t numerator, uint64_t denominator) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << (denominator != 0 ? static_cast<double>(numerator) / denominator : 0.0);
+  return out.str();
+}
+
+void Profiler::AddMetricsArgs(const KernelMetrics& metrics, std::vector<std::pair<std::string, std::string>>& args) {
+  for (int i = 0; i < HW_COUNTER_MAX; i++) {
+    args.emplace_back(hardware_counter_names_[i], std::to_string(metrics.counters.values[i]));
+  }
+  args.emplace_back("ipc", FormatRatio(metrics.counters.values[HW_INSTRUCTIONS], metrics.counters.values[HW_CPU_CYCLES]));
+  args.emplace_back("bytes", std::to_string(metrics.bytes));
+  args.emplace_back("flops", std::to_string(metrics.flops));
+  args.emplace_back("bytes_per_flop", FormatRatio(metrics.bytes, metrics.flops));
+}
+
+uint32_t Profiler::RegisterNode(const std::string& node_name, const std::string& op_type,
+                                const std::string& provider) {
+  static constexpr const char* suffixes[NODE_EVENT_KIND_MAX] = {"_fence_before", "_kernel_time", "_fence_after"};
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  auto node = onnxruntime::make_unique<NodeEntry>();
+  node->name = node_name;
+  for (int kind = 0; kind < NODE_EVENT_KIND_MAX; kind++) {
+    node->args[kind].emplace_back("op_name", op_type);
+    if (kind == NODE_KERNEL_TIME) {
+      node->args[kind].emplace_back("provider", provider);
+    }
+    node->name_id[kind] = InternString(node_name + suffixes[kind]);
+    node->args_id[kind] = InternString(FormatArgs(node->args[kind]));
+  }
+
+  auto op_type_it = op_type_ids_.find(op_type);
+  if (op_type_it == op_type_ids_.end()) {
+    op_type_it = op_type_ids_.emplace(op_type, gsl::narrow<uint32_t>(op_types_.size())).first;
+    op_types_.push_back(onnxruntime::make_unique<OpTypeEntry>());
+    op_types_.back()->op_type = op_type;
+  }
+  node->op_type_id = op_type_it->second;
+
+  nodes_.push_back(std::move(node));
+  return gsl::narrow<uint32_t>(nodes_.size() - 1);
+}
+
+Profiler::ThreadEventBuffer& Profiler::GetThreadEventBuffer() {
+  // cache the buffer of the profiler that this thread recorded to last
+  thread_local uint64_t cached_profiler_id = 0;
+  thread_local ThreadEventBuffer* cached_buffer = nullptr;
+
+  if (cached_profiler_id != profiler_id_) {
+    const int tid = static_cast<int>(logging::GetThreadId());
+
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = std::find_if(thread_buffers_.begin(), thread_buffers_.end(),
+                           [tid](const std::unique_ptr<ThreadEventBuffer>& buffer) { return buffer->tid == tid; });
+    if (it == thread_buffers_.end()) {
+      thread_buffers_.push_back(onnxruntime::make_unique<ThreadEventBuffer>(tid));
+      it = thread_buffers_.end() - 1;
+    }
+
+    cached_buffer = it->get();
+    cached_profiler_id = profiler_id_;
+  }
+
+  return *cached_buffer;
+}
+
+static inline void AppendEvent(std::atomic<size_t>& count, ProfilerEvent* events, size_t capacity,
+                               const ProfilerEvent& event) {
+  const size_t index = count.load(std::memory_order_relaxed);
+  events[index % capacity] = event;
+  count.store(index + 1, std::memory_order_release);
+}
+
+// Marks a thread event buffer as being written. Events may only be appended if the profiler is still
+// enabled once the buffer is marked; EndProfiling disables the profiler and then waits for the buffers
+// that are marked, so it never reads or resets a buffer while an event is being appended.
+class ThreadEventBufferWriter {
+ public:
+  ThreadEventBufferWriter(std::atomic<bool>& writing, const std::atomic<bool>& enabled) : writing_(writing) {
+    writing_.store(true);
+    can_write_ = enabled.load();
+  }
+
+  ~ThreadEventBufferWriter() {
+    writing_.store(false, std::memory_order_release);
+  }
+
+  bool CanWrite() const { return can_write_; }
+
+ private:
+  std::atomic<bool>& writing_;
+  bool can_write_;
+};
+
+void Profiler::EndTimeAndRecordNodeEvent(uint32_t node_id,
+                                         NodeEventKind kind,
+                                         const TimePoint& start_time,
+                                         bool record_trace,
+                                         const KernelMetrics* metrics) {
+  const TimePoint end_time = StartTime();
+  NodeEntry& node = *nodes_[node_id];
+  OpTypeEntry& op_type = *op_types_[node.op_type_id];
+
+  if (summary_enabled_ && kind == NODE_KERNEL_TIME) {
+    const long long duration_ns = duration_cast<nanoseconds>(end_time - start_time).count();
+    node.histogram.Record(duration_ns);
+    op_type.histogram.Record(duration_ns);
+  }
+
+  if (metrics != nullptr) {
+    for (int i = 0; i < HW_COUNTER_MAX; i++) {
+      op_type.counter_totals[i].fetch_add(metrics->counters.values[i], std::memory_order_relaxed);
+    }
+    op_type.bytes.fetch_add(metrics->bytes, std::memory_order_relaxed);
+    op_type.flops.fetch_add(metrics->flops, std::memory_order_relaxed);
+    op_type.metrics_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  if (!record_trace || !enabled_) {
+    return;
+  }
+
+  long long dur = TimeDiffMicroSeconds(start_time, end_time);
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+
+  if (profile_with_logger_) {
+    std::vector<std::pair<std::string, std::string>> args = node.args[kind];
+    if (metrics != nullptr) {
+      AddMetricsArgs(*metrics, args);
+    }
+    std::string event_name;
+    {
+      // strings_ may be reallocated by a concurrent InternString
+      std::lock_guard<OrtMutex> lock(mutex_);
+      event_name = strings_[node.name_id[kind]];
+    }
+    EventRecord event(NODE_EVENT, logging::GetProcessId(), logging::GetThreadId(), event_name,
+                      ts, dur, {args.begin(), args.end()});
+    custom_logger_->SendProfileEvent(event);
+    return;
+  }
+
+  auto& buffer = GetThreadEventBuffer();
+  ThreadEventBufferWriter writer(buffer.writing, enabled_);
+  if (!writer.CanWrite()) {
+    return;
+  }
+  if (metrics != nullptr) {
+    if (!buffer.metrics) {
+      buffer.metrics.reset(new KernelMetrics[max_num_events_per_thread_]);
+    }
+    buffer.metrics[buffer.count.load(std::memory_order_relaxed) % max_num_events_per_thread_] = *metrics;
+  }
+  AppendEvent(buffer.count, buffer.events.get(), max_num_events_per_thread_,
+              ProfilerEvent{ts, dur, node.name_id[kind], node.args_id[kind], NODE_EVENT, metrics != nullptr});
+}
+
 void Profiler::EndTimeAndRecordEvent(EventCategory category,
                                      const std::string& event_name,
                                      TimePoint& start_time,
@@ -63,22 +365,25 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
   long long dur = TimeDiffMicroSeconds(start_time);
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
-  EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
   if (profile_with_logger_) {
+    EventRecord event(category, logging::GetProcessId(),
+                      logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
     custom_logger_->SendProfileEvent(event);
-  } else {
-    //TODO: sync_gpu if needed.
+    return;
+  }
+
+  //TODO: sync_gpu if needed.
+  ProfilerEvent event{ts, dur, 0, 0, category, false};
+  {
     std::lock_guard<OrtMutex> lock(mutex_);
-    if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
-    } else {
-      if (session_logger_ && !max_events_reached) {
-        LOGS(*session_logger_, ERROR)
-            << "Maximum number of events reached, could not record profile event.";
-        max_events_reached = true;
-      }
-    }
+    event.name_id = InternString(event_name);
+    event.args_id = InternString(FormatArgs({event_args.begin(), event_args.end()}));
+  }
+
+  auto& buffer = GetThreadEventBuffer();
+  ThreadEventBufferWriter writer(buffer.writing, enabled_);
+  if (writer.CanWrite()) {
+    AppendEvent(buffer.count, buffer.events.get(), max_num_events_per_thread_, event);
   }
 }
 
@@ -95,37 +400,121 @@ std::string Profiler::EndProfiling() {
     LOGS(*session_logger_, INFO) << "Writing profiler data to file " << profile_stream_file_;
   }
 
+  // stop recording, and wait for the events that are being appended
+  enabled_.store(false);
   std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto& buffer : thread_buffers_) {
+    while (buffer->writing.load()) {
+      std::this_thread::yield();
+    }
+  }
+
+  const auto pid = logging::GetProcessId();
+  size_t num_dropped_events = 0;
+  bool is_first_event = true;
   profile_stream_ << "[\n";
 
-  for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
-    profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
-    profile_stream_ << "\"pid\" :" << rec.pid << ",";
-    profile_stream_ << "\"tid\" :" << rec.tid << ",";
-    profile_stream_ << "\"dur\" :" << rec.dur << ",";
-    profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
-    profile_stream_ << R"("name" :")" << rec.name << "\",";
-    profile_stream_ << "\"args\" : {";
-    bool is_first_arg = true;
-    for (std::pair<std::string, std::string> event_arg : rec.args) {
-      if (!is_first_arg) profile_stream_ << ",";
-      profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
-      is_first_arg = false;
-    }
-    profile_stream_ << "}";
-    if (i == events_.size() - 1) {
-      profile_stream_ << "}\n";
-    } else {
-      profile_stream_ << "},\n";
+  // events are written per thread in the order they were recorded
+  for (auto& buffer : thread_buffers_) {
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    const size_t first = count > max_num_events_per_thread_ ? count - max_num_events_per_thread_ : 0;
+    num_dropped_events += first;
+
+    for (size_t i = first; i < count; ++i) {
+      const auto& rec = buffer->events[i % max_num_events_per_thread_];
+      std::string metrics_args;
+      if (rec.has_metrics) {
+        std::vector<std::pair<std::string, std::string>> args;
+        AddMetricsArgs(buffer->metrics[i % max_num_events_per_thread_], args);
+        metrics_args = "," + FormatArgs(args);
+      }
+      if (!is_first_event) profile_stream_ << ",\n";
+      profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
+      profile_stream_ << "\"pid\" :" << pid << ",";
+      profile_stream_ << "\"tid\" :" << buffer->tid << ",";
+      profile_stream_ << "\"dur\" :" << rec.dur << ",";
+      profile_stream_ << "\"ts\" :" << rec.ts << ",";
+      profile_stream_ << R"("ph" : "X",)";
+      profile_stream_ << R"("name" :")" << strings_[rec.name_id] << "\",";
+      profile_stream_ << "\"args\" : {" << strings_[rec.args_id] << metrics_args << "}}";
+      is_first_event = false;
     }
+
+    buffer->count.store(0, std::memory_order_relaxed);
   }
+  if (!is_first_event) profile_stream_ << "\n";
   profile_stream_ << "]\n";
   profile_stream_.close();
-  enabled_ = false;  // will not collect profile after writing.
+
+  if (session_logger_ && num_dropped_events > 0) {
+    LOGS(*session_logger_, WARNING) << "Profiler event buffers wrapped around, the oldest " << num_dropped_events
+                                    << " events were dropped.";
+  }
+
   return profile_stream_file_;
 }
 
+static void WriteHistogramSummary(std::ostream& out, const LatencyHistogram& histogram) {
+  out << "\"count\" : " << histogram.Count() << ", "
+      << "\"total_us\" : " << histogram.Total() / 1000.0 << ", "
+      << "\"p50_us\" : " << histogram.Percentile(50) / 1000.0 << ", "
+      << "\"p99_us\" : " << histogram.Percentile(99) / 1000.0;
+}
+
+static double Ratio(uint64_t numerator, uint64_t denominator) {
+  return denominator != 0 ? static_cast<double>(numerator) / denominator : 0.0;
+}
+
+std::string Profiler::GetSummary() const {
+  std::vector<const OpTypeEntry*> op_types;
+  for (const auto& op_type : op_types_) {
+    if (op_type->histogram.Count() > 0 || op_type->metrics_count.load(std::memory_order_relaxed) > 0) {
+      op_types.push_back(op_type.get());
+    }
+  }
+  // most expensive op types first
+  std::sort(op_types.begin(), op_types.end(), [](const OpTypeEntry* a, const OpTypeEntry* b) {
+    return a->histogram.Total() > b->histogram.Total();
+  });
+
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "{\n\"op_types\" : [";
+  bool is_first = true;
+  for (const auto* op_type : op_types) {
+    out << (is_first ? "\n" : ",\n") << R"({"op_type" : ")" << op_type->op_type << "\", ";
+    WriteHistogramSummary(out, op_type->histogram);
+    if (op_type->metrics_count.load(std::memory_order_relaxed) > 0) {
+      uint64_t totals[HW_COUNTER_MAX];
+      for (int i = 0; i < HW_COUNTER_MAX; i++) {
+        totals[i] = op_type->counter_totals[i].load(std::memory_order_relaxed);
+        out << ", \"" << hardware_counter_names_[i] << "\" : " << totals[i];
+      }
+      const uint64_t bytes = op_type->bytes.load(std::memory_order_relaxed);
+      const uint64_t flops = op_type->flops.load(std::memory_order_relaxed);
+      out << ", \"ipc\" : " << Ratio(totals[HW_INSTRUCTIONS], totals[HW_CPU_CYCLES])
+          << ", \"bytes\" : " << bytes
+          << ", \"flops\" : " << flops
+          << ", \"bytes_per_flop\" : " << Ratio(bytes, flops);
+    }
+    out << "}";
+    is_first = false;
+  }
+  out << "],\n\"nodes\" : [";
+  is_first = true;
+  for (const auto& node : nodes_) {
+    if (node->histogram.Count() == 0) {
+      continue;
+    }
+    out << (is_first ? "\n" : ",\n") << R"({"name" : ")" << node->name << "\", "
+        << R"("op_type" : ")" << op_types_[node->op_type_id]->op_type << "\", ";
+    WriteHistogramSummary(out, node->histogram);
+    out << "}";
+    is_first = false;
+  }
+  out << "]\n}\n";
+  return out.str();
+}
+
 }  // namespace profiling
 }  // namespace onnxruntime
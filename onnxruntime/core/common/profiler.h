@@ -2,11 +2,16 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <tuple>
 #include <initializer_list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include "core/platform/ort_mutex.h"
+#include "core/common/hardware_counters.h"
 #include "core/common/logging/logging.h"
 
 namespace onnxruntime {
@@ -17,6 +22,73 @@ namespace profiling {
 // note that static profiler instance only works with single session
 //#define ENABLE_STATIC_PROFILER_INSTANCE
 
+/*
+Events recorded for each node by the executors.
+*/
+enum NodeEventKind : uint16_t {
+  NODE_FENCE_BEFORE = 0,
+  NODE_KERNEL_TIME,
+  NODE_FENCE_AFTER,
+  NODE_EVENT_KIND_MAX
+};
+
+/*
+Compact event stored in the per-thread event buffers. Names and arguments are interned by
+the profiler so recording an event never allocates.
+*/
+struct ProfilerEvent {
+  long long ts;
+  long long dur;
+  uint32_t name_id;
+  uint32_t args_id;  // arguments pre-formatted as JSON members
+  EventCategory cat;
+  bool has_metrics;  // KernelMetrics were recorded alongside the event
+};
+
+/*
+Hardware counter deltas and cost estimates measured around a kernel's Compute.
+*/
+struct KernelMetrics {
+  HardwareCounterValues counters;
+  uint64_t bytes;  // bytes of the input and output tensors
+  uint64_t flops;  // estimated floating point operations
+};
+
+/*
+Lock-free latency histogram with logarithmic buckets. Each power of two is split into
+kSubBuckets linear buckets, so percentiles are accurate to within 1/kSubBuckets of the value.
+*/
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void Record(long long nanoseconds);
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t Total() const { return total_.load(std::memory_order_relaxed); }
+
+  /*
+  Approximate value at the given percentile (0..100) in nanoseconds.
+  */
+  uint64_t Percentile(double percentile) const;
+
+  void Reset();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LatencyHistogram);
+
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketLowerBound(size_t index);
+
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> total_;
+  std::atomic<uint64_t> buckets_[kBucketCount];
+};
+
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
@@ -57,6 +129,58 @@ class Profiler {
     return enabled_;
   }
 
+  /*
+  Record trace events for one out of every sampling_rate graph executions. Sampling is applied
+  per executor invocation, so the iterations of a subgraph are sampled independently.
+  */
+  void SetSamplingRate(uint32_t sampling_rate);
+
+  /*
+  Returns true if the trace events of the graph execution that is starting should be recorded.
+  */
+  bool SampleExecution() {
+    return sampling_rate_ <= 1 ||
+           sample_counter_.fetch_add(1, std::memory_order_relaxed) % sampling_rate_ == 0;
+  }
+
+  /*
+  Enable collection of the per-node and per-op-type kernel time histograms. This is independent of
+  IsEnabled() and cheap enough to stay on in production.
+  */
+  void EnableSummary();
+
+  bool IsSummaryEnabled() const {
+    return summary_enabled_;
+  }
+
+  /*
+  Measure hardware performance counters around each kernel. Returns false if the counters are not
+  available on this platform, in which case the mode stays off.
+  */
+  bool EnableHardwareCounters();
+
+  bool IsHardwareCountersEnabled() const {
+    return hardware_counters_enabled_;
+  }
+
+  /*
+  Register a node so its events can be recorded with EndTimeAndRecordNodeEvent. All nodes must be
+  registered before the first execution.
+  @return the node id.
+  */
+  uint32_t RegisterNode(const std::string& node_name, const std::string& op_type, const std::string& provider);
+
+  /*
+  Record an event for a registered node. The kernel time is added to the summary histograms when
+  the summary is enabled, and the event is added to the trace when record_trace is true.
+  Kernel metrics are added to the trace event arguments and the per-op-type totals.
+  */
+  void EndTimeAndRecordNodeEvent(uint32_t node_id,
+                                 NodeEventKind kind,
+                                 const TimePoint& start_time,
+                                 bool record_trace = true,
+                                 const KernelMetrics* metrics = nullptr);
+
   /*
   Record a single event. Time is measured till the call of this function from
   the start_time.
@@ -73,6 +197,11 @@ class Profiler {
   */
   std::string EndProfiling();
 
+  /*
+  Write the per-op-type and per-node kernel time summaries as JSON. Times are in microseconds.
+  */
+  std::string GetSummary() const;
+
   static Profiler& Instance() {
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
     ORT_ENFORCE(instance_ != nullptr);
@@ -85,17 +214,67 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
-  // Mutex controlling access to profiler data
+  // Events of a single thread. Only the owning thread writes to the buffer; once it is full the
+  // oldest events are overwritten.
+  struct ThreadEventBuffer {
+    explicit ThreadEventBuffer(int thread_id);
+
+    int tid;
+    std::unique_ptr<ProfilerEvent[]> events;
+    // parallel to events, allocated when the first event with metrics is recorded
+    std::unique_ptr<KernelMetrics[]> metrics;
+    std::atomic<size_t> count;
+    // set while the owning thread appends an event, so EndProfiling can wait for it to complete
+    std::atomic<bool> writing;
+  };
+
+  struct NodeEntry {
+    std::string name;
+    uint32_t name_id[NODE_EVENT_KIND_MAX];
+    uint32_t args_id[NODE_EVENT_KIND_MAX];
+    std::vector<std::pair<std::string, std::string>> args[NODE_EVENT_KIND_MAX];
+    uint32_t op_type_id;
+    LatencyHistogram histogram;
+  };
+
+  struct OpTypeEntry {
+    std::string op_type;
+    LatencyHistogram histogram;
+    std::atomic<uint64_t> metrics_count{0};
+    std::atomic<uint64_t> counter_totals[HW_COUNTER_MAX]{};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> flops{0};
+  };
+
+  ThreadEventBuffer& GetThreadEventBuffer();
+  uint32_t InternString(const std::string& value);
+  static std::string FormatArgs(const std::vector<std::pair<std::string, std::string>>& args);
+  static void AddMetricsArgs(const KernelMetrics& metrics, std::vector<std::pair<std::string, std::string>>& args);
+
+  // Mutex controlling registration of threads, nodes and interned strings
   OrtMutex mutex_;
-  bool enabled_{false};
+  // cleared by EndProfiling before it reads the event buffers
+  std::atomic<bool> enabled_{false};
+  bool summary_enabled_{false};
+  bool hardware_counters_enabled_{false};
+  uint32_t sampling_rate_{1};
+  std::atomic<uint64_t> sample_counter_{0};
   std::ofstream profile_stream_;
   std::string profile_stream_file_;
   const logging::Logger* session_logger_{nullptr};
   const logging::Logger* custom_logger_{nullptr};
   TimePoint profiling_start_time_;
-  std::vector<EventRecord> events_;
-  bool max_events_reached{false};
-  static constexpr size_t max_num_events_ = 1000000;
+  // unique id used by the threads to find their cached event buffer
+  const uint64_t profiler_id_{next_profiler_id_++};
+  static std::atomic<uint64_t> next_profiler_id_;
+  std::vector<std::unique_ptr<ThreadEventBuffer>> thread_buffers_;
+  static constexpr size_t max_num_events_per_thread_ = 1 << 17;
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> string_ids_;
+  // nodes are only added during session initialization, so lookups while executing are lock-free
+  std::vector<std::unique_ptr<NodeEntry>> nodes_;
+  std::vector<std::unique_ptr<OpTypeEntry>> op_types_;
+  std::unordered_map<std::string, uint32_t> op_type_ids_;
   bool profile_with_logger_{false};
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
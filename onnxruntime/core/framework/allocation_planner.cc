@@ -4,7 +4,9 @@
 #include "core/framework/allocation_planner.h"
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <numeric>
 #include <sstream>
 #include "core/common/exceptions.h"
 #include "core/platform/env.h"
@@ -40,6 +42,9 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kShare:
       out << "Share";
       break;
+    case AllocKind::kSubBuffer:
+      out << "SubBuffer";
+      break;
   }
   return out;
 }
@@ -63,6 +68,10 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kSubBuffer) {
+        out << " " << elt_plan.reused_buffer << " at offset " << elt_plan.sub_buffer_offset;
+      }
+      if (elt_plan.is_strided_view) out << " as strided view";
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -153,6 +162,19 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // SubBufferInfo: where a value is placed inside the buffer of another (parent) value.
+  struct SubBufferInfo {
+    OrtValueIndex parent;
+    size_t byte_offset;
+  };
+  // sub_buffers_ : values to place inside a parent's buffer, found before the reuse plan is computed
+  std::unordered_map<OrtValueIndex, SubBufferInfo> sub_buffers_;
+  // sub_buffer_parents_ : static shapes of Concat outputs that are parents, which are planned before the
+  // nodes producing them so the Concat inputs can be written into them
+  std::unordered_map<OrtValueIndex, std::vector<int64_t>> sub_buffer_parents_;
+  // values planned by PlaceInSubBuffer or PlanSubBufferParent
+  std::unordered_set<OrtValueIndex> sub_buffer_planned_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -197,10 +219,20 @@ class PlannerImpl {
     // adjust original buffer's usecount
     UseCount(original) += UseCount(reused_for);
 
+    // a sub-buffer starts part way into the original buffer, so values reusing it must refer to the sub-buffer
+    OrtValueIndex storage = original;
+    const auto& reused_plan = AllocPlan(reused);
+    if (reused_plan.alloc_kind == AllocKind::kSubBuffer) {
+      storage = reused;
+    } else if (reused_plan.alloc_kind == AllocKind::kReuse &&
+               AllocPlan(reused_plan.reused_buffer).alloc_kind == AllocKind::kSubBuffer) {
+      storage = reused_plan.reused_buffer;
+    }
+
     // update allocation plan (for use at execution-time)
     auto& symplan = AllocPlan(reused_for);
     symplan.alloc_kind = alloc_kind;
-    symplan.reused_buffer = original;
+    symplan.reused_buffer = storage;
   }
 
   // Find if there exists some input tensor that we can use in-place for output_arg
@@ -249,6 +281,243 @@ class PlannerImpl {
     return false;
   }
 
+  // Find if output_arg_num of node can be a strided view of one of the node's inputs, which requires every
+  // consumer of the output to accept strided input.
+  bool FindStridedViewInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* viewed_input) {
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
+      return false;
+    }
+
+    auto input_args = node.InputDefs();
+    for (auto pair : ci->kernel_def->MayStridedOutput()) {
+      if ((pair.second == output_arg_num || pair.second == -1) &&
+          (0 <= pair.first) && (static_cast<size_t>(pair.first) < input_args.size())) {
+        auto p_input_arg = input_args[pair.first];
+        if (p_input_arg->Exists() && ConsumersAcceptStridedInput(node, output_arg_num)) {
+          *viewed_input = Index(p_input_arg->Name());
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool ConsumersAcceptStridedInput(const onnxruntime::Node& node, int output_arg_num) {
+    int num_consumers = 0;
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (it->GetSrcArgIndex() != output_arg_num) continue;
+
+      const Node& consumer = it->GetNode();
+      const KernelCreateInfo* ci;
+      Status st = kernel_registry_.SearchKernelRegistry(consumer, &ci);
+      if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
+        return false;
+      }
+
+      // implicit inputs of control flow nodes are passed on to subgraphs, which may need contiguous data
+      auto input_index = it->GetDstArgIndex();
+      if (static_cast<size_t>(input_index) >= consumer.InputDefs().size() ||
+          !ci->kernel_def->MayStridedInput(input_index)) {
+        return false;
+      }
+      ++num_consumers;
+    }
+
+    // the use count includes the definition. any other use, such as a graph output, needs contiguous data.
+    auto output_index = Index(node.OutputDefs()[output_arg_num]->Name());
+    return num_consumers > 0 && num_consumers + 1 == UseCount(output_index);
+  }
+
+  // Get the static dims and element size of a tensor value. Returns false if the shape is not fully known,
+  // or the value is a string tensor whose elements can not be placed in another buffer.
+  bool GetStaticSize(const onnxruntime::NodeArg& arg, std::vector<int64_t>& dims, size_t& element_size) {
+    if (!arg.Exists() || IsNonTensor(arg)) return false;
+    const auto* tensor_type = utils::GetMLDataType(arg)->AsTensorType();
+    if (tensor_type == nullptr || tensor_type->GetElementType() == DataTypeImpl::GetType<std::string>()) {
+      return false;
+    }
+
+    const auto* shape = context_.GetShape(arg);
+    if (shape == nullptr) return false;
+    dims.clear();
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return false;
+      dims.push_back(dim.dim_value());
+    }
+
+    element_size = tensor_type->GetElementType()->Size();
+    return true;
+  }
+
+  static size_t NumElements(const std::vector<int64_t>& dims) {
+    return static_cast<size_t>(std::accumulate(dims.cbegin(), dims.cend(), int64_t{1}, std::multiplies<int64_t>()));
+  }
+
+  // Each slice along axis is a single contiguous range of the buffer if all the dims before axis are 1.
+  static bool IsContiguousAlongAxis(const std::vector<int64_t>& dims, const Node& node) {
+    const auto& attributes = node.GetAttributes();
+    auto attr = attributes.find("axis");
+    int64_t axis = attr != attributes.cend() ? attr->second.i() : 0;
+    int64_t rank = static_cast<int64_t>(dims.size());
+    if (axis < 0) axis += rank;
+    if (axis < 0 || axis >= rank) return false;
+    return std::all_of(dims.cbegin(), dims.cbegin() + axis, [](int64_t dim) { return dim == 1; });
+  }
+
+  bool IsGraphOutput(const onnxruntime::NodeArg* arg) {
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    return std::find(graph_outputs.cbegin(), graph_outputs.cend(), arg) != graph_outputs.cend();
+  }
+
+  static bool IsCpuOnnxNode(const Node& node, const char* op_type) {
+    return node.OpType() == op_type && node.Domain() == kOnnxDomain &&
+           node.GetExecutionProviderType() == kCpuExecutionProvider;
+  }
+
+  // Find the inputs of a Concat that can be written directly into the Concat output. Each must be produced by a
+  // node in this graph and used only by the Concat, and the producer must not alias it to one of its inputs.
+  void FindConcatSubBuffers(const Node& concat) {
+    const auto* output = concat.OutputDefs()[0];
+    std::vector<int64_t> output_dims;
+    size_t element_size;
+    if (IsGraphOutput(output) || !GetStaticSize(*output, output_dims, element_size) ||
+        !IsContiguousAlongAxis(output_dims, concat)) {
+      return;
+    }
+
+    auto output_index = Index(output->Name());
+    auto input_args = concat.InputDefs();
+    std::vector<const Node*> producers(input_args.size(), nullptr);
+    std::vector<int> producer_output_nums(input_args.size(), 0);
+    for (auto it = concat.InputEdgesBegin(), end = concat.InputEdgesEnd(); it != end; ++it) {
+      producers[it->GetDstArgIndex()] = &it->GetNode();
+      producer_output_nums[it->GetDstArgIndex()] = it->GetSrcArgIndex();
+    }
+
+    std::vector<std::pair<OrtValueIndex, size_t>> placed;
+    size_t offset = 0;
+    for (size_t i = 0; i < input_args.size(); ++i) {
+      const auto* input = input_args[i];
+      std::vector<int64_t> input_dims;
+      size_t input_element_size;
+      // the offsets of all the inputs must be known
+      if (!GetStaticSize(*input, input_dims, input_element_size) || input_element_size != element_size) return;
+
+      auto input_index = Index(input->Name());
+      if (producers[i] != nullptr && UseCount(input_index) == 2 &&
+          std::count(input_args.cbegin(), input_args.cend(), input) == 1 &&
+          AllocPlan(input_index).location == AllocPlan(output_index).location &&
+          !AliasesInput(*producers[i], producer_output_nums[i])) {
+        placed.emplace_back(input_index, offset);
+      }
+      offset += NumElements(input_dims) * element_size;
+    }
+
+    if (placed.empty() || offset != NumElements(output_dims) * element_size) return;
+
+    sub_buffer_parents_[output_index] = output_dims;
+    for (const auto& input : placed) {
+      sub_buffers_[input.first] = SubBufferInfo{output_index, input.second};
+    }
+  }
+
+  // Find the outputs of a Split that can refer to their part of the Split input rather than copy it.
+  void FindSplitSubBuffers(const Node& split) {
+    const auto* input = split.InputDefs()[0];
+    std::vector<int64_t> input_dims;
+    size_t element_size;
+    if (!GetStaticSize(*input, input_dims, element_size) || !IsContiguousAlongAxis(input_dims, split)) return;
+
+    auto input_index = Index(input->Name());
+    std::vector<std::pair<OrtValueIndex, size_t>> placed;
+    size_t offset = 0;
+    for (const auto* output : split.OutputDefs()) {
+      std::vector<int64_t> output_dims;
+      size_t output_element_size;
+      if (!GetStaticSize(*output, output_dims, output_element_size) || output_element_size != element_size) return;
+
+      auto output_index = Index(output->Name());
+      // a Concat input placed in the Concat output takes priority
+      if (!IsGraphOutput(output) && sub_buffers_.find(output_index) == sub_buffers_.cend() &&
+          AllocPlan(output_index).location == AllocPlan(input_index).location) {
+        placed.emplace_back(output_index, offset);
+      }
+      offset += NumElements(output_dims) * element_size;
+    }
+
+    if (offset != NumElements(input_dims) * element_size) return;
+
+    for (const auto& output : placed) {
+      sub_buffers_[output.first] = SubBufferInfo{input_index, output.second};
+    }
+  }
+
+  bool AliasesInput(const Node& node, int output_arg_num) {
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
+      return true;
+    }
+
+    const auto& alias_map = ci->kernel_def->Alias();
+    return std::any_of(alias_map.cbegin(), alias_map.cend(),
+                       [output_arg_num](const std::pair<int, int>& pair) { return pair.second == output_arg_num; });
+  }
+
+  void FindSubBuffers() {
+    for (const auto& node : graph_viewer_.Nodes()) {
+      if (IsCpuOnnxNode(node, "Concat")) FindConcatSubBuffers(node);
+    }
+
+    for (const auto& node : graph_viewer_.Nodes()) {
+      if (IsCpuOnnxNode(node, "Split")) FindSplitSubBuffers(node);
+    }
+  }
+
+  // Plan a Concat output that has sub-buffers when the first of them is placed, which is before the Concat runs.
+  void PlanSubBufferParent(OrtValueIndex parent, const std::vector<int64_t>& dims) {
+    if (!sub_buffer_planned_.insert(parent).second) return;
+
+    auto& parent_plan = AllocPlan(parent);
+    parent_plan.value_type = utils::GetMLDataType(*ort_value_info_[parent].p_def_site);
+    parent_plan.planned_shape = dims;
+
+    // the parent may itself be an input of another Concat
+    auto sub_buffer = sub_buffers_.find(parent);
+    if (sub_buffer == sub_buffers_.cend() || !PlaceInSubBuffer(parent, sub_buffer->second)) {
+      parent_plan.alloc_kind = AllocKind::kAllocate;
+    }
+  }
+
+  bool PlaceInSubBuffer(OrtValueIndex value, const SubBufferInfo& info) {
+    auto parent_dims = sub_buffer_parents_.find(info.parent);
+    if (parent_dims != sub_buffer_parents_.cend()) {
+      PlanSubBufferParent(info.parent, parent_dims->second);
+    } else {
+      // the input of a Split is planned already, and must be a contiguous buffer owned by this session
+      const auto& parent_plan = AllocPlan(info.parent);
+      if (parent_plan.is_strided_view || parent_plan.alloc_kind == AllocKind::kAllocateOutput ||
+          parent_plan.alloc_kind == AllocKind::kShare) {
+        return false;
+      }
+    }
+
+    Reuse(info.parent, value, AllocKind::kSubBuffer);
+    auto& value_plan = AllocPlan(value);
+    value_plan.reused_buffer = info.parent;
+    value_plan.sub_buffer_offset = info.byte_offset;
+    sub_buffer_planned_.insert(value);
+    return true;
+  }
+
+  bool PlanSubBuffer(OrtValueIndex value) {
+    if (sub_buffer_planned_.find(value) != sub_buffer_planned_.cend()) return true;
+    auto sub_buffer = sub_buffers_.find(value);
+    return sub_buffer != sub_buffers_.cend() && PlaceInSubBuffer(value, sub_buffer->second);
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -526,6 +795,11 @@ class PlannerImpl {
     // set AllocationInfo for each weight
     ORT_RETURN_IF_ERROR(GeneratePlanForWeights());
 
+    // the parallel executor may run the producers of sub-buffers of the same parent concurrently
+    if (!context_.IsParallelExecutionEnabled()) {
+      FindSubBuffers();
+    }
+
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
       SequentialExecutionPlan::NodeExecutionPlan step = execution_plan[program_counter];
       auto pnode = graph_viewer_.GetNode(step.node_index);
@@ -557,6 +831,12 @@ class PlannerImpl {
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (PlanSubBuffer(current)) {
+          // Place the output inside the buffer of a Concat output or Split input, so no copy is needed
+        } else if (FindStridedViewInput(*pnode, output_arg_num, &reused)) {
+          // Describe the output as a view of the input's buffer instead of copying the data
+          Reuse(reused, current, AllocKind::kReuse);
+          AllocPlan(current).is_strided_view = true;
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
@@ -140,6 +140,19 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std:
   }
 }
 
+void IExecutionFrame::ResetValues(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                                  const std::unordered_map<int, OrtValue>& initializers,
+                                  const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs_.size());
+
+  for (auto& value : all_values_) {
+    value = OrtValue();
+  }
+
+  Init(feed_mlvalue_idxs, feeds, initializers, fetches);
+}
+
 Status IExecutionFrame::GetOutputs(std::vector<OrtValue>& fetches) {
   auto num_fetches = fetch_mlvalue_idxs_.size();
 
@@ -174,17 +187,7 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       session_state_(session_state),
       mem_patterns_(nullptr),
       planner_(nullptr) {
-  // map the custom allocators to ort_value_idx entries
-  if (!fetch_allocators.empty()) {
-    for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
-      int ort_value_idx = fetch_mlvalue_idxs[idx];
-
-      auto custom_alloc_entry = fetch_allocators.find(idx);
-      if (custom_alloc_entry != fetch_allocators.cend()) {
-        custom_allocators_[ort_value_idx] = custom_alloc_entry->second;
-      }
-    }
-  }
+  MapCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
 
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
@@ -210,6 +213,8 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       if (!mem_patterns_) {
         planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
       } else {
+        mem_pattern_input_shapes_.assign(input_shapes.cbegin(), input_shapes.cend());
+
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
@@ -227,6 +232,50 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
 
 ExecutionFrame::~ExecutionFrame() = default;
 
+void ExecutionFrame::MapCustomAllocators(
+    const std::vector<int>& fetch_mlvalue_idxs,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // map the custom allocators to ort_value_idx entries
+  custom_allocators_.clear();
+
+  if (!fetch_allocators.empty()) {
+    for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
+      int ort_value_idx = fetch_mlvalue_idxs[idx];
+
+      auto custom_alloc_entry = fetch_allocators.find(idx);
+      if (custom_alloc_entry != fetch_allocators.cend()) {
+        custom_allocators_[ort_value_idx] = custom_alloc_entry->second;
+      }
+    }
+  }
+}
+
+bool ExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                           const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // a frame that is tracing allocations needs to be used once so the memory pattern can be generated from it
+  if (planner_) {
+    return false;
+  }
+
+  if (mem_patterns_) {
+    if (feeds.size() != mem_pattern_input_shapes_.size()) {
+      return false;
+    }
+
+    for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+      if (!feeds[i].IsTensor() || feeds[i].Get<Tensor>().Shape() != mem_pattern_input_shapes_[i]) {
+        return false;
+      }
+    }
+  }
+
+  ResetValues(feed_mlvalue_idxs, feeds, session_state_.GetInitializedTensors(), fetches);
+  MapCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+
+  return true;
+}
+
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
                                                           const TensorShape& shape, bool create_fence) {
@@ -313,15 +362,17 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
 
 Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_value, int ort_value_index_reuse,
                                                               MLDataType element_type, const OrtMemoryInfo& location,
-                                                              const TensorShape& shape, bool create_fence) {
+                                                              const TensorShape& shape, bool create_fence,
+                                                              bool is_strided_view) {
   OrtValue& ort_value_reuse = GetMutableMLValue(ort_value_index_reuse);
 
   auto* reuse_tensor = ort_value_reuse.GetMutable<Tensor>();
   auto buffer_num_elements = reuse_tensor->Shape().Size();
   auto required_num_elements = shape.Size();
 
-  // check number of elements matches. shape may not be an exact match (e.g. Reshape op)
-  if (buffer_num_elements != required_num_elements) {
+  // check number of elements matches. shape may not be an exact match (e.g. Reshape op).
+  // a strided view may cover any part of the buffer, and the kernel producing it sets its layout.
+  if (!is_strided_view && buffer_num_elements != required_num_elements) {
     // could be an allocation planner bug (less likely) or the model incorrectly uses something like 'None'
     // as a dim_param, or -1 in dim_value in multiple places making the planner think those shapes are equal.
     auto message = onnxruntime::MakeString(
@@ -349,6 +400,13 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
 
   // reused OrtValue share the same fence
   ort_value.ShareFenceWith(ort_value_reuse);
+  if (is_strided_view) {
+    auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, reuse_buffer, location,
+                                                     reuse_tensor->ByteOffset());
+    ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    return Status::OK();
+  }
+
   return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
 }
 
@@ -362,6 +420,38 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_v
   return Status::OK();
 }
 
+Status ExecutionFrame::AllocateMLValueTensorSubBuffer(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                                      MLDataType element_type, const TensorShape& shape) {
+  int parent_index = per_alloc_plan.reused_buffer;
+  OrtValue& parent_value = GetMutableMLValue(parent_index);
+
+  // the first sub-buffer created allocates the parent, which may itself be a sub-buffer
+  if (!parent_value.IsAllocated()) {
+    const auto& parent_plan = GetAllocationPlan(parent_index);
+    ORT_RETURN_IF_NOT(!parent_plan.planned_shape.empty(), "Sub-buffer parent ", parent_index, " has no planned shape");
+    TensorShape parent_shape(parent_plan.planned_shape);
+    ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(parent_value, parent_index, &parent_shape, 0));
+  }
+
+  auto* parent_tensor = parent_value.GetMutable<Tensor>();
+  ORT_RETURN_IF_NOT(parent_tensor->IsContiguous(), "Sub-buffer parent ", parent_index, " is a strided view");
+
+  size_t size;
+  if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), element_type->Size(), &size)) {
+    return Status(ONNXRUNTIME, FAIL, "size overflow");
+  }
+
+  if (per_alloc_plan.sub_buffer_offset + size > parent_tensor->SizeInBytes()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Sub-buffer of shape ", shape, " at offset ",
+                           per_alloc_plan.sub_buffer_offset, " exceeds the buffer of shape ", parent_tensor->Shape(),
+                           ". Validate the static shapes in the model.");
+  }
+
+  ort_value.ShareFenceWith(parent_value);
+  void* buffer = static_cast<char*>(parent_tensor->MutableDataRaw()) + per_alloc_plan.sub_buffer_offset;
+  return AllocateTensorWithPreAllocateBufferHelper(ort_value, buffer, element_type, per_alloc_plan.location, shape);
+}
+
 static Status AllocateTraditionalMLValue(OrtValue& ort_value, const NonTensorTypeBase& type) {
   auto creator = type.GetCreateFunc();
   ort_value.Init(creator(), &type, type.GetDeleteFunc());
@@ -428,7 +518,12 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       case AllocKind::kReuse: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
-            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
+            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async,
+            per_alloc_plan.is_strided_view));
+        break;
+      }
+      case AllocKind::kSubBuffer: {
+        ORT_RETURN_IF_ERROR(AllocateMLValueTensorSubBuffer(ort_value, per_alloc_plan, ml_data_type, *shape));
         break;
       }
       case AllocKind::kShare: {
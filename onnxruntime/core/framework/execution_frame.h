@@ -69,6 +69,11 @@ class IExecutionFrame {
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // release all values and re-populate the frame with a new set of feeds, initializers and fetches
+  void ResetValues(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                   const std::unordered_map<int, OrtValue>& initializers,
+                   const std::vector<OrtValue>& fetches);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
@@ -116,7 +121,7 @@ class ExecutionFrame final : public IExecutionFrame {
 
   Status AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_value, int ort_value_index_reuse, MLDataType element_type,
                                                 const OrtMemoryInfo& location, const TensorShape& shape,
-                                                bool create_fence = false);
+                                                bool create_fence = false, bool is_strided_view = false);
 
   // thread-safe
   Status GeneratePatterns(MemoryPatternGroup* out) const;
@@ -125,6 +130,18 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_ != nullptr;
   }
 
+  /**
+   * Prepare the frame for another execution of the same graph with new feeds and fetches.
+   * The memory pattern buffers are kept, so a caller that executes a graph repeatedly (e.g. a Loop or Scan subgraph)
+   * avoids re-creating the frame for every execution.
+   * Returns false if the frame can't be re-used, either because it is still tracing allocations to generate a
+   * memory pattern, or because the memory pattern it is using was selected for different feed shapes.
+   * The frame must not be used after Reset returns false.
+   */
+  bool Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
@@ -132,6 +149,9 @@ class ExecutionFrame final : public IExecutionFrame {
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
 
+  void MapCustomAllocators(const std::vector<int>& fetch_mlvalue_idxs,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
   common::Status AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                              size_t nnz);
 
@@ -142,6 +162,9 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
                                                    const OrtMemoryInfo& location, const TensorShape& shape);
 
+  Status AllocateMLValueTensorSubBuffer(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                        MLDataType element_type, const TensorShape& shape);
+
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
@@ -157,6 +180,9 @@ class ExecutionFrame final : public IExecutionFrame {
   // kernel's input/output tensors.
   const MemoryPatternGroup* mem_patterns_;
 
+  // the feed shapes mem_patterns_ was selected for
+  std::vector<TensorShape> mem_pattern_input_shapes_;
+
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::unique_ptr<OrtValuePatternPlanner> planner_;
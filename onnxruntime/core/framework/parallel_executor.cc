@@ -33,9 +33,10 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
                                  const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                  const logging::Logger& logger) {
   TimePoint tp;
-  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
-  if (is_profiler_enabled) {
-    tp = session_state.Profiler().StartTime();
+  auto& profiler = session_state.Profiler();
+  is_profiler_enabled_ = profiler.IsEnabled() && profiler.SampleExecution();
+  if (is_profiler_enabled_) {
+    tp = profiler.StartTime();
   }
 
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
@@ -100,8 +101,8 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     }
   }
 
-  if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
+  if (is_profiler_enabled_) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
   }
 
   return Status::OK();
@@ -119,7 +120,9 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   auto graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
-  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  auto& profiler = session_state.Profiler();
+  const bool f_profiler_enabled = is_profiler_enabled_;
+  const bool f_summary_enabled = profiler.IsSummaryEnabled();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
   // Avoid context switching if possible.
@@ -141,8 +144,9 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 
     OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
 
+    const uint32_t profiler_node_id = session_state.GetProfilerNodeId(node_index);
     if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
     // sync before compute
     int queue_id = p_op_kernel->KernelDef().ExecQueueId();
@@ -178,12 +182,11 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_FENCE_BEFORE, sync_time_begin);
+    }
 
-      kernel_begin_time = session_state.Profiler().StartTime();
+    if (f_profiler_enabled || f_summary_enabled) {
+      kernel_begin_time = profiler.StartTime();
     }
 
     // call compute on the kernel
@@ -206,13 +209,13 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+    if (f_profiler_enabled || f_summary_enabled) {
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_KERNEL_TIME, kernel_begin_time,
+                                         f_profiler_enabled);
+    }
 
-      sync_time_begin = session_state.Profiler().StartTime();
+    if (f_profiler_enabled) {
+      sync_time_begin = profiler.StartTime();
     }
     // sync after compute for outputs
     if (exec_plan.NodeHasFence(node_index)) {
@@ -239,10 +242,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_FENCE_AFTER, sync_time_begin);
     }
 
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
@@ -59,6 +59,8 @@ class ParallelExecutor : public IExecutor {
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
   std::vector<Status> errors_;
+  // whether the trace events of this execution are recorded. set by Execute before any node is enqueued.
+  bool is_profiler_enabled_{false};
 
   const bool& terminate_flag_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
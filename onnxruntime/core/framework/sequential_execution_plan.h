@@ -28,6 +28,15 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // for kSubBuffer, reused_buffer is the value whose buffer contains this one, starting
+  // sub_buffer_offset bytes into its data.
+  size_t sub_buffer_offset{0};
+  // static shape of a value that other values are sub-buffers of. it is allocated with this shape
+  // when its first sub-buffer is created, which is before the node producing it runs.
+  std::vector<int64_t> planned_shape;
+  // if true the value is a strided view into reused_buffer, so its shape and strides are set by the
+  // kernel that produces it rather than matching the buffer.
+  bool is_strided_view{false};
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -8,6 +8,7 @@
 #include <vector>
 #include <sstream>
 #include "core/common/common.h"
+#include "core/common/hardware_counters.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
@@ -32,22 +33,43 @@ static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
                                   const logging::Logger& logger);
 
+static void EstimateKernelCost(OpKernelContextInternal& context, const Node& node, profiling::KernelMetrics& metrics);
+
 Status SequentialExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                                    const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
                                    std::vector<OrtValue>& fetches,
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
-  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+
+  return Execute(session_state, frame, feeds, fetches, logger);
+}
+
+Status SequentialExecutor::Execute(const SessionState& session_state, ExecutionFrame& frame,
+                                   const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                   const logging::Logger& logger) {
+  auto& profiler = session_state.Profiler();
+  const bool is_profiler_enabled = profiler.IsEnabled() && profiler.SampleExecution();
+  const bool is_summary_enabled = profiler.IsSummaryEnabled();
+  profiling::HardwareCounters* hardware_counters = nullptr;
+  if (profiler.IsHardwareCountersEnabled() && (is_profiler_enabled || is_summary_enabled)) {
+    hardware_counters = profiling::HardwareCounters::Get();
+  }
+  if (hardware_counters != nullptr) {
+    // count the work of the thread pools created since the counters were opened
+    hardware_counters->RefreshThreads();
+  }
+  profiling::HardwareCounterValues counters_begin;
+  profiling::HardwareCounterValues counters_end;
+  profiling::KernelMetrics kernel_metrics;
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
 
   if (is_profiler_enabled) {
-    tp = session_state.Profiler().StartTime();
+    tp = profiler.StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
-
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
@@ -92,8 +114,9 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     // TODO: log kernel inputs?
     OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_);
     // TODO: log kernel outputs?
+    const uint32_t profiler_node_id = session_state.GetProfilerNodeId(node_index);
     if (is_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
 
     // sync before compute
@@ -134,15 +157,18 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 #endif
 
     if (is_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_FENCE_BEFORE, sync_time_begin);
 
       // call compute on the kernel
       VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
+    }
+
+    if (is_profiler_enabled || is_summary_enabled) {
+      kernel_begin_time = profiler.StartTime();
+    }
 
-      kernel_begin_time = session_state.Profiler().StartTime();
+    if (hardware_counters != nullptr) {
+      hardware_counters->Read(counters_begin);
     }
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -170,13 +196,22 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 #endif
 
-    if (is_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+    const profiling::KernelMetrics* p_kernel_metrics = nullptr;
+    if (hardware_counters != nullptr && hardware_counters->Read(counters_end)) {
+      for (int i = 0; i < profiling::HW_COUNTER_MAX; i++) {
+        kernel_metrics.counters.values[i] = counters_end.values[i] - counters_begin.values[i];
+      }
+      EstimateKernelCost(op_kernel_context, node, kernel_metrics);
+      p_kernel_metrics = &kernel_metrics;
+    }
 
-      sync_time_begin = session_state.Profiler().StartTime();
+    if (is_profiler_enabled || is_summary_enabled) {
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_KERNEL_TIME, kernel_begin_time,
+                                         is_profiler_enabled, p_kernel_metrics);
+    }
+
+    if (is_profiler_enabled) {
+      sync_time_begin = profiler.StartTime();
     }
 
     // sync after compute for outputs
@@ -204,10 +239,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 
     if (is_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordNodeEvent(profiler_node_id, profiling::NODE_FENCE_AFTER, sync_time_begin);
     }
 
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
@@ -244,7 +276,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   }
 
   if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
   }
 
   return Status::OK();
@@ -262,4 +294,55 @@ static Status ReleaseNodeMLValues(ExecutionFrame& frame,
 
   return Status::OK();
 }
+
+// Estimate the memory traffic and floating point operations of a kernel from its tensor shapes. MatMul, Gemm and
+// Conv count their multiply-adds; other ops are assumed to perform one operation per output element.
+static void EstimateKernelCost(OpKernelContextInternal& context, const Node& node, profiling::KernelMetrics& metrics) {
+  uint64_t bytes = 0;
+  uint64_t output_elements = 0;
+
+  for (int i = 0; i < context.InputCount(); i++) {
+    const OrtValue* value = context.GetInputMLValue(i);
+    if (value != nullptr && value->IsAllocated() && value->IsTensor()) {
+      bytes += value->Get<Tensor>().SizeInBytes();
+    }
+  }
+
+  for (int i = 0; i < context.OutputCount(); i++) {
+    const OrtValue* value = context.GetOutputMLValue(i);
+    if (value != nullptr && value->IsAllocated() && value->IsTensor()) {
+      const auto& tensor = value->Get<Tensor>();
+      bytes += tensor.SizeInBytes();
+      output_elements += static_cast<uint64_t>(tensor.Shape().Size());
+    }
+  }
+
+  uint64_t flops = output_elements;
+
+  const std::string& op_type = node.OpType();
+  if ((op_type == "MatMul" || op_type == "Gemm" || op_type == "Conv") &&
+      context.InputCount() >= 2 && context.OutputCount() >= 1) {
+    const auto* A = context.Input<Tensor>(0);
+    const auto* B = context.Input<Tensor>(1);
+    const OrtValue* Y = context.GetOutputMLValue(0);
+
+    if (A != nullptr && B != nullptr && Y != nullptr && Y->IsTensor()) {
+      const auto& y_shape = Y->Get<Tensor>().Shape();
+
+      if (op_type == "MatMul" && A->Shape().NumDimensions() > 0) {
+        // each output element is a dot product over the last dimension of A
+        flops = 2 * output_elements * static_cast<uint64_t>(A->Shape()[A->Shape().NumDimensions() - 1]);
+      } else if (op_type == "Gemm" && y_shape.NumDimensions() == 2 && y_shape[0] > 0) {
+        flops = 2 * output_elements * static_cast<uint64_t>(A->Shape().Size() / y_shape[0]);
+      } else if (op_type == "Conv" && B->Shape().NumDimensions() > 0 && B->Shape()[0] > 0) {
+        // each output element reduces over one filter of size C/group x kernel
+        flops = 2 * output_elements * static_cast<uint64_t>(B->Shape().Size() / B->Shape()[0]);
+      }
+    }
+  }
+
+  metrics.bytes = bytes;
+  metrics.flops = flops;
+}
+
 }  // namespace onnxruntime
@@ -15,6 +15,8 @@
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+
 class SequentialExecutor : public IExecutor {
  public:
   SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
@@ -25,6 +27,12 @@ class SequentialExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                          const logging::Logger& logger) override;
 
+  // Execute the graph using a frame created by the caller. A caller that executes the same graph repeatedly
+  // can Reset and re-use the frame, along with its memory pattern buffers, across executions.
+  common::Status Execute(const SessionState& session_state, ExecutionFrame& frame,
+                         const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                         const logging::Logger& logger);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
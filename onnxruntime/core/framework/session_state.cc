@@ -77,6 +77,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
+    profiler_node_ids_.clear();
+    profiler_node_ids_.resize(max_nodeid + 1, 0);
     for (auto& node : graph_viewer_->Nodes()) {
       // construct and save the kernels
       std::unique_ptr<OpKernel> op_kernel;
@@ -97,6 +99,10 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
       assert(session_kernels_[node.Index()] == nullptr);
       // assumes vector is already resize()'ed to the number of nodes in the graph
       session_kernels_[node.Index()] = op_kernel.release();
+
+      if (profiler_ != nullptr) {
+        profiler_node_ids_[node.Index()] = profiler_->RegisterNode(node.Name(), node.OpType(), exec_provider_name);
+      }
     }
   }
   node_index_info_ = onnxruntime::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
@@ -305,4 +311,58 @@ const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   ORT_ENFORCE(node_index_info_, "SetGraphAndCreateKernels must be called prior to GetExecutionInfo.");
   return *node_index_info_;
 }
+
+Status SessionState::ShareFrom(const SessionState& source) {
+  ORT_ENFORCE(graph_viewer_ == nullptr, "ShareFrom must be called before a graph is set.");
+  if (source.graph_viewer_ == nullptr || source.p_seq_exec_plan_ == nullptr || source.node_index_info_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The SessionState to share from has not been initialized.");
+  }
+
+  graph_viewer_ = source.graph_viewer_;
+  p_seq_exec_plan_ = source.p_seq_exec_plan_;
+  node_index_info_ = source.node_index_info_;
+
+  // indexes are assigned in the order names are added, so adding them in index order keeps every index
+  std::vector<const std::string*> names(source.ort_value_name_idx_map_.Size());
+  for (const auto& entry : source.ort_value_name_idx_map_) {
+    names[entry.second] = &entry.first;
+  }
+  for (const auto* name : names) {
+    ort_value_name_idx_map_.Add(*name);
+  }
+
+  // the source keeps ownership of the kernels, and of the initializer buffers and their deleters
+  session_kernels_ = source.session_kernels_;
+  owns_kernels_ = false;
+  initialized_tensors_ = source.initialized_tensors_;
+  constant_initialized_tensors_ = source.constant_initialized_tensors_;
+
+  profiler_node_ids_.assign(source.profiler_node_ids_.size(), 0);
+  if (profiler_ != nullptr) {
+    for (const auto& node : graph_viewer_->Nodes()) {
+      profiler_node_ids_[node.Index()] = profiler_->RegisterNode(node.Name(), node.OpType(),
+                                                                 node.GetExecutionProviderType());
+    }
+  }
+
+  input_names_to_nodeinfo_mapping_ = source.input_names_to_nodeinfo_mapping_;
+  output_names_to_nodeinfo_mapping_ = source.output_names_to_nodeinfo_mapping_;
+  export_fused_dll_ = source.export_fused_dll_;
+  fused_funcs_mgr_.SetFusedFuncs(source.fused_funcs_mgr_);
+
+  for (const auto& node_entry : source.subgraph_session_states_) {
+    for (const auto& attribute_entry : node_entry.second) {
+      const SessionState& source_subgraph = *attribute_entry.second;
+      auto subgraph_session_state = onnxruntime::make_unique<SessionState>(
+          execution_providers_, source_subgraph.enable_mem_pattern_, thread_pool_, inter_op_thread_pool_);
+      subgraph_session_state->logger_ = logger_;
+      subgraph_session_state->profiler_ = profiler_;
+      subgraph_session_state->data_transfer_mgr_ = data_transfer_mgr_;
+      ORT_RETURN_IF_ERROR(subgraph_session_state->ShareFrom(source_subgraph));
+      AddSubgraphSessionState(node_entry.first, attribute_entry.first, std::move(subgraph_session_state));
+    }
+  }
+
+  return Status::OK();
+}
 }  // namespace onnxruntime
@@ -60,8 +60,10 @@ class SessionState {
   }
 
   ~SessionState() {
-    for (auto* p : session_kernels_) {
-      delete p;
+    if (owns_kernels_) {
+      for (auto* p : session_kernels_) {
+        delete p;
+      }
     }
     for (auto& kvp : deleter_for_initialized_tensors_) {
       kvp.second.f(kvp.second.param);
@@ -141,6 +143,11 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const;
 
+  /**
+  Get the id of the node in the profiler. Nodes are registered with the profiler when their kernels are created.
+  */
+  uint32_t GetProfilerNodeId(NodeIndex node_index) const { return profiler_node_ids_[node_index]; }
+
   /**
   Get cached memory pattern based on input shapes
   */
@@ -217,13 +224,24 @@ class SessionState {
   std::vector<BufferUniquePtr>& GetMutableWeightsBuffers() { return weights_buffers_; }
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
+  /**
+   * Share the graph, kernels, execution plan and initializers of an initialized SessionState, including those of
+   * its subgraphs. source must outlive this instance. The execution providers, thread pools and memory pattern
+   * cache of this instance are its own, so executions using it allocate from its providers' allocators.
+   * Call SetLogger, SetProfiler and SetDataTransferMgr first.
+   */
+  Status ShareFrom(const SessionState& source);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::vector<OpKernel*> session_kernels_;
-  std::unique_ptr<GraphViewer> graph_viewer_;
+  // false if the kernels are shared from another SessionState
+  bool owns_kernels_ = true;
+  std::vector<uint32_t> profiler_node_ids_;
+  std::shared_ptr<GraphViewer> graph_viewer_;
 
   std::reference_wrapper<const ExecutionProviders> execution_providers_;  // owned by InferenceSession
   OrtValueNameIdxMap ort_value_name_idx_map_;
@@ -237,7 +255,7 @@ class SessionState {
   // munmap memory region and close file descriptor
   std::unordered_map<int, OrtCallback> deleter_for_initialized_tensors_;
   std::vector<BufferUniquePtr> weights_buffers_;
-  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
+  std::shared_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
 
   const logging::Logger* logger_ = nullptr;
   profiling::Profiler* profiler_ = nullptr;
@@ -266,7 +284,7 @@ class SessionState {
   FuncManager fused_funcs_mgr_;
   const DataTransferManager* data_transfer_mgr_ = nullptr;
 
-  std::unique_ptr<NodeIndexInfo> node_index_info_;
+  std::shared_ptr<NodeIndexInfo> node_index_info_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
 };
 
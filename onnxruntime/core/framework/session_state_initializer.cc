@@ -4,8 +4,10 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/session_state_initializer.h"
 
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -20,6 +22,7 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -32,9 +35,12 @@ template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                              const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                             const SequentialExecutionPlan& exec_plan,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             const std::unordered_map<std::string, const OrtValue*>* user_initializers,
+                                             bool share_by_content);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -55,6 +61,12 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
       logger_(session_state.Logger()),
       enable_mem_pattern_(enable_mem_pattern) {}
 
+void SessionStateInitializer::SetInitializerSharing(
+    const std::unordered_map<std::string, const OrtValue*>& user_initializers, bool share_by_content) {
+  user_initializers_ = user_initializers.empty() ? nullptr : &user_initializers;
+  share_initializers_by_content_ = share_by_content;
+}
+
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
     const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
@@ -93,11 +105,11 @@ common::Status SessionStateInitializer::CreatePlan(
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
+      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, *exec_plan_ptr, tensor_allocator_.get(),
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), user_initializers_, share_initializers_by_content_));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
@@ -168,12 +180,77 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+// Whether the initializer can come from the SharedInitializerStore. Initializers with external data are
+// memory-mapped from the file, so the OS already shares their pages between sessions.
+static bool CanShareByContent(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtMemoryInfo& location) {
+  return strcmp(location.name, CPU) == 0 && location.mem_type == OrtMemTypeDefault &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         tensor_proto.data_location() != ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL;
+}
+
+static void ReleaseSharedInitializer(void* param) noexcept {
+  delete static_cast<std::shared_ptr<const Tensor>*>(param);
+}
+
+// Deserializes the initializer and replaces it with the copy in the SharedInitializerStore.
+// The deleter holds the reference that keeps the stored copy alive.
+static common::Status GetSharedInitializer(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                           const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                           const OrtMemoryInfo& location, OrtValue& ort_value,
+                                           OrtCallback& deleter) {
+  size_t cpu_tensor_length;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &cpu_tensor_length));
+  std::unique_ptr<char[]> data(new char[cpu_tensor_length]);
+  OrtValue tmp_ort_value;
+  OrtCallback d{nullptr, nullptr};
+  ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto,
+                                                  MemBuffer(data.get(), cpu_tensor_length, location), tmp_ort_value, d));
+  auto shared = SharedInitializerStore::Instance().Share(tmp_ort_value.Get<Tensor>());
+  if (d.f) d.f(d.param);
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(shared->DataType(), shared->Shape(),
+                                                   const_cast<void*>(shared->DataRaw()), location);
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  deleter.f = ReleaseSharedInitializer;
+  deleter.param = new std::shared_ptr<const Tensor>(std::move(shared));
+  return common::Status::OK();
+}
+
+// The user keeps ownership of the value, so it only has to match what the model and the plan expect.
+static common::Status ValidateUserInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtValue& value,
+                                              const OrtMemoryInfo& location) {
+  if (!value.IsTensor()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Shared initializer ", tensor_proto.name(),
+                           " is not a tensor");
+  }
+
+  const auto& tensor = value.Get<Tensor>();
+  std::vector<int64_t> dims(tensor_proto.dims().begin(), tensor_proto.dims().end());
+  if (tensor.DataType() == DataTypeImpl::GetType<std::string>() ||
+      utils::GetTensorProtoType(tensor) != tensor_proto.data_type() || tensor.Shape() != TensorShape(dims)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Shared initializer ", tensor_proto.name(),
+                           " does not match the type or shape of the model's initializer. Expected shape ",
+                           TensorShape(dims), ", got ", tensor.Shape());
+  }
+
+  if (tensor.Location().device != location.device) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Shared initializer ", tensor_proto.name(),
+                           " is on ", tensor.Location().device.ToString(), " but the model needs it on ",
+                           location.device.ToString());
+  }
+
+  return common::Status::OK();
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const Graph& graph, const ExecutionProviders& exec_providers,
-                                      const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
+                                      const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                      const SequentialExecutionPlan& exec_plan, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      const std::unordered_map<std::string, const OrtValue*>* user_initializers,
+                                      bool share_by_content) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
 
@@ -185,7 +262,21 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
+  // initializers supplied by the user or taken from the SharedInitializerStore don't need a weights buffer
+  std::unordered_map<int, const OrtValue*> id_to_user_initializer;
+  std::unordered_set<int> shared_by_content;
   for (const auto& entry : id_to_initialized_tensor) {
+    if (user_initializers != nullptr) {
+      auto user_initializer = user_initializers->find(entry.second->name());
+      if (user_initializer != user_initializers->cend()) {
+        id_to_user_initializer[entry.first] = user_initializer->second;
+        continue;
+      }
+    }
+    if (share_by_content && CanShareByContent(*entry.second, exec_plan.GetLocation(entry.first))) {
+      shared_by_content.insert(entry.first);
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
   }
 
@@ -197,6 +288,26 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     int ort_value_index = entry.first;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
     const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
+    const OrtMemoryInfo& location = exec_plan.GetLocation(ort_value_index);
+
+    auto user_initializer = id_to_user_initializer.find(ort_value_index);
+    if (user_initializer != id_to_user_initializer.cend()) {
+      ORT_RETURN_IF_ERROR(ValidateUserInitializer(tensor_proto, *user_initializer->second, location));
+      deleter.f = nullptr;
+      deleter.param = nullptr;
+      ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, *user_initializer->second, deleter, constant));
+      VLOGS(logger, 1) << "Added user supplied weight with name : " << name << " with index: " << ort_value_index;
+      continue;
+    }
+
+    if (shared_by_content.count(ort_value_index) != 0) {
+      OrtValue ort_value;
+      ORT_RETURN_IF_ERROR(GetSharedInitializer(env, graph_loc, tensor_proto, location, ort_value, deleter));
+      ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+      VLOGS(logger, 1) << "Added shared weight with name : " << name << " with index: " << ort_value_index;
+      continue;
+    }
 
     std::unique_ptr<MemBuffer> m;
     // TODO: if the tensor need be copied, does it have enough room?
@@ -213,7 +324,6 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
       return Status(st.Category(), st.Code(), oss.str());
     }
 
-    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
     ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
 
     VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
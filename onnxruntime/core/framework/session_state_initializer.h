@@ -3,9 +3,12 @@
 
 #pragma once
 #include <map>
+#include <string>
+#include <unordered_map>
 
 #include "core/common/const_pointer_container.h"
 #include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
 #include "core/framework/path_lib.h"
 #include "core/framework/tensor_allocator.h"
@@ -41,6 +44,14 @@ class SessionStateInitializer {
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
                             bool enable_sequential_execution);
 
+  /**
+   * Use the user supplied values for the initializers named in user_initializers instead of copies of the
+   * model's, and if share_by_content is true get the other CPU initializers from the SharedInitializerStore.
+   * Must be called before CreatePlan.
+   */
+  void SetInitializerSharing(const std::unordered_map<std::string, const OrtValue*>& user_initializers,
+                             bool share_by_content);
+
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
   onnxruntime::Graph& graph_;
@@ -50,5 +61,7 @@ class SessionStateInitializer {
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  const std::unordered_map<std::string, const OrtValue*>* user_initializers_ = nullptr;
+  bool share_initializers_by_content_ = false;
 };
 }  // namespace onnxruntime
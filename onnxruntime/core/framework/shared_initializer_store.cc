@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <cstring>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+// FNV-1a over 64-bit words. Collisions are resolved by comparing the data, so this only needs to be fast.
+static uint64_t HashTensor(const Tensor& tensor) {
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= kPrime;
+  };
+
+  mix(reinterpret_cast<uintptr_t>(tensor.DataType()));
+  for (auto dim : tensor.Shape().GetDims()) {
+    mix(static_cast<uint64_t>(dim));
+  }
+
+  const auto* data = static_cast<const unsigned char*>(tensor.DataRaw());
+  size_t size = tensor.SizeInBytes();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    mix(word);
+  }
+  for (; i < size; ++i) {
+    mix(data[i]);
+  }
+
+  return hash;
+}
+
+static bool IsSameTensor(const Tensor& lhs, const Tensor& rhs) {
+  return lhs.DataType() == rhs.DataType() && lhs.Shape() == rhs.Shape() &&
+         memcmp(lhs.DataRaw(), rhs.DataRaw(), lhs.SizeInBytes()) == 0;
+}
+
+SharedInitializerStore::SharedInitializerStore() : allocator_(std::make_shared<CPUAllocator>()) {}
+
+SharedInitializerStore& SharedInitializerStore::Instance() {
+  // Never destroyed, so sessions that outlive static destruction can still release their initializers
+  static auto* store = new SharedInitializerStore();
+  return *store;
+}
+
+std::shared_ptr<const Tensor> SharedInitializerStore::Share(const Tensor& tensor) {
+  ORT_ENFORCE(tensor.DataType() != DataTypeImpl::GetType<std::string>(), "String initializers can not be shared");
+
+  uint64_t hash = HashTensor(tensor);
+  // Entries with a colliding hash are held until the lock is released. Another thread may drop its
+  // reference while one is checked, and the deleter of the last reference takes the lock to remove it.
+  std::vector<std::shared_ptr<const Tensor>> collisions;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = tensors_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    // An expired entry is being released by its deleter, which is waiting for the lock to remove it
+    auto stored = it->second.lock();
+    if (stored == nullptr) {
+      continue;
+    }
+    if (IsSameTensor(*stored, tensor)) {
+      return stored;
+    }
+    collisions.push_back(std::move(stored));
+  }
+
+  auto* copy = new Tensor(tensor.DataType(), tensor.Shape(), allocator_);
+  memcpy(copy->MutableDataRaw(), tensor.DataRaw(), tensor.SizeInBytes());
+  std::shared_ptr<const Tensor> stored(copy, [this, hash](const Tensor* p) {
+    Remove(hash);
+    delete p;
+  });
+  tensors_.emplace(hash, stored);
+  return stored;
+}
+
+size_t SharedInitializerStore::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tensors_.size();
+}
+
+void SharedInitializerStore::Remove(uint64_t hash) noexcept {
+  // The entry being released has expired. Other expired entries with the same hash are being released too,
+  // and finding nothing to remove is fine for them.
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = tensors_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    if (it->second.expired()) {
+      it = tensors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace onnxruntime
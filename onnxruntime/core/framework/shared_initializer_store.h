@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+/**
+ * Process wide store of CPU initializers that sessions share read-only.
+ * Initializers are keyed by a hash of their element type, shape and bytes, so sessions that load the same
+ * weights reference one copy. An initializer is released when the last session using it is destroyed.
+ */
+class SharedInitializerStore {
+ public:
+  static SharedInitializerStore& Instance();
+
+  /**
+   * Returns the stored initializer with the same element type, shape and data as tensor, copying tensor
+   * into the store if there is none. String tensors are not supported.
+   */
+  std::shared_ptr<const Tensor> Share(const Tensor& tensor);
+
+  // Number of distinct initializers currently stored.
+  size_t Size() const;
+
+ private:
+  SharedInitializerStore();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+  void Remove(uint64_t hash) noexcept;
+
+  mutable std::mutex mutex_;
+  std::unordered_multimap<uint64_t, std::weak_ptr<const Tensor>> tensors_;
+  AllocatorPtr allocator_;
+};
+
+}  // namespace onnxruntime
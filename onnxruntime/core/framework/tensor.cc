@@ -67,12 +67,14 @@ Tensor::Tensor(Tensor&& other) noexcept
       shape_(other.shape_),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
-      byte_offset_(other.byte_offset_) {
+      byte_offset_(other.byte_offset_),
+      strides_(std::move(other.strides_)) {
   other.dtype_ = DataTypeImpl::GetType<float>();
   other.shape_ = TensorShape(vector<int64_t>(1, 0));
   other.p_data_ = nullptr;
   other.buffer_deleter_ = nullptr;
   other.byte_offset_ = 0;
+  other.strides_.clear();
 }
 
 Tensor& Tensor::operator=(Tensor&& other) noexcept {
@@ -83,6 +85,7 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     shape_ = other.shape_;
     alloc_info_ = other.alloc_info_;
     byte_offset_ = other.byte_offset_;
+    strides_ = std::move(other.strides_);
     p_data_ = other.p_data_;
     buffer_deleter_ = other.buffer_deleter_;
 
@@ -90,11 +93,50 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     other.shape_ = TensorShape(vector<int64_t>(1, 0));
     other.p_data_ = nullptr;
     other.byte_offset_ = 0;
+    other.strides_.clear();
     other.buffer_deleter_ = nullptr;
   }
   return *this;
 }
 
+static std::vector<int64_t> ContiguousStrides(const TensorShape& shape) {
+  std::vector<int64_t> strides(shape.NumDimensions());
+  int64_t stride = 1;
+  for (size_t i = strides.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+std::vector<int64_t> Tensor::Strides() const {
+  return strides_.empty() ? ContiguousStrides(shape_) : strides_;
+}
+
+void Tensor::SetShapeAndStrides(const TensorShape& new_shape, const std::vector<int64_t>& new_strides,
+                                int64_t byte_offset) {
+  ORT_ENFORCE(new_shape.NumDimensions() == new_strides.size(),
+              "Number of strides (", new_strides.size(), ") != rank (", new_shape.NumDimensions(), ")");
+  shape_ = new_shape;
+  byte_offset_ = byte_offset;
+
+  // the stride of a dimension with one element is never used, so it does not affect contiguity
+  auto contiguous = ContiguousStrides(new_shape);
+  bool is_contiguous = true;
+  for (size_t i = 0; i < contiguous.size() && new_shape.Size() != 0; ++i) {
+    if (new_shape[i] != 1 && new_strides[i] != contiguous[i]) {
+      is_contiguous = false;
+      break;
+    }
+  }
+
+  if (is_contiguous) {
+    strides_.clear();
+  } else {
+    strides_ = new_strides;
+  }
+}
+
 Tensor::~Tensor() {
   ReleaseBuffer();
 }
@@ -528,6 +528,39 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
   return status;
 }
 
+SubgraphRunner::SubgraphRunner(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                               const bool& terminate_flag, const logging::Logger& logger)
+    : session_state_(session_state),
+      feeds_fetches_manager_(feeds_fetches_manager),
+      terminate_flag_(terminate_flag),
+      logger_(logger) {
+}
+
+SubgraphRunner::~SubgraphRunner() = default;
+
+common::Status SubgraphRunner::Run(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // the frame can only be re-used if the feeds and fetches are passed through to the executor as-is
+  if (feeds_fetches_manager_.GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+    return ExecuteSubgraph(session_state_, feeds_fetches_manager_, feeds, fetches, fetch_allocators,
+                           /*sequential_execution*/ true, terminate_flag_, logger_);
+  }
+
+  const auto& feeds_fetches_info = feeds_fetches_manager_.GetFeedsFetchesInfo();
+  const auto& feed_idxs = feeds_fetches_info.feeds_mlvalue_idxs;
+  const auto& fetch_idxs = feeds_fetches_info.fetches_mlvalue_idxs;
+
+  if (!frame_ || !frame_->Reset(feed_idxs, feeds, fetch_idxs, fetches, fetch_allocators)) {
+    // release the existing frame first so its memory pattern buffers can be re-used by the new one
+    frame_.reset();
+    frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_idxs, feeds, fetch_idxs, fetches, fetch_allocators,
+                                                      session_state_);
+  }
+
+  SequentialExecutor executor(terminate_flag_);
+  return executor.Execute(session_state_, *frame_, feeds, fetches, logger_);
+}
+
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 std::ostream& operator<<(std::ostream& out, const BFloat16& value) {
   return out << value.ToFloat();
@@ -18,6 +18,7 @@ std::ostream& operator<<(std::ostream& out, const TensorProto& tensor_proto);
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {
+class ExecutionFrame;
 class ExecutionProviders;
 struct FeedsFetchesInfo;
 class FeedsFetchesManager;
@@ -76,6 +77,32 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
 
+/**
+Executes a subgraph repeatedly, as the Loop and Scan kernels do for each iteration.
+The ExecutionFrame is kept between executions so the per-execution setup (creating the value array, adding
+the initializers, looking up the memory pattern and allocating its buffers) is only repeated when the feed shapes
+change. Create one instance per Compute call of the control flow node.
+*/
+class SubgraphRunner {
+ public:
+  SubgraphRunner(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                 const bool& terminate_flag, const logging::Logger& logger);
+  ~SubgraphRunner();
+
+  // Execute the subgraph. Arguments match ExecuteSubgraph with sequential execution.
+  common::Status Run(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                     const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SubgraphRunner);
+
+  const SessionState& session_state_;
+  const FeedsFetchesManager& feeds_fetches_manager_;
+  const bool& terminate_flag_;
+  const logging::Logger& logger_;
+  std::unique_ptr<ExecutionFrame> frame_;
+};
+
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 // to create a build with these enabled run the build script with
 //   --cmake_extra_defines onnxruntime_DEBUG_NODE_INPUTS_OUTPUTS=ON
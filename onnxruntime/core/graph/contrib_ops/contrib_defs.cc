@@ -200,10 +200,11 @@ void RegisterBertSchemas() {
       .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
       .SetDoc("Multi-Head Self Attention")
       .Attr("num_heads", "Number of attention heads", AttributeProto::INT)
+      .Attr("mask_filter_value", "The value added to the attention scores of masked positions, as (1 - mask) * mask_filter_value. Sequences without any attended position add it to all their scores.", AttributeProto::FLOAT, -10000.0f)
       .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size", "T")
       .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
       .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
-      .Input(3, "mask_index", "Attention mask index with shape (batch_size)", "M")
+      .Input(3, "mask_index", "Attention mask index with shape (batch_size): only the first mask_index[b] positions of sequence b are attended to. Or a mask with shape (batch_size, sequence_length) that is 1 for the positions to attend to and 0 for the others. All positions are attended to if it is not given.", "M", OpSchema::Optional)
       .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
       .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index to integer types")
@@ -1812,6 +1813,194 @@ Example 4:
           "Constrain input and output types to float tensors.")
       .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
 
+  static const char* EmbeddingBag_ver1_doc = R"DOC(
+Looks up bags of rows of an embedding table and reduces each bag to a single row, which is the same as a Gather
+of the rows followed by a ReduceSum, ReduceMean or ReduceMax of each bag, without the gathered rows in between.
+
+If offsets is given, indices is 1-D and bag i is indices[offsets[i]:offsets[i + 1]], with the last bag ending at
+the end of indices. Otherwise indices is 2-D and each row of it is a bag. Negative indices count from the end of
+the table, and an empty bag produces a row of zeros.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(EmbeddingBag_ver1_doc)
+      .Attr("mode", "How the rows of a bag are reduced: 'sum', 'mean' or 'max'.", AttributeProto::STRING,
+            std::string("sum"))
+      .Input(0, "weight", "Embedding table of shape (num_embeddings, embedding_dim).", "T")
+      .Input(1, "indices", "Rows of the table to look up, 1-D if offsets is given and 2-D otherwise.", "Tind")
+      .Input(2, "offsets", "1-D start of each bag in indices, in non-decreasing order.", "Tind",
+             OpSchema::Optional)
+      .Output(0, "output", "Reduced bags of shape (num_bags, embedding_dim).", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the table and output to float tensors.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 2)) {
+          return;
+        }
+
+        const auto& weight_shape = ctx.getInputType(0)->tensor_type().shape();
+        const auto& indices_shape = ctx.getInputType(1)->tensor_type().shape();
+        const bool has_offsets = ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr;
+        if (weight_shape.dim_size() != 2) {
+          fail_shape_inference("weight must be 2-D");
+        }
+        if (indices_shape.dim_size() != (has_offsets ? 1 : 2)) {
+          fail_shape_inference("indices must be 1-D with offsets and 2-D without");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        if (!has_offsets) {
+          *output_shape.add_dim() = indices_shape.dim(0);
+        } else if (hasInputShape(ctx, 2)) {
+          *output_shape.add_dim() = ctx.getInputType(2)->tensor_type().shape().dim(0);
+        } else {
+          output_shape.add_dim();
+        }
+        *output_shape.add_dim() = weight_shape.dim(1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  static const char* SparseMatMul_ver1_doc = R"DOC(
+Matrix product Y = A * B + bias of a dense input A with a sparse constant weight B, like MatMul with a 2-D B.
+A has shape (..., K) and Y has shape (..., N).
+
+B (K, N) is stored transposed, as the rows of W = B^T (N, K) in compressed sparse row format with blocks of
+block_size consecutive elements of a row: the blocks of row n of W are [row_ptr[n], row_ptr[n + 1]), block j
+holds W[n, col_indices[j] * block_size : (col_indices[j] + 1) * block_size] in values[j], and all other elements
+are zero. With a block_size of 1 this is the plain CSR format.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(SparseMatMul_ver1_doc)
+      .Attr("dense_shape", "Shape (K, N) of the dense weight B.", AttributeProto::INTS)
+      .Attr("block_size", "Number of consecutive elements of a row of W in each block. K must be a multiple of it.",
+            AttributeProto::INT, static_cast<int64_t>(1))
+      .Input(0, "A", "Dense input of shape (..., K).", "T")
+      .Input(1, "values", "Nonzero blocks of W, of shape (num_blocks, block_size).", "T")
+      .Input(2, "col_indices", "1-D column of each block of W in units of block_size, of shape (num_blocks).",
+             "tensor(int32)")
+      .Input(3, "row_ptr", "1-D start of the blocks of each row of W, of shape (N + 1).", "tensor(int32)")
+      .Input(4, "bias", "1-D bias of shape (N) added to each row of Y.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Dense output of shape (..., N).", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        std::vector<int64_t> dense_shape;
+        if (!getRepeatedAttribute(ctx, "dense_shape", dense_shape) || dense_shape.size() != 2) {
+          fail_shape_inference("dense_shape must have 2 elements");
+        }
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        const auto& a_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (a_shape.dim_size() < 1) {
+          fail_shape_inference("A must have at least 1 dimension");
+        }
+        const auto& k_dim = a_shape.dim(a_shape.dim_size() - 1);
+        if (k_dim.has_dim_value() && k_dim.dim_value() != dense_shape[0]) {
+          fail_shape_inference("Last dimension of A doesn't match the first dimension of dense_shape");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < a_shape.dim_size() - 1; ++i) {
+          *output_shape.add_dim() = a_shape.dim(i);
+        }
+        output_shape.add_dim()->set_dim_value(dense_shape[1]);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  static const char* CompressedMatMul_ver1_doc = R"DOC(
+Matrix product Y = alpha * A * op(B) + bias of a float input A with a constant weight B stored in reduced precision,
+like MatMul with a 2-D B. op(B) is B, or B transposed if transB is set, and has shape (K, N). A has shape (..., K)
+and Y has shape (..., N).
+
+B is converted to float a panel at a time as it is packed for the matrix multiply, so no float copy of it is kept.
+int8 elements of B are multiplied by the scale of their column of op(B).
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(CompressedMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(CompressedMatMul_ver1_doc)
+      .Attr("transB", "Whether B should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("alpha", "Scalar multiplier for the product of A and op(B).", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "A", "Input of shape (..., K).", "T")
+      .Input(1, "B", "2-D weight of shape (K, N), or (N, K) if transB is set.", "T2")
+      .Input(2, "scales", "1-D scale of each column of op(B), of shape (N). Required for an int8 B.",
+             "tensor(float)", OpSchema::Optional)
+      .Input(3, "bias", "1-D bias of shape (N) added to each row of Y.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output of shape (..., N).", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T2", {"tensor(float16)", "tensor(bfloat16)", "tensor(int8)"},
+                      "Constrain the weight to reduced precision tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 2)) {
+          return;
+        }
+
+        const auto& a_shape = ctx.getInputType(0)->tensor_type().shape();
+        const auto& b_shape = ctx.getInputType(1)->tensor_type().shape();
+        if (a_shape.dim_size() < 1) {
+          fail_shape_inference("A must have at least 1 dimension");
+        }
+        if (b_shape.dim_size() != 2) {
+          fail_shape_inference("B must be 2-D");
+        }
+
+        const bool trans_b = getAttribute(ctx, "transB", 0) != 0;
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < a_shape.dim_size() - 1; ++i) {
+          *output_shape.add_dim() = a_shape.dim(i);
+        }
+        *output_shape.add_dim() = b_shape.dim(trans_b ? 0 : 1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  static const char* FusedElementwise_ver1_doc = R"DOC(
+Computes a chain of float elementwise ops in a single pass over the output, reading each input and writing the
+output once. The chain is a program in which instruction i applies ops[i] to the values operands[2 * i] and
+operands[2 * i + 1]. Values 0 to N - 1 are the N inputs and value N + j is the result of instruction j, which may
+only use earlier values. The second operand of a unary op is -1. Y is the result of the last instruction.
+
+The supported ops are Add, Sub, Mul, Div, Max, Min, Neg, Abs, Relu, LeakyRelu, Sigmoid, Tanh, Exp, Log, Sqrt,
+Reciprocal and Erf, and the alpha of LeakyRelu is alphas[i]. Each input must have the shape of Y, a suffix of it, or
+a single element.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(FusedElementwise_ver1_doc)
+      .Attr("ops", "Op type of each instruction.", AttributeProto::STRINGS)
+      .Attr("operands", "Indices of the two values used by each instruction.", AttributeProto::INTS)
+      .Attr("alphas", "Alpha of each instruction, used by LeakyRelu.", AttributeProto::FLOATS, OPTIONAL)
+      .Input(0, "inputs", "Inputs of the chain.", "T", OpSchema::Variadic)
+      .Output(0, "Y", "Output of the chain, of the broadcast shape of the inputs.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        const auto num_inputs = static_cast<int>(ctx.getNumInputs());
+        if (!hasNInputShapes(ctx, num_inputs)) {
+          return;
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape = ctx.getInputType(0)->tensor_type().shape();
+        for (int i = 1; i < num_inputs; ++i) {
+          ONNX_NAMESPACE::TensorShapeProto broadcast_shape;
+          bidirectionalBroadcastShapeInference(output_shape, ctx.getInputType(i)->tensor_type().shape(),
+                                               broadcast_shape);
+          output_shape = broadcast_shape;
+        }
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
 #ifdef MICROSOFT_INTERNAL
   // register internal ops
   RegisterInternalSchemas();
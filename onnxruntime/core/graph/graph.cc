@@ -248,6 +248,11 @@ void NodeArg::SetType(const TypeProto& type_proto) {
   *(node_arg_info_.mutable_type()) = type_proto;
 }
 
+void NodeArg::ClearType() {
+  type_ = nullptr;
+  node_arg_info_.clear_type();
+}
+
 bool NodeArg::Exists() const noexcept {
   return exists_;
 }
@@ -128,6 +128,45 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Single precision matrix/matrix multiply with matrix B stored in a reduced
+// precision format. Panels of matrix B are converted to single precision as
+// they are packed, so no single precision copy of matrix B is needed.
+//
+// Int8 elements are multiplied by the scale of their column of op(B).
+//
+
+enum MLAS_SGEMM_B_FORMAT {
+    MlasSgemmBFormatFloat16,
+    MlasSgemmBFormatBFloat16,
+    MlasSgemmBFormatInt8,
+};
+
+struct MLAS_SGEMM_COMPRESSED_B {
+    MLAS_SGEMM_B_FORMAT Format;
+    const void* Data;
+    const float* Scales;
+};
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_SGEMM_COMPRESSED_B* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -189,6 +228,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
+    MlasConvAlgorithmWinograd,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -217,6 +258,9 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            const float* PackedFilter;
+        } Winograd;
     } u;
 };
 
@@ -252,6 +296,32 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd filter packing. If MlasConvPrepare selects MlasConvAlgorithmWinograd,
+// the caller may store filters packed by MlasConvWinogradPackFilter in
+// Parameters->u.Winograd.PackedFilter to avoid transforming the filters on
+// every call to MlasConv.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradGetPackedFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Pooling routines.
 //
@@ -306,6 +376,25 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -0,0 +1,766 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements routines to compute the exponential function and
+    the softmax and log softmax functions.
+
+    The exponential uses the same range reduction and polynomial coefficients
+    as the implementation in erf.cpp: exp(x) = 2^n * exp(r), where n is
+    round(x / ln(2)) and r is x - n * ln(2).
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Bundles the floating point constants for the exponential function.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float LowerRange;
+    float UpperRange;
+    float LowerRangeSumExp;
+    float Log2Reciprocal;
+    float log2_hi;
+    float log2_lo;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_56;
+    float RoundingBias;
+} MlasExpConstants = {
+    -87.3365402f,
+    88.7228394f,
+    -88.3762626647949f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.38319808e-3f,
+    8.37550033e-3f,
+    4.16689515e-2f,
+    1.66664466e-1f,
+    4.99999851e-1f,
+    1.00000000e+0f,
+    1.25829120e+7f,
+};
+
+//
+// Define the number of elements to process per thread when threading the
+// softmax operation over rows.
+//
+
+#define MLAS_SOFTMAX_ELEMENTS_PER_THREAD            16384
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpExponentVector(
+    MLAS_FLOAT32X4 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the integral exponent n = round(Value / ln(2)) used
+    to reduce the range of the exponential function.
+
+Arguments:
+
+    Value - Supplies the clamped input values.
+
+Return Value:
+
+    Returns the exponents as integral floating point values.
+
+--*/
+{
+    const MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+
+    MLAS_FLOAT32X4 n = MlasMultiplyAddFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal),
+        Value, RoundingBias);
+
+    return MlasSubtractFloat32x4(n, RoundingBias);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpPolynomialVector(
+    MLAS_FLOAT32X4 Value,
+    MLAS_FLOAT32X4 n
+    )
+/*++
+
+Routine Description:
+
+    This routine computes exp(Value - n * ln(2)) for a vector of values, so
+    that exp(Value) is the result scaled by 2^n.
+
+Arguments:
+
+    Value - Supplies the clamped input values.
+
+    n - Supplies the exponents from MlasComputeExpExponentVector.
+
+Return Value:
+
+    Returns the exponential of the reduced input values.
+
+--*/
+{
+    MLAS_FLOAT32X4 r = MlasMultiplyAddFloat32x4(n, MlasBroadcastFloat32x4(MlasExpConstants.log2_hi), Value);
+    r = MlasMultiplyAddFloat32x4(n, MlasBroadcastFloat32x4(MlasExpConstants.log2_lo), r);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasExpConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+
+    return p;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of values
+    already clamped to [LowerRangeSumExp, 0].
+
+Arguments:
+
+    Value - Supplies the clamped input values.
+
+Return Value:
+
+    Returns the exponential of the input values.
+
+--*/
+{
+    MLAS_FLOAT32X4 n = MlasComputeExpExponentVector(Value);
+
+    return MlasMultiplyFloat32x4(MlasComputeExpPolynomialVector(Value, n), MlasPowerOf2Float32x4(n));
+}
+
+MLAS_FORCEINLINE
+float
+MlasComputeExpScalar(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a single value already
+    clamped to [LowerRange, UpperRange].
+
+Arguments:
+
+    Value - Supplies the clamped input value.
+
+Return Value:
+
+    Returns the exponential of the input value.
+
+--*/
+{
+    float n = MlasExpConstants.Log2Reciprocal * Value + MlasExpConstants.RoundingBias;
+    n -= MlasExpConstants.RoundingBias;
+
+    float r = n * MlasExpConstants.log2_hi + Value;
+    r = n * MlasExpConstants.log2_lo + r;
+
+    float p = MlasExpConstants.poly_0;
+    p = p * r + MlasExpConstants.poly_1;
+    p = p * r + MlasExpConstants.poly_2;
+    p = p * r + MlasExpConstants.poly_3;
+    p = p * r + MlasExpConstants.poly_4;
+    p = p * r + MlasExpConstants.poly_56;
+    p = p * r + MlasExpConstants.poly_56;
+
+    return ldexpf(p, int(n));
+}
+
+void
+MLASCALL
+MlasExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+    Inputs below the lower range flush to zero, inputs above the upper range
+    overflow to infinity and NaNs propagate to the output.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 LowerRange = MlasBroadcastFloat32x4(MlasExpConstants.LowerRange);
+    const MLAS_FLOAT32X4 UpperRange = MlasBroadcastFloat32x4(MlasExpConstants.UpperRange);
+    const MLAS_FLOAT32X4 MaximumExponent = MlasBroadcastFloat32x4(127.0f);
+    const MLAS_FLOAT32X4 Infinity = MlasBroadcastFloat32x4(std::numeric_limits<float>::infinity());
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Input);
+
+        MLAS_FLOAT32X4 UnderflowMask = MlasGreaterThanFloat32x4(LowerRange, Value);
+        MLAS_FLOAT32X4 OverflowMask = MlasGreaterThanFloat32x4(Value, UpperRange);
+
+        //
+        // The clamping keeps NaNs, which then propagate through the
+        // polynomial.
+        //
+
+        Value = MlasMaximumFloat32x4(LowerRange, Value);
+        Value = MlasMinimumFloat32x4(UpperRange, Value);
+
+        //
+        // Inputs just below the overflow threshold round to n = 128, which is
+        // out of range for a single float power of 2, so scale in two steps.
+        //
+
+        MLAS_FLOAT32X4 n = MlasComputeExpExponentVector(Value);
+        MLAS_FLOAT32X4 n0 = MlasMinimumFloat32x4(MaximumExponent, n);
+
+        MLAS_FLOAT32X4 Result = MlasComputeExpPolynomialVector(Value, n);
+        Result = MlasMultiplyFloat32x4(Result, MlasPowerOf2Float32x4(n0));
+        Result = MlasMultiplyFloat32x4(Result, MlasPowerOf2Float32x4(MlasSubtractFloat32x4(n, n0)));
+
+        Result = MlasOrFloat32x4(MlasAndNotFloat32x4(OverflowMask, Result), MlasAndFloat32x4(OverflowMask, Infinity));
+
+        MlasStoreFloat32x4(Output, MlasAndNotFloat32x4(UnderflowMask, Result));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        float Value = *Input++;
+
+        if (Value < MlasExpConstants.LowerRange) {
+            *Output++ = 0.0f;
+        } else if (Value <= MlasExpConstants.UpperRange) {
+            *Output++ = MlasComputeExpScalar(Value);
+        } else {
+            // Overflows to infinity or propagates a NaN.
+            *Output++ = Value * std::numeric_limits<float>::infinity();
+        }
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasExpKernel(Input, Output, N);
+}
+
+float
+MlasReduceMaximumKernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum value of the input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector0 = MlasBroadcastFloat32x4(Maximum);
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 MaximumVector1 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector2 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector3 = MaximumVector0;
+
+            while (N >= 16) {
+
+                MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+                MaximumVector1 = MlasMaximumFloat32x4(MaximumVector1, MlasLoadFloat32x4(Input + 4));
+                MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MlasLoadFloat32x4(Input + 8));
+                MaximumVector3 = MlasMaximumFloat32x4(MaximumVector3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector1);
+            MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MaximumVector3);
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector2);
+        }
+
+        while (N >= 4) {
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Maximum = (std::max)((std::max)(MlasExtractLaneFloat32x4<0>(MaximumVector0),
+            MlasExtractLaneFloat32x4<1>(MaximumVector0)),
+            (std::max)(MlasExtractLaneFloat32x4<2>(MaximumVector0),
+            MlasExtractLaneFloat32x4<3>(MaximumVector0)));
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+float
+MlasComputeSumExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential of the input buffer shifted by the
+    negative maximum and returns the sum of the exponentials. The shifted
+    inputs are at most zero, so only the lower range needs to be clamped.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer to receive the
+        exponentials, else nullptr if only the sum is required.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the negated maximum value of the input buffer.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    const MLAS_FLOAT32X4 LowerRange = MlasBroadcastFloat32x4(MlasExpConstants.LowerRangeSumExp);
+    const MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+
+    MLAS_FLOAT32X4 AccumulatorVector = MlasZeroFloat32x4();
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Value = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+        Value = MlasMaximumFloat32x4(LowerRange, Value);
+
+        Value = MlasComputeExpVector(Value);
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Value);
+            Output += 4;
+        }
+
+        AccumulatorVector = MlasAddFloat32x4(AccumulatorVector, Value);
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float Accumulator = MlasExtractLaneFloat32x4<0>(AccumulatorVector) +
+        MlasExtractLaneFloat32x4<1>(AccumulatorVector) +
+        MlasExtractLaneFloat32x4<2>(AccumulatorVector) +
+        MlasExtractLaneFloat32x4<3>(AccumulatorVector);
+
+    while (N > 0) {
+
+        float Value = *Input + NegativeMaximum;
+
+        //
+        // Propagate NaNs as the vector path does instead of clamping them.
+        //
+
+        if (Value < MlasExpConstants.LowerRangeSumExp) {
+            Value = 0.0f;
+        } else if (Value == Value) {
+            Value = MlasComputeExpScalar(Value);
+        }
+
+        if (Output != nullptr) {
+            *Output++ = Value;
+        }
+
+        Accumulator += Value;
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+void
+MlasComputeSoftmaxOutputKernel(
+    float* Output,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the exponentials in the output buffer by the
+    reciprocal of their sum.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output), ScaleVector));
+
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ *= Scale;
+
+        N -= 1;
+    }
+}
+
+void
+MlasComputeLogSoftmaxOutputKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float NegativeMaximum,
+    float NegativeLogarithm
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the log softmax output by shifting the input buffer
+    by the maximum value and the logarithm of the sum of the exponentials.
+
+    The shifts are applied separately so that the precision of the shifted
+    input is not lost when the maximum is large relative to the logarithm.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the negated maximum value of the input buffer.
+
+    NegativeLogarithm - Supplies the negated logarithm of the sum of the
+        exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    const MLAS_FLOAT32X4 NegativeLogarithmVector = MlasBroadcastFloat32x4(NegativeLogarithm);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Value = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+
+        MlasStoreFloat32x4(Output, MlasAddFloat32x4(Value, NegativeLogarithmVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = (*Input++ + NegativeMaximum) + NegativeLogarithm;
+
+        N -= 1;
+    }
+}
+
+//
+// Define the parameters to execute segments of a softmax operation on worker
+// threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    int32_t ThreadCountN;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Compute the range of rows to use for this thread.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    const size_t RowsPerThread = N / WorkBlock->ThreadCountN;
+    const size_t RowsExtra = N % WorkBlock->ThreadCountN;
+
+    size_t RowStart;
+    size_t RowCount;
+
+    if (uint32_t(Index) < RowsExtra) {
+        RowStart = (RowsPerThread + 1) * Index;
+        RowCount = RowsPerThread + 1;
+    } else {
+        RowStart = RowsPerThread * Index + RowsExtra;
+        RowCount = RowsPerThread;
+    }
+
+    const float* Input = WorkBlock->Input + RowStart * D;
+    float* Output = WorkBlock->Output + RowStart * D;
+
+    while (RowCount > 0) {
+
+        const float Maximum = MlasReduceMaximumKernel(Input, D);
+
+        if (WorkBlock->LogSoftmax) {
+
+            //
+            // Only the sum of the exponentials is needed; the output is the
+            // shifted input.
+            //
+
+            const float Accumulation = MlasComputeSumExpKernel(Input, nullptr, D, -Maximum);
+
+            MlasComputeLogSoftmaxOutputKernel(Input, Output, D, -Maximum, -std::log(Accumulation));
+
+        } else {
+
+            //
+            // Store the exponentials to the output buffer while computing
+            // their sum and then normalize the output in place.
+            //
+
+            const float Accumulation = MlasComputeSumExpKernel(Input, Output, D, -Maximum);
+
+            MlasComputeSoftmaxOutputKernel(Output, D, 1.0f / Accumulation);
+        }
+
+        Input += D;
+        Output += D;
+        RowCount--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function over each of the
+    rows of the input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed,
+        else false if the softmax function should be computed.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_ELEMENTS_PER_THREAD * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_ELEMENTS_PER_THREAD)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock.ThreadCountN = 1;
+        MlasComputeSoftmaxThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    WorkBlock.ThreadCountN = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
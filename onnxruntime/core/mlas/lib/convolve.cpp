@@ -736,6 +736,336 @@ Return Value:
     }
 }
 
+template<size_t KernelSize>
+MLAS_FORCEINLINE
+float
+MlasConvDepthwiseBorder(
+    const float* InputRow,
+    const float* FilterRow,
+    ptrdiff_t InputColumn,
+    size_t InputWidth
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the dot product of one filter row with one input row
+    for an output column where the kernel extends past the edge of the input
+    row. Padding elements are implicitly zero.
+
+Arguments:
+
+    InputRow - Supplies the input row.
+
+    FilterRow - Supplies the filter row.
+
+    InputColumn - Supplies the (possibly negative) input column that aligns
+        with the first filter element.
+
+    InputWidth - Supplies the number of columns of the input row.
+
+Return Value:
+
+    Returns the partial sum.
+
+--*/
+{
+    float Accumulator = 0.0f;
+
+    for (size_t kw = 0; kw < KernelSize; kw++) {
+
+        ptrdiff_t iw = InputColumn + ptrdiff_t(kw);
+
+        if (iw >= 0 && size_t(iw) < InputWidth) {
+            Accumulator += InputRow[iw] * FilterRow[kw];
+        }
+    }
+
+    return Accumulator;
+}
+
+template<size_t KernelSize, size_t Stride>
+void
+MlasConvDepthwiseFloatPlane(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional depthwise convolution for a
+    single channel plane with a square kernel and no dilation.
+
+    The output columns are split into the left border, interior and right
+    border ranges. Interior columns read the input rows directly without
+    bounds checks; for unit stride, the interior is vectorized over four
+    output columns at a time.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input plane.
+
+    Filter - Supplies the KernelSize x KernelSize filter.
+
+    Output - Supplies the output plane.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    //
+    // Compute the range of output columns where the kernel lies entirely
+    // within the input row.
+    //
+
+    size_t OutputWidthStart = (PaddingLeft + Stride - 1) / Stride;
+    size_t OutputWidthEnd = 0;
+
+    if (InputWidth + PaddingLeft >= KernelSize) {
+        OutputWidthEnd = (InputWidth + PaddingLeft - KernelSize) / Stride + 1;
+    }
+
+    OutputWidthStart = std::min(OutputWidthStart, OutputWidth);
+    OutputWidthEnd = std::max(std::min(OutputWidthEnd, OutputWidth), OutputWidthStart);
+
+    //
+    // Broadcast the filter elements once for the vectorized interior.
+    //
+
+    MLAS_FLOAT32X4 FilterVector[KernelSize * KernelSize];
+
+    if (Stride == 1) {
+        for (size_t k = 0; k < KernelSize * KernelSize; k++) {
+            FilterVector[k] = MlasBroadcastFloat32x4(Filter[k]);
+        }
+    }
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        //
+        // Gather the input rows that are covered by the kernel for this
+        // output row. Rows that fall in the padding region are skipped.
+        //
+
+        const float* InputRows[KernelSize];
+        size_t FilterRows[KernelSize];
+        size_t RowCount = 0;
+
+        for (size_t kh = 0; kh < KernelSize; kh++) {
+
+            ptrdiff_t ih = ptrdiff_t(oh * Stride + kh) - ptrdiff_t(PaddingTop);
+
+            if (ih >= 0 && size_t(ih) < InputHeight) {
+                InputRows[RowCount] = Input + size_t(ih) * InputWidth;
+                FilterRows[RowCount] = kh;
+                RowCount++;
+            }
+        }
+
+        float* output = Output + oh * OutputWidth;
+
+        //
+        // Process the left border.
+        //
+
+        size_t ow = 0;
+
+        for (; ow < OutputWidthStart; ow++) {
+
+            ptrdiff_t iw = ptrdiff_t(ow * Stride) - ptrdiff_t(PaddingLeft);
+            float Accumulator = 0.0f;
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulator += MlasConvDepthwiseBorder<KernelSize>(InputRows[r],
+                    Filter + FilterRows[r] * KernelSize, iw, InputWidth);
+            }
+
+            output[ow] = Accumulator;
+        }
+
+        //
+        // Process the interior.
+        //
+
+        if (Stride == 1) {
+
+            for (; ow + 4 <= OutputWidthEnd; ow += 4) {
+
+                const size_t iw = ow - PaddingLeft;
+                MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+                for (size_t r = 0; r < RowCount; r++) {
+
+                    const float* row = InputRows[r] + iw;
+                    const MLAS_FLOAT32X4* filter = &FilterVector[FilterRows[r] * KernelSize];
+
+                    for (size_t kw = 0; kw < KernelSize; kw++) {
+                        Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(row + kw),
+                            filter[kw], Accumulator);
+                    }
+                }
+
+                MlasStoreFloat32x4(output + ow, Accumulator);
+            }
+        }
+
+        for (; ow < OutputWidthEnd; ow++) {
+
+            const size_t iw = ow * Stride - PaddingLeft;
+            float Accumulator = 0.0f;
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                const float* row = InputRows[r] + iw;
+                const float* filter = Filter + FilterRows[r] * KernelSize;
+
+                for (size_t kw = 0; kw < KernelSize; kw++) {
+                    Accumulator += row[kw] * filter[kw];
+                }
+            }
+
+            output[ow] = Accumulator;
+        }
+
+        //
+        // Process the right border.
+        //
+
+        for (; ow < OutputWidth; ow++) {
+
+            ptrdiff_t iw = ptrdiff_t(ow * Stride) - ptrdiff_t(PaddingLeft);
+            float Accumulator = 0.0f;
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulator += MlasConvDepthwiseBorder<KernelSize>(InputRows[r],
+                    Filter + FilterRows[r] * KernelSize, iw, InputWidth);
+            }
+
+            output[ow] = Accumulator;
+        }
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of indices to use for this thread.
+    //
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
+    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupEnd;
+
+    if (uint32_t(Index) < BatchGroupCountExtra) {
+        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
+    } else {
+        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
+    }
+
+    //
+    // Select the plane kernel for the kernel size and stride.
+    //
+
+    void (*PlaneKernel)(const MLAS_CONV_PARAMETERS*, const float*, const float*, float*);
+
+    const bool StrideIsOne = (Parameters->StrideShape[0] == 1);
+
+    if (Parameters->KernelShape[0] == 3) {
+        PlaneKernel = StrideIsOne ? MlasConvDepthwiseFloatPlane<3, 1> : MlasConvDepthwiseFloatPlane<3, 2>;
+    } else {
+        PlaneKernel = StrideIsOne ? MlasConvDepthwiseFloatPlane<5, 1> : MlasConvDepthwiseFloatPlane<5, 2>;
+    }
+
+    //
+    // Iterate over the batch and groups allocated to this thread.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputGroupSize;
+        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            PlaneKernel(Parameters, input, filter + f * K, output + f * OutputSize);
+        }
+
+        //
+        // Apply the activation with optional bias while the output planes
+        // are still cache resident.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, FilterCount,
+            OutputSize, OutputSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -882,10 +1212,12 @@ Return Value:
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
     //
-    // Schedule batches of GEMMs across multiple threads.
+    // Schedule batches of GEMMs or depthwise channel planes across multiple
+    // threads.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    if ((Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) ||
+        Algorithm == MlasConvAlgorithmDepthwise) {
 
         const size_t BatchGroupCount = BatchCount * GroupCount;
 
@@ -905,7 +1237,10 @@ Return Value:
         WorkBlock.Output = Output;
         WorkBlock.TargetThreadCount = TargetThreadCount;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+        PMLAS_THREADED_ROUTINE ThreadedRoutine = (Algorithm == MlasConvAlgorithmDepthwise) ?
+            MlasConvDepthwiseThreaded : MlasConvGemmDirectThreaded;
+
+        MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, TargetThreadCount, ThreadPool);
 
         return;
     }
@@ -988,6 +1323,36 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Transform the filters (unless prepacked) and the input
+                    // tiles to the working buffer and compute the threaded
+                    // Winograd stages.
+                    //
+
+                    const float* PackedFilter = Parameters->u.Winograd.PackedFilter;
+
+                    if (PackedFilter != nullptr) {
+                        PackedFilter += group * MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount *
+                            Parameters->InputChannels;
+                    }
+
+                    MlasConvWinograd(Parameters, Input, filter, PackedFilter, bias,
+                        WorkingBuffer, Output, ThreadPool);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Depthwise convolutions are always scheduled above.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1123,6 +1488,46 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    if (Dimensions == 2 && GroupCount > 1 && InputChannels == 1 && AllDilationsAreOne) {
+
+        //
+        // Detect a depthwise convolution with a 3x3 or 5x5 kernel and a stride
+        // of 1 or 2. Each channel plane is convolved directly without
+        // expanding the input.
+        //
+
+        const size_t KernelSize = Parameters->KernelShape[0];
+        const size_t Stride = Parameters->StrideShape[0];
+
+        if ((KernelSize == 3 || KernelSize == 5) && Parameters->KernelShape[1] == KernelSize &&
+            (Stride == 1 || Stride == 2) && Parameters->StrideShape[1] == Stride) {
+
+            Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+            return;
+        }
+    }
+
+    if (Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        Parameters->OutputShape[0] >= 8 && Parameters->OutputShape[1] >= 8) {
+
+        //
+        // Detect a 3x3 unit stride convolution with enough channels for the
+        // Winograd transforms to be amortized by the reduction in
+        // multiplications.
+        //
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.PackedFilter = nullptr;
+
+        *WorkingBufferSize = MlasConvWinogradGetWorkingBufferSize(Parameters);
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -573,7 +573,36 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_COMPRESSED_B* CompressedB = nullptr,
+    size_t OffsetN = 0
+    );
+
+//
+// Winograd convolution support.
+//
+// The number of elements in a transformed 6x6 tile and the minimum number of
+// input and output channels to select the Winograd algorithm.
+//
+
+#define MLAS_WINOGRAD_TILE_ELEMENTS                 36
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         32
+
+size_t
+MlasConvWinogradGetWorkingBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
     );
 
 //
@@ -40,12 +40,14 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const MLAS_SGEMM_COMPRESSED_B* CompressedB;
     struct SEGMENT {
         size_t M;
         size_t N;
         const float* A;
         const float* B;
         float* C;
+        size_t OffsetN;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
@@ -374,6 +376,231 @@ Return Value:
     }
 }
 
+inline
+float
+MlasSgemmHalfToFloat(
+    uint16_t Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision value to single precision.
+
+Arguments:
+
+    Value - Supplies the half precision value.
+
+Return Value:
+
+    Returns the single precision value.
+
+--*/
+{
+    uint32_t Sign = uint32_t(Value & 0x8000) << 16;
+    uint32_t Exponent = (Value >> 10) & 0x1F;
+    uint32_t Mantissa = Value & 0x3FF;
+    uint32_t Bits;
+
+    if (Exponent == 0x1F) {
+        Bits = Sign | 0x7F800000 | (Mantissa << 13);
+    } else if (Exponent != 0) {
+        Bits = Sign | ((Exponent + 112) << 23) | (Mantissa << 13);
+    } else if (Mantissa == 0) {
+        Bits = Sign;
+    } else {
+
+        //
+        // Normalize the subnormal value.
+        //
+
+        Exponent = 113;
+
+        while ((Mantissa & 0x400) == 0) {
+            Mantissa <<= 1;
+            Exponent--;
+        }
+
+        Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FF) << 13);
+    }
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+inline
+float
+MlasSgemmBFloat16ToFloat(
+    uint16_t Value
+    )
+{
+    uint32_t Bits = uint32_t(Value) << 16;
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+template<typename T, typename ConvertRoutine>
+void
+MlasSgemmConvertPackBImpl(
+    float* D,
+    const T* B,
+    const float* Scales,
+    CBLAS_TRANSPOSE TransB,
+    size_t ldb,
+    size_t CountX,
+    size_t CountY,
+    ConvertRoutine Convert
+    )
+/*++
+
+Routine Description:
+
+    This routine converts elements from the source matrix to single precision
+    and stores them to the destination packed buffer in the same layout as
+    MlasSgemmCopyPackB.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    Scales - Optionally supplies the scale of each column of op(B).
+
+    TransB - Supplies the transpose operation for the source matrix.
+
+    ldb - Supplies the first dimension of the source matrix.
+
+    CountX - Supplies the number of columns of op(B) to convert.
+
+    CountY - Supplies the number of rows of op(B) to convert.
+
+    Convert - Supplies the routine to convert an element to single precision.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t x = 0; x < CountX; x += 16) {
+
+        size_t CountColumns = CountX - x;
+
+        if (CountColumns > 16) {
+            CountColumns = 16;
+        }
+
+        float* d = D + x * CountY;
+
+        //
+        // Walk the source matrix along its rows to access memory sequentially.
+        //
+
+        if (TransB == CblasNoTrans) {
+
+            for (size_t y = 0; y < CountY; y++) {
+
+                const T* b = B + x + y * ldb;
+
+                for (size_t c = 0; c < CountColumns; c++) {
+                    d[y * 16 + c] = Convert(b[c]);
+                }
+            }
+
+        } else {
+
+            for (size_t c = 0; c < CountColumns; c++) {
+
+                const T* b = B + (x + c) * ldb;
+
+                for (size_t y = 0; y < CountY; y++) {
+                    d[y * 16 + c] = Convert(b[y]);
+                }
+            }
+        }
+
+        for (size_t y = 0; y < CountY; y++) {
+
+            if (Scales != nullptr) {
+                for (size_t c = 0; c < CountColumns; c++) {
+                    d[y * 16 + c] *= Scales[x + c];
+                }
+            }
+
+            for (size_t c = CountColumns; c < 16; c++) {
+                d[y * 16 + c] = 0.0f;
+            }
+        }
+    }
+}
+
+void
+MlasSgemmConvertPackB(
+    float* D,
+    const MLAS_SGEMM_COMPRESSED_B* CompressedB,
+    CBLAS_TRANSPOSE TransB,
+    size_t ldb,
+    size_t n,
+    size_t k,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a panel of a reduced precision matrix B to single
+    precision and stores it to the destination packed buffer.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    CompressedB - Supplies the reduced precision matrix B.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    n - Supplies the first column of op(B) to convert.
+
+    k - Supplies the first row of op(B) to convert.
+
+    CountN - Supplies the number of columns of op(B) to convert.
+
+    CountK - Supplies the number of rows of op(B) to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t Offset = (TransB == CblasNoTrans) ? (n + k * ldb) : (k + n * ldb);
+
+    switch (CompressedB->Format) {
+
+        case MlasSgemmBFormatFloat16:
+            MlasSgemmConvertPackBImpl(D, static_cast<const uint16_t*>(CompressedB->Data) + Offset,
+                static_cast<const float*>(nullptr), TransB, ldb, CountN, CountK, MlasSgemmHalfToFloat);
+            break;
+
+        case MlasSgemmBFormatBFloat16:
+            MlasSgemmConvertPackBImpl(D, static_cast<const uint16_t*>(CompressedB->Data) + Offset,
+                static_cast<const float*>(nullptr), TransB, ldb, CountN, CountK, MlasSgemmBFloat16ToFloat);
+            break;
+
+        case MlasSgemmBFormatInt8:
+            MlasSgemmConvertPackBImpl(D, static_cast<const int8_t*>(CompressedB->Data) + Offset,
+                CompressedB->Scales + n, TransB, ldb, CountN, CountK, [](int8_t Value) { return float(Value); });
+            break;
+    }
+}
+
 template<unsigned N>
 inline
 void
@@ -776,7 +1003,9 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_COMPRESSED_B* CompressedB,
+    size_t OffsetN
     )
 /*++
 
@@ -814,6 +1043,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    CompressedB - Optionally supplies matrix B in a reduced precision format,
+        in which case B is not used.
+
+    OffsetN - Supplies the column of op(CompressedB) that corresponds to the
+        first column of matrix C.
+
 Return Value:
 
     None.
@@ -829,7 +1064,8 @@ Return Value:
     // memory copy.
     //
 
-    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f)) {
+    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f) &&
+        CompressedB == nullptr) {
 
 #if defined(MLAS_TARGET_AMD64)
 
@@ -917,7 +1153,9 @@ Return Value:
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
 
-            if (TransB == CblasNoTrans) {
+            if (CompressedB != nullptr) {
+                MlasSgemmConvertPackB(PanelB, CompressedB, TransB, ldb, OffsetN + n, k, CountN, CountK);
+            } else if (TransB == CblasNoTrans) {
                 MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
             } else {
                 MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
@@ -1043,7 +1281,7 @@ Return Value:
     MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
         Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
         Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+        WorkBlock->ldc, WorkBlock->CompressedB, Segment->OffsetN);
 }
 
 inline
@@ -1062,7 +1300,8 @@ MlasSgemmTryMultithread(
     float beta,
     float* C,
     size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_COMPRESSED_B* CompressedB
     )
 /*++
 
@@ -1103,6 +1342,9 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    CompressedB - Optionally supplies matrix B in a reduced precision format,
+        in which case B is not used.
+
 Return Value:
 
     Returns true if the operation was completed across multiple threads, else
@@ -1148,6 +1390,7 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.CompressedB = CompressedB;
 
     //
     // Segment the operation across multiple threads.
@@ -1179,8 +1422,9 @@ Return Value:
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (B != nullptr) ? B + n * pldb : nullptr;
             WorkBlock.Segments[Index].C = C + n;
+            WorkBlock.Segments[Index].OffsetN = n;
 
             Index++;
         }
@@ -1208,6 +1452,7 @@ Return Value:
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
+            WorkBlock.Segments[Index].OffsetN = 0;
 
             Index++;
         }
@@ -1286,7 +1531,75 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool, nullptr)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, 0);
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_SGEMM_COMPRESSED_B* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with matrix B stored in a reduced precision format.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies matrix B and its format.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, nullptr, ldb, beta, C, ldc, ThreadPool, B)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, nullptr, ldb, beta, C, ldc, B, 0);
     }
 }
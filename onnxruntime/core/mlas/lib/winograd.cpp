@@ -0,0 +1,904 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    winograd.cpp
+
+Abstract:
+
+    This module implements the Winograd F(4x4, 3x3) convolution algorithm.
+
+    The output is divided into 4x4 tiles, each produced from a 6x6 input tile.
+    The filter and input tiles are transformed into the Winograd domain, where
+    the convolution reduces to 36 independent matrix multiplications over the
+    channel dimension. The products are then transformed back to the spatial
+    domain.
+
+    The input and output transforms operate on four tiles at a time so that
+    each element of the 6x6 tile maps to one 4-wide vector.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute the stages of a Winograd convolution on
+// worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    float* TransformedFilter;
+    float* TransformedInput;
+    float* TransformedOutput;
+    size_t TilesHeight;
+    size_t TilesWidth;
+    size_t TileCount;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasConvWinogradPartitionWork(
+    size_t TotalWork,
+    int32_t ThreadCount,
+    int32_t Index,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of work items assigned to a thread.
+
+Arguments:
+
+    TotalWork - Supplies the total number of work items.
+
+    ThreadCount - Supplies the number of threads sharing the work.
+
+    Index - Supplies the index of the current thread.
+
+    WorkIndex - Receives the index of the first work item for this thread.
+
+    WorkRemaining - Receives the number of work items for this thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t WorkPerThread = TotalWork / ThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % ThreadCount;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        *WorkIndex = (WorkPerThread + 1) * Index;
+        *WorkRemaining = WorkPerThread + 1;
+    } else {
+        *WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        *WorkRemaining = WorkPerThread;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradInputTransform6(
+    const MLAS_FLOAT32X4 x[6],
+    MLAS_FLOAT32X4 y[6]
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the 6x6 input transform matrix B^T to a column of six
+    vectors:
+
+        | 4  0 -5  0  1  0 |
+        | 0 -4 -4  1  1  0 |
+        | 0  4 -4 -1  1  0 |
+        | 0 -2 -1  2  1  0 |
+        | 0  2 -1 -2  1  0 |
+        | 0  4  0 -5  0  1 |
+
+Arguments:
+
+    x - Supplies the input vectors.
+
+    y - Receives the transformed vectors.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Two = MlasBroadcastFloat32x4(2.0f);
+    const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+    const MLAS_FLOAT32X4 Five = MlasBroadcastFloat32x4(5.0f);
+
+    MLAS_FLOAT32X4 t0 = MlasSubtractFloat32x4(x[4], MlasMultiplyFloat32x4(Four, x[2]));
+    MLAS_FLOAT32X4 t1 = MlasSubtractFloat32x4(x[3], MlasMultiplyFloat32x4(Four, x[1]));
+    MLAS_FLOAT32X4 t2 = MlasSubtractFloat32x4(x[4], x[2]);
+    MLAS_FLOAT32X4 t3 = MlasMultiplyFloat32x4(Two, MlasSubtractFloat32x4(x[3], x[1]));
+
+    y[0] = MlasAddFloat32x4(MlasSubtractFloat32x4(MlasMultiplyFloat32x4(Four, x[0]),
+        MlasMultiplyFloat32x4(Five, x[2])), x[4]);
+    y[1] = MlasAddFloat32x4(t0, t1);
+    y[2] = MlasSubtractFloat32x4(t0, t1);
+    y[3] = MlasAddFloat32x4(t2, t3);
+    y[4] = MlasSubtractFloat32x4(t2, t3);
+    y[5] = MlasAddFloat32x4(MlasSubtractFloat32x4(MlasMultiplyFloat32x4(Four, x[1]),
+        MlasMultiplyFloat32x4(Five, x[3])), x[5]);
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradOutputTransform6(
+    const MLAS_FLOAT32X4 m[6],
+    MLAS_FLOAT32X4 y[4]
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the 4x6 output transform matrix A^T to a column of six
+    vectors:
+
+        | 1  1  1  1  1  0 |
+        | 0  1 -1  2 -2  0 |
+        | 0  1  1  4  4  0 |
+        | 0  1 -1  8 -8  1 |
+
+Arguments:
+
+    m - Supplies the input vectors.
+
+    y - Receives the transformed vectors.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Two = MlasBroadcastFloat32x4(2.0f);
+    const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+    const MLAS_FLOAT32X4 Eight = MlasBroadcastFloat32x4(8.0f);
+
+    MLAS_FLOAT32X4 s12 = MlasAddFloat32x4(m[1], m[2]);
+    MLAS_FLOAT32X4 d12 = MlasSubtractFloat32x4(m[1], m[2]);
+    MLAS_FLOAT32X4 s34 = MlasAddFloat32x4(m[3], m[4]);
+    MLAS_FLOAT32X4 d34 = MlasSubtractFloat32x4(m[3], m[4]);
+
+    y[0] = MlasAddFloat32x4(MlasAddFloat32x4(m[0], s12), s34);
+    y[1] = MlasMultiplyAddFloat32x4(Two, d34, d12);
+    y[2] = MlasMultiplyAddFloat32x4(Four, s34, s12);
+    y[3] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(Eight, d34, d12), m[5]);
+}
+
+void
+MlasConvWinogradFilterThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform a range of
+    filters to the Winograd domain by computing G * g * G^T.
+
+    The filters are transformed four input channels at a time and staged in a
+    local buffer so that each of the 36 transformed planes is written with
+    contiguous runs of channels.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TransformStride = FilterCount * InputChannels;
+
+    size_t FilterIndex;
+    size_t FilterRemaining;
+
+    MlasConvWinogradPartitionWork(FilterCount, WorkBlock->TargetThreadCount, Index,
+        &FilterIndex, &FilterRemaining);
+
+    //
+    // Define the non-trivial rows of the 6x3 filter transform matrix G:
+    //
+    //      |  1/4     0     0   |
+    //      | -1/6  -1/6  -1/6   |
+    //      | -1/6   1/6  -1/6   |
+    //      |  1/24  1/12  1/6   |
+    //      |  1/24 -1/12  1/6   |
+    //      |  0       0     1   |
+    //
+
+    const MLAS_FLOAT32X4 Quarter = MlasBroadcastFloat32x4(1.0f / 4.0f);
+    const MLAS_FLOAT32X4 Sixth = MlasBroadcastFloat32x4(1.0f / 6.0f);
+    const MLAS_FLOAT32X4 Twelfth = MlasBroadcastFloat32x4(1.0f / 12.0f);
+    const MLAS_FLOAT32X4 TwentyFourth = MlasBroadcastFloat32x4(1.0f / 24.0f);
+
+    constexpr size_t ChannelBlock = 16;
+
+    MLAS_DECLSPEC_ALIGN(float Transformed[MLAS_WINOGRAD_TILE_ELEMENTS][ChannelBlock], 16);
+    MLAS_DECLSPEC_ALIGN(float Gathered[9][4], 16);
+
+    for (size_t f = FilterIndex; f < FilterIndex + FilterRemaining; f++) {
+
+        for (size_t ic0 = 0; ic0 < InputChannels; ic0 += ChannelBlock) {
+
+            const size_t ChannelCount = std::min(InputChannels - ic0, ChannelBlock);
+
+            for (size_t k = 0; k < ChannelCount; k += 4) {
+
+                //
+                // Gather the 3x3 filters for the next four input channels so
+                // that each filter element is a 4-wide vector.
+                //
+
+                const float* g = WorkBlock->Filter + (f * InputChannels + ic0 + k) * 9;
+
+                for (size_t c = 0; c < 4; c++) {
+                    for (size_t e = 0; e < 9; e++) {
+                        Gathered[e][c] = (k + c < ChannelCount) ? g[c * 9 + e] : 0.0f;
+                    }
+                }
+
+                //
+                // Transform the columns (t = G * g) and then the rows
+                // (u = t * G^T).
+                //
+
+                MLAS_FLOAT32X4 t[6][3];
+
+                for (size_t j = 0; j < 3; j++) {
+
+                    MLAS_FLOAT32X4 g0 = MlasLoadFloat32x4(Gathered[j]);
+                    MLAS_FLOAT32X4 g1 = MlasLoadFloat32x4(Gathered[3 + j]);
+                    MLAS_FLOAT32X4 g2 = MlasLoadFloat32x4(Gathered[6 + j]);
+
+                    MLAS_FLOAT32X4 s02 = MlasAddFloat32x4(g0, g2);
+
+                    t[0][j] = MlasMultiplyFloat32x4(Quarter, g0);
+                    t[1][j] = MlasMultiplyFloat32x4(Sixth, MlasSubtractFloat32x4(MlasZeroFloat32x4(),
+                        MlasAddFloat32x4(s02, g1)));
+                    t[2][j] = MlasMultiplyFloat32x4(Sixth, MlasSubtractFloat32x4(g1, s02));
+                    t[3][j] = MlasMultiplyAddFloat32x4(TwentyFourth, g0,
+                        MlasMultiplyAddFloat32x4(Twelfth, g1, MlasMultiplyFloat32x4(Sixth, g2)));
+                    t[4][j] = MlasMultiplyAddFloat32x4(TwentyFourth, g0,
+                        MlasSubtractFloat32x4(MlasMultiplyFloat32x4(Sixth, g2),
+                        MlasMultiplyFloat32x4(Twelfth, g1)));
+                    t[5][j] = g2;
+                }
+
+                for (size_t i = 0; i < 6; i++) {
+
+                    MLAS_FLOAT32X4 g0 = t[i][0];
+                    MLAS_FLOAT32X4 g1 = t[i][1];
+                    MLAS_FLOAT32X4 g2 = t[i][2];
+
+                    MLAS_FLOAT32X4 s02 = MlasAddFloat32x4(g0, g2);
+
+                    float* u = &Transformed[i * 6][k];
+
+                    MlasStoreFloat32x4(u, MlasMultiplyFloat32x4(Quarter, g0));
+                    MlasStoreFloat32x4(u + ChannelBlock, MlasMultiplyFloat32x4(Sixth,
+                        MlasSubtractFloat32x4(MlasZeroFloat32x4(), MlasAddFloat32x4(s02, g1))));
+                    MlasStoreFloat32x4(u + 2 * ChannelBlock, MlasMultiplyFloat32x4(Sixth,
+                        MlasSubtractFloat32x4(g1, s02)));
+                    MlasStoreFloat32x4(u + 3 * ChannelBlock, MlasMultiplyAddFloat32x4(TwentyFourth, g0,
+                        MlasMultiplyAddFloat32x4(Twelfth, g1, MlasMultiplyFloat32x4(Sixth, g2))));
+                    MlasStoreFloat32x4(u + 4 * ChannelBlock, MlasMultiplyAddFloat32x4(TwentyFourth, g0,
+                        MlasSubtractFloat32x4(MlasMultiplyFloat32x4(Sixth, g2),
+                        MlasMultiplyFloat32x4(Twelfth, g1))));
+                    MlasStoreFloat32x4(u + 5 * ChannelBlock, g2);
+                }
+            }
+
+            //
+            // Copy the staged channels to each of the transformed planes.
+            //
+
+            float* u = WorkBlock->TransformedFilter + f * InputChannels + ic0;
+
+            for (size_t e = 0; e < MLAS_WINOGRAD_TILE_ELEMENTS; e++) {
+                std::copy_n(Transformed[e], ChannelCount, u + e * TransformStride);
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradInputThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform the input tiles
+    of a range of input channels to the Winograd domain by computing
+    B^T * d * B.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const ptrdiff_t PaddingTop = ptrdiff_t(Parameters->Padding[0]);
+    const ptrdiff_t PaddingLeft = ptrdiff_t(Parameters->Padding[1]);
+
+    const size_t TilesWidth = WorkBlock->TilesWidth;
+    const size_t TilesCount = WorkBlock->TilesHeight * TilesWidth;
+    const size_t TileCount = WorkBlock->TileCount;
+    const size_t TransformStride = InputChannels * TileCount;
+
+    size_t ChannelIndex;
+    size_t ChannelRemaining;
+
+    MlasConvWinogradPartitionWork(InputChannels, WorkBlock->TargetThreadCount, Index,
+        &ChannelIndex, &ChannelRemaining);
+
+    for (size_t ic = ChannelIndex; ic < ChannelIndex + ChannelRemaining; ic++) {
+
+        const float* input = WorkBlock->Input + ic * InputSize;
+        float* v = WorkBlock->TransformedInput + ic * TileCount;
+
+        for (size_t tile = 0; tile < TileCount; tile += 4) {
+
+            //
+            // Gather the 6x6 input tiles for the next four output tiles into
+            // a buffer where each tile element is a 4-wide vector. Elements
+            // in the padding region or beyond the last tile are zero.
+            //
+
+            MLAS_DECLSPEC_ALIGN(float Buffer[MLAS_WINOGRAD_TILE_ELEMENTS][4], 16);
+
+            for (size_t k = 0; k < 4; k++) {
+
+                if (tile + k >= TilesCount) {
+                    for (size_t e = 0; e < MLAS_WINOGRAD_TILE_ELEMENTS; e++) {
+                        Buffer[e][k] = 0.0f;
+                    }
+                    continue;
+                }
+
+                const ptrdiff_t ih0 = ptrdiff_t(((tile + k) / TilesWidth) * 4) - PaddingTop;
+                const ptrdiff_t iw0 = ptrdiff_t(((tile + k) % TilesWidth) * 4) - PaddingLeft;
+
+                const bool Interior = ih0 >= 0 && size_t(ih0 + 6) <= InputHeight &&
+                    iw0 >= 0 && size_t(iw0 + 6) <= InputWidth;
+
+                for (size_t i = 0; i < 6; i++) {
+
+                    const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+                    const float* row = input + ih * ptrdiff_t(InputWidth);
+
+                    for (size_t j = 0; j < 6; j++) {
+
+                        const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+
+                        if (Interior || (ih >= 0 && size_t(ih) < InputHeight &&
+                            iw >= 0 && size_t(iw) < InputWidth)) {
+                            Buffer[i * 6 + j][k] = row[iw];
+                        } else {
+                            Buffer[i * 6 + j][k] = 0.0f;
+                        }
+                    }
+                }
+            }
+
+            //
+            // Transform the columns and then the rows of the tiles.
+            //
+
+            MLAS_FLOAT32X4 x[6];
+            MLAS_FLOAT32X4 y[6];
+            MLAS_FLOAT32X4 t[6][6];
+
+            for (size_t j = 0; j < 6; j++) {
+
+                for (size_t i = 0; i < 6; i++) {
+                    x[i] = MlasLoadFloat32x4(Buffer[i * 6 + j]);
+                }
+
+                MlasWinogradInputTransform6(x, y);
+
+                for (size_t i = 0; i < 6; i++) {
+                    t[i][j] = y[i];
+                }
+            }
+
+            for (size_t i = 0; i < 6; i++) {
+
+                MlasWinogradInputTransform6(t[i], y);
+
+                for (size_t j = 0; j < 6; j++) {
+                    MlasStoreFloat32x4(v + (i * 6 + j) * TransformStride + tile, y[j]);
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to multiply the transformed
+    filters by the transformed input tiles for a range of the 36 Winograd
+    domain elements.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileCount = WorkBlock->TileCount;
+
+    size_t ElementIndex;
+    size_t ElementRemaining;
+
+    MlasConvWinogradPartitionWork(MLAS_WINOGRAD_TILE_ELEMENTS, WorkBlock->TargetThreadCount,
+        Index, &ElementIndex, &ElementRemaining);
+
+    for (size_t e = ElementIndex; e < ElementIndex + ElementRemaining; e++) {
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount,
+            InputChannels, 1.0f, WorkBlock->TransformedFilter + e * FilterCount * InputChannels,
+            InputChannels, WorkBlock->TransformedInput + e * InputChannels * TileCount,
+            TileCount, 0.0f, WorkBlock->TransformedOutput + e * FilterCount * TileCount,
+            TileCount);
+    }
+}
+
+void
+MlasConvWinogradOutputThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform the products for
+    a range of filters back to the spatial domain by computing A^T * m * A and
+    then apply the activation with optional bias.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+
+    const size_t TilesWidth = WorkBlock->TilesWidth;
+    const size_t TilesCount = WorkBlock->TilesHeight * TilesWidth;
+    const size_t TileCount = WorkBlock->TileCount;
+    const size_t TransformStride = FilterCount * TileCount;
+
+    size_t FilterIndex;
+    size_t FilterRemaining;
+
+    MlasConvWinogradPartitionWork(FilterCount, WorkBlock->TargetThreadCount, Index,
+        &FilterIndex, &FilterRemaining);
+
+    for (size_t f = FilterIndex; f < FilterIndex + FilterRemaining; f++) {
+
+        const float* m = WorkBlock->TransformedOutput + f * TileCount;
+        float* output = WorkBlock->Output + f * OutputSize;
+
+        for (size_t tile = 0; tile < TileCount; tile += 4) {
+
+            //
+            // Transform the columns and then the rows of the next four tiles.
+            //
+
+            MLAS_FLOAT32X4 x[6];
+            MLAS_FLOAT32X4 y[4];
+            MLAS_FLOAT32X4 t[4][6];
+
+            for (size_t j = 0; j < 6; j++) {
+
+                for (size_t i = 0; i < 6; i++) {
+                    x[i] = MlasLoadFloat32x4(m + (i * 6 + j) * TransformStride + tile);
+                }
+
+                MlasWinogradOutputTransform6(x, y);
+
+                for (size_t i = 0; i < 4; i++) {
+                    t[i][j] = y[i];
+                }
+            }
+
+            MLAS_DECLSPEC_ALIGN(float Buffer[16][4], 16);
+
+            for (size_t i = 0; i < 4; i++) {
+
+                MlasWinogradOutputTransform6(t[i], y);
+
+                for (size_t j = 0; j < 4; j++) {
+                    MlasStoreFloat32x4(Buffer[i * 4 + j], y[j]);
+                }
+            }
+
+            //
+            // Scatter the 4x4 output tiles, clipping at the output edges.
+            //
+
+            for (size_t k = 0; k < 4 && tile + k < TilesCount; k++) {
+
+                const size_t oh0 = ((tile + k) / TilesWidth) * 4;
+                const size_t ow0 = ((tile + k) % TilesWidth) * 4;
+
+                const size_t RowCount = std::min(OutputHeight - oh0, size_t(4));
+                const size_t ColumnCount = std::min(OutputWidth - ow0, size_t(4));
+
+                for (size_t i = 0; i < RowCount; i++) {
+                    for (size_t j = 0; j < ColumnCount; j++) {
+                        output[(oh0 + i) * OutputWidth + ow0 + j] = Buffer[i * 4 + j][k];
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias.
+    //
+
+    if (FilterRemaining > 0) {
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += FilterIndex;
+        }
+
+        MlasActivation(Parameters->Activation, WorkBlock->Output + FilterIndex * OutputSize,
+            bias, FilterRemaining, OutputSize, OutputSize);
+    }
+}
+
+size_t
+MlasConvWinogradGetTileCount(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of 4x4 output tiles for the convolution,
+    rounded up to a multiple of the transform vector width.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the padded number of output tiles.
+
+--*/
+{
+    const size_t TilesHeight = (Parameters->OutputShape[0] + 3) / 4;
+    const size_t TilesWidth = (Parameters->OutputShape[1] + 3) / 4;
+
+    return (TilesHeight * TilesWidth + 3) & ~size_t(3);
+}
+
+size_t
+MlasConvWinogradGetWorkingBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of working buffer elements required to
+    hold the transformed filters, input tiles and products.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the number of elements of the working buffer.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileCount = MlasConvWinogradGetTileCount(Parameters);
+
+    return MLAS_WINOGRAD_TILE_ELEMENTS * (FilterCount * InputChannels +
+        InputChannels * TileCount + FilterCount * TileCount);
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd F(4x4, 3x3) convolution for a single
+    batch and group.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor for the batch and group.
+
+    Filter - Supplies the filter tensor for the group.
+
+    PackedFilter - Optionally supplies the filters for the group transformed
+        by MlasConvWinogradPackFilter, else nullptr if the filters should be
+        transformed to the working buffer.
+
+    Bias - Optionally supplies the bias vector for the group.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvWinogradGetWorkingBufferSize.
+
+    Output - Supplies the output tensor for the batch and group.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.TilesHeight = (Parameters->OutputShape[0] + 3) / 4;
+    WorkBlock.TilesWidth = (Parameters->OutputShape[1] + 3) / 4;
+    WorkBlock.TileCount = MlasConvWinogradGetTileCount(Parameters);
+
+    WorkBlock.TransformedFilter = WorkingBuffer;
+    WorkBlock.TransformedInput = WorkBlock.TransformedFilter +
+        MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels;
+    WorkBlock.TransformedOutput = WorkBlock.TransformedInput +
+        MLAS_WINOGRAD_TILE_ELEMENTS * InputChannels * WorkBlock.TileCount;
+
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    //
+    // Transform the filters if not already packed and then the input tiles.
+    //
+
+    if (PackedFilter != nullptr) {
+
+        WorkBlock.TransformedFilter = const_cast<float*>(PackedFilter);
+
+    } else {
+
+        WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MaximumThreadCount), FilterCount));
+
+        MlasExecuteThreaded(MlasConvWinogradFilterThreaded, &WorkBlock,
+            WorkBlock.TargetThreadCount, ThreadPool);
+    }
+
+    WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MaximumThreadCount), InputChannels));
+
+    MlasExecuteThreaded(MlasConvWinogradInputThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+
+    //
+    // Multiply the transformed filters and input tiles for each of the
+    // Winograd domain elements.
+    //
+
+    WorkBlock.TargetThreadCount = int32_t(std::min(MaximumThreadCount,
+        int32_t(MLAS_WINOGRAD_TILE_ELEMENTS)));
+
+    MlasExecuteThreaded(MlasConvWinogradGemmThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+
+    //
+    // Transform the products back to the output tensor.
+    //
+
+    WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MaximumThreadCount), FilterCount));
+
+    MlasExecuteThreaded(MlasConvWinogradOutputThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasConvWinogradGetPackedFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements required to store the 3x3
+    filters transformed for the Winograd algorithm.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the packed filter buffer, or zero if
+    MlasConvPrepare never selects the Winograd algorithm for these channel
+    counts.
+
+--*/
+{
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return 0;
+    }
+
+    return GroupCount * MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms 3x3 filters for the Winograd algorithm so that the
+    transform is not repeated by every call to MlasConv.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor in OIHW format.
+
+    PackedFilter - Supplies the buffer sized to the number of elements
+        returned by MlasConvWinogradGetPackedFilterSize.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_PARAMETERS Parameters;
+
+    Parameters.InputChannels = InputChannels;
+    Parameters.FilterCount = FilterCount;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = &Parameters;
+    WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MlasGetMaximumThreadCount(ThreadPool)),
+        FilterCount));
+
+    const size_t FilterGroupSize = FilterCount * InputChannels * 9;
+    const size_t PackedFilterGroupSize = MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        WorkBlock.Filter = Filter + group * FilterGroupSize;
+        WorkBlock.TransformedFilter = PackedFilter + group * PackedFilterGroupSize;
+
+        MlasExecuteThreaded(MlasConvWinogradFilterThreaded, &WorkBlock,
+            WorkBlock.TargetThreadCount, ThreadPool);
+    }
+}
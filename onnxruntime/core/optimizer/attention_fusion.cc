@@ -0,0 +1,459 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Q, K or V: Transpose(Reshape(MatMul(x, weight) + bias, (batch_size, sequence_length, num_heads, head_size)))
+struct AttentionProjection {
+  const Node* matmul;
+  const Node* add;
+  const Node* reshape;
+  const Node* transpose;
+  const NodeArg* x;
+  const TensorProto* weight;
+  const TensorProto* bias;
+  int64_t num_heads;
+  int64_t head_size;
+};
+
+// Returns the node producing input input_index of node.
+static const Node* GetInputNode(const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+// Returns the node producing input input_index of node if node is the only use of its output.
+static const Node* GetExclusiveInputNode(const Graph& graph, const Node& node, int input_index) {
+  const Node* input_node = GetInputNode(node, input_index);
+  if (input_node == nullptr || input_node->GetOutputEdgesCount() != 1 ||
+      graph.IsNodeOutputsInGraphOutputs(*input_node) ||
+      input_node->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return input_node;
+}
+
+// Reads a 1-D int64 constant such as the shape of a Reshape.
+static bool GetConstantInts(const Graph& graph, const NodeArg& arg, std::vector<int64_t>& values) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() != 1) {
+    return false;
+  }
+
+  values.resize(static_cast<size_t>(tensor_proto->dims(0)));
+  const bool has_raw_data = utils::HasRawData(*tensor_proto);
+  return utils::UnpackTensor(*tensor_proto,
+                             has_raw_data ? tensor_proto->raw_data().data() : nullptr,
+                             has_raw_data ? tensor_proto->raw_data().size() : 0,
+                             values.data(), static_cast<int64_t>(values.size()))
+      .IsOK();
+}
+
+static bool HasPerm(const Node& transpose, const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(transpose, "Transpose", {1}) &&
+         graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm) && perm == expected_perm;
+}
+
+// Checks that the first two dimensions of a Reshape shape keep the batch and sequence dimensions of x.
+static bool KeepsSequenceDims(const std::vector<int64_t>& shape, const NodeArg& x) {
+  const auto* x_shape = x.Shape();
+  if (x_shape == nullptr || x_shape->dim_size() != 3 || (shape[0] == -1 && shape[1] == -1)) {
+    return false;
+  }
+  for (int i = 0; i < 2; ++i) {
+    if (shape[i] != 0 && shape[i] != -1 &&
+        !(utils::HasDimValue(x_shape->dim(i)) && x_shape->dim(i).dim_value() == shape[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static const TensorProto* GetConstantFloatInitializer(const Graph& graph, const NodeArg& arg, int rank) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      tensor_proto->dims_size() != rank) {
+    return nullptr;
+  }
+  return tensor_proto;
+}
+
+static bool MatchProjection(const Graph& graph, const Node* transpose, const std::vector<int64_t>& perm,
+                            AttentionProjection& projection) {
+  if (transpose == nullptr || !HasPerm(*transpose, perm)) {
+    return false;
+  }
+
+  const Node* reshape = GetExclusiveInputNode(graph, *transpose, 0);
+  std::vector<int64_t> shape;
+  if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5}) ||
+      !GetConstantInts(graph, *reshape->InputDefs()[1], shape) || shape.size() != 4 ||
+      shape[2] <= 0 || shape[3] <= 0) {
+    return false;
+  }
+
+  const Node* add = GetExclusiveInputNode(graph, *reshape, 0);
+  if (add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*add, "Add", {7})) {
+    return false;
+  }
+
+  // the bias may be either input of the Add
+  int matmul_index = 0;
+  const Node* matmul = GetExclusiveInputNode(graph, *add, 0);
+  if (matmul == nullptr || matmul->OpType() != "MatMul") {
+    matmul_index = 1;
+    matmul = GetExclusiveInputNode(graph, *add, 1);
+  }
+  if (matmul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*matmul, "MatMul", {1, 9})) {
+    return false;
+  }
+
+  const TensorProto* weight = GetConstantFloatInitializer(graph, *matmul->InputDefs()[1], 2);
+  const TensorProto* bias = GetConstantFloatInitializer(graph, *add->InputDefs()[1 - matmul_index], 1);
+  const int64_t hidden_size = shape[2] * shape[3];
+  if (weight == nullptr || bias == nullptr ||
+      weight->dims(0) != hidden_size || weight->dims(1) != hidden_size || bias->dims(0) != hidden_size ||
+      !KeepsSequenceDims(shape, *matmul->InputDefs()[0])) {
+    return false;
+  }
+
+  projection.matmul = matmul;
+  projection.add = add;
+  projection.reshape = reshape;
+  projection.transpose = transpose;
+  projection.x = matmul->InputDefs()[0];
+  projection.weight = weight;
+  projection.bias = bias;
+  projection.num_heads = shape[2];
+  projection.head_size = shape[3];
+  return true;
+}
+
+// Applies the Unsqueezes, from the last one of unsqueeze_axes to the first, to a 2-D tensor and returns the
+// dimensions of the result: 0 and 1 for the dimensions of the 2-D tensor and -1 for the inserted ones.
+static std::vector<int64_t> GetUnsqueezedDims(const std::vector<std::vector<int64_t>>& unsqueeze_axes) {
+  std::vector<int64_t> dims{0, 1};
+  for (auto it = unsqueeze_axes.rbegin(); it != unsqueeze_axes.rend(); ++it) {
+    const int64_t rank = static_cast<int64_t>(dims.size() + it->size());
+    std::vector<int64_t> axes;
+    for (int64_t axis : *it) {
+      axes.push_back(axis < 0 ? axis + rank : axis);
+    }
+    std::sort(axes.begin(), axes.end());
+    for (int64_t axis : axes) {
+      if (axis < 0 || axis > static_cast<int64_t>(dims.size())) {
+        return {};
+      }
+      dims.insert(dims.begin() + axis, -1);
+    }
+  }
+  return dims;
+}
+
+// Matches (1 - Unsqueeze(mask)) * c with a large negative c, and possibly Casts, and returns the 2-D mask.
+// The mask must have an integer type so that the Attention kernel computes the same (1 - mask) * c from it.
+// mask_nodes receives the nodes computing the additive mask from the consumer to the producer.
+static const NodeArg* MatchMask(const Graph& graph, const Node& mask_add, int mask_index, float& mask_value,
+                                std::vector<NodeIndex>& mask_nodes) {
+  const Node* mul = GetInputNode(mask_add, mask_index);
+  if (mul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", {7})) {
+    return nullptr;
+  }
+  int sub_index = 0;
+  if (!optimizer_utils::GetScalarConstant(graph, *mul->InputDefs()[1], mask_value)) {
+    sub_index = 1;
+    if (!optimizer_utils::GetScalarConstant(graph, *mul->InputDefs()[0], mask_value)) {
+      return nullptr;
+    }
+  }
+  if (mask_value > -1000.0f) {
+    return nullptr;
+  }
+
+  const Node* sub = GetInputNode(*mul, sub_index);
+  float one;
+  if (sub == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*sub, "Sub", {7}) ||
+      !optimizer_utils::GetScalarConstant(graph, *sub->InputDefs()[0], one) || one != 1.0f) {
+    return nullptr;
+  }
+  mask_nodes.push_back(mul->Index());
+  mask_nodes.push_back(sub->Index());
+
+  // Unsqueeze the 2-D mask to (batch_size, 1, 1, sequence_length). The axes of each Unsqueeze are collected from
+  // the consumer to the producer.
+  std::vector<std::vector<int64_t>> unsqueeze_axes;
+  const Node* node = GetInputNode(*sub, 1);
+  const NodeArg* mask = sub->InputDefs()[1];
+  while (node != nullptr) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Unsqueeze", {1, 11})) {
+      std::vector<int64_t> axes;
+      if (!graph_utils::GetRepeatedNodeAttributeValues(*node, "axes", axes)) {
+        return nullptr;
+      }
+      unsqueeze_axes.push_back(std::move(axes));
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Cast", {6, 9})) {
+      // Casts to a narrower type could change the mask
+      const auto to = optimizer_utils::GetIntAttribute(*node, "to", TensorProto_DataType_UNDEFINED);
+      if (to != TensorProto_DataType_FLOAT && to != TensorProto_DataType_DOUBLE &&
+          to != TensorProto_DataType_INT32 && to != TensorProto_DataType_INT64) {
+        return nullptr;
+      }
+    } else {
+      break;
+    }
+    mask_nodes.push_back(node->Index());
+    mask = node->InputDefs()[0];
+    node = GetInputNode(*node, 0);
+  }
+
+  if (mask->Shape() == nullptr || mask->Shape()->dim_size() != 2 ||
+      GetUnsqueezedDims(unsqueeze_axes) != std::vector<int64_t>{0, -1, -1, 1}) {
+    return nullptr;
+  }
+
+  const auto mask_type = mask->TypeAsProto() != nullptr ? mask->TypeAsProto()->tensor_type().elem_type()
+                                                         : TensorProto_DataType_UNDEFINED;
+  if (mask_type != TensorProto_DataType_INT32 && mask_type != TensorProto_DataType_INT64 &&
+      mask_type != TensorProto_DataType_BOOL) {
+    return nullptr;
+  }
+  return mask;
+}
+
+// Returns the mask as the int32 mask input of Attention, casting it if needed.
+static NodeArg& AddMaskInput(Graph& graph, NodeArg& mask, const std::string& provider_type) {
+  if (mask.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_INT32) {
+    return mask;
+  }
+
+  TypeProto int_mask_type;
+  int_mask_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  NodeArg& int_mask = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(mask.Name() + "_int32"), &int_mask_type);
+  Node& cast = graph.AddNode(graph.GenerateNodeName("MaskCast"), "Cast", "attention mask to int32",
+                             {&mask}, {&int_mask});
+  cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+  cast.SetExecutionProviderType(provider_type);
+  return int_mask;
+}
+
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::vector<NodeIndex> mask_nodes;
+  std::unordered_map<std::string, NodeArg*> mask_inputs;
+
+  for (auto node_index : node_topology_list) {
+    auto& softmax = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the softmax is over the keys, the last of (batch_size, num_heads, sequence_length, sequence_length)
+    const auto* axis = graph_utils::GetNodeAttribute(softmax, "axis");
+    if (axis == nullptr || (axis->i() != 3 && axis->i() != -1)) {
+      continue;
+    }
+
+    // scores = MatMul(Q, K) / sqrt(head_size) + mask
+    const Node* scale = GetExclusiveInputNode(graph, softmax, 0);
+    const Node* mask_add = nullptr;
+    int mask_input = 0;
+    if (scale != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Add", {7})) {
+      mask_add = scale;
+      scale = GetExclusiveInputNode(graph, *mask_add, 0);
+      mask_input = 1;
+      if (scale == nullptr || (scale->OpType() != "Div" && scale->OpType() != "Mul")) {
+        scale = GetExclusiveInputNode(graph, *mask_add, 1);
+        mask_input = 0;
+      }
+    }
+    if (scale == nullptr) {
+      continue;
+    }
+
+    float scale_value;
+    const Node* qk = nullptr;
+    bool is_div = false;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Div", {7})) {
+      if (!optimizer_utils::GetScalarConstant(graph, *scale->InputDefs()[1], scale_value)) {
+        continue;
+      }
+      qk = GetExclusiveInputNode(graph, *scale, 0);
+      is_div = true;
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Mul", {7})) {
+      int qk_index = 0;
+      if (!optimizer_utils::GetScalarConstant(graph, *scale->InputDefs()[1], scale_value)) {
+        qk_index = 1;
+        if (!optimizer_utils::GetScalarConstant(graph, *scale->InputDefs()[0], scale_value)) {
+          continue;
+        }
+      }
+      qk = GetExclusiveInputNode(graph, *scale, qk_index);
+    }
+    if (qk == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*qk, "MatMul", {1, 9})) {
+      continue;
+    }
+
+    AttentionProjection q, k, v;
+    if (!MatchProjection(graph, GetExclusiveInputNode(graph, *qk, 0), {0, 2, 1, 3}, q) ||
+        !MatchProjection(graph, GetExclusiveInputNode(graph, *qk, 1), {0, 2, 3, 1}, k)) {
+      continue;
+    }
+
+    // Y = Reshape(Transpose(MatMul(P, V)), (batch_size, sequence_length, hidden_size))
+    const Node* context = optimizer_utils::GetOnlyConsumer(graph, softmax);
+    if (context == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*context, "MatMul", {1, 9}) ||
+        context->InputDefs()[0] != softmax.OutputDefs()[0] ||
+        !MatchProjection(graph, GetExclusiveInputNode(graph, *context, 1), {0, 2, 1, 3}, v)) {
+      continue;
+    }
+
+    const Node* transpose = optimizer_utils::GetOnlyConsumer(graph, *context);
+    if (transpose == nullptr || !HasPerm(*transpose, {0, 2, 1, 3})) {
+      continue;
+    }
+    const Node* reshape = optimizer_utils::GetOnlyConsumer(graph, *transpose);
+    std::vector<int64_t> shape;
+    if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5}) ||
+        !GetConstantInts(graph, *reshape->InputDefs()[1], shape) || shape.size() != 3) {
+      continue;
+    }
+
+    // Q, K and V project the same input with the same heads
+    const int64_t num_heads = q.num_heads;
+    const int64_t head_size = q.head_size;
+    const int64_t hidden_size = num_heads * head_size;
+    if (q.x != k.x || q.x != v.x || *q.x->Type() != "tensor(float)" ||
+        k.num_heads != num_heads || v.num_heads != num_heads ||
+        k.head_size != head_size || v.head_size != head_size ||
+        shape[2] != hidden_size || !KeepsSequenceDims(shape, *q.x)) {
+      continue;
+    }
+    const auto& x_dim = q.x->Shape()->dim(2);
+    if (!utils::HasDimValue(x_dim) || x_dim.dim_value() != hidden_size) {
+      continue;
+    }
+
+    const float expected_scale = is_div ? std::sqrt(static_cast<float>(head_size))
+                                        : 1.0f / std::sqrt(static_cast<float>(head_size));
+    if (std::abs(scale_value - expected_scale) > 1e-3f * expected_scale) {
+      continue;
+    }
+
+    const NodeArg* mask = nullptr;
+    float mask_filter_value = 0.f;
+    std::vector<NodeIndex> layer_mask_nodes;
+    if (mask_add != nullptr) {
+      mask = MatchMask(graph, *mask_add, mask_input, mask_filter_value, layer_mask_nodes);
+      if (mask == nullptr) {
+        continue;
+      }
+    }
+
+    // Pack the weights so that each row of the projection is (Q, K, V).
+    Initializer q_weight{q.weight}, k_weight{k.weight}, v_weight{v.weight};
+    Initializer q_bias{q.bias}, k_bias{k.bias}, v_bias{v.bias};
+    std::vector<float> weight(static_cast<size_t>(hidden_size * 3 * hidden_size));
+    std::vector<float> bias(static_cast<size_t>(3 * hidden_size));
+    for (int64_t r = 0; r < hidden_size; ++r) {
+      float* row = weight.data() + r * 3 * hidden_size;
+      std::copy_n(q_weight.data<float>() + r * hidden_size, hidden_size, row);
+      std::copy_n(k_weight.data<float>() + r * hidden_size, hidden_size, row + hidden_size);
+      std::copy_n(v_weight.data<float>() + r * hidden_size, hidden_size, row + 2 * hidden_size);
+    }
+    std::copy_n(q_bias.data<float>(), hidden_size, bias.data());
+    std::copy_n(k_bias.data<float>(), hidden_size, bias.data() + hidden_size);
+    std::copy_n(v_bias.data<float>(), hidden_size, bias.data() + 2 * hidden_size);
+
+    const std::string& provider_type = softmax.GetExecutionProviderType();
+    std::vector<NodeArg*> attention_inputs{
+        const_cast<NodeArg*>(q.x),
+        &optimizer_utils::AddInitializer(graph, q.weight->name() + "_qkv", TensorProto_DataType_FLOAT, weight,
+                                         {hidden_size, 3 * hidden_size}),
+        &optimizer_utils::AddInitializer(graph, q.bias->name() + "_qkv", TensorProto_DataType_FLOAT, bias,
+                                         {3 * hidden_size})};
+    if (mask != nullptr) {
+      // the layers of a model share the mask, and its cast to int32
+      auto it = mask_inputs.find(mask->Name());
+      if (it == mask_inputs.end()) {
+        it = mask_inputs.emplace(mask->Name(), &AddMaskInput(graph, *const_cast<NodeArg*>(mask), provider_type))
+                 .first;
+      }
+      attention_inputs.push_back(it->second);
+      mask_nodes.insert(mask_nodes.end(), layer_mask_nodes.begin(), layer_mask_nodes.end());
+    }
+
+    Node& attention = graph.AddNode(graph.GenerateNodeName("Attention"),
+                                    "Attention",
+                                    "fused Attention subgraphs",
+                                    attention_inputs,
+                                    {const_cast<NodeArg*>(reshape->OutputDefs()[0])}, {}, kMSDomain);
+    attention.AddAttribute("num_heads", num_heads);
+    if (mask != nullptr) {
+      attention.AddAttribute("mask_filter_value", mask_filter_value);
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention.SetExecutionProviderType(provider_type);
+
+    for (const auto* projection : {&q, &k, &v}) {
+      removed_nodes.push_front(projection->matmul->Index());
+      removed_nodes.push_front(projection->add->Index());
+      removed_nodes.push_front(projection->reshape->Index());
+      removed_nodes.push_front(projection->transpose->Index());
+    }
+    removed_nodes.push_front(qk->Index());
+    removed_nodes.push_front(scale->Index());
+    if (mask_add != nullptr) {
+      removed_nodes.push_front(mask_add->Index());
+    }
+    removed_nodes.push_front(softmax.Index());
+    removed_nodes.push_front(context->Index());
+    removed_nodes.push_front(transpose->Index());
+    removed_nodes.push_front(reshape->Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  // The additive mask is no longer used once all the layers sharing it are fused. The mask nodes of each layer are
+  // listed from the consumer to the producer, so a node shared by several layers is unused when it is reached for
+  // the last of them.
+  for (NodeIndex mask_node_index : mask_nodes) {
+    const Node* mask_node = graph.GetNode(mask_node_index);
+    if (mask_node != nullptr &&
+        mask_node->GetOutputEdgesCount() == 0 && !graph.IsNodeOutputsInGraphOutputs(*mask_node)) {
+      graph.RemoveNode(mask_node_index);
+    }
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AttentionFusion
+
+Rewrite graph fusing the multi-head self attention subgraph exported for BERT-like models to a single Attention
+node, with the Q, K and V weights packed into one (hidden_size, 3 * hidden_size) weight.
+
+The subgraph is, for a 3-D input x of shape (batch_size, sequence_length, hidden_size):
+  Q = Transpose(Reshape(MatMul(x, Wq) + Bq, (batch_size, sequence_length, num_heads, head_size)), (0, 2, 1, 3))
+  K = Transpose(Reshape(MatMul(x, Wk) + Bk, (batch_size, sequence_length, num_heads, head_size)), (0, 2, 3, 1))
+  V = Transpose(Reshape(MatMul(x, Wv) + Bv, (batch_size, sequence_length, num_heads, head_size)), (0, 2, 1, 3))
+  P = Softmax(MatMul(Q, K) / sqrt(head_size) + mask, axis=-1)
+  Y = Reshape(Transpose(MatMul(P, V), (0, 2, 1, 3)), (batch_size, sequence_length, hidden_size))
+where the scaling may be a Mul by 1 / sqrt(head_size) and the Reshape shapes are constant.
+
+The mask, if any, must be computed from a 2-D input mask as (1 - Unsqueeze(mask)) * -10000, possibly with Casts.
+Attention attends to the first mask_index[b] positions of each sequence, so the fusion computes mask_index as the
+sum of the input mask, which assumes every sequence is padded at the end.
+
+*/
+class AttentionFusion : public GraphTransformer {
+ public:
+  AttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("AttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+#include <algorithm>
+
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Hashes a node by the values it computes. The attributes are hashed by name only, since the order of the
+// NodeAttributes map isn't defined; EquivalentNodeEqual compares their values.
+struct EquivalentNodeHash {
+  size_t operator()(const Node* node) const {
+    size_t hash = std::hash<std::string>{}(node->OpType());
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    combine(std::hash<std::string>{}(node->Domain()));
+    for (const auto* input_def : node->InputDefs()) {
+      combine(std::hash<const NodeArg*>{}(input_def));
+    }
+    size_t attributes_hash = 0;
+    for (const auto& attr : node->GetAttributes()) {
+      attributes_hash += std::hash<std::string>{}(attr.first);
+    }
+    combine(attributes_hash);
+    return hash;
+  }
+};
+
+// Checks that two nodes compute the same values.
+struct EquivalentNodeEqual {
+  bool operator()(const Node* lhs, const Node* rhs) const {
+    // the schemas are the same if the op types, domains and versions are
+    if (lhs->Op() != rhs->Op() || lhs->OpType() != rhs->OpType() ||
+        lhs->GetExecutionProviderType() != rhs->GetExecutionProviderType() ||
+        lhs->InputDefs().size() != rhs->InputDefs().size() ||
+        !std::equal(lhs->InputDefs().begin(), lhs->InputDefs().end(), rhs->InputDefs().begin())) {
+      return false;
+    }
+
+    const auto& lhs_outputs = lhs->OutputDefs();
+    const auto& rhs_outputs = rhs->OutputDefs();
+    if (lhs_outputs.size() != rhs_outputs.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs_outputs.size(); ++i) {
+      if (lhs_outputs[i]->Exists() != rhs_outputs[i]->Exists()) {
+        return false;
+      }
+    }
+
+    const auto& lhs_attributes = lhs->GetAttributes();
+    const auto& rhs_attributes = rhs->GetAttributes();
+    if (lhs_attributes.size() != rhs_attributes.size()) {
+      return false;
+    }
+    for (const auto& attr : lhs_attributes) {
+      auto it = rhs_attributes.find(attr.first);
+      if (it == rhs_attributes.end() || it->second.SerializeAsString() != attr.second.SerializeAsString()) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // The nodes kept so far, which the nodes computing the same values are merged into.
+  std::unordered_set<const Node*, EquivalentNodeHash, EquivalentNodeEqual> computed_nodes;
+
+  for (NodeIndex i : order) {
+    auto* node = graph.GetNode(i);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    // Nodes that include subgraphs (control flow operators, such as If/Loop/Scan) have implicit inputs, which the
+    // nodes in the subgraph use by name. The subgraphs are processed by the Recurse call above.
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::IsOperationDeterministic(node->OpType()) ||
+        node->ContainsSubgraph() ||
+        node->Op() == nullptr) {
+      continue;
+    }
+
+    auto it = computed_nodes.find(node);
+    if (it == computed_nodes.end()) {
+      computed_nodes.insert(node);
+      continue;
+    }
+
+    // The outputs of the node must keep their names if they are graph outputs or used by a subgraph.
+    if (graph.IsNodeOutputsInGraphOutputs(*node)) {
+      continue;
+    }
+    struct OutputEdge {
+      NodeIndex dst_node;
+      int src_arg_index;
+      int dst_arg_index;
+    };
+    std::vector<OutputEdge> output_edges;
+    bool used_by_subgraph = false;
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      const Node& consumer = edge->GetNode();
+      if (static_cast<size_t>(edge->GetDstArgIndex()) >= consumer.InputDefs().size()) {
+        used_by_subgraph = true;
+        break;
+      }
+      output_edges.push_back({consumer.Index(), edge->GetSrcArgIndex(), edge->GetDstArgIndex()});
+    }
+    if (used_by_subgraph) {
+      continue;
+    }
+
+    // Connect the consumers to the outputs of the equivalent node. AddEdge also replaces their input NodeArgs.
+    // The consumers are visited later in the topological order, so they are compared with their new inputs.
+    const NodeIndex equivalent_node_index = (*it)->Index();
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    for (const auto& edge : output_edges) {
+      graph.AddEdge(equivalent_node_index, edge.dst_node, edge.src_arg_index, edge.dst_arg_index);
+    }
+    graph.RemoveNode(node->Index());
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
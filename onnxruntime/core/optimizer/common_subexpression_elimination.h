@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class CommonSubexpressionElimination
+
+Transformer that traverses the graph top-down and merges the nodes that compute the same values, i.e., nodes with
+the same op type, domain, version, attributes, execution provider and input NodeArgs. The consumers of a merged node
+are connected to the outputs of the first equivalent node. Since consumers are reconnected during the traversal,
+chains of equivalent nodes, such as repeated Shape->Gather->Unsqueeze subgraphs, are merged in one pass.
+
+Each subgraph is processed on its own. Nodes containing subgraphs, nodes producing graph outputs or values used by
+a subgraph, and non-deterministic nodes are not merged.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/compressed_matmul_transformer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include "core/util/math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <tuple>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The initializers of a converted weight, which are shared by all the nodes using the same weight.
+struct CompressedWeightArgs {
+  NodeArg* weight;
+  NodeArg* scales;
+};
+
+}  // namespace
+
+// Rounds to the nearest bfloat16, with ties to even.
+static uint16_t FloatToBFloat16(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if (std::isnan(value)) {
+    return static_cast<uint16_t>((bits >> 16) | 0x40);
+  }
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+// Converts the weight b of shape dims to the storage type. An int8 weight is quantized symmetrically with a scale
+// per column of op(b).
+static CompressedWeightArgs CompressWeight(Graph& graph, const std::string& name, const float* b,
+                                           const std::vector<int64_t>& dims, bool trans_b,
+                                           WeightStorageType storage_type) {
+  const int64_t size = dims[0] * dims[1];
+  CompressedWeightArgs args{nullptr, nullptr};
+
+  if (storage_type == WeightStorageType::kFloat16 || storage_type == WeightStorageType::kBFloat16) {
+    const bool is_half = storage_type == WeightStorageType::kFloat16;
+    std::vector<uint16_t> data(static_cast<size_t>(size));
+    for (int64_t i = 0; i < size; ++i) {
+      data[i] = is_half ? math::floatToHalf(b[i]) : FloatToBFloat16(b[i]);
+    }
+    args.weight = &optimizer_utils::AddInitializer(
+        graph, name + (is_half ? "_fp16" : "_bf16"),
+        is_half ? TensorProto_DataType_FLOAT16 : TensorProto_DataType_BFLOAT16, data, dims);
+    return args;
+  }
+
+  const int64_t N = trans_b ? dims[0] : dims[1];
+  auto column = [&](int64_t i) { return trans_b ? i / dims[1] : i % dims[1]; };
+
+  std::vector<float> scales(static_cast<size_t>(N), 0.f);
+  for (int64_t i = 0; i < size; ++i) {
+    scales[column(i)] = std::max(scales[column(i)], std::abs(b[i]));
+  }
+  for (auto& scale : scales) {
+    scale /= 127.f;
+  }
+
+  std::vector<int8_t> data(static_cast<size_t>(size));
+  for (int64_t i = 0; i < size; ++i) {
+    const float scale = scales[column(i)];
+    data[i] = scale != 0.f ? static_cast<int8_t>(std::max(-127.f, std::min(127.f, std::round(b[i] / scale)))) : 0;
+  }
+
+  args.weight = &optimizer_utils::AddInitializer(graph, name + "_int8", TensorProto_DataType_INT8, data, dims);
+  args.scales = &optimizer_utils::AddInitializer(graph, name + "_scales", TensorProto_DataType_FLOAT, scales, {N});
+  return args;
+}
+
+Status CompressedMatMulTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  if (storage_type_ == WeightStorageType::kFloat) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::map<std::tuple<std::string, bool>, CompressedWeightArgs> converted_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    optimizer_utils::ConstantWeightMatMul match;
+    if (!optimizer_utils::MatchConstantWeightMatMul(graph, node, match) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        match.K * match.N < min_weight_size_) {
+      continue;
+    }
+
+    const bool trans_b = match.trans_b;
+    auto& input_defs = node.MutableInputDefs();
+    const std::string& b_name = input_defs[1]->Name();
+    auto converted = converted_weights.find(std::make_tuple(b_name, trans_b));
+    if (converted == converted_weights.end()) {
+      Initializer b{match.b};
+      std::vector<int64_t> dims{match.b->dims(0), match.b->dims(1)};
+      converted = converted_weights.emplace(std::make_tuple(b_name, trans_b),
+                                            CompressWeight(graph, b_name, b.data<float>(), dims, trans_b,
+                                                           storage_type_))
+                      .first;
+    }
+
+    const CompressedWeightArgs& weight = converted->second;
+    std::vector<NodeArg*> compressed_inputs{input_defs[0], weight.weight};
+    if (weight.scales != nullptr || match.c != nullptr) {
+      compressed_inputs.push_back(weight.scales != nullptr ? weight.scales : &graph.GetOrCreateNodeArg("", nullptr));
+    }
+
+    if (match.c != nullptr) {
+      compressed_inputs.push_back(&optimizer_utils::GetScaledBias(graph, node, match));
+    }
+
+    Node& compressed_matmul = graph.AddNode(graph.GenerateNodeName(node.Name() + "_compressed"),
+                                            "CompressedMatMul",
+                                            "reduced precision weight " + node.OpType(),
+                                            compressed_inputs,
+                                            {node.MutableOutputDefs()[0]}, {}, kMSDomain);
+    compressed_matmul.AddAttribute("transB", static_cast<int64_t>(trans_b));
+    compressed_matmul.AddAttribute("alpha", match.alpha);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    compressed_matmul.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    removed_nodes.push_front(node.Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode.
+  // The float weights are removed with the other unused initializers when the graph is resolved.
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Storage type of large constant MatMul and Gemm weights.
+enum class WeightStorageType {
+  kFloat,
+  kFloat16,
+  kBFloat16,
+  kInt8,  // symmetric, with a scale per output channel
+};
+
+/**
+@Class CompressedMatMulTransformer
+
+Rewrite graph replacing a MatMul or Gemm with a constant float weight of at least min_weight_size elements by a
+CompressedMatMul node, which stores the weight in float16, bfloat16 or int8 and converts it back to float while the
+GEMM packs it.
+
+This changes the results within the precision of the storage type, so it is only applied when requested.
+
+*/
+class CompressedMatMulTransformer : public GraphTransformer {
+ public:
+  CompressedMatMulTransformer(WeightStorageType storage_type,
+                              const std::unordered_set<std::string>& compatible_execution_providers = {},
+                              int64_t min_weight_size = 64 * 1024) noexcept
+      : GraphTransformer("CompressedMatMulTransformer", compatible_execution_providers),
+        storage_type_(storage_type),
+        min_weight_size_(min_weight_size) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+ private:
+  const WeightStorageType storage_type_;
+  const int64_t min_weight_size_;
+};
+
+}  // namespace onnxruntime
@@ -20,11 +20,6 @@ class ConstantFolding : public GraphTransformer {
     GraphTransformer("ConstantFolding", compatible_execution_providers) {}
 
  private:
-  /** Constant folding will not be applied to nodes whose op_type is included in this set.
-      All non-deterministic operators should be included in this set. */
-  const std::unordered_set<std::string> excluded_op_types_ =
-      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
-
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
 
   /** Create a TensorProto that has the same value as the given OrtValue
@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_set>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// The ops supported by the FusedElementwise kernel.
+static bool IsChainOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7}) ||
+         ((graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8}) ||
+           graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8})) &&
+          node.InputDefs().size() == 2) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9});
+}
+
+// Checks that the output of producer is only used by consumer.
+static bool HasOnlyConsumer(const Graph& graph, const Node& producer, const Node& consumer) {
+  if (graph.IsNodeOutputsInGraphOutputs(producer)) {
+    return false;
+  }
+  for (auto it = producer.OutputNodesBegin(); it != producer.OutputNodesEnd(); ++it) {
+    if (&*it != &consumer) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool DimsEqual(const TensorShapeProto_Dimension& lhs, const TensorShapeProto_Dimension& rhs) {
+  if (utils::HasDimValue(lhs) && utils::HasDimValue(rhs)) {
+    return lhs.dim_value() == rhs.dim_value();
+  }
+  return utils::HasDimParam(lhs) && utils::HasDimParam(rhs) && lhs.dim_param() == rhs.dim_param();
+}
+
+// Checks that shape, without its leading dimensions of 1, is a suffix of output_shape, as the kernel requires.
+static bool IsBroadcastSuffix(const TensorShapeProto& shape, const TensorShapeProto& output_shape) {
+  int first = 0;
+  while (first < shape.dim_size() && utils::HasDimValue(shape.dim(first)) && shape.dim(first).dim_value() == 1) {
+    ++first;
+  }
+  const int rank = shape.dim_size() - first;
+  if (rank > output_shape.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < rank; ++i) {
+    if (!DimsEqual(shape.dim(first + i), output_shape.dim(output_shape.dim_size() - rank + i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool IsSameShape(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    if (!DimsEqual(lhs.dim(i), rhs.dim(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks that the inputs of a chain can be broadcast by the FusedElementwise kernel to the output of the chain,
+// and returns them in the order they are first used.
+static bool GetChainInputs(const std::vector<Node*>& chain, std::vector<NodeArg*>& inputs) {
+  const auto* output_shape = chain.back()->OutputDefs()[0]->Shape();
+  if (output_shape == nullptr) {
+    return false;
+  }
+
+  std::unordered_set<const NodeArg*> chain_outputs;
+  for (const auto* node : chain) {
+    chain_outputs.insert(node->OutputDefs()[0]);
+  }
+
+  bool has_output_shape = false;
+  for (auto* node : chain) {
+    for (auto* input : node->MutableInputDefs()) {
+      if (chain_outputs.count(input) != 0 || std::find(inputs.begin(), inputs.end(), input) != inputs.end()) {
+        continue;
+      }
+      const auto* shape = input->Shape();
+      if (shape == nullptr || !IsBroadcastSuffix(*shape, *output_shape)) {
+        return false;
+      }
+      has_output_shape = has_output_shape || IsSameShape(*shape, *output_shape);
+      inputs.push_back(input);
+    }
+  }
+  return has_output_shape;
+}
+
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // The nodes of each chain in topological order, and the chain of each node.
+  std::vector<std::vector<Node*>> chains;
+  std::unordered_map<NodeIndex, size_t> node_chains;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!IsChainOp(node) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        node.OutputDefs()[0]->Type() == nullptr || *node.OutputDefs()[0]->Type() != "tensor(float)") {
+      continue;
+    }
+
+    // The node joins the chains producing its inputs if it is their only consumer. Conv outputs are left to the
+    // Conv fusions and the NCHWc transformer.
+    std::vector<size_t> input_chains;
+    bool uses_conv = false;
+    for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+      const Node& producer = *it;
+      uses_conv = uses_conv || producer.OpType() == "Conv" || producer.OpType() == "FusedConv";
+      auto chain = node_chains.find(producer.Index());
+      if (chain != node_chains.end() &&
+          producer.GetExecutionProviderType() == node.GetExecutionProviderType() &&
+          HasOnlyConsumer(graph, producer, node) &&
+          std::find(input_chains.begin(), input_chains.end(), chain->second) == input_chains.end()) {
+        input_chains.push_back(chain->second);
+      }
+    }
+    if (uses_conv) {
+      continue;
+    }
+
+    // Chains only depend on each other through their last node, so their nodes stay in topological order when
+    // they are concatenated.
+    size_t chain_index = chains.size();
+    if (input_chains.empty()) {
+      chains.emplace_back();
+    } else {
+      chain_index = input_chains[0];
+      for (size_t i = 1; i < input_chains.size(); ++i) {
+        for (auto* chain_node : chains[input_chains[i]]) {
+          chains[chain_index].push_back(chain_node);
+          node_chains[chain_node->Index()] = chain_index;
+        }
+        chains[input_chains[i]].clear();
+      }
+    }
+    chains[chain_index].push_back(&node);
+    node_chains[node.Index()] = chain_index;
+  }
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (const auto& chain : chains) {
+    std::vector<NodeArg*> inputs;
+    if (chain.size() < 2 || !GetChainInputs(chain, inputs)) {
+      continue;
+    }
+
+    // The values of the program are the inputs and then the output of each node of the chain.
+    std::unordered_map<const NodeArg*, int64_t> value_indices;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      value_indices[inputs[i]] = static_cast<int64_t>(i);
+    }
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    std::vector<float> alphas;
+    for (const auto* node : chain) {
+      const auto& input_defs = node->InputDefs();
+      ops.push_back(node->OpType());
+      operands.push_back(value_indices[input_defs[0]]);
+      operands.push_back(input_defs.size() > 1 ? value_indices[input_defs[1]] : -1);
+      const auto* alpha = graph_utils::GetNodeAttribute(*node, "alpha");
+      alphas.push_back(node->OpType() == "LeakyRelu" ? (alpha != nullptr ? alpha->f() : 0.01f) : 0.f);
+      value_indices[node->OutputDefs()[0]] = static_cast<int64_t>(inputs.size() + ops.size() - 1);
+    }
+
+    Node& root = *chain.back();
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused elementwise chain",
+                                     inputs,
+                                     {root.MutableOutputDefs()[0]}, {}, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    fused_node.AddAttribute("alphas", alphas);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(root.GetExecutionProviderType());
+
+    for (auto* node : chain) {
+      removed_nodes.push_front(node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseChainFusion
+
+Rewrite graph fusing chains of float elementwise ops, such as the Mul, Add, Sigmoid and Tanh nodes of GELU variants
+or gating, to a FusedElementwise node, which computes the chain in a single pass over the output.
+
+A chain grows from a node to the nodes producing its inputs while their output has no other consumer, so it is a
+tree of nodes with a single output. It is fused if it has at least two nodes and each of its other inputs has the
+shape of the output, a suffix of it, or a single element, with at least one input of the shape of the output.
+
+*/
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  ElementwiseChainFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
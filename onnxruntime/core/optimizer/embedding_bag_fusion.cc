@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static bool HasRank(const NodeArg& arg, int rank) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() == rank;
+}
+
+// Checks that the bags of the (num_bags, bag_size) indices are known not to be empty.
+static bool HasNonZeroBagSize(const NodeArg& indices) {
+  const auto& bag_size = indices.Shape()->dim(1);
+  return utils::HasDimValue(bag_size) && bag_size.dim_value() > 0;
+}
+
+// Returns the EmbeddingBag mode matching a reduction, or nullptr if it doesn't reduce each bag of rows.
+static const char* GetReduceMode(const Node& reduce) {
+  const char* mode = nullptr;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceSum", {1, 11})) {
+    mode = "sum";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceMean", {1, 11})) {
+    mode = "mean";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceMax", {1, 11})) {
+    mode = "max";
+  } else {
+    return nullptr;
+  }
+
+  // the gathered rows have shape (num_bags, bag_size, embedding_dim), and each bag is reduced over axis 1
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(reduce, "axes", axes) || axes.size() != 1 ||
+      (axes[0] != 1 && axes[0] != -2)) {
+    return nullptr;
+  }
+
+  const auto* keepdims = graph_utils::GetNodeAttribute(reduce, "keepdims");
+  if (keepdims == nullptr || keepdims->i() != 0) {
+    return nullptr;
+  }
+
+  return mode;
+}
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& gather = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(gather, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather, "Gather", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(gather, GetCompatibleExecutionProviders()) ||
+        gather.GetOutputEdgesCount() != 1 ||
+        graph.IsNodeOutputsInGraphOutputs(gather)) {
+      continue;
+    }
+
+    const auto* axis = graph_utils::GetNodeAttribute(gather, "axis");
+    if (axis != nullptr && axis->i() != 0) {
+      continue;
+    }
+
+    // EmbeddingBag supports a float table
+    const auto& gather_inputs = gather.InputDefs();
+    if (gather_inputs[0]->Type() == nullptr || *gather_inputs[0]->Type() != "tensor(float)" ||
+        !HasRank(*gather_inputs[0], 2) || !HasRank(*gather_inputs[1], 2)) {
+      continue;
+    }
+
+    const Node& reduce = *gather.OutputNodesBegin();
+    const char* mode = GetReduceMode(reduce);
+    if (mode == nullptr || reduce.GetExecutionProviderType() != gather.GetExecutionProviderType()) {
+      continue;
+    }
+
+    // The mean and the max of an empty bag are NaN and -inf, where EmbeddingBag gives 0
+    if (std::string(mode) != "sum" && !HasNonZeroBagSize(*gather_inputs[1])) {
+      continue;
+    }
+
+    Node& embedding_bag = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                        "EmbeddingBag",
+                                        "fused Gather and " + reduce.OpType(),
+                                        {gather.MutableInputDefs()[0], gather.MutableInputDefs()[1]},
+                                        {const_cast<NodeArg*>(reduce.OutputDefs()[0])}, {}, kMSDomain);
+    embedding_bag.AddAttribute("mode", std::string(mode));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag.SetExecutionProviderType(gather.GetExecutionProviderType());
+
+    removed_nodes.push_front(gather.Index());
+    removed_nodes.push_front(reduce.Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class EmbeddingBagFusion
+
+Rewrite graph fusing a Gather of the rows of an embedding table followed by a ReduceSum, ReduceMean or ReduceMax
+over each bag of rows to a single EmbeddingBag node, which doesn't materialize the gathered rows.
+
+The Gather must be along axis 0 of a 2-D table with 2-D indices, and the reduction must be over axis 1 of its
+output without keeping the reduced dimension. ReduceMean and ReduceMax are only fused if the bag size is known
+not to be 0, since EmbeddingBag gives 0 for an empty bag.
+
+*/
+class EmbeddingBagFusion : public GraphTransformer {
+ public:
+  EmbeddingBagFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingBagFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -8,6 +8,8 @@
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/conv_activation_fusion.h"
@@ -19,6 +21,11 @@
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/free_dim_override_transformer.h"
 #include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/sparse_matmul_transformer.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/inference_session.h"
 
@@ -99,6 +106,8 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       std::unordered_set<std::string> l1_execution_providers = {};
 
       transformers.emplace_back(onnxruntime::make_unique<ConstantFolding>(l1_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<CommonSubexpressionElimination>(l1_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<TransposeOptimizer>(l1_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<FreeDimensionOverrideTransformer>(free_dimension_overrides));
 
       rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l1_execution_providers);
@@ -116,6 +125,11 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       transformers.emplace_back(onnxruntime::make_unique<MatMulAddFusion>(l2_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<ConvActivationFusion>(l2_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<GeluFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<LayerNormFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<AttentionFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<EmbeddingBagFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<SparseMatMulTransformer>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<ElementwiseChainFusion>(l2_execution_providers));
 #endif
     } break;
 
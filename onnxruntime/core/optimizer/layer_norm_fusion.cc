@@ -0,0 +1,204 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the size of the last dimension of arg, or -1 if it isn't known.
+static int64_t GetLastDimValue(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() == 0) {
+    return -1;
+  }
+  const auto& dim = shape->dim(shape->dim_size() - 1);
+  return utils::HasDimValue(dim) ? dim.dim_value() : -1;
+}
+
+// Checks that node is a ReduceMean of input over its last axis that keeps the reduced dimension.
+static bool IsLastAxisReduceMean(const Node& node, const NodeArg& input) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11}) ||
+      node.InputDefs()[0] != &input) {
+    return false;
+  }
+
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes.size() != 1) {
+    return false;
+  }
+  if (axes[0] != -1) {
+    const auto* shape = input.Shape();
+    if (shape == nullptr || axes[0] != shape->dim_size() - 1) {
+      return false;
+    }
+  }
+
+  const auto* keepdims = graph_utils::GetNodeAttribute(node, "keepdims");
+  return keepdims == nullptr || keepdims->i() != 0;
+}
+
+// Returns the input of a binary node that isn't arg.
+static const NodeArg* GetOtherInput(const Node& node, const NodeArg& arg) {
+  const auto& inputs = node.InputDefs();
+  if (inputs[0] == &arg) {
+    return inputs[1];
+  }
+  return inputs[1] == &arg ? inputs[0] : nullptr;
+}
+
+// LayerNormalization takes a scale and bias with an element for each element of the normalized dimension.
+static bool IsNormalizedDimVector(const NodeArg& arg, int64_t dim_value) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() != 1 || !utils::HasDimValue(shape->dim(0))) {
+    return false;
+  }
+  return dim_value < 0 || shape->dim(0).dim_value() == dim_value;
+}
+
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& mean = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(mean, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(mean, "ReduceMean", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(mean, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the CPU kernel supports float and double
+    NodeArg& x = *mean.MutableInputDefs()[0];
+    if (x.Type() == nullptr || (*x.Type() != "tensor(float)" && *x.Type() != "tensor(double)") ||
+        !IsLastAxisReduceMean(mean, x)) {
+      continue;
+    }
+
+    // d = x - mean(x)
+    const Node* sub = optimizer_utils::GetOnlyConsumer(graph, mean);
+    if (sub == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*sub, "Sub", {7}) ||
+        sub->InputDefs()[0] != &x || sub->InputDefs()[1] != mean.OutputDefs()[0] ||
+        graph.IsNodeOutputsInGraphOutputs(*sub)) {
+      continue;
+    }
+
+    // d is used by the square and the division only. Mul(d, d) has an edge for each of its inputs.
+    const NodeArg& d = *sub->OutputDefs()[0];
+    const Node* square = nullptr;
+    const Node* div = nullptr;
+    bool other_use = false;
+    for (auto it = sub->OutputNodesBegin(); it != sub->OutputNodesEnd(); ++it) {
+      const Node& next = *it;
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(next, "Div", {7}) && next.InputDefs()[0] == &d) {
+        other_use |= div != nullptr;
+        div = &next;
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next, "Mul", {7}) &&
+                 next.InputDefs()[0] == &d && next.InputDefs()[1] == &d) {
+        other_use |= square != nullptr && square != &next;
+        square = &next;
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next, "Pow", {7}) && next.InputDefs()[0] == &d) {
+        float exponent;
+        if (!optimizer_utils::GetScalarConstant(graph, *next.InputDefs()[1], exponent) || exponent != 2.0f) {
+          other_use = true;
+        }
+        other_use |= square != nullptr;
+        square = &next;
+      } else {
+        other_use = true;
+      }
+    }
+    if (other_use || square == nullptr || div == nullptr ||
+        sub->GetOutputEdgesCount() != (square->OpType() == "Mul" ? 3u : 2u) ||
+        square->GetExecutionProviderType() != mean.GetExecutionProviderType() ||
+        div->GetExecutionProviderType() != mean.GetExecutionProviderType()) {
+      continue;
+    }
+
+    // variance = mean(d^2)
+    const Node* variance = optimizer_utils::GetOnlyConsumer(graph, *square);
+    if (variance == nullptr || !IsLastAxisReduceMean(*variance, *square->OutputDefs()[0])) {
+      continue;
+    }
+
+    // std = sqrt(variance + epsilon)
+    const Node* add_epsilon = optimizer_utils::GetOnlyConsumer(graph, *variance);
+    if (add_epsilon == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*add_epsilon, "Add", {7})) {
+      continue;
+    }
+    const NodeArg* epsilon_arg = GetOtherInput(*add_epsilon, *variance->OutputDefs()[0]);
+    float epsilon;
+    if (epsilon_arg == nullptr || !optimizer_utils::GetScalarConstant(graph, *epsilon_arg, epsilon)) {
+      continue;
+    }
+
+    const Node* sqrt = optimizer_utils::GetOnlyConsumer(graph, *add_epsilon);
+    if (sqrt == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*sqrt, "Sqrt", {6})) {
+      continue;
+    }
+
+    // Y = d / std * scale + B
+    if (optimizer_utils::GetOnlyConsumer(graph, *sqrt) != div || div->InputDefs()[1] != sqrt->OutputDefs()[0]) {
+      continue;
+    }
+
+    const Node* mul = optimizer_utils::GetOnlyConsumer(graph, *div);
+    if (mul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", {7})) {
+      continue;
+    }
+
+    const Node* add = optimizer_utils::GetOnlyConsumer(graph, *mul);
+    if (add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*add, "Add", {7})) {
+      continue;
+    }
+
+    const NodeArg* scale = GetOtherInput(*mul, *div->OutputDefs()[0]);
+    const NodeArg* bias = GetOtherInput(*add, *mul->OutputDefs()[0]);
+    const int64_t normalized_dim = GetLastDimValue(x);
+    if (scale == nullptr || bias == nullptr ||
+        !IsNormalizedDimVector(*scale, normalized_dim) || !IsNormalizedDimVector(*bias, normalized_dim)) {
+      continue;
+    }
+
+    Node& layer_norm = graph.AddNode(graph.GenerateNodeName("LayerNormalization"),
+                                     "LayerNormalization",
+                                     "fused LayerNorm subgraphs",
+                                     {&x, const_cast<NodeArg*>(scale), const_cast<NodeArg*>(bias)},
+                                     {const_cast<NodeArg*>(add->OutputDefs()[0])}, {}, kOnnxDomain);
+    layer_norm.AddAttribute("axis", int64_t{-1});
+    layer_norm.AddAttribute("epsilon", epsilon);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm.SetExecutionProviderType(mean.GetExecutionProviderType());
+
+    removed_nodes.push_front(mean.Index());
+    removed_nodes.push_front(sub->Index());
+    removed_nodes.push_front(square->Index());
+    removed_nodes.push_front(variance->Index());
+    removed_nodes.push_front(add_epsilon->Index());
+    removed_nodes.push_front(sqrt->Index());
+    removed_nodes.push_front(div->Index());
+    removed_nodes.push_front(mul->Index());
+    removed_nodes.push_front(add->Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
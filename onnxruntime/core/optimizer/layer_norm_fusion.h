@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LayerNormFusion
+
+Rewrite graph fusing the decomposed layer normalization exported by the training frameworks to a single
+LayerNormalization node.
+
+The subgraph normalizes the last dimension of x:
+d = x - ReduceMean(x), Y = d / Sqrt(ReduceMean(Pow(d, 2)) + epsilon) * scale + B,
+where the square may also be computed as Mul(d, d).
+
+*/
+class LayerNormFusion : public GraphTransformer {
+ public:
+  LayerNormFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
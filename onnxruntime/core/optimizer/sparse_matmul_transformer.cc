@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/sparse_matmul_transformer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+#include <limits>
+#include <map>
+#include <tuple>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Number of consecutive elements of a row of W = B^T in a block of the block-sparse format.
+constexpr int64_t kSparseBlockSize = 8;
+
+namespace {
+
+// A weight in the SparseMatMul format. See the SparseMatMul schema.
+struct SparseWeight {
+  int64_t block_size{1};
+  std::vector<float> values;
+  std::vector<int32_t> col_indices;
+  std::vector<int32_t> row_ptr;
+};
+
+// The initializers of a converted weight, which are shared by all the nodes using the same weight.
+struct SparseWeightArgs {
+  int64_t block_size;
+  NodeArg* values;
+  NodeArg* col_indices;
+  NodeArg* row_ptr;
+};
+
+}  // namespace
+
+// Converts the rows of w (N, K) to blocks of block_size elements, keeping the blocks with a nonzero element.
+static SparseWeight ToSparseWeight(const std::vector<float>& w, int64_t N, int64_t K, int64_t block_size,
+                                   float alpha) {
+  SparseWeight sparse;
+  sparse.block_size = block_size;
+  sparse.row_ptr.reserve(static_cast<size_t>(N + 1));
+  sparse.row_ptr.push_back(0);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t k = 0; k < K; k += block_size) {
+      const float* block = w.data() + n * K + k;
+      if (std::any_of(block, block + block_size, [](float v) { return v != 0.f; })) {
+        for (int64_t i = 0; i < block_size; ++i) {
+          sparse.values.push_back(alpha * block[i]);
+        }
+        sparse.col_indices.push_back(static_cast<int32_t>(k / block_size));
+      }
+    }
+    sparse.row_ptr.push_back(static_cast<int32_t>(sparse.col_indices.size()));
+  }
+  return sparse;
+}
+
+Status SparseMatMulTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::map<std::tuple<std::string, bool, float>, SparseWeightArgs> converted_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    optimizer_utils::ConstantWeightMatMul match;
+    if (!optimizer_utils::MatchConstantWeightMatMul(graph, node, match) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const bool trans_b = match.trans_b;
+    const float alpha = match.alpha;
+    const int64_t K = match.K;
+    const int64_t N = match.N;
+    if (K == 0 || N == 0 || N * K > std::numeric_limits<int32_t>::max()) {
+      continue;
+    }
+
+    auto& input_defs = node.MutableInputDefs();
+    const std::string& b_name = input_defs[1]->Name();
+    auto converted = converted_weights.find(std::make_tuple(b_name, trans_b, alpha));
+    if (converted == converted_weights.end()) {
+      // Lay out the weight as W = B^T so the rows of W are the output columns.
+      Initializer b{match.b};
+      const float* b_data = b.data<float>();
+      std::vector<float> w(static_cast<size_t>(N * K));
+      for (int64_t n = 0; n < N; ++n) {
+        for (int64_t k = 0; k < K; ++k) {
+          w[n * K + k] = trans_b ? b_data[n * K + k] : b_data[k * N + n];
+        }
+      }
+
+      const int64_t nnz = std::count_if(w.begin(), w.end(), [](float v) { return v != 0.f; });
+      int64_t nonzero_blocks = 0;
+      if (K % kSparseBlockSize == 0) {
+        for (int64_t i = 0; i < N * K; i += kSparseBlockSize) {
+          nonzero_blocks += std::any_of(w.data() + i, w.data() + i + kSparseBlockSize,
+                                        [](float v) { return v != 0.f; });
+        }
+      }
+
+      int64_t block_size = 0;
+      if (K % kSparseBlockSize == 0 && nonzero_blocks <= max_density_ * (N * K / kSparseBlockSize)) {
+        block_size = kSparseBlockSize;
+      } else if (nnz <= max_density_ * (N * K)) {
+        block_size = 1;
+      } else {
+        continue;
+      }
+
+      SparseWeight sparse = ToSparseWeight(w, N, K, block_size, alpha);
+      const auto num_blocks = static_cast<int64_t>(sparse.col_indices.size());
+      SparseWeightArgs args{
+          block_size,
+          &optimizer_utils::AddInitializer(graph, b_name + "_sparse_values", TensorProto_DataType_FLOAT,
+                                           sparse.values, {num_blocks, block_size}),
+          &optimizer_utils::AddInitializer(graph, b_name + "_sparse_col_indices", TensorProto_DataType_INT32,
+                                           sparse.col_indices, {num_blocks}),
+          &optimizer_utils::AddInitializer(graph, b_name + "_sparse_row_ptr", TensorProto_DataType_INT32,
+                                           sparse.row_ptr, {N + 1})};
+      converted = converted_weights.emplace(std::make_tuple(b_name, trans_b, alpha), args).first;
+    }
+
+    const SparseWeightArgs& weight = converted->second;
+    std::vector<NodeArg*> sparse_inputs{input_defs[0], weight.values, weight.col_indices, weight.row_ptr};
+    if (match.c != nullptr) {
+      sparse_inputs.push_back(&optimizer_utils::GetScaledBias(graph, node, match));
+    }
+
+    Node& sparse_matmul = graph.AddNode(graph.GenerateNodeName(node.Name() + "_sparse"),
+                                        "SparseMatMul",
+                                        "sparse weight " + node.OpType(),
+                                        sparse_inputs,
+                                        {node.MutableOutputDefs()[0]}, {}, kMSDomain);
+    sparse_matmul.AddAttribute("dense_shape", std::vector<int64_t>{K, N});
+    sparse_matmul.AddAttribute("block_size", weight.block_size);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    sparse_matmul.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    removed_nodes.push_front(node.Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode.
+  // The dense weights are removed with the other unused initializers when the graph is resolved.
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
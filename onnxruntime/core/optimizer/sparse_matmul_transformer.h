@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SparseMatMulTransformer
+
+Rewrite graph replacing a MatMul or Gemm with a sparse constant float weight by a SparseMatMul node, which stores
+only the nonzero blocks of the weight.
+
+The weight is converted to blocks of consecutive elements of a row of its transpose if at most max_density of the
+blocks have a nonzero element, and otherwise to CSR if at most max_density of its elements are nonzero. Weights
+that are denser than that are left to the dense kernels, which are faster on them.
+
+*/
+class SparseMatMulTransformer : public GraphTransformer {
+ public:
+  SparseMatMulTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                          float max_density = 0.25f) noexcept
+      : GraphTransformer("SparseMatMulTransformer", compatible_execution_providers), max_density_(max_density) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+ private:
+  const float max_density_;
+};
+
+}  // namespace onnxruntime
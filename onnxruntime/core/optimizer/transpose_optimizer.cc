@@ -0,0 +1,539 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/optimizer/initializer.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+#include <unordered_set>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The rewrite of a consumer of Transposes that moves the Transposes below it.
+struct PushDown {
+  // the Transposes feeding the consumer, which are removed
+  std::vector<Node*> transposes;
+  // the inputs of the consumer that are replaced
+  std::vector<std::pair<size_t, NodeArg*>> inputs;
+  // the float constant inputs of the consumer that are transposed by the inverse permutation
+  std::vector<std::pair<size_t, const TensorProto*>> constants;
+  // the attributes of the consumer that are remapped to the layout of its new inputs
+  std::vector<AttributeProto> attributes;
+  // the permutation of the Transpose added after the consumer, empty if the output keeps its layout
+  std::vector<int64_t> output_perm;
+};
+
+}  // namespace
+
+// Reads the permutation of a Transpose, which reverses the dimensions if the perm attribute isn't given.
+static bool GetPerm(const Node& transpose, std::vector<int64_t>& perm) {
+  if (!graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm)) {
+    const auto* shape = transpose.InputDefs()[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    perm.resize(shape->dim_size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+      perm[i] = static_cast<int64_t>(perm.size() - 1 - i);
+    }
+  }
+
+  std::vector<bool> seen(perm.size(), false);
+  for (auto axis : perm) {
+    if (axis < 0 || axis >= static_cast<int64_t>(perm.size()) || seen[axis]) {
+      return false;
+    }
+    seen[axis] = true;
+  }
+  return true;
+}
+
+static bool IsIdentityPerm(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<int64_t> InvertPerm(const std::vector<int64_t>& perm) {
+  std::vector<int64_t> inverse(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    inverse[perm[i]] = static_cast<int64_t>(i);
+  }
+  return inverse;
+}
+
+// Transpose(Transpose(x, first), second) is Transpose(x, ComposePerm(first, second)).
+static std::vector<int64_t> ComposePerm(const std::vector<int64_t>& first, const std::vector<int64_t>& second) {
+  std::vector<int64_t> composed(second.size());
+  for (size_t i = 0; i < second.size(); ++i) {
+    composed[i] = first[second[i]];
+  }
+  return composed;
+}
+
+static AttributeProto MakeAttribute(const std::string& name, int64_t value) {
+  AttributeProto attr;
+  attr.set_name(name);
+  attr.set_type(AttributeProto_AttributeType_INT);
+  attr.set_i(value);
+  return attr;
+}
+
+static AttributeProto MakeAttribute(const std::string& name, const std::vector<int64_t>& values) {
+  AttributeProto attr;
+  attr.set_name(name);
+  attr.set_type(AttributeProto_AttributeType_INTS);
+  for (auto value : values) {
+    attr.add_ints(value);
+  }
+  return attr;
+}
+
+static bool IsUnaryElementwise(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Elu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Selu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softplus", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softsign", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Floor", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Ceil", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Round", {11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sign", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sin", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cos", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Not", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "IsNaN", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Identity", {1});
+}
+
+// Elementwise ops with multidirectional broadcasting of their inputs.
+static bool IsBroadcastElementwise(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pow", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "PRelu", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mean", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Equal", {7, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Less", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Greater", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "And", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Or", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Xor", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9});
+}
+
+static bool IsReduction(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSumSquare", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMax", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMin", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceProd", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL1", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL2", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSum", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSumExp", {1, 11});
+}
+
+// Returns the node producing input index of node, or nullptr if the input is a graph input or an initializer.
+static Node* GetInputNode(Graph& graph, const Node& node, int index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == index) {
+      return graph.GetNode(it->GetNode().Index());
+    }
+  }
+  return nullptr;
+}
+
+// Returns the node consuming all the uses of the output of node, or nullptr if the output has several consumers,
+// is a graph output or is used by a subgraph.
+static Node* GetOnlyConsumer(Graph& graph, const Node& node) {
+  if (graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+  const Node* consumer = nullptr;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    const Node& next = it->GetNode();
+    if ((consumer != nullptr && consumer != &next) ||
+        static_cast<size_t>(it->GetDstArgIndex()) >= next.InputDefs().size()) {
+      return nullptr;
+    }
+    consumer = &next;
+  }
+  return consumer != nullptr ? graph.GetNode(consumer->Index()) : nullptr;
+}
+
+// Adds the constant of a float initializer broadcast to the rank of perm and transposed by perm.
+static NodeArg& AddTransposedConstant(Graph& graph, const TensorProto& tensor_proto,
+                                      const std::vector<int64_t>& perm) {
+  const size_t rank = perm.size();
+  std::vector<int64_t> dims(rank - tensor_proto.dims_size(), 1);
+  dims.insert(dims.end(), tensor_proto.dims().begin(), tensor_proto.dims().end());
+  std::vector<int64_t> strides(rank);
+  int64_t stride = 1;
+  for (size_t i = rank; i-- > 0;) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+
+  TensorProto transposed_proto;
+  transposed_proto.set_name(graph.GenerateNodeArgName(tensor_proto.name() + "_transposed"));
+  transposed_proto.set_data_type(TensorProto_DataType_FLOAT);
+  std::vector<int64_t> transposed_dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    transposed_dims[i] = dims[perm[i]];
+    transposed_proto.add_dims(transposed_dims[i]);
+  }
+
+  Initializer constant{&tensor_proto};
+  const float* data = constant.data<float>();
+  std::vector<float> transposed(static_cast<size_t>(constant.size()));
+  std::vector<int64_t> index(rank, 0);
+  for (auto& value : transposed) {
+    int64_t offset = 0;
+    for (size_t i = 0; i < rank; ++i) {
+      offset += index[i] * strides[perm[i]];
+    }
+    value = data[offset];
+    for (size_t i = rank; i-- > 0;) {
+      if (++index[i] < transposed_dims[i]) {
+        break;
+      }
+      index[i] = 0;
+    }
+  }
+  transposed_proto.set_raw_data(transposed.data(), transposed.size() * sizeof(float));
+
+  graph.AddInitializedTensor(transposed_proto);
+  return graph.GetOrCreateNodeArg(transposed_proto.name(), nullptr);
+}
+
+class TransposeOptimizerPass {
+ public:
+  TransposeOptimizerPass(Graph& graph, const std::unordered_set<std::string>& compatible_providers)
+      : graph_(graph), compatible_providers_(compatible_providers) {}
+
+  // Rewrites the graph once for each Transpose that can be removed, merged or pushed down.
+  bool Run();
+
+ private:
+  // Checks that node is a Transpose that can be rewritten in this pass and reads its permutation.
+  bool IsTransposeToRewrite(const Node& node, std::vector<int64_t>& perm) const;
+
+  bool RemoveIdentity(Node& transpose);
+  bool PlanInputs(Node& consumer, const std::vector<int64_t>& perm, bool allow_constants, PushDown& push_down);
+  bool PlanReduction(Node& consumer, Node& transpose, const std::vector<int64_t>& perm, PushDown& push_down);
+  void ApplyPushDown(Node& consumer, const PushDown& push_down);
+
+  Graph& graph_;
+  const std::unordered_set<std::string>& compatible_providers_;
+
+  // The nodes rewritten in this pass, whose edges aren't up to date until the graph is resolved.
+  std::unordered_set<NodeIndex> rewritten_nodes_;
+};
+
+bool TransposeOptimizerPass::IsTransposeToRewrite(const Node& node, std::vector<int64_t>& perm) const {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) &&
+         graph_utils::IsSupportedProvider(node, compatible_providers_) &&
+         rewritten_nodes_.count(node.Index()) == 0 &&
+         GetPerm(node, perm);
+}
+
+// Connects the consumers of a Transpose with an identity permutation to its input.
+bool TransposeOptimizerPass::RemoveIdentity(Node& transpose) {
+  NodeArg* input = transpose.MutableInputDefs()[0];
+  NodeArg* output = transpose.MutableOutputDefs()[0];
+
+  // A graph output keeps its name, so the producer of the input writes it instead.
+  Node* producer = nullptr;
+  if (graph_.IsNodeOutputsInGraphOutputs(transpose)) {
+    producer = GetInputNode(graph_, transpose, 0);
+    if (producer == nullptr || rewritten_nodes_.count(producer->Index()) != 0 ||
+        GetOnlyConsumer(graph_, *producer) != &transpose) {
+      return false;
+    }
+  }
+
+  std::vector<Node*> consumers;
+  for (auto it = transpose.OutputEdgesBegin(); it != transpose.OutputEdgesEnd(); ++it) {
+    if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+      return false;
+    }
+    consumers.push_back(graph_.GetNode(it->GetNode().Index()));
+  }
+
+  graph_utils::RemoveNodeOutputEdges(graph_, transpose);
+  if (producer != nullptr) {
+    graph_utils::RemoveNodeOutputEdges(graph_, *producer);
+    for (auto*& output_def : producer->MutableOutputDefs()) {
+      if (output_def == input) {
+        output_def = output;
+      }
+    }
+    rewritten_nodes_.insert(producer->Index());
+  } else {
+    for (auto* consumer : consumers) {
+      for (auto*& input_def : consumer->MutableInputDefs()) {
+        if (input_def == output) {
+          input_def = input;
+        }
+      }
+    }
+  }
+  for (auto* consumer : consumers) {
+    rewritten_nodes_.insert(consumer->Index());
+  }
+  graph_.RemoveNode(transpose.Index());
+  return true;
+}
+
+// Plans replacing each input of consumer by the input of the Transpose producing it. The Transposes must have
+// the permutation perm and no other consumer. Constants with a single element are kept as they are, and other
+// float constants are transposed if allow_constants is set.
+bool TransposeOptimizerPass::PlanInputs(Node& consumer, const std::vector<int64_t>& perm, bool allow_constants,
+                                        PushDown& push_down) {
+  const auto& input_defs = consumer.InputDefs();
+  for (int i = 0; i < static_cast<int>(input_defs.size()); ++i) {
+    const NodeArg& input = *input_defs[i];
+    if (!input.Exists()) {
+      continue;
+    }
+
+    Node* producer = GetInputNode(graph_, consumer, i);
+    if (producer != nullptr) {
+      std::vector<int64_t> input_perm;
+      if (!IsTransposeToRewrite(*producer, input_perm) || input_perm != perm ||
+          producer->GetExecutionProviderType() != consumer.GetExecutionProviderType() ||
+          GetOnlyConsumer(graph_, *producer) != &consumer) {
+        return false;
+      }
+      if (std::find(push_down.transposes.begin(), push_down.transposes.end(), producer) ==
+          push_down.transposes.end()) {
+        push_down.transposes.push_back(producer);
+      }
+      push_down.inputs.emplace_back(i, producer->MutableInputDefs()[0]);
+      continue;
+    }
+
+    // a constant broadcast to the rank of the other inputs
+    const TensorProto* constant = graph_utils::GetConstantInitializer(graph_, input.Name());
+    if (!allow_constants || constant == nullptr || constant->dims_size() > static_cast<int>(perm.size())) {
+      return false;
+    }
+    int64_t size = 1;
+    for (auto dim : constant->dims()) {
+      size *= dim;
+    }
+    if (size != 1) {
+      if (constant->data_type() != TensorProto_DataType_FLOAT) {
+        return false;
+      }
+      push_down.constants.emplace_back(i, constant);
+    }
+  }
+  return true;
+}
+
+bool TransposeOptimizerPass::PlanReduction(Node& consumer, Node& transpose, const std::vector<int64_t>& perm,
+                                           PushDown& push_down) {
+  push_down.transposes.push_back(&transpose);
+  push_down.inputs.emplace_back(0, transpose.MutableInputDefs()[0]);
+
+  // a reduction over all the axes doesn't depend on the layout, and its output either is a scalar or has
+  // dimensions of 1 only
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(consumer, "axes", axes)) {
+    return true;
+  }
+
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  std::vector<bool> reduced(perm.size(), false);
+  std::vector<int64_t> new_axes;
+  for (auto axis : axes) {
+    if (axis < -rank || axis >= rank) {
+      return false;
+    }
+    if (axis < 0) {
+      axis += rank;
+    }
+    reduced[axis] = true;
+    new_axes.push_back(perm[axis]);
+  }
+  std::sort(new_axes.begin(), new_axes.end());
+  push_down.attributes.push_back(MakeAttribute("axes", new_axes));
+
+  const auto* keepdims = graph_utils::GetNodeAttribute(consumer, "keepdims");
+  if (keepdims == nullptr || keepdims->i() != 0) {
+    push_down.output_perm = perm;
+    return true;
+  }
+
+  // Without the reduced dimensions, the output dimensions are the kept input dimensions in the order of perm.
+  std::vector<int64_t> kept_input_axes;
+  for (int64_t axis = 0; axis < rank; ++axis) {
+    if (std::find(new_axes.begin(), new_axes.end(), axis) == new_axes.end()) {
+      kept_input_axes.push_back(axis);
+    }
+  }
+  for (int64_t i = 0; i < rank; ++i) {
+    if (!reduced[i]) {
+      push_down.output_perm.push_back(
+          std::find(kept_input_axes.begin(), kept_input_axes.end(), perm[i]) - kept_input_axes.begin());
+    }
+  }
+  return true;
+}
+
+void TransposeOptimizerPass::ApplyPushDown(Node& consumer, const PushDown& push_down) {
+  for (auto* transpose : push_down.transposes) {
+    graph_utils::RemoveNodeOutputEdges(graph_, *transpose);
+  }
+
+  auto& input_defs = consumer.MutableInputDefs();
+  for (const auto& input : push_down.inputs) {
+    input_defs[input.first] = input.second;
+  }
+  if (!push_down.constants.empty()) {
+    const auto inverse_perm = InvertPerm(push_down.output_perm);
+    for (const auto& constant : push_down.constants) {
+      input_defs[constant.first] = &AddTransposedConstant(graph_, *constant.second, inverse_perm);
+    }
+  }
+  for (const auto& attr : push_down.attributes) {
+    consumer.AddAttribute(attr.name(), attr);
+  }
+
+  if (!push_down.output_perm.empty() && !IsIdentityPerm(push_down.output_perm)) {
+    NodeArg* output = consumer.MutableOutputDefs()[0];
+    graph_utils::RemoveNodeOutputEdges(graph_, consumer);
+    NodeArg& transposed_output = graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(output->Name()), nullptr);
+    consumer.MutableOutputDefs()[0] = &transposed_output;
+
+    Node& transpose = graph_.AddNode(graph_.GenerateNodeName("Transpose"),
+                                     "Transpose",
+                                     "Transpose pushed below " + consumer.OpType(),
+                                     {&transposed_output},
+                                     {output});
+    transpose.AddAttribute("perm", push_down.output_perm);
+    transpose.SetExecutionProviderType(consumer.GetExecutionProviderType());
+    rewritten_nodes_.insert(transpose.Index());
+  }
+
+  for (auto* transpose : push_down.transposes) {
+    graph_.RemoveNode(transpose->Index());
+  }
+  rewritten_nodes_.insert(consumer.Index());
+}
+
+bool TransposeOptimizerPass::Run() {
+  GraphViewer graph_viewer(graph_);
+  const auto node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  bool modified = false;
+
+  for (auto node_index : node_topology_list) {
+    auto* node = graph_.GetNode(node_index);
+    std::vector<int64_t> perm;
+    if (node == nullptr || !IsTransposeToRewrite(*node, perm)) {
+      continue;
+    }
+
+    if (IsIdentityPerm(perm)) {
+      modified |= RemoveIdentity(*node);
+      continue;
+    }
+
+    Node* consumer = GetOnlyConsumer(graph_, *node);
+    if (consumer == nullptr || rewritten_nodes_.count(consumer->Index()) != 0 ||
+        consumer->OutputDefs().size() != 1 ||
+        consumer->GetExecutionProviderType() != node->GetExecutionProviderType()) {
+      continue;
+    }
+
+    // Transpose(Transpose(x)) is a single Transpose, which is removed in the next pass if it is an identity
+    std::vector<int64_t> consumer_perm;
+    if (IsTransposeToRewrite(*consumer, consumer_perm)) {
+      graph_utils::RemoveNodeOutputEdges(graph_, *node);
+      consumer->MutableInputDefs()[0] = node->MutableInputDefs()[0];
+      consumer->AddAttribute("perm", ComposePerm(perm, consumer_perm));
+      graph_.RemoveNode(node->Index());
+      rewritten_nodes_.insert(consumer->Index());
+      modified = true;
+      continue;
+    }
+
+    PushDown push_down;
+    bool can_push = false;
+    if (IsUnaryElementwise(*consumer)) {
+      // the other inputs of Clip are scalars
+      can_push = consumer->InputDefs()[0] == node->OutputDefs()[0];
+      push_down.transposes.push_back(node);
+      push_down.inputs.emplace_back(0, node->MutableInputDefs()[0]);
+      push_down.output_perm = perm;
+    } else if (IsBroadcastElementwise(*consumer)) {
+      can_push = PlanInputs(*consumer, perm, true, push_down);
+      push_down.output_perm = perm;
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*consumer, "Concat", {4, 11})) {
+      const auto* axis_attr = graph_utils::GetNodeAttribute(*consumer, "axis");
+      const int64_t rank = static_cast<int64_t>(perm.size());
+      if (axis_attr != nullptr && axis_attr->i() >= -rank && axis_attr->i() < rank) {
+        const int64_t axis = axis_attr->i() < 0 ? axis_attr->i() + rank : axis_attr->i();
+        can_push = PlanInputs(*consumer, perm, false, push_down);
+        push_down.attributes.push_back(MakeAttribute("axis", perm[axis]));
+        push_down.output_perm = perm;
+      }
+    } else if (IsReduction(*consumer)) {
+      can_push = PlanReduction(*consumer, *node, perm, push_down);
+    }
+
+    if (can_push) {
+      ApplyPushDown(*consumer, push_down);
+      modified = true;
+    }
+  }
+
+  return modified;
+}
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  {
+    GraphViewer graph_viewer(graph);
+    for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+      ORT_RETURN_IF_ERROR(Recurse(*graph.GetNode(node_index), modified, graph_level));
+    }
+  }
+
+  // Each pass moves Transposes further down or removes them, so this terminates. The graph is resolved between
+  // the passes to update the edges and the types of the values that changed layout.
+  while (TransposeOptimizerPass(graph, GetCompatibleExecutionProviders()).Run()) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Rewrite graph moving Transpose nodes towards the graph outputs so that they meet and cancel, which removes the
+NHWC/NCHW Transposes that models converted from TensorFlow have around each layer.
+
+A Transpose is pushed below its only consumer if that consumer doesn't depend on the layout of its input:
+- unary elementwise ops and activations;
+- broadcasting elementwise ops whose other inputs are Transposes with the same permutation, single element
+  constants or float constants, which are transposed in the graph;
+- Concat of Transposes with the same permutation, with the axis remapped;
+- reductions, with the axes remapped, and keepdims=0 handled by adjusting the permutation of the output.
+Consecutive Transposes are merged into one and Transposes with an identity permutation are removed.
+
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
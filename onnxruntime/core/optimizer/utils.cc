@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/graph/graph_utils.h"
+#include <unordered_set>
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace optimizer_utils {
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : default_value;
+}
+
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->f() : default_value;
+}
+
+bool IsOperationDeterministic(const std::string& op_type) {
+  static const std::unordered_set<std::string> non_deterministic_op_types =
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+  return non_deterministic_op_types.find(op_type) == non_deterministic_op_types.end();
+}
+
+const Node* GetOnlyConsumer(const Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+  const Node& next = *node.OutputNodesBegin();
+  return next.GetExecutionProviderType() == node.GetExecutionProviderType() ? &next : nullptr;
+}
+
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, float& value) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr) {
+    return false;
+  }
+
+  Initializer init_const{tensor_proto};
+  if (init_const.size() != 1) {
+    return false;
+  }
+  if (tensor_proto->data_type() == TensorProto_DataType_FLOAT) {
+    value = *init_const.data<float>();
+  } else if (tensor_proto->data_type() == TensorProto_DataType_DOUBLE) {
+    value = static_cast<float>(*init_const.data<double>());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool MatchConstantWeightMatMul(const Graph& graph, const Node& node, ConstantWeightMatMul& match) {
+  const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+  if (!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  if (input_defs[0]->Type() == nullptr || *input_defs[0]->Type() != "tensor(float)") {
+    return false;
+  }
+
+  match = ConstantWeightMatMul{};
+  match.b = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+  if (match.b == nullptr || match.b->data_type() != TensorProto_DataType_FLOAT || match.b->dims_size() != 2) {
+    return false;
+  }
+
+  if (is_gemm) {
+    if (GetIntAttribute(node, "transA", 0) != 0) {
+      return false;
+    }
+    match.trans_b = GetIntAttribute(node, "transB", 0) != 0;
+    match.alpha = GetFloatAttribute(node, "alpha", 1.f);
+    match.beta = GetFloatAttribute(node, "beta", 1.f);
+    if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+      match.c = graph_utils::GetConstantInitializer(graph, input_defs[2]->Name());
+      if (match.c == nullptr || match.c->data_type() != TensorProto_DataType_FLOAT) {
+        return false;
+      }
+    }
+  }
+
+  match.K = match.b->dims(match.trans_b ? 1 : 0);
+  match.N = match.b->dims(match.trans_b ? 0 : 1);
+
+  // The bias must have shape (N) or (1, N).
+  if (match.c != nullptr) {
+    int64_t c_size = 1;
+    for (auto dim : match.c->dims()) {
+      c_size *= dim;
+    }
+    const int c_rank = match.c->dims_size();
+    if (c_size != match.N || c_rank < 1 || c_rank > 2 || match.c->dims(c_rank - 1) != match.N) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+NodeArg& GetScaledBias(Graph& graph, Node& node, const ConstantWeightMatMul& match) {
+  NodeArg& c_arg = *node.MutableInputDefs()[2];
+  if (match.beta == 1.f && match.c->dims_size() == 1) {
+    return c_arg;
+  }
+
+  Initializer c{match.c};
+  const float* c_data = c.data<float>();
+  std::vector<float> bias(c_data, c_data + match.N);
+  for (auto& v : bias) {
+    v *= match.beta;
+  }
+  return AddInitializer(graph, c_arg.Name() + "_bias", TensorProto_DataType_FLOAT, bias, {match.N});
+}
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
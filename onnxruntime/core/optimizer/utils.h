@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/graph/onnx_protobuf.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace optimizer_utils {
+
+/** Returns the value of an int attribute of the node, or default_value if the node doesn't have it. */
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value);
+
+/** Returns the value of a float attribute of the node, or default_value if the node doesn't have it. */
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value);
+
+/** Checks if the operator always computes the same outputs from the same inputs. Transformers such as
+    ConstantFolding and CommonSubexpressionElimination must not replace non-deterministic nodes. */
+bool IsOperationDeterministic(const std::string& op_type);
+
+/** Returns the node consuming the output of node if it is the only use of the output and runs on the same
+    execution provider as node, or nullptr otherwise. */
+const Node* GetOnlyConsumer(const Graph& graph, const Node& node);
+
+/** Reads a constant with a single float or double element as a float. */
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, float& value);
+
+/** Adds an initializer with the given data and a unique name derived from name, and returns its NodeArg. */
+template <typename T>
+NodeArg& AddInitializer(Graph& graph, const std::string& name, ONNX_NAMESPACE::TensorProto_DataType data_type,
+                        const std::vector<T>& data, const std::vector<int64_t>& dims) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(name));
+  tensor_proto.set_data_type(data_type);
+  tensor_proto.set_raw_data(data.data(), data.size() * sizeof(T));
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  graph.AddInitializedTensor(tensor_proto);
+  return graph.GetOrCreateNodeArg(tensor_proto.name(), nullptr);
+}
+
+/** A float MatMul or Gemm computing Y = alpha * A * op(B) + beta * C with a constant 2-D weight B and an optional
+    constant bias C of N elements, which transformers can replace by a kernel that prepacks the weight. */
+struct ConstantWeightMatMul {
+  const ONNX_NAMESPACE::TensorProto* b{nullptr};
+  const ONNX_NAMESPACE::TensorProto* c{nullptr};
+  bool trans_b{false};
+  float alpha{1.f};
+  float beta{1.f};
+  int64_t K{0};
+  int64_t N{0};
+};
+
+/** Checks if the node is a MatMul, or a Gemm without transA, with a constant weight and a bias that can be
+    applied to each row of the output. Fills in match if it is. */
+bool MatchConstantWeightMatMul(const Graph& graph, const Node& node, ConstantWeightMatMul& match);
+
+/** Returns the bias input of N elements for a matched Gemm: its C input if it is 1-D and beta is 1,
+    or else a new initializer holding beta * C. */
+NodeArg& GetScaledBias(Graph& graph, Node& node, const ConstantWeightMatMul& match);
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_elimination.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+#include <sstream>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static void AppendJsonString(std::ostringstream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        out << c;
+        break;
+    }
+  }
+  out << '"';
+}
+
+static std::string LabelsToJson(const Node& zipmap) {
+  std::ostringstream out;
+  out << '[';
+
+  const auto* strings = graph_utils::GetNodeAttribute(zipmap, "classlabels_strings");
+  const auto* ints = graph_utils::GetNodeAttribute(zipmap, "classlabels_int64s");
+  if (strings != nullptr && strings->strings_size() > 0) {
+    for (int i = 0; i < strings->strings_size(); i++) {
+      if (i > 0) out << ',';
+      AppendJsonString(out, strings->strings(i));
+    }
+  } else if (ints != nullptr) {
+    for (int i = 0; i < ints->ints_size(); i++) {
+      if (i > 0) out << ',';
+      out << ints->ints(i);
+    }
+  }
+
+  out << ']';
+  return out.str();
+}
+
+Status ZipMapElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  // Changing the type of a subgraph output would break the node consuming it in the parent graph.
+  if (graph.IsSubgraph()) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::vector<NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& zipmap = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(zipmap, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(zipmap, "ZipMap", {1}, kMLDomain) ||
+        zipmap.GetOutputEdgesCount() != 0 ||
+        !graph.IsNodeOutputsInGraphOutputs(zipmap)) {
+      continue;
+    }
+
+    NodeArg* probabilities = zipmap.MutableInputDefs()[0];
+    NodeArg* output = zipmap.MutableOutputDefs()[0];
+
+    if (label_metadata_ != nullptr) {
+      (*label_metadata_)[output->Name() + ".labels"] = LabelsToJson(zipmap);
+    }
+
+    // The output keeps its name but now holds a tensor, so let the type be
+    // inferred again from the Identity node when the graph is resolved.
+    output->ClearType();
+
+    Node& identity = graph.AddNode(graph.GenerateNodeName(zipmap.Name() + "_bypass"),
+                                   "Identity",
+                                   "ZipMap bypassed to return dense probabilities",
+                                   {probabilities},
+                                   {output});
+    identity.SetExecutionProviderType(zipmap.GetExecutionProviderType());
+
+    removed_nodes.push_back(zipmap.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapElimination
+
+Bypass ZipMap nodes that produce a graph output so the output carries the dense
+[N, C] probability tensor instead of a sequence of maps (one heap allocated map
+per row). The ZipMap node is replaced by an Identity node so the graph output
+keeps its name.
+
+The class labels that ZipMap would have used as keys are shared by every row.
+If label_metadata is provided they are recorded in it as a JSON array under the
+key "<output name>.labels".
+*/
+class ZipMapElimination : public GraphTransformer {
+ public:
+  explicit ZipMapElimination(std::unordered_map<std::string, std::string>* label_metadata = nullptr) noexcept
+      : GraphTransformer("ZipMapElimination"), label_metadata_(label_metadata) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  std::unordered_map<std::string, std::string>* label_metadata_;
+};
+
+}  // namespace onnxruntime
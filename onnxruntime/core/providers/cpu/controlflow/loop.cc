@@ -10,11 +10,13 @@
 #endif
 
 #include "core/providers/cpu/controlflow/loop.h"
+#include "core/providers/cpu/controlflow/scan_utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
 #include "core/framework/allocator.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
@@ -130,6 +132,38 @@ struct Loop::Info {
       auto& output = subgraph_outputs[i];
       subgraph_output_names.push_back(output->Name());
     }
+
+    // check if the 'cond' output is the 'cond' input, either directly or via an Identity node.
+    const auto& cond_input_name = subgraph_input_names[1];
+    const auto& cond_output_name = subgraph_output_names[0];
+    condition_passthrough = cond_input_name == cond_output_name;
+
+    output_producers.resize(num_subgraph_outputs, nullptr);
+    for (const auto& subgraph_node : subgraph.Nodes()) {
+      for (const auto* output_def : subgraph_node.OutputDefs()) {
+        for (int i = 0; i < num_subgraph_outputs; ++i) {
+          if (output_def->Exists() && output_def->Name() == subgraph_output_names[i]) {
+            output_producers[i] = &subgraph_node;
+          }
+        }
+      }
+    }
+
+    // check if a loop carried variable input is returned as an output. The loop carried variables then can't
+    // alternate between two buffers, as the output would alias a buffer that a later iteration overwrites.
+    loop_carried_var_passthrough = false;
+    for (int i = 1; i < num_subgraph_outputs; ++i) {
+      if (std::find(subgraph_input_names.cbegin() + 2, subgraph_input_names.cend(), subgraph_output_names[i]) !=
+          subgraph_input_names.cend()) {
+        loop_carried_var_passthrough = true;
+      }
+    }
+
+    const auto* cond_producer = output_producers[0];
+    if (cond_producer && cond_producer->OpType() == "Identity" &&
+        cond_producer->InputDefs()[0]->Name() == cond_input_name) {
+      condition_passthrough = true;
+    }
   }
 
   const GraphViewer& subgraph;
@@ -143,6 +177,22 @@ struct Loop::Info {
 
   std::vector<std::string> subgraph_input_names;
   std::vector<std::string> subgraph_output_names;
+
+  // the node producing each subgraph output. nullptr if the output is a subgraph input, initializer or outer scope
+  // value.
+  std::vector<const onnxruntime::Node*> output_producers;
+
+  // true if the subgraph returns its 'cond' input as the 'cond' output, so the trip count is known upfront.
+  bool condition_passthrough;
+
+  // true if the subgraph returns a loop carried variable input as one of its outputs.
+  bool loop_carried_var_passthrough;
+
+  // for each Loop output, whether the Loop can provide the memory for the subgraph output that it comes from.
+  // this requires the value to be produced on CPU by a node in the subgraph, and to be returned only once.
+  // loop carried variables also require loop_carried_var_passthrough to be false.
+  std::vector<bool> loop_provides_output_buffer;
+  std::vector<MLDataType> output_element_types;
 };
 
 class LoopImpl {
@@ -165,6 +215,16 @@ class LoopImpl {
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // create iterators to write directly to the Loop scan outputs if the number of iterations is known upfront
+  Status CreateOutputIterators();
+
+  // setup the fetches and custom allocators to use the memory provided by the Loop for the subgraph outputs
+  void CreateFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                     std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // allocate the subgraph output for a loop carried variable using one of the buffers for the variable
+  Status AllocateLoopCarriedVar(int index, int64_t iteration, const TensorShape& shape, OrtValue& ort_value);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -177,9 +237,29 @@ class LoopImpl {
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
+  AllocatorPtr allocator_;
+
   // collection of OrtValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
+
+  // iterators for writing to slices of the Loop scan outputs. nullptr if the output is concatenated at the end.
+  std::vector<std::unique_ptr<scan::detail::OutputIterator>> output_iterators_;
+
+  /* a loop carried variable alternates between two buffers so no allocation is needed once they are large enough.
+
+    Iteration   Input             Output
+    0           Loop input        buffers[0]
+    1           buffers[0]        buffers[1]
+    2           buffers[1]        buffers[0]
+    ...
+  */
+  struct LoopCarriedVarBuffers {
+    BufferUniquePtr buffers[2];
+    size_t sizes[2] = {0, 0};
+  };
+
+  std::vector<LoopCarriedVarBuffers> loop_carried_var_buffers_;
 };
 
 Loop::Loop(const OpKernelInfo& info) : OpKernel(info) {
@@ -248,6 +328,37 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
   std::vector<const OrtMemoryInfo*> fetch_locations(info_->num_subgraph_outputs, nullptr);
   utils::FinalizeFeedFetchCopyInfo(subgraph_session_state, *ffm, feed_locations, fetch_locations);
 
+  // figure out which subgraph outputs can be written to memory provided by the Loop. the buffers are only
+  // used if no device copies are required for the fetches.
+  const auto& subgraph_output_names = info_->subgraph_output_names;
+  info_->loop_provides_output_buffer.resize(info_->num_outputs, false);
+  info_->output_element_types.resize(info_->num_outputs, nullptr);
+
+  if (ffm->GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy) {
+    for (int i = 0; i < info_->num_outputs; ++i) {
+      // + 1 to skip the 'cond' subgraph output
+      const auto& name = subgraph_output_names[i + 1];
+
+      if (info_->output_producers[i + 1] == nullptr ||
+          std::count(subgraph_output_names.cbegin(), subgraph_output_names.cend(), name) != 1 ||
+          (i < info_->num_loop_carried_vars && info_->loop_carried_var_passthrough)) {
+        continue;
+      }
+
+      int ort_value_idx = -1;
+      ORT_RETURN_IF_ERROR(subgraph_session_state.GetOrtValueNameIdxMap().GetIdx(name, ort_value_idx));
+      const auto& alloc_plan = subgraph_session_state.GetExecutionPlan()->allocation_plan[ort_value_idx];
+      const auto* tensor_type = alloc_plan.value_type ? alloc_plan.value_type->AsTensorType() : nullptr;
+
+      if (tensor_type != nullptr &&
+          alloc_plan.location.device.Type() == OrtDevice::CPU &&
+          alloc_plan.location.device.MemType() == OrtDevice::MemType::DEFAULT) {
+        info_->loop_provides_output_buffer[i] = true;
+        info_->output_element_types[i] = tensor_type->GetElementType();
+      }
+    }
+  }
+
   feeds_fetches_manager_ = std::move(ffm);
 
   return Status::OK();
@@ -316,8 +427,7 @@ Status LoopImpl::Initialize() {
     }
   }
 
-  AllocatorPtr allocator;
-  status = context_.GetTempSpaceAllocator(&allocator);
+  status = context_.GetTempSpaceAllocator(&allocator_);
   ORT_RETURN_IF_ERROR(status);
 
   auto& subgraph_inputs = info_.subgraph.GetInputs();
@@ -325,10 +435,11 @@ Status LoopImpl::Initialize() {
   auto iter_num_rank = subgraph_inputs[0]->Shape()->dim_size();
   auto condition_rank = subgraph_inputs[1]->Shape()->dim_size();
 
-  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(allocator, 0, iter_num_rank);
-  condition_mlvalue_ = MakeScalarMLValue<bool>(allocator, condition_, condition_rank);
+  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(allocator_, 0, iter_num_rank);
+  condition_mlvalue_ = MakeScalarMLValue<bool>(allocator_, condition_, condition_rank);
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
+  loop_carried_var_buffers_.resize(info_.num_loop_carried_vars);
 
   return status;
 }
@@ -361,12 +472,109 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
-  // save loop outputs as we have to concatenate at the end
+  // save loop outputs that weren't written directly to the Loop output as we have to concatenate at the end
   for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    if (!output_iterators_[j - info_.num_loop_carried_vars]) {
+      loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    }
+  }
+}
+
+Status LoopImpl::CreateOutputIterators() {
+  const int num_scan_outputs = info_.num_outputs - info_.num_loop_carried_vars;
+  output_iterators_.resize(num_scan_outputs);
+
+  // the number of iterations is only known upfront if 'M' was provided and the subgraph can't change 'cond'
+  bool fixed_trip_count = context_.Input<Tensor>(0) != nullptr && info_.condition_passthrough &&
+                          condition_ && max_trip_count_ > 0;
+  if (!fixed_trip_count) {
+    return Status::OK();
+  }
+
+  auto& graph_outputs = info_.subgraph.GetOutputs();
+
+  for (int i = 0; i < num_scan_outputs; ++i) {
+    int output_index = info_.num_loop_carried_vars + i;
+    auto* graph_output_shape = graph_outputs[output_index + 1]->Shape();  // + 1 to skip 'cond'
+
+    // we need the rank of the subgraph output to create the Loop output shape
+    if (!info_.loop_provides_output_buffer[output_index] || !graph_output_shape) {
+      continue;
+    }
+
+    // prepend the number of iterations. symbolic dimensions are -1 and will be filled in by the first iteration.
+    const auto per_iteration_shape = onnxruntime::utils::GetTensorShapeFromTensorShapeProto(*graph_output_shape);
+    const auto& per_iteration_dims = per_iteration_shape.GetDims();
+    std::vector<int64_t> dims{max_trip_count_};
+    std::copy(per_iteration_dims.cbegin(), per_iteration_dims.cend(), std::back_inserter(dims));
+
+    ORT_RETURN_IF_ERROR(scan::detail::OutputIterator::Create(context_, output_index, /*is_loop_state_var*/ false,
+                                                             /*is_v8*/ false, TensorShape(dims),
+                                                             output_iterators_[i]));
+  }
+
+  return Status::OK();
+}
+
+void LoopImpl::CreateFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                             std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  fetches.clear();
+  fetches.resize(info_.num_subgraph_outputs);
+  fetch_allocators.clear();
+
+  // + 1 for the fetch index to skip 'cond' in the subgraph outputs
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    if (info_.loop_provides_output_buffer[i]) {
+      fetch_allocators[i + 1] = [this, i, iteration](const TensorShape& shape, OrtValue& ort_value) {
+        return AllocateLoopCarriedVar(i, iteration, shape, ort_value);
+      };
+    }
+  }
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    auto* iterator = output_iterators_[i - info_.num_loop_carried_vars].get();
+    if (!iterator) {
+      continue;
+    }
+
+    if (iterator->FinalOutputAllocated()) {
+      fetches[i + 1] = **iterator;
+    } else {
+      // allocate the Loop output once the first iteration provides the shape of the subgraph output
+      fetch_allocators[i + 1] = [iterator](const TensorShape& shape, OrtValue& ort_value) {
+        return iterator->AllocateSubgraphOutput(shape, ort_value);
+      };
+    }
   }
 }
 
+Status LoopImpl::AllocateLoopCarriedVar(int index, int64_t iteration, const TensorShape& shape,
+                                        OrtValue& ort_value) {
+  const auto* element_type = info_.output_element_types[index];
+
+  size_t size_in_bytes = 0;
+  int64_t num_elements = shape.Size();
+  if (num_elements < 0 ||
+      !IAllocator::CalcMemSizeForArray(static_cast<size_t>(num_elements), element_type->Size(), &size_in_bytes)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid shape for loop carried variable ", index, ": ", shape);
+  }
+
+  auto& var_buffers = loop_carried_var_buffers_[index];
+  auto buffer_index = iteration % 2;
+
+  if (var_buffers.sizes[buffer_index] < size_in_bytes) {
+    var_buffers.buffers[buffer_index] = BufferUniquePtr(allocator_->Alloc(size_in_bytes), BufferDeleter(allocator_));
+    var_buffers.sizes[buffer_index] = size_in_bytes;
+  }
+
+  auto tensor = onnxruntime::make_unique<Tensor>(element_type, shape, var_buffers.buffers[buffer_index].get(),
+                                                 allocator_->Info());
+
+  ort_value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  return Status::OK();
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   size_t bytes_per_iteration = first_output.SizeInBytes();
@@ -410,24 +618,36 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
+  status = CreateOutputIterators();
+  ORT_RETURN_IF_ERROR(status);
+
+  // keep the execution frame alive across the iterations
+  utils::SubgraphRunner subgraph_runner(session_state_, ffm, context_.GetTerminateFlag(), context_.Logger());
+
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
-      fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
-                                    /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+    CreateFetches(iter_num_value, fetches, fetch_allocators);
 
+    status = subgraph_runner.Run(feeds, fetches, fetch_allocators);
     ORT_RETURN_IF_ERROR(status);
 
     condition_mlvalue_ = fetches[0];
 
+    for (auto& iterator : output_iterators_) {
+      if (iterator) {
+        ++(*iterator);
+      }
+    }
+
     ++iter_num_value;
   }
 
@@ -449,6 +669,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+      // nothing to do if each iteration wrote directly to the Loop output
+      if (output_iterators_[i - info_.num_loop_carried_vars]) {
+        continue;
+      }
+
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[i - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[i + 1]);  // skip cond
@@ -196,6 +196,9 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
   feeds.resize(num_inputs);
   fetches.resize(num_variadic_outputs);
 
+  // keep the execution frame alive across the iterations
+  utils::SubgraphRunner subgraph_runner(session_state, ffm, context.GetTerminateFlag(), context.Logger());
+
   // add implicit inputs and pass in implicit inputs as feeds. we're going to pass in the explicit inputs
   // first in each iteration though so offset by num_variadic_inputs
   for (size_t i = 0; i < num_implicit_inputs; ++i) {
@@ -243,9 +246,7 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
       }
     }
 
-    // Create Executor and run graph.
-    status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
-                                    /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger());
+    status = subgraph_runner.Run(feeds, fetches, fetch_allocators);
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -277,6 +277,16 @@ Status Exp<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status Exp<float>::Compute(OpKernelContext* ctx) const {
+  auto& X = *ctx->Input<Tensor>(0);
+  auto& Y = *ctx->Output(0, X.Shape());
+
+  MlasComputeExp(X.template Data<float>(), Y.template MutableData<float>(), gsl::narrow<size_t>(X.Shape().Size()));
+
+  return Status::OK();
+}
+
 template <>
 Status Log<float>::Compute(OpKernelContext* ctx) const {
   auto& X = *ctx->Input<Tensor>(0);
@@ -129,6 +129,9 @@ class Exp final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+Status Exp<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class Log final : public OpKernel {
  public:
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -13,7 +14,10 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     1, 8,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .MayStridedInput(0)
+        .MayStridedInput(1),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -28,7 +32,10 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     9,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .MayStridedInput(0)
+        .MayStridedInput(1),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
@@ -66,6 +73,98 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint64_t>()),
     MatMul<uint64_t>);
 
+namespace {
+// The matrices of a MatMul input that is a strided view, in the form GEMM takes them
+struct StridedMatrices {
+  CBLAS_TRANSPOSE trans;
+  int ld;
+  // element offset of each matrix, in the order of the matrices of a contiguous input
+  std::vector<int64_t> offsets;
+};
+
+// A view can be passed to GEMM if one of its two innermost dimensions has unit stride,
+// as produced by Transpose of the last two axes or by Slice/Split of the outer axes.
+bool GetStridedMatrices(const Tensor& tensor, StridedMatrices& matrices) {
+  const auto& dims = tensor.Shape().GetDims();
+  const size_t rank = dims.size();
+  if (rank < 2)
+    return false;
+
+  const auto strides = tensor.Strides();
+  const int64_t rows = dims[rank - 2];
+  const int64_t cols = dims[rank - 1];
+  if (strides[rank - 1] == 1 && strides[rank - 2] >= std::max<int64_t>(cols, 1)) {
+    matrices.trans = CblasNoTrans;
+    matrices.ld = gsl::narrow<int>(strides[rank - 2]);
+  } else if (strides[rank - 2] == 1 && strides[rank - 1] >= std::max<int64_t>(rows, 1)) {
+    matrices.trans = CblasTrans;
+    matrices.ld = gsl::narrow<int>(strides[rank - 1]);
+  } else {
+    return false;
+  }
+
+  const int64_t num_matrices = tensor.Shape().SizeToDimension(rank - 2);
+  matrices.offsets.resize(static_cast<size_t>(num_matrices));
+  for (int64_t i = 0; i < num_matrices; ++i) {
+    int64_t remainder = i;
+    int64_t offset = 0;
+    for (size_t axis = rank - 2; axis-- > 0;) {
+      offset += (remainder % dims[axis]) * strides[axis];
+      remainder /= dims[axis];
+    }
+    matrices.offsets[static_cast<size_t>(i)] = offset;
+  }
+  return true;
+}
+
+// Multiplies inputs that are strided views without making them contiguous. Returns false if their
+// layout is not one GEMM can read.
+template <typename T>
+bool MatMulStrided(const MatMulComputeHelper& /*helper*/, const Tensor& /*left*/, const Tensor& /*right*/,
+                   Tensor& /*output*/, concurrency::ThreadPool* /*thread_pool*/) {
+  return false;
+}
+
+template <>
+bool MatMulStrided<float>(const MatMulComputeHelper& helper, const Tensor& left, const Tensor& right,
+                          Tensor& output, concurrency::ThreadPool* thread_pool) {
+  const auto& left_dims = left.Shape().GetDims();
+  const auto& right_dims = right.Shape().GetDims();
+  const auto M = helper.M();
+  const auto N = helper.N();
+  const auto K = helper.K();
+
+  // the helper folds the outer dimensions of the left input into M when the right input is a matrix,
+  // which only a contiguous left input allows
+  if (left_dims.size() < 2 || right_dims.size() < 2 ||
+      (left_dims[left_dims.size() - 2] != M && !left.IsContiguous()) ||
+      M == 0 || N == 0 || K == 0) {
+    return false;
+  }
+
+  StridedMatrices left_matrices;
+  StridedMatrices right_matrices;
+  if (!GetStridedMatrices(left, left_matrices) || !GetStridedMatrices(right, right_matrices)) {
+    return false;
+  }
+
+  const float* left_data = left.Data<float>();
+  const float* right_data = right.Data<float>();
+  float* output_data = output.MutableData<float>();
+  for (size_t i = 0, end = helper.OutputOffsets().size(); i < end; ++i) {
+    auto left_matrix = helper.LeftOffsets()[i] / static_cast<size_t>(M * K);
+    auto right_matrix = helper.RightOffsets()[i] / static_cast<size_t>(K * N);
+    math::GemmEx<float, concurrency::ThreadPool>(
+        left_matrices.trans, right_matrices.trans,
+        static_cast<int>(M), static_cast<int>(N), static_cast<int>(K), 1.f,
+        left_data + left_matrices.offsets[left_matrix], left_matrices.ld,
+        right_data + right_matrices.offsets[right_matrix], right_matrices.ld,
+        0.f, output_data + helper.OutputOffsets()[i], static_cast<int>(N), thread_pool);
+  }
+  return true;
+}
+}  // namespace
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
@@ -79,6 +178,20 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, helper.OutputShape());
 
+  // inputs that are strided views are read in place if possible, and copied only when GEMM can not read them
+  std::unique_ptr<Tensor> left_contiguous;
+  std::unique_ptr<Tensor> right_contiguous;
+  if (!left_X->IsContiguous() || !right_X->IsContiguous()) {
+    if (MatMulStrided<T>(helper, *left_X, *right_X, *Y, thread_pool)) {
+      return Status::OK();
+    }
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    left_X = &MakeContiguous<T>(*left_X, alloc, left_contiguous);
+    right_X = &MakeContiguous<T>(*right_X, alloc, right_contiguous);
+  }
+
   size_t max_len = helper.OutputOffsets().size();
   for (size_t i = 0; i < max_len; i++) {
     math::MatMul<T>(
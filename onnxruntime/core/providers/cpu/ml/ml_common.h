@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -251,22 +252,8 @@ static inline float sigmoid_probability(float score, float proba, float probb) {
 }
 
 static inline void ComputeSoftmax(std::vector<float>& values) {
-  std::vector<float> newscores;
   // compute exp with negative number to be numerically stable
-  float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
-  }
-  float this_sum = 0.f;
-  for (float value : values) {
-    float val2 = std::exp(value - v_max);
-    this_sum += val2;
-    newscores.push_back(val2);
-  }
-  for (int64_t k = 0; k < static_cast<int64_t>(values.size()); k++) {
-    values[k] = newscores[k] / this_sum;
-  }
+  MlasComputeSoftmax(values.data(), values.data(), 1, values.size(), false, nullptr);
 }
 
 //this function skips zero values (since exp(0) is non zero)
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -73,6 +74,10 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       break;
     }
   }
+
+  if (get_kernel_type() == KERNEL::RBF) {
+    support_vector_sq_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
 }
 
 template <typename LabelType>
@@ -101,6 +106,109 @@ int _set_score_svm(Tensor* Y, float max_weight, const int64_t maxclass, const in
   return write_additional_scores;
 }
 
+template <typename T>
+void SVMClassifier<T>::ComputeScores(int64_t n, const float* kernels, std::vector<float>& scores,
+                                     std::vector<int64_t>& votes, int write_additional_scores, int64_t z_stride,
+                                     Tensor* Y, Tensor* Z) const {
+  int64_t maxclass = -1;
+  scores.clear();
+  votes.clear();
+
+  if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
+    for (int64_t j = 0; j < class_count_; j++) {  //for each class
+      scores.push_back(kernels[j] + rho_[0]);
+    }
+  } else {
+    int evals = 0;
+
+    votes.resize(class_count_, 0);
+    for (int64_t i = 0; i < class_count_; i++) {        // for each class
+      for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
+        double sum = 0;
+        int64_t start_index_i = starting_vector_[i];  // *feature_count_;
+        int64_t start_index_j = starting_vector_[j];  // *feature_count_;
+
+        int64_t class_i_support_count = vectors_per_class_[i];
+        int64_t class_j_support_count = vectors_per_class_[j];
+
+        int64_t pos1 = (vector_count_) * (j - 1);
+        int64_t pos2 = (vector_count_) * (i);
+        const float* val1 = &(coefficients_[pos1 + start_index_i]);
+        const float* val2 = kernels + start_index_i;
+        for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        val1 = &(coefficients_[pos2 + start_index_j]);
+        val2 = kernels + start_index_j;
+        for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        sum += rho_[evals];
+        scores.push_back((float)sum);
+        ++(votes[sum > 0 ? i : j]);
+        ++evals;  //index into rho
+      }
+    }
+  }
+
+  if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
+    //compute probabilities from the scores
+    int64_t num = class_count_ * class_count_;
+    std::vector<float> probsp2(num, 0.f);
+    std::vector<float> estimates(class_count_, 0.f);
+    int64_t index = 0;
+    for (int64_t i = 0; i < class_count_; ++i) {
+      int64_t p1 = i * class_count_ + i + 1;
+      int64_t p2 = (i + 1) * class_count_ + i;
+      for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
+        float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
+        float val2 = std::max(val1, 1.0e-7f);
+        val2 = std::min(val2, 1 - 1.0e-7f);
+        probsp2[p1] = val2;
+        probsp2[p2] = 1 - val2;
+        ++p1;
+        p2 += class_count_;
+      }
+    }
+    multiclass_probability(class_count_, probsp2, estimates);
+    // copy probabilities back into scores
+    scores.resize(estimates.size());
+    std::copy(estimates.begin(), estimates.end(), scores.begin());
+  }
+
+  float max_weight = 0;
+  if (votes.size() > 0) {
+    auto it_maxvotes = std::max_element(votes.begin(), votes.end());
+    maxclass = std::distance(votes.begin(), it_maxvotes);
+  } else {
+    auto it_max_weight = std::max_element(scores.begin(), scores.end());
+    maxclass = std::distance(scores.begin(), it_max_weight);
+    max_weight = *it_max_weight;
+  }
+
+  // write top class
+  // onnx specs expects one column per class.
+  if (rho_.size() == 1) {
+    if (using_strings_) {
+      _set_score_svm<std::string>(
+          Y, max_weight, maxclass, n, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_strings_, "1", "0");
+    } else {
+      _set_score_svm<int64_t>(
+          Y, max_weight, maxclass, n, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_ints_, 1, 0);
+    }
+  } else {  //multiclass
+    if (using_strings_) {
+      Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
+    } else {
+      Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+    }
+  }
+
+  write_scores(scores, post_transform_, n * z_stride, Z, write_additional_scores);
+}
+
 template <typename T>
 Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   const auto* X = ctx->Input<Tensor>(0);
@@ -121,124 +229,58 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
+  if (vector_count_ == 0 && mode_ != SVM_TYPE::SVM_LINEAR)
+    return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
+
+  // In liblinear mode the coefficients act as one weight vector per class,
+  // otherwise the kernel is evaluated against every support vector.
+  const bool linear = vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR;
+  const std::vector<float>& weights = linear ? coefficients_ : support_vectors_;
+  const int64_t kernel_count = linear ? class_count_ : vector_count_;
+
+  // The binary case writes both class scores when there is a single rho.
+  int write_additional_scores = -1;
+  if (rho_.size() == 1 &&
+      (using_strings_ ? classlabels_strings_.size() : classlabels_ints_.size()) == 2) {
+    write_additional_scores = post_transform_ == POST_EVAL_TRANSFORM::NONE ? 2 : 0;
+  }
+
+  // Every example produces the same number of scores, so each one owns a
+  // fixed slice of Z and examples can be processed independently.
+  int64_t z_stride = linear ? class_count_
+                            : (proba_.size() > 0 ? class_count_ : class_count_ * (class_count_ - 1) / 2);
+  if (z_stride == 1 && post_transform_ != POST_EVAL_TRANSFORM::PROBIT && write_additional_scores >= 0) {
+    z_stride = 2;
+  }
+
   const T* x_data = X->template Data<T>();
-  int64_t zindex = 0;
-
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
-
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
-    } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
-      int evals = 0;
-
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      votes.resize(class_count_, 0);
-      for (int64_t i = 0; i < class_count_; i++) {        // for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
-          double sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[evals];
-          scores.push_back((float)sum);
-          ++(votes[sum > 0 ? i : j]);
-          ++evals;  //index into rho
-        }
-      }
-    }
+  const int64_t num_blocks = (N + kSVMBatchSize - 1) / kSVMBatchSize;
 
-    if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
-      //compute probabilities from the scores
-      int64_t num = class_count_ * class_count_;
-      std::vector<float> probsp2(num, 0.f);
-      std::vector<float> estimates(class_count_, 0.f);
-      int64_t index = 0;
-      for (int64_t i = 0; i < class_count_; ++i) {
-        int64_t p1 = i * class_count_ + i + 1;
-        int64_t p2 = (i + 1) * class_count_ + i;
-        for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
-          float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
-          float val2 = std::max(val1, 1.0e-7f);
-          val2 = std::min(val2, 1 - 1.0e-7f);
-          probsp2[p1] = val2;
-          probsp2[p2] = 1 - val2;
-          ++p1;
-          p2 += class_count_;
-        }
-      }
-      multiclass_probability(class_count_, probsp2, estimates);
-      // copy probabilities back into scores
-      scores.resize(estimates.size());
-      std::copy(estimates.begin(), estimates.end(), scores.begin());
-    }
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
-    float max_weight = 0;
-    if (votes.size() > 0) {
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
-    } else {
-      auto it_max_weight = std::max_element(scores.begin(), scores.end());
-      maxclass = std::distance(scores.begin(), it_max_weight);
-      max_weight = *it_max_weight;
-    }
+  concurrency::ThreadPool::TryBatchParallelFor(
+      num_blocks > 1 ? tp : nullptr, static_cast<int32_t>(num_blocks),
+      [&](int32_t block) {
+        const int64_t first = block * kSVMBatchSize;
+        const int64_t count = std::min(kSVMBatchSize, N - first);
 
-    // write top class
-    // onnx specs expects one column per class.
-    int write_additional_scores = -1;
-    if (rho_.size() == 1) {
-      if (using_strings_) {
-        write_additional_scores = _set_score_svm<std::string>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_strings_, "1", "0");
-      } else {
-        write_additional_scores = _set_score_svm<int64_t>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_ints_, 1, 0);
-      }
-    } else {  //multiclass
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
-      }
-    }
+        std::vector<float> x_buffer;
+        const float* x_block = as_float(x_data + first * stride, static_cast<size_t>(count * stride), x_buffer);
 
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
-  }
+        // A single block keeps the whole pool for the GEMM instead.
+        std::vector<float> kernels(static_cast<size_t>(count * kernel_count));
+        batched_kernel_dot(x_block, stride, weights.data(), support_vector_sq_norms_.data(),
+                           count, kernel_count, feature_count_, get_kernel_type(), kernels.data(),
+                           num_blocks > 1 ? nullptr : tp);
+
+        std::vector<float> scores;
+        std::vector<int64_t> votes;
+        for (int64_t i = 0; i < count; i++) {
+          ComputeScores(first + i, kernels.data() + i * kernel_count, scores, votes,
+                        write_additional_scores, z_stride, Y, Z);
+        }
+      });
 
   return Status::OK();
 }
@@ -3,14 +3,22 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
 namespace onnxruntime {
 namespace ml {
 
+// RBF distances below this fraction of ||a||^2 + ||b||^2 lose too many bits to
+// cancellation in the GEMM expansion and are recomputed directly.
+constexpr double kRBFCancellationRatio = 1.0 / 16;
+
 // stuffs shared by SVMClassifier and SVMRegressor
 template <typename T>
 class SVMCommon {
@@ -29,31 +37,75 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
+  // Evaluates the kernel between M rows of A (leading dimension lda) and N rows
+  // of B, all of length K, as a single GEMM followed by the kernel transform.
+  // The M x N result is written to C. B_sq_norms holds the squared L2 norm of
+  // each row of B and is only read by the RBF kernel.
+  void batched_kernel_dot(const float* A, size_t lda, const float* B, const float* B_sq_norms,
+                          size_t M, size_t N, size_t K, KERNEL k, float* C,
+                          concurrency::ThreadPool* threadpool) const {
+    if (k == KERNEL::RBF) {
+      // ||a - b||^2 = ||a||^2 + ||b||^2 - 2 * a.b
+      MlasGemm(CblasNoTrans, CblasTrans, M, N, K, -2.f, A, lda, B, K, 0.f, C, N, threadpool);
+      for (size_t m = 0; m < M; m++) {
+        const float* a = A + m * lda;
+        double a_sq_norm = 0;
+        for (size_t i = 0; i < K; i++) {
+          a_sq_norm += static_cast<double>(a[i]) * a[i];
+        }
+        float* c = C + m * N;
+        for (size_t n = 0; n < N; n++) {
+          double sq_norms = a_sq_norm + B_sq_norms[n];
+          double distance = sq_norms + c[n];
+          // The float dot product cancels catastrophically when a and b are close,
+          // so recompute those distances directly in double.
+          if (distance <= sq_norms * kRBFCancellationRatio) {
+            const float* b = B + n * K;
+            distance = 0;
+            for (size_t i = 0; i < K; i++) {
+              double diff = static_cast<double>(a[i]) - b[i];
+              distance += diff * diff;
+            }
+          }
+          c[n] = static_cast<float>(std::exp(-gamma_ * distance));
+        }
+      }
+      return;
+    }
+
+    MlasGemm(CblasNoTrans, CblasTrans, M, N, K, 1.f, A, lda, B, K, 0.f, C, N, threadpool);
     if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      for (size_t i = 0; i < M * N; i++) {
+        C[i] = static_cast<float>(std::pow(gamma_ * C[i] + coef0_, degree_));
+      }
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
+      for (size_t i = 0; i < M * N; i++) {
+        C[i] = gamma_ * C[i] + coef0_;
       }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+      MlasComputeTanh(C, C, M * N);
     }
-    return (float)sum;
+  }
+
+  // Computes the squared L2 norm of each of the count vectors of length len in V.
+  static std::vector<float> squared_norms(const std::vector<float>& V, int64_t count, int64_t len) {
+    std::vector<float> norms(static_cast<size_t>(count));
+    for (int64_t j = 0; j < count; j++) {
+      const float* v = V.data() + j * len;
+      double sum = 0;
+      for (int64_t i = 0; i < len; i++) {
+        sum += static_cast<double>(v[i]) * v[i];
+      }
+      norms[j] = static_cast<float>(sum);
+    }
+    return norms;
+  }
+
+  // Returns rows of X as a contiguous float buffer, converting through buffer
+  // when the input type is not float.
+  static const float* as_float(const T* X, size_t count, std::vector<float>& buffer) {
+    buffer.resize(count);
+    std::transform(X, X + count, buffer.begin(), [](T v) { return static_cast<float>(v); });
+    return buffer.data();
   }
 
  private:
@@ -63,9 +115,20 @@ class SVMCommon {
   float degree_;
 };
 
+template <>
+inline const float* SVMCommon<float>::as_float(const float* X, size_t, std::vector<float>&) {
+  return X;
+}
+
+// Number of examples whose kernel rows are evaluated by one GEMM. Blocks are
+// the unit of parallelism and bound the size of the kernel scratch buffer.
+constexpr int64_t kSVMBatchSize = 64;
+
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
+  using SVMCommon<T>::squared_norms;
+  using SVMCommon<T>::as_float;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -74,6 +137,9 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  void ComputeScores(int64_t n, const float* kernels, std::vector<float>& scores, std::vector<int64_t>& votes,
+                     int write_additional_scores, int64_t z_stride, Tensor* Y, Tensor* Z) const;
+
   bool weights_are_all_positive_;
   int64_t feature_count_;
   int64_t class_count_;
@@ -86,6 +152,7 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  std::vector<float> support_vector_sq_norms_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
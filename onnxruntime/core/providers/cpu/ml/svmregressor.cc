@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -34,6 +35,10 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+
+  if (get_kernel_type() == KERNEL::RBF) {
+    support_vector_sq_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
 }
 
 template <typename T>
@@ -45,32 +50,51 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
   const auto* x_data = X->template Data<T>();
+  float* y_data = Y->template MutableData<float>();
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
-
-    float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
-    }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
-    }
-  }
+  // In liblinear mode the coefficients are a single weight vector.
+  const bool svc = mode_ == SVM_TYPE::SVM_SVC;
+  const std::vector<float>& weights = svc ? support_vectors_ : coefficients_;
+  const int64_t kernel_count = svc ? vector_count_ : 1;
+  const int64_t num_blocks = (N + kSVMBatchSize - 1) / kSVMBatchSize;
+
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      num_blocks > 1 ? tp : nullptr, static_cast<int32_t>(num_blocks),
+      [&](int32_t block) {
+        const int64_t first = block * kSVMBatchSize;
+        const int64_t count = std::min(kSVMBatchSize, N - first);
+
+        std::vector<float> x_buffer;
+        const float* x_block = as_float(x_data + first * stride, static_cast<size_t>(count * stride), x_buffer);
+
+        // A single block keeps the whole pool for the GEMM instead.
+        std::vector<float> kernels(static_cast<size_t>(count * kernel_count));
+        batched_kernel_dot(x_block, stride, weights.data(), support_vector_sq_norms_.data(),
+                           count, kernel_count, feature_count_, get_kernel_type(), kernels.data(),
+                           num_blocks > 1 ? nullptr : tp);
+
+        for (int64_t i = 0; i < count; i++) {
+          float sum = 0.f;
+          if (svc) {
+            const float* k = kernels.data() + i * kernel_count;
+            for (int64_t j = 0; j < vector_count_; j++) {
+              sum += k[j] * coefficients_[j];
+            }
+          } else {
+            sum = kernels[i];
+          }
+          sum += rho_[0];
+
+          if (one_class_) {
+            y_data[first + i] = sum > 0 ? 1.f : -1.f;
+          } else {
+            y_data[first + i] = sum;
+          }
+        }
+      });
 
   return Status::OK();
 }
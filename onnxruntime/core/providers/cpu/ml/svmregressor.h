@@ -14,7 +14,9 @@ namespace ml {
 
 template <typename T>
 class SVMRegressor final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
+  using SVMCommon<T>::squared_norms;
+  using SVMCommon<T>::as_float;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -29,6 +31,7 @@ class SVMRegressor final : public OpKernel, private SVMCommon<T> {
   std::vector<float> rho_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  std::vector<float> support_vector_sq_norms_;
   POST_EVAL_TRANSFORM post_transform_;
   SVM_TYPE mode_;  //how are we computing SVM? 0=LibSVC, 1=LibLinear
 };
@@ -146,6 +146,41 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+void Conv<float>::PackWinogradFilter(const OpKernelInfo& info) {
+  const Tensor* W;
+  if (!info.TryGetConstantInput(1, &W)) {
+    return;
+  }
+
+  const auto& W_shape = W->Shape();
+  if (W_shape.NumDimensions() != 4 || W_shape[2] != 3 || W_shape[3] != 3 || conv_attrs_.group <= 0 ||
+      W_shape[0] % conv_attrs_.group != 0) {
+    return;
+  }
+
+  const auto is_one = [](int64_t value) { return value == 1; };
+  if (!std::all_of(conv_attrs_.strides.begin(), conv_attrs_.strides.end(), is_one) ||
+      !std::all_of(conv_attrs_.dilations.begin(), conv_attrs_.dilations.end(), is_one)) {
+    return;
+  }
+
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t input_channels = static_cast<size_t>(W_shape[1]);
+  const size_t filter_count = static_cast<size_t>(W_shape[0]) / group_count;
+
+  const size_t packed_W_size = MlasConvWinogradGetPackedFilterSize(group_count, input_channels, filter_count);
+  if (packed_W_size == 0) {
+    return;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_W = alloc->Alloc(sizeof(float) * packed_W_size);
+  packed_W_buffer_ = BufferUniquePtr(packed_W, BufferDeleter(alloc));
+
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, W->template Data<float>(),
+                             static_cast<float*>(packed_W), nullptr);
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
   concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
@@ -210,6 +245,10 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &WorkingBufferSize,
                     tp);
 
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd && packed_W_buffer_ != nullptr) {
+      Parameters.u.Winograd.PackedFilter = static_cast<const float*>(packed_W_buffer_.get());
+    }
+
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
 
@@ -26,6 +26,7 @@ class Conv<float> : public OpKernel {
  public:
   Conv<float>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    PackWinogradFilter(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -34,6 +35,12 @@ class Conv<float> : public OpKernel {
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // Transforms constant 3x3 weights once for the MLAS Winograd algorithm.
+  void PackWinogradFilter(const OpKernelInfo& info);
+
+  BufferUniquePtr packed_W_buffer_;
 };
 
 }  // namespace onnxruntime
@@ -3,10 +3,20 @@
 
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+#include <algorithm>
+#include <limits>
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
+// Bytes copied by each task of the thread pool.
+constexpr int64_t kGatherBytesPerTask = 16 * 1024;
+// Number of rows ahead of the one being copied to prefetch. Rows of an embedding table are usually
+// far apart, so the hardware prefetcher can not predict them.
+constexpr int64_t kGatherPrefetchDistance = 8;
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Gather,
     1,
@@ -51,11 +61,11 @@ template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
                       const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const TensorShape& input_data_shape, const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
   // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // We can't return from the parallel loop below.
   auto axis_dim_limit = input_data_shape[axis];
 
   for (int64_t i = 0; i < N; ++i) {
@@ -67,27 +77,63 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
+  auto src_offset = [&](int64_t index) {
     int64_t batch = index / N;
     int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
     Tin idx = indices_data[i];
     idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+    return batch * data_batch_bytes + idx * block_size;
+  };
+
+  auto copy_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t index = first; index < last; ++index) {
+      const int64_t src = src_offset(index);
+      const int64_t dst_offset = (index / N) * gathered_batch_bytes + (index % N) * block_size;
+      if (is_string_type) {
+        reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
+            reinterpret_cast<const std::string*>(src_base)[src / element_bytes];
+      } else {
+        if (index + kGatherPrefetchDistance < last) {
+          PrefetchRow(src_base + src_offset(index + kGatherPrefetchDistance), static_cast<size_t>(block_size));
+        }
+        memcpy(dst_base + dst_offset, src_base + src, block_size);
+      }
     }
-  }
+  };
+
+  // Gathering along axis 0 copies whole rows of the table, which needs no batch arithmetic.
+  auto copy_rows = [&](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) {
+      if (i + kGatherPrefetchDistance < last) {
+        Tin next = indices_data[i + kGatherPrefetchDistance];
+        next = next < 0 ? next + static_cast<Tin>(axis_dim_limit) : next;
+        PrefetchRow(src_base + next * block_size, static_cast<size_t>(block_size));
+      }
+      Tin idx = indices_data[i];
+      idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+      memcpy(dst_base + i * block_size, src_base + idx * block_size, block_size);
+    }
+  };
+
+  // Small blocks are grouped so each task of the thread pool copies a reasonable amount of data.
+  const int64_t total = M * N;
+  const int64_t blocks_per_task = std::max<int64_t>(
+      std::max<int64_t>(1, kGatherBytesPerTask / std::max<int64_t>(block_size, 1)),
+      (total + std::numeric_limits<int32_t>::max() - 1) / std::numeric_limits<int32_t>::max());
+  const int64_t num_tasks = (total + blocks_per_task - 1) / blocks_per_task;
+  const bool gather_rows = M == 1 && !is_string_type;
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      num_tasks > 1 ? tp : nullptr, static_cast<int32_t>(num_tasks),
+      [&](int32_t task) {
+        const int64_t first = task * blocks_per_task;
+        const int64_t last = std::min(first + blocks_per_task, total);
+        if (gather_rows) {
+          copy_rows(first, last);
+        } else {
+          copy_blocks(first, last);
+        }
+      });
 
   return Status::OK();
 }
@@ -111,14 +157,18 @@ Status Gather::Compute(OpKernelContext* context) const {
   const auto* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
     return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
   if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
     return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
@@ -3,12 +3,32 @@
 
 #pragma once
 
+#include <algorithm>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace onnxruntime {
 
+// Hint the processor to load the first bytes of a row that will be read soon.
+inline void PrefetchRow(const void* row, size_t bytes) {
+  // the first few cache lines are enough for the hardware prefetcher to follow the rest of the row
+  constexpr size_t kCacheLine = 64;
+  const size_t prefetch_bytes = std::min<size_t>(bytes, 4 * kCacheLine);
+  for (size_t offset = 0; offset < prefetch_bytes; offset += kCacheLine) {
+#if defined(__GNUC__)
+    __builtin_prefetch(static_cast<const char*>(row) + offset);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(row) + offset, _MM_HINT_T0);
+#else
+    ORT_UNUSED_PARAMETER(row);
+#endif
+  }
+}
+
 class GatherBase {
  protected:
   GatherBase(const OpKernelInfo& info) {
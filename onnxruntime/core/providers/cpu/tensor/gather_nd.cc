@@ -2,9 +2,14 @@
 // Licensed under the MIT License.
 
 #include "gather_nd.h"
+#include <algorithm>
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 
+// Bytes copied by each task of the thread pool.
+constexpr int64_t kGatherNDBytesPerTask = 16 * 1024;
+
 // Register a kernel for kMsDomain (contrib op) GatherND
 #ifndef DISABLE_CONTRIB_OPS
 
@@ -110,30 +115,38 @@ Status GatherND::Compute(OpKernelContext* context) const {
                           ? PrepareForCompute<int32_t>(context, p)
                           : PrepareForCompute<int64_t>(context, p));
 
-  return nullptr == p.input_str_base ? GatherNumber(p) : GatherString(p);
+  auto* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
-Status GatherND::GatherNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + i * p.bytes_to_copy, p.input_base + p.element_offsets[i] * p.element_bytes,
-           p.bytes_to_copy);
-  }
+Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
+  // group small slices so each task of the thread pool copies a reasonable amount of data
+  const int64_t num_slices = static_cast<int64_t>(p.element_offsets.size());
+  const int64_t slice_bytes = std::max<int64_t>(static_cast<int64_t>(p.bytes_to_copy), 1);
+  const int64_t slices_per_task = std::max<int64_t>(1, kGatherNDBytesPerTask / slice_bytes);
+  const int64_t num_tasks = (num_slices + slices_per_task - 1) / slices_per_task;
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      num_tasks > 1 ? tp : nullptr, gsl::narrow<int32_t>(num_tasks),
+      [&](int32_t task) {
+        const int64_t last = std::min(num_slices, (task + 1) * slices_per_task);
+        for (int64_t i = task * slices_per_task; i < last; ++i) {
+          memcpy(p.output_base + i * p.bytes_to_copy, p.input_base + p.element_offsets[i] * p.element_bytes,
+                 p.bytes_to_copy);
+        }
+      });
 
   return Status::OK();
 }
 
-Status GatherND::GatherString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
-    }
-  }
+Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) const {
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, gsl::narrow<int32_t>(p.element_offsets.size()),
+      [&](int32_t i) {
+        for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
+          p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+        }
+      });
 
   return Status::OK();
 }
@@ -16,7 +16,9 @@ namespace onnxruntime {
       Slice,                                                                            \
       1, 9,                                                                             \
       data_type,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()), \
+      KernelDefBuilder()                                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())                \
+          .MayStridedOutput(0, 0),                                                      \
       Slice<data_type, false>);
 
 ADD_TYPED_SLICE_V9_OP(uint8_t);
@@ -41,7 +43,8 @@ ADD_TYPED_SLICE_V9_OP(string);
       data_type,                                                                            \
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())      \
                         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),    \
-                                                 DataTypeImpl::GetTensorType<int64_t>()}),  \
+                                                 DataTypeImpl::GetTensorType<int64_t>()})   \
+                        .MayStridedOutput(0, 0),                                            \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V10_OP(uint8_t);
@@ -65,7 +68,8 @@ ADD_TYPED_SLICE_V10_OP(string);
       data_type,                                                                            \
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())      \
                         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),    \
-                                                 DataTypeImpl::GetTensorType<int64_t>()}),  \
+                                                 DataTypeImpl::GetTensorType<int64_t>()})   \
+                        .MayStridedOutput(0, 0),                                            \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V11_OP(uint8_t);
@@ -281,6 +285,18 @@ Status SliceImpl(OpKernelContext* ctx,
   if (output_shape.Size() == 0)
     return Status::OK();
 
+  // the planner placed the output in the input's buffer, so describe the slice with strides
+  if (output_tensor.DataRaw() == input_tensor.DataRaw()) {
+    auto strides = input_tensor.Strides();
+    int64_t byte_offset = input_tensor.ByteOffset();
+    for (size_t i = 0; i < strides.size(); ++i) {
+      byte_offset += starts[i] * strides[i] * static_cast<int64_t>(sizeof(T));
+      strides[i] *= steps[i];
+    }
+    output_tensor.SetShapeAndStrides(output_shape, strides, byte_offset);
+    return Status::OK();
+  }
+
   auto* output = output_tensor.template MutableData<T>();
   const auto* output_end = output + output_tensor.Shape().Size();
 
@@ -18,7 +18,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
                                       std::vector<MLDataType>{
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayStridedOutput(0, -1),
     Split);
 
 // Opset 11 starts to support Neg Axis.
@@ -29,7 +30,8 @@ ONNX_CPU_OPERATOR_KERNEL(
                                       std::vector<MLDataType>{
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayStridedOutput(0, -1),
     Split);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -130,6 +132,21 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     output_dimensions[axis] = split_size;
 
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
+
+    // the planner placed the output at its part of the input, so there is nothing to copy
+    if (before_dims == 1 && output->DataRaw() == input_data + input_offset) {
+      input_offset += split_size * after_dims_excluding_split;
+      continue;
+    }
+
+    // the planner made the output a view of the input's buffer, so it only needs to start at the right element
+    if (output->DataRaw() == input.DataRaw() && output->Shape().Size() > 0) {
+      output->SetShapeAndStrides(output->Shape(), input.Strides(),
+                                 input.ByteOffset() + input_offset * static_cast<int64_t>(sizeof(T)));
+      input_offset += split_size * after_dims_excluding_split;
+      continue;
+    }
+
     T* output_data = output->template MutableData<T>();
 
     ::onnxruntime::math::CopyMatrix<T>(
@@ -274,6 +274,17 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
+  // the planner placed the output in the input's buffer, so describe the permutation with strides
+  if (Y.DataRaw() == X.DataRaw() && output_shape.Size() > 0) {
+    const auto input_strides = X.Strides();
+    std::vector<int64_t> output_strides(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      output_strides[i] = input_strides[(*p_perm)[i]];
+    }
+    Y.SetShapeAndStrides(output_shape, output_strides, X.ByteOffset());
+    return Status::OK();
+  }
+
   DoUntypedTranspose(*p_perm, X, Y);
 
   return Status::OK();
@@ -282,7 +293,9 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
+        .MayStridedOutput(0, 0),
     Transpose);
 
 }  // namespace onnxruntime
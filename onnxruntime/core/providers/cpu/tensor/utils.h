@@ -262,6 +262,59 @@ struct SliceIterator {
   std::vector<int64_t> indices_;  // There is no index for innermost axis since it's a special case
 };
 
+// Copies the elements of a tensor that may be a strided view into dst in row-major order
+template <typename T>
+void StridedCopy(const Tensor& src, T* dst) {
+  const auto& dims = src.Shape().GetDims();
+  if (src.Shape().Size() == 0)
+    return;
+
+  const T* input = src.template Data<T>();
+  if (dims.empty()) {
+    *dst = *input;
+    return;
+  }
+
+  const auto strides = src.Strides();
+  const size_t inner_axis = dims.size() - 1;
+  const int64_t inner_extent = dims[inner_axis];
+  const int64_t inner_stride = strides[inner_axis];
+  std::vector<int64_t> indices(inner_axis, 0);
+  for (;;) {
+    if (inner_stride == 1) {
+      dst = std::copy(input, input + inner_extent, dst);
+    } else {
+      for (int64_t i = 0; i < inner_extent; ++i) {
+        *dst++ = input[i * inner_stride];
+      }
+    }
+
+    // move to the start of the next row, carrying into the outer axes
+    size_t axis = inner_axis;
+    for (;;) {
+      if (axis-- == 0)
+        return;
+      input += strides[axis];
+      if (++indices[axis] != dims[axis])
+        break;
+      input -= strides[axis] * dims[axis];
+      indices[axis] = 0;
+    }
+  }
+}
+
+// Returns tensor if it is contiguous, otherwise copies it into contiguous and returns the copy.
+// Kernels registered with MayStridedInput use this where they need contiguous data.
+template <typename T>
+const Tensor& MakeContiguous(const Tensor& tensor, AllocatorPtr alloc, std::unique_ptr<Tensor>& contiguous) {
+  if (tensor.IsContiguous())
+    return tensor;
+
+  contiguous = onnxruntime::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), std::move(alloc));
+  StridedCopy<T>(tensor, contiguous->template MutableData<T>());
+  return *contiguous;
+}
+
 inline void CopyCpuTensor(const Tensor* src, Tensor* tgt) {
   void* target = tgt->MutableDataRaw();
   const void* source = src->DataRaw();
@@ -144,8 +144,84 @@ ORT_API_STATUS_IMPL(OrtApis::SetInterOpNumThreads, _In_ OrtSessionOptions* optio
   return nullptr;
 }
 
+// return the dense probability tensor from ZipMap outputs instead of a sequence of maps
+ORT_API_STATUS_IMPL(OrtApis::EnableZipMapBypass, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_bypass = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableZipMapBypass, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_bypass = false;
+  return nullptr;
+}
+
+// collect per-node and per-op-type kernel time histograms, see SessionGetProfilingSummary
+ORT_API_STATUS_IMPL(OrtApis::EnableProfilingSummary, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_profiling_summary = true;
+  return nullptr;
+}
+
+// record the profiling trace for one out of every sampling_rate graph executions
+ORT_API_STATUS_IMPL(OrtApis::SetProfilingSamplingRate, _Inout_ OrtSessionOptions* options, int sampling_rate) {
+  if (sampling_rate < 1) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "sampling_rate must be at least 1");
+  }
+  options->value.profiling_sampling_rate = static_cast<unsigned>(sampling_rate);
+  return nullptr;
+}
+
+// measure hardware performance counters around each kernel
+ORT_API_STATUS_IMPL(OrtApis::EnableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_profiling_hardware_counters = true;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::OrtAddFreeDimensionOverride, _Inout_ OrtSessionOptions* options,
                     _In_ const char* symbolic_dim, _In_ int64_t dim_override) {
   options->value.free_dimension_overrides.push_back(onnxruntime::FreeDimensionOverride{symbolic_dim, dim_override});
   return nullptr;
 }
+
+// share identical CPU initializers with the other sessions in the process
+ORT_API_STATUS_IMPL(OrtApis::EnableInitializerSharing, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_initializer_sharing = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableInitializerSharing, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_initializer_sharing = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::AddSharedInitializer, _Inout_ OrtSessionOptions* options, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  if (name == nullptr || val == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "name and val must not be null");
+  }
+  if (!val->IsTensor()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "A shared initializer must be a tensor");
+  }
+  options->value.shared_initializers[name] = val;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetWeightStorageType, _Inout_ OrtSessionOptions* options,
+                    OrtWeightStorageType storage_type) {
+  switch (storage_type) {
+    case ORT_WEIGHT_STORAGE_FLOAT:
+      options->value.weight_storage_type = onnxruntime::WeightStorageType::kFloat;
+      break;
+    case ORT_WEIGHT_STORAGE_FLOAT16:
+      options->value.weight_storage_type = onnxruntime::WeightStorageType::kFloat16;
+      break;
+    case ORT_WEIGHT_STORAGE_BFLOAT16:
+      options->value.weight_storage_type = onnxruntime::WeightStorageType::kBFloat16;
+      break;
+    case ORT_WEIGHT_STORAGE_INT8:
+      options->value.weight_storage_type = onnxruntime::WeightStorageType::kInt8;
+      break;
+    default:
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "storage_type is not valid");
+  }
+  return nullptr;
+}
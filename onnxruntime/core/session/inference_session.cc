@@ -22,6 +22,7 @@
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/customregistry.h"
 #include "core/session/environment.h"
 #include "core/framework/error_code_helper.h"
@@ -51,6 +52,7 @@
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
+#include "core/optimizer/zipmap_elimination.h"
 #include "core/util/thread_utils.h"
 
 using namespace ONNX_NAMESPACE;
@@ -116,6 +118,19 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
   session_state_.SetDataTransferMgr(&data_transfer_mgr_);
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
+  session_profiler_.SetSamplingRate(session_options.profiling_sampling_rate);
+  if (session_options.enable_profiling_summary) {
+    session_profiler_.EnableSummary();
+  }
+  if (session_options.enable_profiling_hardware_counters) {
+    if (!session_options.enable_sequential_execution) {
+      // the counters are process wide, so nodes running concurrently would be counted together
+      LOGS(*session_logger_, WARNING) << "Hardware performance counters are only measured by the sequential executor.";
+    } else if (!session_profiler_.EnableHardwareCounters()) {
+      LOGS(*session_logger_, WARNING) << "Hardware performance counters are not available. "
+                                         "On Linux check the kernel.perf_event_paranoid setting.";
+    }
+  }
   if (session_options.enable_profiling) {
     StartProfiling(session_options.profile_file_prefix);
   }
@@ -446,6 +461,8 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
       // setup everything required to execute the subgraph and save it in subgraph_session_state
       SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
                                           *subgraph_session_state, execution_providers_, kernel_registry_manager_);
+      initializer.SetInitializerSharing(session_options_.shared_initializers,
+                                        session_options_.enable_initializer_sharing);
 
       const auto implicit_inputs = node.ImplicitInputDefs();
       ORT_RETURN_IF_ERROR(initializer.CreatePlan(&node, &implicit_inputs,
@@ -505,6 +522,24 @@ common::Status InferenceSession::Initialize() {
     // add predefined transformers
     AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
 
+    // bypassing ZipMap changes the output types so it is opt-in and independent of the optimization level
+    if (session_options_.enable_zipmap_bypass) {
+      ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(
+          onnxruntime::make_unique<ZipMapElimination>(&model_metadata_.custom_metadata_map), TransformerLevel::Level1));
+    }
+
+    // compressing the weights changes the results so it is opt-in as well
+    if (session_options_.weight_storage_type != WeightStorageType::kFloat) {
+#ifndef DISABLE_CONTRIB_OPS
+      ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(
+          onnxruntime::make_unique<CompressedMatMulTransformer>(session_options_.weight_storage_type,
+                                                                std::unordered_set<std::string>{kCpuExecutionProvider}),
+          TransformerLevel::Level2));
+#else
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Compressed weight storage requires the contrib ops");
+#endif
+    }
+
     onnxruntime::Graph& graph = model_->MainGraph();
 
     // Collect the kernel registries from execution provider instances;
@@ -519,6 +554,8 @@ common::Status InferenceSession::Initialize() {
 
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
                                                 session_state_, execution_providers_, kernel_registry_manager_);
+    session_initializer.SetInitializerSharing(session_options_.shared_initializers,
+                                              session_options_.enable_initializer_sharing);
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
@@ -901,6 +938,61 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+std::string InferenceSession::GetProfilingSummary() const {
+  return session_profiler_.GetSummary();
+}
+
+common::Status InferenceSession::GetArenaStats(const OrtMemoryInfo& memory_info, AllocatorStats& stats) const {
+  auto allocator = execution_providers_.GetAllocator(memory_info);
+  if (allocator == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "No allocator for memory info " + memory_info.ToString());
+  }
+
+  auto* arena = dynamic_cast<BFCArena*>(allocator.get());
+  if (arena == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED,
+                          "The allocator for " + memory_info.ToString() + " is not an arena");
+  }
+
+  arena->GetStats(&stats);
+  return Status::OK();
+}
+
+common::Status InferenceSession::Clone(std::unique_ptr<InferenceSession>& clone) const {
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session must be initialized before it can be cloned.");
+  }
+
+  // the clone gets new instances of the execution providers so it has its own allocators
+  for (const auto& provider_type : execution_providers_.GetIds()) {
+    if (provider_type != kCpuExecutionProvider) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Cloning a session that uses the ", provider_type,
+                             " execution provider is not supported.");
+    }
+  }
+
+  auto session = onnxruntime::make_unique<InferenceSession>(session_options_, logging_manager_);
+  CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+  ORT_RETURN_IF_ERROR(session->RegisterExecutionProvider(onnxruntime::make_unique<CPUExecutionProvider>(epi)));
+  ORT_RETURN_IF_ERROR(session->session_state_.ShareFrom(session_state_));
+
+  session->model_ = model_;
+  session->model_location_ = model_location_;
+  session->model_metadata_ = model_metadata_;
+  session->required_inputs_ = required_inputs_;
+  session->input_def_map_ = input_def_map_;
+  session->output_def_list_ = output_def_list_;
+  session->model_output_names_ = model_output_names_;
+  session->is_model_loaded_ = true;
+  session->is_inited_ = true;
+
+  LOGS(*session_logger_, INFO) << "Session cloned.";
+  clone = std::move(session);
+  return Status::OK();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
@@ -16,6 +16,7 @@
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/session_state.h"
 #include "core/graph/basic_types.h"
+#include "core/optimizer/compressed_matmul_transformer.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
@@ -38,6 +39,7 @@ struct OrtCustomOpDomain {
 
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
+struct AllocatorStats;
 class IOBinding;
 class CustomRegistry;
 class Notification;
@@ -79,6 +81,17 @@ struct SessionOptions {
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
+  // record the profiling trace for one out of every profiling_sampling_rate graph executions.
+  unsigned profiling_sampling_rate = 1;
+
+  // collect per-node and per-op-type kernel time histograms. independent of enable_profiling.
+  bool enable_profiling_summary = false;
+
+  // measure hardware performance counters around each kernel when profiling or collecting the summary.
+  // only supported by the sequential executor on Linux. the counters include the work of all threads of the
+  // process, including the intra-op thread pool, so only one Run should execute at a time while measuring.
+  bool enable_profiling_hardware_counters = false;
+
   std::string session_logid;  ///< logger id to use for session output
 
   /// Log severity for the inference session. Applies to session load, initialization, etc.
@@ -102,6 +115,25 @@ struct SessionOptions {
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
+
+  // bypass ZipMap nodes that produce graph outputs so those outputs return the dense probability tensor
+  // instead of a sequence of maps. The class labels are recorded in the model metadata under
+  // "<output name>.labels" as a JSON array.
+  bool enable_zipmap_bypass = false;
+
+  // share CPU initializers with other sessions in the process that load identical weights.
+  // sessions reference one read-only copy that is released with the last session using it.
+  bool enable_initializer_sharing = false;
+
+  // initializers supplied by the user that replace the model's initializers with the same name, so several
+  // sessions can use one copy of the weights. the values are not copied and must hold the same data as the
+  // model's initializers, which graph optimizations may still read. a value that does not own its buffer
+  // requires the buffer to outlive the sessions.
+  std::unordered_map<std::string, const OrtValue*> shared_initializers;
+
+  // store large constant MatMul and Gemm weights in reduced precision. they are converted back to float a panel
+  // at a time inside the GEMM. this changes the results so it is opt-in and independent of the optimization level.
+  WeightStorageType weight_storage_type = WeightStorageType::kFloat;
 };
 
 /**
@@ -334,6 +366,27 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the kernel time histograms collected when SessionOptions::enable_profiling_summary is set.
+    @return the per-op-type and per-node summaries in JSON format.
+    */
+  std::string GetProfilingSummary() const;
+
+  /**
+    * Get the usage statistics of the arena allocator that serves the given memory.
+    @return INVALID_ARGUMENT if no execution provider allocates that memory, or NOT_IMPLEMENTED if
+    its allocator is not a BFCArena.
+    */
+  common::Status GetArenaStats(const OrtMemoryInfo& memory_info, AllocatorStats& stats) const;
+
+  /**
+    * Create a session that shares the model, kernels, execution plan and initializers of this initialized session
+    * but has its own execution providers, memory arena and thread pools. This avoids loading, optimizing and
+    * planning the model again for each replica. This session must outlive the clone.
+    * @return NOT_IMPLEMENTED if this session uses an execution provider other than the CPU one.
+    */
+  common::Status Clone(std::unique_ptr<InferenceSession>& clone) const;
+
  protected:
   /**
     * Load an ONNX model.
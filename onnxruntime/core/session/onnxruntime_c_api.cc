@@ -14,6 +14,7 @@
 #include "core/common/status.h"
 #include "core/graph/graph.h"
 #include "core/framework/allocator.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/tensor.h"
 #include "core/framework/ml_value.h"
 #include "core/session/environment.h"
@@ -625,6 +626,42 @@ static OrtStatus* GetNodeDefNameImpl(_In_ const OrtSession* sess, size_t index,
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingSummary, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetProfilingSummary(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetArenaStats, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* info,
+                    _Out_ size_t* bytes_in_use, _Out_ size_t* total_allocated_bytes, _Out_ size_t* max_bytes_in_use) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  onnxruntime::AllocatorStats stats;
+  auto status = session->GetArenaStats(*info, stats);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *bytes_in_use = static_cast<size_t>(stats.bytes_in_use);
+  *total_allocated_bytes = static_cast<size_t>(stats.total_allocated_bytes);
+  *max_bytes_in_use = static_cast<size_t>(stats.max_bytes_in_use);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CloneSession, _In_ const OrtSession* sess, _Outptr_ OrtSession** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::InferenceSession> clone;
+  auto status = session->Clone(clone);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtSession*>(clone.release());
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetInputName, _In_ const OrtSession* sess, size_t index,
                     _Inout_ OrtAllocator* allocator, _Outptr_ char** output) {
   API_IMPL_BEGIN
@@ -1329,6 +1366,19 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+
+    &OrtApis::EnableZipMapBypass,
+    &OrtApis::DisableZipMapBypass,
+    &OrtApis::EnableProfilingSummary,
+    &OrtApis::SetProfilingSamplingRate,
+    &OrtApis::SessionGetProfilingSummary,
+    &OrtApis::EnableProfilingHardwareCounters,
+    &OrtApis::SessionGetArenaStats,
+    &OrtApis::EnableInitializerSharing,
+    &OrtApis::DisableInitializerSharing,
+    &OrtApis::AddSharedInitializer,
+    &OrtApis::CloneSession,
+    &OrtApis::SetWeightStorageType,
 };
 
 const OrtApi* ORT_API_CALL OrtGetApi(uint32_t version) NO_EXCEPTION {
@@ -51,6 +51,21 @@ ORT_API_STATUS_IMPL(SetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* op
                     GraphOptimizationLevel graph_optimization_level);
 ORT_API_STATUS_IMPL(SetIntraOpNumThreads, _Inout_ OrtSessionOptions* options, int intra_op_num_threads);
 ORT_API_STATUS_IMPL(SetInterOpNumThreads, _Inout_ OrtSessionOptions* options, int inter_op_num_threads);
+ORT_API_STATUS_IMPL(EnableZipMapBypass, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableZipMapBypass, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(EnableProfilingSummary, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetProfilingSamplingRate, _Inout_ OrtSessionOptions* options, int sampling_rate);
+ORT_API_STATUS_IMPL(EnableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SessionGetProfilingSummary, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetArenaStats, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* info,
+                    _Out_ size_t* bytes_in_use, _Out_ size_t* total_allocated_bytes, _Out_ size_t* max_bytes_in_use);
+ORT_API_STATUS_IMPL(EnableInitializerSharing, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableInitializerSharing, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(AddSharedInitializer, _Inout_ OrtSessionOptions* options, _In_ const char* name,
+                    _In_ const OrtValue* val);
+ORT_API_STATUS_IMPL(CloneSession, _In_ const OrtSession* sess, _Outptr_ OrtSession** out);
+ORT_API_STATUS_IMPL(SetWeightStorageType, _Inout_ OrtSessionOptions* options, OrtWeightStorageType storage_type);
 
 ORT_API_STATUS_IMPL(CreateCustomOpDomain, _In_ const char* domain, _Outptr_ OrtCustomOpDomain** out);
 ORT_API_STATUS_IMPL(CustomOpDomain_Add, _Inout_ OrtCustomOpDomain* custom_op_domain, _In_ OrtCustomOp* op);
@@ -548,6 +548,9 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
                      R"pbdoc(Sets the number of threads used to parallelize the execution within nodes. Default is 0 to let onnxruntime choose.)pbdoc")
       .def_readwrite("inter_op_num_threads", &SessionOptions::inter_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_readwrite("enable_zipmap_bypass", &SessionOptions::enable_zipmap_bypass,
+                     R"pbdoc(Return the dense probability tensor from ZipMap outputs instead of a list of dicts.
+The class labels are stored in the model metadata under '<output name>.labels' as a JSON array. Default is false.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
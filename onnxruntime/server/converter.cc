@@ -14,6 +14,24 @@ namespace server {
 
 namespace protobufutil = google::protobuf::util;
 
+// Copy tensor data to a repeated field of the same type with a single memcpy.
+template <typename T>
+static void CopyToRepeatedField(const T* data, size_t count, google::protobuf::RepeatedField<T>& field) {
+  field.Resize(static_cast<int>(count), T{});
+  if (count > 0) {
+    memcpy(field.mutable_data(), data, count * sizeof(T));
+  }
+}
+
+// Copy tensor data to a repeated field of a wider type. ONNX stores the smaller integer types in int32_data.
+template <typename TSrc, typename TDst>
+static void WidenToRepeatedField(const TSrc* data, size_t count, google::protobuf::RepeatedField<TDst>& field) {
+  field.Reserve(static_cast<int>(count));
+  for (size_t i = 0; i < count; ++i) {
+    field.AddAlreadyReserved(static_cast<TDst>(data[i]));
+  }
+}
+
 onnx::TensorProto_DataType MLDataTypeToTensorProtoDataType(ONNXTensorElementDataType onnx_enum) {
   switch (onnx_enum) {
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
@@ -87,9 +105,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(float) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_float_data(data[i]);
-        }
+        CopyToRepeatedField(data, elem_count, *tensor_proto.mutable_float_data());
       }
       break;
     }
@@ -98,9 +114,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(int32_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        CopyToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -109,9 +123,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(uint8_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -120,9 +132,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(int8_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -131,9 +141,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(uint16_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -142,9 +150,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(int16_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -153,9 +159,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(bool) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -164,27 +168,18 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(onnxruntime::MLFloat16) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(reinterpret_cast<const uint16_t*>(data)[i]);
-        }
+        WidenToRepeatedField(reinterpret_cast<const uint16_t*>(data), elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
     case onnx::TensorProto_DataType_BFLOAT16: {  // Target: raw_data or int32_data
-      const auto* data = ml_value.GetTensorMutableData<onnxruntime::BFloat16>();
-
-      std::vector<uint16_t> raw_data;
-      raw_data.reserve(elem_count);
-      for (size_t i = 0; i < elem_count; ++i) {
-        raw_data.push_back(data[i].val);
-      }
-
+      // BFloat16 is stored as its uint16_t bit pattern
+      static_assert(sizeof(onnxruntime::BFloat16) == sizeof(uint16_t), "BFloat16 must be 16 bits");
+      const auto* data = reinterpret_cast<const uint16_t*>(ml_value.GetTensorMutableData<onnxruntime::BFloat16>());
       if (using_raw_data) {
-        tensor_proto.set_raw_data(raw_data.data(), raw_data.size() * sizeof(uint16_t));
+        tensor_proto.set_raw_data(data, sizeof(uint16_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(raw_data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_int32_data());
       }
       break;
     }
@@ -210,9 +205,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(int64_t) * elem_count);
       } else {
-        for (size_t x = 0, loop_length = elem_count; x < loop_length; ++x) {
-          tensor_proto.add_int64_data(data[x]);
-        }
+        CopyToRepeatedField(data, elem_count, *tensor_proto.mutable_int64_data());
       }
       break;
     }
@@ -221,9 +214,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(uint32_t) * elem_count);
       } else {
-        for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_uint64_data(data[i]);
-        }
+        WidenToRepeatedField(data, elem_count, *tensor_proto.mutable_uint64_data());
       }
       break;
     }
@@ -232,9 +223,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(uint64_t) * elem_count);
       } else {
-        for (size_t x = 0, loop_length = elem_count; x < loop_length; ++x) {
-          tensor_proto.add_uint64_data(data[x]);
-        }
+        CopyToRepeatedField(data, elem_count, *tensor_proto.mutable_uint64_data());
       }
       break;
     }
@@ -243,9 +232,7 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
       if (using_raw_data) {
         tensor_proto.set_raw_data(data, sizeof(double) * elem_count);
       } else {
-        for (size_t x = 0, loop_length = elem_count; x < loop_length; ++x) {
-          tensor_proto.add_double_data(data[x]);
-        }
+        CopyToRepeatedField(data, elem_count, *tensor_proto.mutable_double_data());
       }
       break;
     }
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
 #include "environment.h"
 #include "core/session/onnxruntime_cxx_api.h"
@@ -42,46 +43,122 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
   spdlog::initialize_logger(default_logger_);
 }
 
-void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), Ort::SessionOptions()));
+ServableModel::ServableModel(Ort::Env& env, const std::string& path, const Ort::SessionOptions& options)
+    : session(env, path.c_str(), options) {
+  auto output_count = session.GetOutputCount();
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0; i < output_count; i++) {
+    auto name = session.GetOutputName(i, allocator);
+    output_names.push_back(name);
+    allocator.Free(name);
+  }
+}
+
+bool ModelVersionLess::operator()(const std::string& lhs, const std::string& rhs) const {
+  auto is_numeric = [](const std::string& version) {
+    return !version.empty() && std::all_of(version.begin(), version.end(), [](char c) { return c >= '0' && c <= '9'; });
+  };
+
+  bool lhs_numeric = is_numeric(lhs);
+  bool rhs_numeric = is_numeric(rhs);
+  if (lhs_numeric != rhs_numeric) {
+    return lhs_numeric;
+  }
+  if (!lhs_numeric) {
+    return lhs < rhs;
+  }
+
+  // Compare digit strings by value without converting them, ignoring leading zeros
+  auto lhs_start = std::min(lhs.find_first_not_of('0'), lhs.size());
+  auto rhs_start = std::min(rhs.find_first_not_of('0'), rhs.size());
+  auto lhs_length = lhs.size() - lhs_start;
+  auto rhs_length = rhs.size() - rhs_start;
+  if (lhs_length != rhs_length) {
+    return lhs_length < rhs_length;
+  }
+  int result = lhs.compare(lhs_start, lhs_length, rhs, rhs_start, rhs_length);
+  return result != 0 ? result < 0 : lhs.size() < rhs.size();
+}
+
+void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                                        int intra_op_num_threads) {
+  AddModel(model_name, model_version, LoadModel(model_path, intra_op_num_threads));
+}
+
+std::shared_ptr<ServableModel> ServerEnvironment::LoadModel(const std::string& model_path, int intra_op_num_threads) {
+  Ort::SessionOptions options;
+  if (intra_op_num_threads > 0) {
+    options.SetIntraOpNumThreads(intra_op_num_threads);
+  }
+
+  return std::make_shared<ServableModel>(runtime_environment_, model_path, options);
+}
+
+void ServerEnvironment::AddModel(const std::string& model_name, const std::string& model_version, std::shared_ptr<ServableModel> model) {
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  auto result = models_[model_name].emplace(model_version, std::move(model));
 
   if (!result.second) {
     throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
   }
+}
 
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
-
-  Ort::AllocatorWithDefaultOptions allocator;
-  for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
-    allocator.Free(name);
+std::shared_ptr<const ServableModel> ServerEnvironment::GetModel(const std::string& model_name, const std::string& model_version) const {
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  auto versions = models_.find(model_name);
+  if (versions != models_.end() && !versions->second.empty()) {
+    if (model_version.empty()) {
+      return versions->second.rbegin()->second;
+    }
+
+    auto it = versions->second.find(model_version);
+    if (it != versions->second.end()) {
+      return it->second;
+    }
   }
+
+  throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+ModelMetrics& ServerEnvironment::GetModelMetrics(const std::string& model_name) {
+  bool served;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    auto versions = models_.find(model_name);
+    served = versions != models_.end() && !versions->second.empty();
   }
 
-  return it->second.output_names;
+  return metrics_.GetModelMetrics(served ? model_name : ServerMetrics::kUnknownModel);
 }
 
-OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
-  return severity_;
+std::vector<std::string> ServerEnvironment::GetModelVersions(const std::string& model_name) const {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  auto versions = models_.find(model_name);
+  if (versions != models_.end()) {
+    for (const auto& version : versions->second) {
+      result.push_back(version.first);
+    }
+  }
+
+  return result;
 }
 
-const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+std::vector<ServerEnvironment::ModelEntry> ServerEnvironment::GetModels() const {
+  std::vector<ModelEntry> result;
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  for (const auto& versions : models_) {
+    for (const auto& version : versions.second) {
+      result.push_back({versions.first, version.first, version.second});
+    }
   }
 
-  return it->second.session;
+  return result;
+}
+
+OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
+  return severity_;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -95,13 +172,28 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 }
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  std::shared_ptr<ServableModel> unloaded;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    auto versions = models_.find(model_name);
+    if (versions == models_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    auto it = versions->second.find(model_version);
+    if (it == versions->second.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    unloaded = std::move(it->second);
+    versions->second.erase(it);
+    if (versions->second.empty()) {
+      models_.erase(versions);
+    }
   }
 
-  sessions_.erase(it);
+  // Release the session outside the lock, unless a request still holds it.
+  unloaded.reset();
 }
 
 }  // namespace server
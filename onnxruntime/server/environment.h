@@ -3,17 +3,41 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
-#include <boost/functional/hash.hpp>
+
+#include "metrics.h"
+#include "request_scheduler.h"
+#include "shared_memory.h"
 
 namespace onnxruntime {
 namespace server {
 
+// A loaded model version.
+// Requests hold a reference for the duration of the call, so a version that is unloaded or
+// replaced keeps serving its in-flight requests and is released when the last of them finishes.
+struct ServableModel {
+  ServableModel(Ort::Env& env, const std::string& path, const Ort::SessionOptions& options);
+  ~ServableModel() = default;
+  ServableModel(const ServableModel&) = delete;
+  ServableModel& operator=(const ServableModel&) = delete;
+
+  Ort::Session session;
+  std::vector<std::string> output_names;
+};
+
+// Orders model versions: numeric versions by value and below any non-numeric version, which are
+// ordered lexicographically.
+struct ModelVersionLess {
+  bool operator()(const std::string& lhs, const std::string& rhs) const;
+};
+
 class ServerEnvironment {
  public:
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
@@ -22,9 +46,50 @@ class ServerEnvironment {
 
   OrtLoggingLevel GetLogSeverity() const;
 
-  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
-  void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
-  const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Loads a model and serves it under the given name and version.
+  // intra_op_num_threads of 0 uses the runtime default.
+  void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                       int intra_op_num_threads = 0);
+
+  // Loads a model without serving it, so it can be warmed up before it receives traffic.
+  std::shared_ptr<ServableModel> LoadModel(const std::string& model_path, int intra_op_num_threads);
+
+  // Starts serving a loaded model. Throws if the name and version are already in use.
+  void AddModel(const std::string& model_name, const std::string& model_version, std::shared_ptr<ServableModel> model);
+
+  // Returns the requested version of a model, or its latest version by ModelVersionLess if model_version is empty.
+  // The session and output names stay valid while the returned pointer is held, even if the version is unloaded.
+  std::shared_ptr<const ServableModel> GetModel(const std::string& model_name, const std::string& model_version) const;
+
+  // Returns the served versions of a model in ascending order.
+  std::vector<std::string> GetModelVersions(const std::string& model_name) const;
+
+  struct ModelEntry {
+    std::string name;
+    std::string version;
+    std::shared_ptr<const ServableModel> model;
+  };
+
+  // Returns a snapshot of all served models.
+  std::vector<ModelEntry> GetModels() const;
+
+  ServerMetrics& GetMetrics() { return metrics_; }
+  const ServerMetrics& GetMetrics() const { return metrics_; }
+
+  // Returns the counters for a model. Model names come from requests, so requests for
+  // models that are not served share the ServerMetrics::kUnknownModel entry.
+  ModelMetrics& GetModelMetrics(const std::string& model_name);
+
+  // Sets the queue that prediction requests go through before they run.
+  // Without a scheduler, requests run on the thread that received them.
+  void SetScheduler(std::unique_ptr<RequestScheduler> scheduler) { scheduler_ = std::move(scheduler); }
+  RequestScheduler* GetScheduler() const { return scheduler_.get(); }
+
+  // Allows clients on the same host to pass tensors in shared memory. Disabled unless set.
+  void EnableSharedMemory() { shared_memory_.reset(new SharedMemoryManager()); }
+  void DisableSharedMemory() { shared_memory_.reset(); }
+  SharedMemoryManager* GetSharedMemory() const { return shared_memory_.get(); }
+
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
   void UnloadModel(const std::string& model_name, const std::string& model_version);
@@ -36,21 +101,19 @@ class ServerEnvironment {
   const std::shared_ptr<spdlog::logger> default_logger_;
 
   Ort::Env runtime_environment_;
-  Ort::SessionOptions options_;
-
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
+  ServerMetrics metrics_;
+
+  using ModelVersions = std::map<std::string, std::shared_ptr<ServableModel>, ModelVersionLess>;
+
+  // Guards models_. Lookups only copy a shared_ptr under the lock, so loading and
+  // unloading never block requests for longer than a map update.
+  mutable std::mutex models_mutex_;
+  std::unordered_map<std::string, ModelVersions> models_;
+
+  std::unique_ptr<SharedMemoryManager> shared_memory_;
 
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // Declared last so the workers stop before the models, the shared memory regions and the logger go away
+  std::unique_ptr<RequestScheduler> scheduler_;
 };
 
 }  // namespace server
@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
+#include <cstring>
 #include "core/common/logging/logging.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_types.h"
 #include "core/session/environment.h"
 #include "core/framework/framework_common.h"
@@ -15,6 +18,7 @@
 #include "predict.pb.h"
 
 #include "converter.h"
+#include "shared_memory.h"
 #include "executor.h"
 #include "util.h"
 
@@ -31,6 +35,16 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // Raw data that is already laid out as the tensor expects is used in place. The request outlives the Run call.
+  try {
+    if (onnxruntime::server::TryWrapRawDataAsMLValue(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TryWrapRawDataAsMLValue() failed. Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -87,7 +101,8 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+// Runs the session. Entries of outputs that are not null are preallocated and are written in place.
+void Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names, std::vector<Ort::Value>& outputs) {
   size_t input_count = input_names.size();
   size_t output_count = output_names.size();
 
@@ -102,7 +117,240 @@ std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions&
     output_ptrs.push_back(output.data());
   }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), outputs.data(), output_count);
+}
+
+// Returns the address of a tensor in a registered shared memory region, keeping the region mapped
+// for the rest of the request. The offset must be aligned to the element size.
+static protobufutil::Status GetSharedMemoryData(const SharedMemoryManager* shared_memory,
+                                                const onnxruntime::server::SharedMemoryTensor& tensor,
+                                                size_t byte_size,
+                                                size_t element_size,
+                                                std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions,
+                                                /* out */ void*& data) {
+  if (shared_memory == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED, "Shared memory is not enabled on this server");
+  }
+
+  auto region = shared_memory->GetRegion(tensor.region());
+  if (region == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::NOT_FOUND, "Shared memory region " + tensor.region() + " is not registered");
+  }
+
+  if (tensor.offset() % element_size != 0) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Shared memory offset is not aligned to the element size");
+  }
+
+  data = region->GetData(tensor.offset(), byte_size);
+  if (data == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::OUT_OF_RANGE, "Shared memory tensor does not fit into region " + tensor.region());
+  }
+
+  regions.push_back(std::move(region));
+  return protobufutil::Status::OK;
+}
+
+// Returns the element type and size in bytes described by a shared memory tensor.
+static protobufutil::Status GetSharedMemoryTensorSize(const onnxruntime::server::SharedMemoryTensor& tensor,
+                                                      /* out */ ONNXTensorElementDataType& element_type,
+                                                      /* out */ size_t& element_size,
+                                                      /* out */ size_t& byte_size) {
+  element_type = CApiElementTypeFromProtoType(tensor.data_type());
+  element_size = GetElementSize(element_type);
+  if (element_size == 0) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Unsupported data type for a shared memory tensor");
+  }
+
+  byte_size = element_size;
+  for (auto dim : tensor.dims()) {
+    if (dim < 0 || !IAllocator::CalcMemSizeForArray(byte_size, static_cast<size_t>(dim), &byte_size)) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Invalid shape for a shared memory tensor");
+    }
+  }
+
+  if (tensor.byte_size() != 0 && tensor.byte_size() != byte_size) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "byte_size of a shared memory tensor does not match its shape");
+  }
+
+  return protobufutil::Status::OK;
+}
+
+// The bytes of a shared memory object that a tensor of the request uses. Regions are compared by
+// key, so two names registered for the same object are recognized as the same memory.
+struct SharedMemorySpan {
+  std::string tensor;
+  std::string key;
+  uint64_t begin;
+  uint64_t end;
+
+  bool Overlaps(const SharedMemorySpan& other) const {
+    return key == other.key && begin < other.end && other.begin < end;
+  }
+};
+
+// Returns false if the region of the tensor is not registered or the tensor does not fit into it.
+static bool GetSharedMemorySpan(const SharedMemoryManager* shared_memory,
+                                const std::string& tensor_name,
+                                const onnxruntime::server::SharedMemoryTensor& tensor,
+                                uint64_t byte_size,
+                                /* out */ SharedMemorySpan& span) {
+  auto region = shared_memory == nullptr ? nullptr : shared_memory->GetRegion(tensor.region());
+  if (region == nullptr || region->GetData(tensor.offset(), byte_size) == nullptr) {
+    return false;
+  }
+
+  span = SharedMemorySpan{tensor_name, region->Key(), tensor.offset(), tensor.offset() + byte_size};
+  return true;
+}
+
+protobufutil::Status Executor::SetSharedMemoryInputs(std::vector<std::string>& input_names,
+                                                     std::vector<Ort::Value>& input_values,
+                                                     const onnxruntime::server::PredictRequest& request,
+                                                     std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions) {
+  if (request.shared_memory_inputs().empty()) {
+    return protobufutil::Status::OK;
+  }
+
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  for (const auto& input : request.shared_memory_inputs()) {
+    ONNXTensorElementDataType element_type;
+    size_t element_size = 0;
+    size_t byte_size = 0;
+    auto status = GetSharedMemoryTensorSize(input.second, element_type, element_size, byte_size);
+    void* data = nullptr;
+    if (status.ok()) {
+      status = GetSharedMemoryData(env_->GetSharedMemory(), input.second, byte_size, element_size, regions, data);
+    }
+    if (!status.ok()) {
+      env_->GetLogger(request_id_)->error("Shared memory input {} is invalid: {}", input.first, status.error_message());
+      return status;
+    }
+
+    std::vector<int64_t> shape(input.second.dims().begin(), input.second.dims().end());
+    try {
+      input_values.push_back(Ort::Value::CreateTensor(memory_info, data, byte_size, shape.data(), shape.size(), element_type));
+    } catch (const Ort::Exception& e) {
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+    input_names.push_back(input.first);
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status Executor::SetSharedMemoryOutputs(const std::vector<std::string>& output_names,
+                                                      const onnxruntime::server::PredictRequest& request,
+                                                      std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions,
+                                                      std::vector<Ort::Value>& outputs) {
+  if (request.shared_memory_outputs().empty()) {
+    return protobufutil::Status::OK;
+  }
+
+  // Outputs must not overlap the inputs or each other, or the run would overwrite data it still reads.
+  // The inputs were validated already.
+  std::vector<SharedMemorySpan> spans;
+  for (const auto& input : request.shared_memory_inputs()) {
+    ONNXTensorElementDataType element_type;
+    size_t element_size = 0;
+    size_t byte_size = 0;
+    SharedMemorySpan span;
+    if (GetSharedMemoryTensorSize(input.second, element_type, element_size, byte_size).ok() &&
+        GetSharedMemorySpan(env_->GetSharedMemory(), "input " + input.first, input.second, byte_size, span)) {
+      spans.push_back(std::move(span));
+    }
+  }
+
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    auto it = request.shared_memory_outputs().find(output_names[i]);
+    if (it == request.shared_memory_outputs().end()) {
+      continue;
+    }
+
+    // Outputs without a shape are copied into the byte_size given for them after the run
+    const bool in_place = !it->second.dims().empty();
+    ONNXTensorElementDataType element_type;
+    size_t element_size = 0;
+    size_t byte_size = it->second.byte_size();
+    void* data = nullptr;
+    protobufutil::Status status;
+    if (in_place) {
+      status = GetSharedMemoryTensorSize(it->second, element_type, element_size, byte_size);
+      if (status.ok()) {
+        status = GetSharedMemoryData(env_->GetSharedMemory(), it->second, byte_size, element_size, regions, data);
+      }
+    }
+
+    SharedMemorySpan span;
+    if (status.ok() && GetSharedMemorySpan(env_->GetSharedMemory(), "output " + output_names[i], it->second, byte_size, span)) {
+      for (const auto& other : spans) {
+        if (span.Overlaps(other)) {
+          status = protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Shared memory output overlaps " + other.tensor);
+          break;
+        }
+      }
+      spans.push_back(std::move(span));
+    }
+    if (!status.ok()) {
+      env_->GetLogger(request_id_)->error("Shared memory output {} is invalid: {}", output_names[i], status.error_message());
+      return status;
+    }
+
+    if (!in_place) {
+      continue;
+    }
+
+    std::vector<int64_t> shape(it->second.dims().begin(), it->second.dims().end());
+    try {
+      outputs[i] = Ort::Value::CreateTensor(memory_info, data, byte_size, shape.data(), shape.size(), element_type);
+    } catch (const Ort::Exception& e) {
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status Executor::WriteSharedMemoryOutput(const onnxruntime::server::SharedMemoryTensor& location,
+                                                       Ort::Value& output,
+                                                       std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions,
+                                                       /* out */ onnxruntime::server::SharedMemoryTensor& written) {
+  try {
+    auto info = output.GetTensorTypeAndShapeInfo();
+    auto element_type = info.GetElementType();
+    auto element_size = GetElementSize(element_type);
+    if (element_size == 0) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Unsupported data type for a shared memory output");
+    }
+
+    auto byte_size = info.GetElementCount() * element_size;
+    void* data = output.GetTensorMutableData<void>();
+    // Outputs with a shape in the request were computed in place
+    if (location.dims().empty()) {
+      if (byte_size > location.byte_size()) {
+        return protobufutil::Status(protobufutil::error::Code::OUT_OF_RANGE, "Output does not fit into the byte_size given for it");
+      }
+
+      void* destination = nullptr;
+      auto status = GetSharedMemoryData(env_->GetSharedMemory(), location, byte_size, element_size, regions, destination);
+      if (!status.ok()) {
+        return status;
+      }
+      memcpy(destination, data, byte_size);
+    }
+
+    written.set_region(location.region());
+    written.set_offset(location.offset());
+    written.set_byte_size(byte_size);
+    written.set_data_type(static_cast<int32_t>(element_type));
+    for (auto dim : info.GetShape()) {
+      written.add_dims(dim);
+    }
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  return protobufutil::Status::OK;
 }
 
 protobufutil::Status Executor::Predict(const std::string& model_name,
@@ -111,6 +359,15 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
   auto logger = env_->GetLogger(request_id_);
 
+  // Hold the model for the whole request so a concurrent reload or unload cannot release it
+  std::shared_ptr<const ServableModel> model;
+  try {
+    model = env_->GetModel(model_name, model_version);
+  } catch (const Ort::Exception& e) {
+    logger->error("GetModel() failed. Model: {}, Version: {}. Error Message: {}", model_name, model_version, e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   // Convert PredictRequest to NameMLValMap
   MemBufferArray buffer_array;
   std::vector<std::string> input_names;
@@ -120,6 +377,13 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
     return conversion_status;
   }
 
+  // Shared memory regions used by the request stay mapped until it finishes, even if they are unregistered
+  std::vector<std::shared_ptr<const SharedMemoryRegion>> regions;
+  conversion_status = SetSharedMemoryInputs(input_names, input_values, request, regions);
+  if (conversion_status != protobufutil::Status::OK) {
+    return conversion_status;
+  }
+
   Ort::RunOptions run_options{};
   run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
   run_options.SetRunTag(request_id_.c_str());
@@ -133,36 +397,93 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       output_names.push_back(name);
     }
   } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
+    output_names = model->output_names;
+  }
+
+  // Outputs requested in shared memory are computed even if the output filter does not name them
+  for (const auto& output : request.shared_memory_outputs()) {
+    if (std::find(output_names.begin(), output_names.end(), output.first) == output_names.end()) {
+      output_names.push_back(output.first);
+    }
   }
 
   std::vector<Ort::Value> outputs;
+  outputs.reserve(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    outputs.emplace_back(nullptr);
+  }
+
+  conversion_status = SetSharedMemoryOutputs(output_names, request, regions, outputs);
+  if (conversion_status != protobufutil::Status::OK) {
+    return conversion_status;
+  }
+
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    Run(model->session, run_options, input_names, input_values, output_names, outputs);
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
 
-  // Build the response
+  // Build the response. Each output is converted directly into its map entry so the tensor data is copied once.
+  auto& response_outputs = *response.mutable_outputs();
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    auto shared_memory_output = request.shared_memory_outputs().find(output_names[i]);
+    if (shared_memory_output != request.shared_memory_outputs().end()) {
+      auto status = WriteSharedMemoryOutput(shared_memory_output->second, outputs[i], regions,
+                                            (*response.mutable_shared_memory_outputs())[output_names[i]]);
+      if (!status.ok()) {
+        logger->error("Writing output {} to shared memory failed: {}", output_names[i], status.error_message());
+        return status;
+      }
+      continue;
+    }
+
+    if (response_outputs.count(output_names[i]) != 0) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
+
     try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
+      MLValueToTensorProto(outputs[i], using_raw_data_, logger, response_outputs[output_names[i]]);
     } catch (const Ort::Exception& e) {
       logger = env_->GetLogger(request_id_);
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
+  }
+
+  return protobufutil::Status::OK;
+}
 
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
+protobufutil::Status Executor::SchedulePredict(const std::string& model_name,
+                                               const std::string& model_version,
+                                               int priority,
+                                               RequestScheduler::Clock::time_point deadline,
+                                               const onnxruntime::server::PredictRequest& request,
+                                               /* out */ onnxruntime::server::PredictResponse& response,
+                                               ModelMetrics& metrics) {
+  auto* scheduler = env_->GetScheduler();
+  if (scheduler == nullptr) {
+    ScopedLatency inference_latency(metrics.inference_latency);
+    return Predict(model_name, model_version, request, response);
+  }
 
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
+  auto queued = RequestScheduler::Clock::now();
+  bool ran = false;
+  auto status = scheduler->Run(model_name, priority, deadline, [&]() {
+    ran = true;
+    auto started = RequestScheduler::Clock::now();
+    metrics.queue_latency.Observe(std::chrono::duration_cast<std::chrono::microseconds>(started - queued));
+    ScopedLatency inference_latency(metrics.inference_latency);
+    return Predict(model_name, model_version, request, response);
+  });
+
+  if (!ran) {
+    metrics.rejected.fetch_add(1, std::memory_order_relaxed);
+    env_->GetLogger(request_id_)->warn("Request for model {} was not run: {}", model_name, status.error_message());
   }
 
-  return protobufutil::Status::OK;
+  return status;
 }
 
 }  // namespace server
@@ -25,6 +25,16 @@ class Executor {
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Runs Predict through the request scheduler of the environment, or inline if there is none,
+  // and records the queue and inference latency in metrics.
+  google::protobuf::util::Status SchedulePredict(const std::string& model_name,
+                                                 const std::string& model_version,
+                                                 int priority,
+                                                 RequestScheduler::Clock::time_point deadline,
+                                                 const onnxruntime::server::PredictRequest& request,
+                                                 /* out */ onnxruntime::server::PredictResponse& response,
+                                                 ModelMetrics& metrics);
+
  private:
   ServerEnvironment* env_;
   const std::string request_id_;
@@ -35,6 +45,23 @@ class Executor {
                                             OrtMemoryInfo* cpu_memory_info,
                                             /* out */ Ort::Value& ml_value);
 
+  google::protobuf::util::Status SetSharedMemoryInputs(/* out */ std::vector<std::string>& input_names,
+                                                       /* out */ std::vector<Ort::Value>& input_values,
+                                                       const onnxruntime::server::PredictRequest& request,
+                                                       std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions);
+
+  // Creates the outputs that are written directly into shared memory. Fails if a shared memory output
+  // overlaps a shared memory input or another shared memory output.
+  google::protobuf::util::Status SetSharedMemoryOutputs(const std::vector<std::string>& output_names,
+                                                        const onnxruntime::server::PredictRequest& request,
+                                                        std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions,
+                                                        /* out */ std::vector<Ort::Value>& outputs);
+
+  google::protobuf::util::Status WriteSharedMemoryOutput(const onnxruntime::server::SharedMemoryTensor& location,
+                                                         Ort::Value& output,
+                                                         std::vector<std::shared_ptr<const SharedMemoryRegion>>& regions,
+                                                         /* out */ onnxruntime::server::SharedMemoryTensor& written);
+
   google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
                                                    /* out */ std::vector<Ort::Value>& input_values,
                                                    const onnxruntime::server::PredictRequest& request,
@@ -1,5 +1,6 @@
 #include "prediction_service_impl.h"
 #include "request_id.h"
+#include "metrics.h"
 
 namespace onnxruntime {
 namespace server {
@@ -9,15 +10,77 @@ PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
+  auto metadata = context->client_metadata();
+
+  // The model is selected with metadata, as with a model repository there is no single model to serve.
+  // Without it the latest version of the model named "default" runs, which is the model given with --model_path.
+  std::string model_name = "default";
+  std::string model_version;
+  auto name = metadata.find(util::MS_MODEL_NAME_HEADER);
+  if (name != metadata.end()) {
+    model_name.assign(name->second.data(), name->second.length());
+  }
+  auto version = metadata.find(util::MS_MODEL_VERSION_HEADER);
+  if (version != metadata.end()) {
+    model_version.assign(version->second.data(), version->second.length());
+  }
+
+  auto& metrics = environment_->GetModelMetrics(model_name);
+  RequestMetricsScope request_metrics(metrics);
+
+  int priority = 0;
+  auto deadline = GetDeadline(context);
+  auto search = metadata.find(util::MS_REQUEST_PRIORITY_HEADER);
+  if (search != metadata.end() && !ParseRequestPriority(std::string(search->second.data(), search->second.length()), priority)) {
+    return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Invalid '" + util::MS_REQUEST_PRIORITY_HEADER + "' metadata in the request");
+  }
+
   onnxruntime::server::Executor executor(environment_.get(), request_id);
-  //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  auto status = executor.SchedulePredict(model_name, model_version, priority, deadline, *request, *response, metrics);
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
+  request_metrics.Succeeded();
   return ::grpc::Status::OK;
 }
 
+::grpc::Status PredictionServiceImpl::RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* /*response*/) {
+  auto request_id = SetRequestContext(context);
+  auto* shared_memory = environment_->GetSharedMemory();
+  if (shared_memory == nullptr) {
+    return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "Shared memory is not enabled on this server");
+  }
+
+  auto status = shared_memory->Register(request->name(), request->key(), request->byte_size());
+  if (!status.ok()) {
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+
+  environment_->GetLogger(request_id)->info("Registered shared memory region {} for {}", request->name(), request->key());
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* /*response*/) {
+  SetRequestContext(context);
+  auto* shared_memory = environment_->GetSharedMemory();
+  if (shared_memory == nullptr) {
+    return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "Shared memory is not enabled on this server");
+  }
+
+  auto status = shared_memory->Unregister(request->name());
+  if (!status.ok()) {
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+
+  return ::grpc::Status::OK;
+}
+
+// Converts the GRPC deadline of the call to the clock of the scheduler. Calls without a deadline have an infinite one.
+RequestScheduler::Clock::time_point PredictionServiceImpl::GetDeadline(::grpc::ServerContext* context) {
+  auto remaining = context->deadline() - std::chrono::system_clock::now();
+  return GetRequestDeadline(std::chrono::duration_cast<std::chrono::milliseconds>(remaining));
+}
+
 std::string PredictionServiceImpl::SetRequestContext(::grpc::ServerContext* context) {
   auto metadata = context->client_metadata();
   auto request_id = util::InternalRequestId();
@@ -11,12 +11,16 @@ class PredictionServiceImpl final : public onnxruntime::server::PredictionServic
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
   ::grpc::Status Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response);
+  ::grpc::Status RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* response);
+  ::grpc::Status UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* response);
 
  private:
   std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
 
   //Extract customer request ID and set request ID for response.
   std::string SetRequestContext(::grpc::ServerContext* context);
+
+  static RequestScheduler::Clock::time_point GetDeadline(::grpc::ServerContext* context);
 };
 }  // namespace grpc
 }  // namespace server
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
 #include "re2/re2.h"
 
@@ -17,12 +18,17 @@ bool Routes::RegisterController(http::verb method, const std::string& url_patter
     return false;
   }
 
+  auto regex = std::make_shared<const re2::RE2>(url_pattern);
+  if (!regex->ok()) {
+    return false;
+  }
+
   switch (method) {
     case http::verb::get:
-      this->get_fn_table.emplace_back(url_pattern, controller);
+      this->get_fn_table.emplace_back(std::move(regex), controller);
       return true;
     case http::verb::post:
-      this->post_fn_table.emplace_back(url_pattern, controller);
+      this->post_fn_table.emplace_back(std::move(regex), controller);
       return true;
     default:
       return false;
@@ -44,25 +50,32 @@ http::status Routes::ParseUrl(http::verb method,
                               /* out */ std::string& model_version,
                               /* out */ std::string& action,
                               /* out */ HandlerFn& func) const {
-  std::vector<std::pair<std::string, HandlerFn>> func_table;
+  const std::vector<std::pair<std::shared_ptr<const re2::RE2>, HandlerFn>>* func_table;
   switch (method) {
     case http::verb::get:
-      func_table = this->get_fn_table;
+      func_table = &this->get_fn_table;
       break;
     case http::verb::post:
-      func_table = this->post_fn_table;
+      func_table = &this->post_fn_table;
       break;
     default:
       return http::status::method_not_allowed;
   }
 
-  if (func_table.empty()) {
+  if (func_table->empty()) {
     return http::status::method_not_allowed;
   }
 
+  const re2::RE2::Arg name_arg(&model_name);
+  const re2::RE2::Arg version_arg(&model_version);
+  const re2::RE2::Arg action_arg(&action);
+  const re2::RE2::Arg* const args[] = {&name_arg, &version_arg, &action_arg};
+
   bool found_match = false;
-  for (const auto& pattern : func_table) {
-    if (re2::RE2::FullMatch(url, pattern.first, &model_name, &model_version, &action)) {
+  for (const auto& pattern : *func_table) {
+    const auto& regex = *pattern.first;
+    int arg_count = std::min(regex.NumberOfCapturingGroups(), 3);
+    if (re2::RE2::FullMatchN(url, regex, args, arg_count)) {
       func = pattern.second;
 
       found_match = true;
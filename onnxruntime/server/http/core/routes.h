@@ -3,10 +3,16 @@
 
 #pragma once
 
+#include <memory>
+
 #include <boost/beast/http.hpp>
 
 #include "context.h"
 
+namespace re2 {
+class RE2;
+}
+
 namespace onnxruntime {
 namespace server {
 
@@ -17,6 +23,8 @@ using ErrorFn = std::function<void(HttpContext&)>;
 
 // This class maintains two lists of regex -> function lists. One for POST requests and one for GET requests
 // If the incoming URL could match more than one regex, the first one will win.
+// The first three capturing groups of a regex are passed to the function as model name, version and action.
+// Patterns with fewer groups leave the remaining arguments empty.
 class Routes {
  public:
   Routes() = default;
@@ -32,8 +40,9 @@ class Routes {
                         /* out */ HandlerFn& func) const;
 
  private:
-  std::vector<std::pair<std::string, HandlerFn>> post_fn_table;
-  std::vector<std::pair<std::string, HandlerFn>> get_fn_table;
+  // The patterns are compiled once at registration
+  std::vector<std::pair<std::shared_ptr<const re2::RE2>, HandlerFn>> post_fn_table;
+  std::vector<std::pair<std::shared_ptr<const re2::RE2>, HandlerFn>> get_fn_table;
 };
 
 }  //namespace server
@@ -1,8 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iomanip>
+#include <limits>
+#include <sstream>
+#include <type_traits>
 
 #include <boost/beast/core.hpp>
 #include <google/protobuf/util/json_util.h>
@@ -15,7 +22,622 @@ namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
 namespace server {
 
+namespace {
+
+// The protobuf JSON utilities go through a reflection based object writer which is slow for large tensors.
+// The functions below handle the common PredictRequest and PredictResponse layouts directly. They produce the
+// same result as the protobuf JSON utilities, and return false for anything they don't handle so the caller can
+// fall back to protobuf, which also provides the error messages for invalid input.
+
+const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int Base64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  // protobuf accepts both the standard and the web safe alphabets
+  if (c == '+' || c == '-') return 62;
+  if (c == '/' || c == '_') return 63;
+  return -1;
+}
+
+void AppendBase64(const std::string& data, std::string& out) {
+  const auto* src = reinterpret_cast<const unsigned char*>(data.data());
+  const size_t len = data.size();
+
+  const size_t offset = out.size();
+  out.resize(offset + (len + 2) / 3 * 4);
+  char* dst = &out[offset];
+
+  size_t i = 0;
+  for (; i + 2 < len; i += 3) {
+    uint32_t v = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | uint32_t(src[i + 2]);
+    *dst++ = kBase64Chars[(v >> 18) & 0x3f];
+    *dst++ = kBase64Chars[(v >> 12) & 0x3f];
+    *dst++ = kBase64Chars[(v >> 6) & 0x3f];
+    *dst++ = kBase64Chars[v & 0x3f];
+  }
+
+  if (i < len) {
+    uint32_t v = uint32_t(src[i]) << 16;
+    if (i + 1 < len) {
+      v |= uint32_t(src[i + 1]) << 8;
+    }
+
+    *dst++ = kBase64Chars[(v >> 18) & 0x3f];
+    *dst++ = kBase64Chars[(v >> 12) & 0x3f];
+    *dst++ = i + 1 < len ? kBase64Chars[(v >> 6) & 0x3f] : '=';
+    *dst++ = '=';
+  }
+}
+
+bool DecodeBase64(const char* src, size_t len, std::string& out) {
+  size_t padding = 0;
+  while (len > 0 && src[len - 1] == '=') {
+    --len;
+    ++padding;
+  }
+
+  if (padding > 2 || len % 4 == 1 || (padding > 0 && (len + padding) % 4 != 0)) {
+    return false;
+  }
+
+  out.resize(len / 4 * 3 + (len % 4 == 0 ? 0 : len % 4 - 1));
+  char* dst = &out[0];
+
+  uint32_t bits = 0;
+  int num_bits = 0;
+  for (size_t i = 0; i < len; ++i) {
+    int value = Base64Value(src[i]);
+    if (value < 0) {
+      return false;
+    }
+
+    bits = (bits << 6) | static_cast<uint32_t>(value);
+    num_bits += 6;
+    if (num_bits >= 8) {
+      num_bits -= 8;
+      *dst++ = static_cast<char>((bits >> num_bits) & 0xff);
+    }
+  }
+
+  return true;
+}
+
+// Strings that can be written to JSON as-is by both this code and protobuf.
+bool IsPlainString(const std::string& value) {
+  return std::all_of(value.cbegin(), value.cend(), [](char c) {
+    return c >= 0x20 && c < 0x7f && c != '"' && c != '\\' && c != '<' && c != '>' && c != '&' && c != '\'' &&
+           c != '=';
+  });
+}
+
+void AppendString(const std::string& value, std::string& out) {
+  out += '"';
+  out += value;
+  out += '"';
+}
+
+inline float ParseFloatingPoint(const char* str, float) { return strtof(str, nullptr); }
+inline double ParseFloatingPoint(const char* str, double) { return strtod(str, nullptr); }
+
+// Format floating point values the same way as protobuf, using the shortest of two precisions that round trips.
+template <typename T>
+void AppendFloatingPoint(T value, std::string& out) {
+  if (std::isnan(value)) {
+    out += "\"NaN\"";
+    return;
+  }
+
+  if (std::isinf(value)) {
+    out += value > 0 ? "\"Infinity\"" : "\"-Infinity\"";
+    return;
+  }
+
+  constexpr int digits = std::numeric_limits<T>::digits10;
+  char buffer[40];
+  snprintf(buffer, sizeof(buffer), "%.*g", digits, static_cast<double>(value));
+  if (ParseFloatingPoint(buffer, value) != value) {
+    snprintf(buffer, sizeof(buffer), "%.*g", digits + (std::is_same<T, float>::value ? 3 : 2),
+             static_cast<double>(value));
+  }
+
+  out += buffer;
+}
+
+template <typename Container, typename Func>
+void AppendArray(const Container& values, std::string& out, Func append_element) {
+  out += '[';
+  bool first = true;
+  for (const auto& value : values) {
+    if (!first) {
+      out += ',';
+    }
+
+    first = false;
+    append_element(value);
+  }
+  out += ']';
+}
+
+// Fields are written in field number order, matching the protobuf JSON output.
+bool AppendTensor(const onnx::TensorProto& tensor, std::string& out) {
+  if (tensor.has_segment() || tensor.external_data_size() > 0 ||
+      !IsPlainString(tensor.name()) || !IsPlainString(tensor.doc_string())) {
+    return false;
+  }
+
+  bool first = true;
+  auto append_key = [&out, &first](const char* key) {
+    if (!first) {
+      out += ',';
+    }
+
+    first = false;
+    out += '"';
+    out += key;
+    out += "\":";
+  };
+
+  auto append_quoted_integer = [&out](auto value) { AppendString(std::to_string(value), out); };
+  auto append_integer = [&out](auto value) { out += std::to_string(value); };
+  auto append_float = [&out](auto value) { AppendFloatingPoint(value, out); };
+  auto append_bytes = [&out](const std::string& value) {
+    out += '"';
+    AppendBase64(value, out);
+    out += '"';
+  };
+
+  out += '{';
+
+  if (tensor.dims_size() > 0) {
+    append_key("dims");
+    AppendArray(tensor.dims(), out, append_quoted_integer);
+  }
+
+  if (tensor.has_data_type()) {
+    append_key("dataType");
+    append_integer(tensor.data_type());
+  }
+
+  if (tensor.float_data_size() > 0) {
+    append_key("floatData");
+    AppendArray(tensor.float_data(), out, append_float);
+  }
+
+  if (tensor.int32_data_size() > 0) {
+    append_key("int32Data");
+    AppendArray(tensor.int32_data(), out, append_integer);
+  }
+
+  if (tensor.string_data_size() > 0) {
+    append_key("stringData");
+    AppendArray(tensor.string_data(), out, append_bytes);
+  }
+
+  if (tensor.int64_data_size() > 0) {
+    append_key("int64Data");
+    AppendArray(tensor.int64_data(), out, append_quoted_integer);
+  }
+
+  if (tensor.has_name()) {
+    append_key("name");
+    AppendString(tensor.name(), out);
+  }
+
+  if (tensor.has_raw_data()) {
+    append_key("rawData");
+    append_bytes(tensor.raw_data());
+  }
+
+  if (tensor.double_data_size() > 0) {
+    append_key("doubleData");
+    AppendArray(tensor.double_data(), out, append_float);
+  }
+
+  if (tensor.uint64_data_size() > 0) {
+    append_key("uint64Data");
+    AppendArray(tensor.uint64_data(), out, append_quoted_integer);
+  }
+
+  if (tensor.has_doc_string()) {
+    append_key("docString");
+    AppendString(tensor.doc_string(), out);
+  }
+
+  if (tensor.has_data_location()) {
+    append_key("dataLocation");
+    AppendString(onnx::TensorProto_DataLocation_Name(tensor.data_location()), out);
+  }
+
+  out += '}';
+  return true;
+}
+
+bool WriteResponse(const onnxruntime::server::PredictResponse& response, std::string& json_string) {
+  // Responses describing shared memory outputs are small and go through the generic printer
+  if (!response.shared_memory_outputs().empty()) {
+    return false;
+  }
+
+  // reserve for the base64 encoded raw data which is the bulk of the response in most cases
+  size_t estimated_size = 16;
+  for (const auto& output : response.outputs()) {
+    const auto& tensor = output.second;
+    estimated_size += output.first.size() + 64 + tensor.raw_data().size() / 3 * 4 +
+                      24 * (tensor.float_data_size() + tensor.int32_data_size() + tensor.int64_data_size() +
+                            tensor.double_data_size() + tensor.uint64_data_size());
+  }
+
+  json_string.clear();
+  json_string.reserve(estimated_size);
+  json_string += '{';
+
+  if (!response.outputs().empty()) {
+    json_string += "\"outputs\":{";
+
+    bool first = true;
+    for (const auto& output : response.outputs()) {
+      if (!IsPlainString(output.first)) {
+        return false;
+      }
+
+      if (!first) {
+        json_string += ',';
+      }
+
+      first = false;
+      AppendString(output.first, json_string);
+      json_string += ':';
+
+      if (!AppendTensor(output.second, json_string)) {
+        return false;
+      }
+    }
+
+    json_string += '}';
+  }
+
+  json_string += '}';
+  return true;
+}
+
+// Single pass reader for PredictRequest JSON.
+class RequestReader {
+ public:
+  explicit RequestReader(const std::string& json) : cur_(json.data()), end_(json.data() + json.size()) {}
+
+  bool Read(onnxruntime::server::PredictRequest& request) {
+    bool ok = ReadObject([this, &request](const std::string& key) {
+      if (key == "inputs") {
+        return ReadObject([this, &request](const std::string& name) {
+          auto& inputs = *request.mutable_inputs();
+          if (inputs.find(name) != inputs.end()) {
+            return false;
+          }
+
+          return ReadTensor(inputs[name]);
+        });
+      }
+
+      if (key == "outputFilter" || key == "output_filter") {
+        return ReadArray([this, &request]() { return ReadString(*request.add_output_filter()); });
+      }
+
+      return false;
+    });
+
+    SkipWhitespace();
+    return ok && cur_ == end_;
+  }
+
+ private:
+  bool ReadTensor(onnx::TensorProto& tensor) {
+    return ReadObject([this, &tensor](const std::string& key) {
+      if (key == "dims") {
+        return ReadArray([this, &tensor]() {
+          int64_t value;
+          return ReadInteger(value, true) && (tensor.add_dims(value), true);
+        });
+      }
+
+      if (key == "dataType" || key == "data_type") {
+        int64_t value;
+        if (!ReadInteger(value, false) || value < std::numeric_limits<int32_t>::min() ||
+            value > std::numeric_limits<int32_t>::max()) {
+          return false;
+        }
+
+        tensor.set_data_type(static_cast<int32_t>(value));
+        return true;
+      }
+
+      if (key == "rawData" || key == "raw_data") {
+        return ReadBytes(*tensor.mutable_raw_data());
+      }
+
+      if (key == "floatData" || key == "float_data") {
+        return ReadArray([this, &tensor]() {
+          double value;
+          if (!ReadDouble(value) || std::abs(value) > std::numeric_limits<float>::max()) {
+            return false;
+          }
+
+          tensor.add_float_data(static_cast<float>(value));
+          return true;
+        });
+      }
+
+      if (key == "doubleData" || key == "double_data") {
+        return ReadArray([this, &tensor]() {
+          double value;
+          return ReadDouble(value) && (tensor.add_double_data(value), true);
+        });
+      }
+
+      if (key == "int32Data" || key == "int32_data") {
+        return ReadArray([this, &tensor]() {
+          int64_t value;
+          if (!ReadInteger(value, false) || value < std::numeric_limits<int32_t>::min() ||
+              value > std::numeric_limits<int32_t>::max()) {
+            return false;
+          }
+
+          tensor.add_int32_data(static_cast<int32_t>(value));
+          return true;
+        });
+      }
+
+      if (key == "int64Data" || key == "int64_data") {
+        return ReadArray([this, &tensor]() {
+          int64_t value;
+          return ReadInteger(value, true) && (tensor.add_int64_data(value), true);
+        });
+      }
+
+      if (key == "uint64Data" || key == "uint64_data") {
+        return ReadArray([this, &tensor]() {
+          int64_t value;
+          if (!ReadInteger(value, true) || value < 0) {
+            return false;
+          }
+
+          tensor.add_uint64_data(static_cast<uint64_t>(value));
+          return true;
+        });
+      }
+
+      if (key == "stringData" || key == "string_data") {
+        return ReadArray([this, &tensor]() { return ReadBytes(*tensor.add_string_data()); });
+      }
+
+      if (key == "name") {
+        return ReadString(*tensor.mutable_name());
+      }
+
+      if (key == "docString" || key == "doc_string") {
+        return ReadString(*tensor.mutable_doc_string());
+      }
+
+      if (key == "dataLocation" || key == "data_location") {
+        std::string value;
+        onnx::TensorProto_DataLocation location;
+        if (!ReadString(value) || !onnx::TensorProto_DataLocation_Parse(value, &location)) {
+          return false;
+        }
+
+        tensor.set_data_location(location);
+        return true;
+      }
+
+      return false;
+    });
+  }
+
+  // on_member is called with the key once the reader is positioned at the value
+  template <typename Func>
+  bool ReadObject(Func on_member) {
+    if (!Expect('{')) {
+      return false;
+    }
+
+    if (Expect('}')) {
+      return true;
+    }
+
+    do {
+      std::string key;
+      if (!ReadString(key) || !Expect(':') || !on_member(key)) {
+        return false;
+      }
+    } while (Expect(','));
+
+    return Expect('}');
+  }
+
+  template <typename Func>
+  bool ReadArray(Func on_element) {
+    if (!Expect('[')) {
+      return false;
+    }
+
+    if (Expect(']')) {
+      return true;
+    }
+
+    do {
+      SkipWhitespace();
+      if (!on_element()) {
+        return false;
+      }
+    } while (Expect(','));
+
+    return Expect(']');
+  }
+
+  // read a string that has no escape sequences. escaped strings are left to protobuf.
+  bool ReadRawString(const char*& begin, size_t& length) {
+    if (!Expect('"')) {
+      return false;
+    }
+
+    begin = cur_;
+    while (cur_ < end_ && *cur_ != '"') {
+      if (*cur_ == '\\' || static_cast<unsigned char>(*cur_) < 0x20) {
+        return false;
+      }
+
+      ++cur_;
+    }
+
+    if (cur_ == end_) {
+      return false;
+    }
+
+    length = static_cast<size_t>(cur_ - begin);
+    ++cur_;
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    const char* begin;
+    size_t length;
+    if (!ReadRawString(begin, length)) {
+      return false;
+    }
+
+    value.assign(begin, length);
+    return true;
+  }
+
+  bool ReadBytes(std::string& value) {
+    const char* begin;
+    size_t length;
+    return ReadRawString(begin, length) && DecodeBase64(begin, length, value);
+  }
+
+  // find the end of a JSON number starting at cur_
+  bool ScanNumber(const char* begin, const char*& end, bool& is_integer) const {
+    const char* p = begin;
+    auto is_digit = [this](const char* c) { return c < end_ && *c >= '0' && *c <= '9'; };
+
+    if (p < end_ && *p == '-') {
+      ++p;
+    }
+
+    if (!is_digit(p) || (*p == '0' && is_digit(p + 1))) {
+      return false;
+    }
+
+    while (is_digit(p)) {
+      ++p;
+    }
+
+    is_integer = true;
+    if (p < end_ && *p == '.') {
+      is_integer = false;
+      if (!is_digit(++p)) {
+        return false;
+      }
+
+      while (is_digit(p)) {
+        ++p;
+      }
+    }
+
+    if (p < end_ && (*p == 'e' || *p == 'E')) {
+      is_integer = false;
+      ++p;
+      if (p < end_ && (*p == '+' || *p == '-')) {
+        ++p;
+      }
+
+      if (!is_digit(p)) {
+        return false;
+      }
+
+      while (is_digit(p)) {
+        ++p;
+      }
+    }
+
+    end = p;
+    return true;
+  }
+
+  // read an integer. 64-bit integers are written as strings in the protobuf JSON format so allow quotes if requested.
+  bool ReadInteger(int64_t& value, bool allow_quoted) {
+    bool quoted = allow_quoted && cur_ < end_ && *cur_ == '"';
+    if (quoted) {
+      ++cur_;
+    }
+
+    const char* end;
+    bool is_integer;
+    if (!ScanNumber(cur_, end, is_integer) || !is_integer) {
+      return false;
+    }
+
+    // the input is null terminated so strtoll will stop at the end of the number at the latest
+    errno = 0;
+    char* parse_end;
+    value = strtoll(cur_, &parse_end, 10);
+    if (errno == ERANGE || parse_end != end) {
+      return false;
+    }
+
+    cur_ = end;
+    return !quoted || (cur_ < end_ && *cur_++ == '"');
+  }
+
+  bool ReadDouble(double& value) {
+    const char* end;
+    bool is_integer;
+    if (!ScanNumber(cur_, end, is_integer)) {
+      return false;
+    }
+
+    char* parse_end;
+    value = strtod(cur_, &parse_end);
+    if (parse_end != end || std::isinf(value)) {
+      return false;
+    }
+
+    cur_ = end;
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r')) {
+      ++cur_;
+    }
+  }
+
+  // skip whitespace and consume the character if it's next
+  bool Expect(char c) {
+    SkipWhitespace();
+    if (cur_ < end_ && *cur_ == c) {
+      ++cur_;
+      return true;
+    }
+
+    return false;
+  }
+
+  const char* cur_;
+  const char* const end_;
+};
+
+}  // namespace
+
 protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request) {
+  RequestReader reader(json_string);
+  if (reader.Read(request)) {
+    return protobufutil::Status::OK;
+  }
+
+  request.Clear();
+
   protobufutil::JsonParseOptions options;
   options.ignore_unknown_fields = true;
 
@@ -24,6 +646,12 @@ protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out *
 }
 
 protobufutil::Status GenerateResponseInJson(const onnxruntime::server::PredictResponse& response, /* out */ std::string& json_string) {
+  if (WriteResponse(response, json_string)) {
+    return protobufutil::Status::OK;
+  }
+
+  json_string.clear();
+
   protobufutil::JsonPrintOptions options;
   options.add_whitespace = false;
   options.always_print_primitive_fields = false;
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "environment.h"
+#include "http_server.h"
+#include "metrics.h"
+#include "metrics_request_handler.h"
+
+namespace onnxruntime {
+namespace server {
+
+void Metrics(HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  std::string body;
+  WriteMetrics(*env, body);
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  context.response.set(http::field::content_type, "text/plain; version=0.0.4");
+  context.response.body() = std::move(body);
+  context.response.result(http::status::ok);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
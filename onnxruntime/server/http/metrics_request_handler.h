@@ -0,0 +1,17 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+
+namespace onnxruntime {
+namespace server {
+
+class ServerEnvironment;
+
+// Responds with the server metrics in the Prometheus text exposition format
+void Metrics(/* in, out */ HttpContext& context, const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include "http_server.h"
 #include "json_handling.h"
 #include "executor.h"
+#include "metrics.h"
 #include "util.h"
 
 namespace onnxruntime {
@@ -39,13 +40,17 @@ void Predict(const std::string& name,
   auto logger = env->GetLogger(context.request_id);
   logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
 
+  // An empty version selects the latest version of the model
   auto effective_name = name.empty() ? "default" : name;
-  auto effective_version = version.empty() ? "1" : version;
+  const auto& effective_version = version;
 
   if (!context.client_request_id.empty()) {
     logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
   }
 
+  auto& metrics = env->GetModelMetrics(effective_name);
+  RequestMetricsScope request_metrics(metrics);
+
   // Request and Response content type information
   SupportedContentType request_type = GetRequestContentType(context);
   SupportedContentType response_type = GetResponseContentType(context);
@@ -53,12 +58,22 @@ void Predict(const std::string& name,
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
 
+  int priority = 0;
+  auto deadline = RequestScheduler::Clock::time_point::max();
+  if (!GetRequestScheduling(context, priority, deadline)) {
+    GenerateErrorResponse(logger, http::status::bad_request, "Invalid '" + util::MS_REQUEST_PRIORITY_HEADER + "' or '" + util::MS_REQUEST_TIMEOUT_HEADER + "' header field in the request", context);
+    return;
+  }
+
   // Deserialize the payload
-  auto body = context.request.body();
   PredictRequest predict_request{};
   http::status error_code;
   std::string error_message;
-  bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
+  bool parse_succeeded;
+  {
+    ScopedLatency parse_latency(metrics.parse_latency);
+    parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
+  }
   if (!parse_succeeded) {
     GenerateErrorResponse(logger, error_code, error_message, context);
     return;
@@ -67,7 +82,8 @@ void Predict(const std::string& name,
   // Run Prediction
   Executor executor(env.get(), context.request_id);
   PredictResponse predict_response{};
-  auto status = executor.Predict(effective_name, effective_version, predict_request, predict_response);
+  auto status = executor.SchedulePredict(effective_name, effective_version, priority, deadline,
+                                         predict_request, predict_response, metrics);
   if (!status.ok()) {
     GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
     return;
@@ -75,6 +91,7 @@ void Predict(const std::string& name,
 
   // Serialize to proper output format
   std::string response_body{};
+  ScopedLatency serialize_latency(metrics.serialize_latency);
   if (response_type == SupportedContentType::Json) {
     status = GenerateResponseInJson(predict_response, response_body);
     if (!status.ok()) {
@@ -83,7 +100,7 @@ void Predict(const std::string& name,
     }
     context.response.set(http::field::content_type, "application/json");
   } else {
-    response_body = predict_response.SerializeAsString();
+    predict_response.SerializeToString(&response_body);
     if (context.request.find("Accept") != context.request.end() && context.request["Accept"] != "*/*") {
       context.response.set(http::field::content_type, context.request["Accept"].to_string());
     } else {
@@ -96,12 +113,13 @@ void Predict(const std::string& name,
   if (!context.client_request_id.empty()) {
     context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
   }
-  context.response.body() = response_body;
+  context.response.body() = std::move(response_body);
   context.response.result(http::status::ok);
+  request_metrics.Succeeded();
 };
 
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
-  auto body = context.request.body();
+  const auto& body = context.request.body();
   protobufutil::Status status;
   switch (request_type) {
     case SupportedContentType::Json: {
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <google/protobuf/stubs/status.h>
+#include <google/protobuf/util/json_util.h>
+
+#include "environment.h"
+#include "http_server.h"
+#include "json_handling.h"
+#include "shared_memory_request_handler.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+static void WriteResponse(const protobufutil::Status& status, HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+
+  if (status.ok()) {
+    context.response.result(http::status::ok);
+    context.response.body() = "{}";
+  } else {
+    auto http_error_code = GetHttpStatusCode(status);
+    env->GetLogger(context.request_id)->debug("Shared memory request failed: {}", status.error_message());
+    context.response.result(http_error_code);
+    context.response.body() = CreateJsonError(http_error_code, status.error_message());
+  }
+}
+
+static protobufutil::Status GetSharedMemory(const std::shared_ptr<ServerEnvironment>& env, SharedMemoryManager*& shared_memory) {
+  shared_memory = env->GetSharedMemory();
+  if (shared_memory == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED, "Shared memory is not enabled on this server");
+  }
+
+  return protobufutil::Status::OK;
+}
+
+void RegisterSharedMemory(const std::string& name, HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  SharedMemoryManager* shared_memory = nullptr;
+  auto status = GetSharedMemory(env, shared_memory);
+  if (!status.ok()) {
+    WriteResponse(status, context, env);
+    return;
+  }
+
+  RegisterSharedMemoryRequest request{};
+  const auto& body = context.request.body();
+  switch (GetRequestContentType(context)) {
+    case SupportedContentType::Json: {
+      protobufutil::JsonParseOptions options;
+      options.ignore_unknown_fields = true;
+      status = JsonStringToMessage(body, &request, options);
+      break;
+    }
+    case SupportedContentType::PbByteArray:
+      if (!request.ParseFromArray(body.data(), static_cast<int>(body.size()))) {
+        status = protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Invalid payload.");
+      }
+      break;
+    default:
+      status = protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Missing or unknown 'Content-Type' header field in the request");
+      break;
+  }
+
+  if (status.ok()) {
+    status = shared_memory->Register(name, request.key(), request.byte_size());
+  }
+  if (status.ok()) {
+    env->GetLogger(context.request_id)->info("Registered shared memory region {} for {}", name, request.key());
+  }
+
+  WriteResponse(status, context, env);
+}
+
+void UnregisterSharedMemory(const std::string& name, HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  SharedMemoryManager* shared_memory = nullptr;
+  auto status = GetSharedMemory(env, shared_memory);
+  if (status.ok()) {
+    status = shared_memory->Unregister(name);
+  }
+
+  WriteResponse(status, context, env);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+
+namespace onnxruntime {
+namespace server {
+
+class ServerEnvironment;
+
+// Registers a shared memory region under name. The body is a RegisterSharedMemoryRequest in JSON or protobuf;
+// its name field is ignored.
+void RegisterSharedMemory(const std::string& name,
+                          /* in, out */ HttpContext& context,
+                          const std::shared_ptr<ServerEnvironment>& env);
+
+void UnregisterSharedMemory(const std::string& name,
+                            /* in, out */ HttpContext& context,
+                            const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -25,14 +25,16 @@ boost::beast::http::status GetHttpStatusCode(const protobufutil::Status& status)
 
     case protobufutil::error::Code::UNKNOWN:
     case protobufutil::error::Code::DEADLINE_EXCEEDED:
-    case protobufutil::error::Code::RESOURCE_EXHAUSTED:
     case protobufutil::error::Code::ABORTED:
     case protobufutil::error::Code::UNIMPLEMENTED:
     case protobufutil::error::Code::INTERNAL:
-    case protobufutil::error::Code::UNAVAILABLE:
     case protobufutil::error::Code::DATA_LOSS:
       return boost::beast::http::status::internal_server_error;
 
+    case protobufutil::error::Code::RESOURCE_EXHAUSTED:
+    case protobufutil::error::Code::UNAVAILABLE:
+      return boost::beast::http::status::service_unavailable;
+
     case protobufutil::error::Code::CANCELLED:
     case protobufutil::error::Code::INVALID_ARGUMENT:
     case protobufutil::error::Code::ALREADY_EXISTS:
@@ -80,5 +82,23 @@ SupportedContentType GetResponseContentType(const HttpContext& context) {
   return SupportedContentType::Unknown;
 }
 
+bool GetRequestScheduling(const HttpContext& context, int& priority, RequestScheduler::Clock::time_point& deadline) {
+  auto priority_field = context.request.find(util::MS_REQUEST_PRIORITY_HEADER);
+  if (priority_field != context.request.end() && !ParseRequestPriority(priority_field->value().to_string(), priority)) {
+    return false;
+  }
+
+  auto timeout_field = context.request.find(util::MS_REQUEST_TIMEOUT_HEADER);
+  if (timeout_field != context.request.end()) {
+    std::chrono::milliseconds timeout{};
+    if (!ParseRequestTimeout(timeout_field->value().to_string(), timeout)) {
+      return false;
+    }
+    deadline = GetRequestDeadline(timeout);
+  }
+
+  return true;
+}
+
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <google/protobuf/stubs/status.h>
 
 #include "http/core/context.h"
+#include "request_scheduler.h"
 
 namespace onnxruntime {
 namespace server {
@@ -31,5 +32,9 @@ SupportedContentType GetRequestContentType(const HttpContext& context);
 // Currently we only support three types of response content type: */*, application/json and application/octet-stream
 SupportedContentType GetResponseContentType(const HttpContext& context);
 
+// "x-ms-request-priority" and "x-ms-request-timeout-ms" header fields in request are OPTIONAL.
+// Leaves priority and deadline unchanged for missing fields and returns false for malformed ones.
+bool GetRequestScheduling(const HttpContext& context, /* out */ int& priority, /* out */ RequestScheduler::Clock::time_point& deadline);
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -3,7 +3,10 @@
 
 #include "environment.h"
 #include "http_server.h"
+#include "model_repository.h"
 #include "predict_request_handler.h"
+#include "metrics_request_handler.h"
+#include "shared_memory_request_handler.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
 #include <spdlog/spdlog.h>
@@ -60,14 +63,39 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}", config.model_path);
 
-  try {
-    env->InitializeModel(config.model_path, "default", "1");
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+  std::unique_ptr<server::ModelRepository> repository;
+  if (!config.repository_path.empty()) {
+    logger->info("Model repository: {}", config.repository_path);
+    repository.reset(new server::ModelRepository(env, config.repository_path, config.intra_op_threads, config.per_model_threads));
+    if (repository->Poll() == 0) {
+      logger->critical("No models could be loaded from the model repository");
+      exit(EXIT_FAILURE);
+    }
+
+    if (config.repository_poll_seconds > 0) {
+      repository->StartPolling(std::chrono::seconds(config.repository_poll_seconds));
+    }
+  } else {
+    logger->info("Model path: {}", config.model_path);
+
+    try {
+      env->InitializeModel(config.model_path, "default", "1", config.intra_op_threads);
+      logger->debug("Initialize Model Successfully!");
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  env->SetScheduler(std::unique_ptr<server::RequestScheduler>(new server::RequestScheduler(
+      config.num_inference_threads, config.max_queue_size, config.max_runs_per_model)));
+  logger->info("Inference workers: {}, queue size: {}, runs per model: {}",
+               config.num_inference_threads, config.max_queue_size, config.max_runs_per_model);
+
+  if (config.enable_shared_memory) {
+    env->EnableSharedMemory();
+    logger->info("Shared memory transport enabled");
   }
 
   //Setup GRPC Server
@@ -109,6 +137,24 @@ int main(int argc, char* argv[]) {
         server::Predict(name, version, action, context, env);
       });
 
+  app.RegisterPost(
+      R"(/v1/shared_memory/([^/:]+):register)",
+      [&env](const auto& name, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::RegisterSharedMemory(name, context, env);
+      });
+
+  app.RegisterPost(
+      R"(/v1/shared_memory/([^/:]+):unregister)",
+      [&env](const auto& name, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::UnregisterSharedMemory(name, context, env);
+      });
+
+  app.RegisterGet(
+      R"(/metrics)",
+      [&env](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::Metrics(context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
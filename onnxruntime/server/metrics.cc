@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "environment.h"
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+static const std::array<uint64_t, LatencyHistogram::kBucketCount> kBucketBoundsUs = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000};
+
+static const char* const kOtherModels = "_other";
+
+// Label values are model names and versions from the repository or from request URLs
+static std::string EscapeLabelValue(const std::string& value) {
+  std::string result;
+  result.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (c == '\n') {
+      result.append("\\n");
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+static void AppendMetricHeader(const char* name, const char* type, const char* help, std::string& out) {
+  out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+  out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+template <typename T>
+static void AppendSample(const std::string& name, const std::string& labels, T value, std::string& out) {
+  out.append(name);
+  if (!labels.empty()) {
+    out.append("{").append(labels).append("}");
+  }
+  out.append(" ").append(std::to_string(value)).append("\n");
+}
+
+static std::string FormatSeconds(uint64_t microseconds) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.6g", static_cast<double>(microseconds) / 1e6);
+  return buffer;
+}
+
+void LatencyHistogram::Observe(std::chrono::microseconds latency) {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  auto bucket = std::lower_bound(kBucketBoundsUs.begin(), kBucketBoundsUs.end(), us) - kBucketBoundsUs.begin();
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(us, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Write(const std::string& name, const std::string& labels, std::string& out) const {
+  const std::string label_prefix = labels.empty() ? "" : labels + ",";
+
+  // Prometheus buckets are cumulative. The buckets are read one at a time, so a scrape that races with
+  // observations may be off by the requests in flight, which is acceptable for monitoring.
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    cumulative += buckets_[i].load(std::memory_order_relaxed);
+    AppendSample(name + "_bucket", label_prefix + "le=\"" + FormatSeconds(kBucketBoundsUs[i]) + "\"", cumulative, out);
+  }
+  cumulative += buckets_[kBucketCount].load(std::memory_order_relaxed);
+  AppendSample(name + "_bucket", label_prefix + "le=\"+Inf\"", cumulative, out);
+
+  out.append(name).append("_sum");
+  if (!labels.empty()) {
+    out.append("{").append(labels).append("}");
+  }
+  out.append(" ").append(FormatSeconds(sum_us_.load(std::memory_order_relaxed))).append("\n");
+  AppendSample(name + "_count", labels, cumulative, out);
+}
+
+ModelMetrics& ServerMetrics::GetModelMetrics(const std::string& model_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = models_.find(model_name);
+  if (it == models_.end()) {
+    const auto& name = models_.size() < kMaxModels ? model_name : std::string(kOtherModels);
+    it = models_.find(name);
+    if (it == models_.end()) {
+      it = models_.emplace(name, std::unique_ptr<ModelMetrics>(new ModelMetrics())).first;
+    }
+  }
+
+  return *it->second;
+}
+
+void ServerMetrics::Write(std::string& out) const {
+  std::vector<std::pair<std::string, const ModelMetrics*>> models;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& model : models_) {
+      models.emplace_back("model=\"" + EscapeLabelValue(model.first) + "\"", model.second.get());
+    }
+  }
+
+  AppendMetricHeader("onnxruntime_server_requests_total", "counter", "Number of prediction requests.", out);
+  for (const auto& model : models) {
+    AppendSample("onnxruntime_server_requests_total", model.first, model.second->requests.load(std::memory_order_relaxed), out);
+  }
+
+  AppendMetricHeader("onnxruntime_server_request_errors_total", "counter", "Number of prediction requests that failed.", out);
+  for (const auto& model : models) {
+    AppendSample("onnxruntime_server_request_errors_total", model.first, model.second->errors.load(std::memory_order_relaxed), out);
+  }
+
+  AppendMetricHeader("onnxruntime_server_requests_rejected_total", "counter", "Number of prediction requests rejected by the request queue.", out);
+  for (const auto& model : models) {
+    AppendSample("onnxruntime_server_requests_rejected_total", model.first, model.second->rejected.load(std::memory_order_relaxed), out);
+  }
+
+  AppendMetricHeader("onnxruntime_server_requests_in_flight", "gauge", "Number of prediction requests being processed.", out);
+  for (const auto& model : models) {
+    AppendSample("onnxruntime_server_requests_in_flight", model.first, model.second->in_flight.load(std::memory_order_relaxed), out);
+  }
+
+  const struct {
+    const char* name;
+    const char* help;
+    LatencyHistogram ModelMetrics::*histogram;
+  } histograms[] = {
+      {"onnxruntime_server_request_duration_seconds", "End to end latency of prediction requests.", &ModelMetrics::request_latency},
+      {"onnxruntime_server_parse_duration_seconds", "Time spent deserializing prediction requests.", &ModelMetrics::parse_latency},
+      {"onnxruntime_server_queue_duration_seconds", "Time spent waiting in the request queue.", &ModelMetrics::queue_latency},
+      {"onnxruntime_server_inference_duration_seconds", "Time spent running the model, including tensor conversion.", &ModelMetrics::inference_latency},
+      {"onnxruntime_server_serialize_duration_seconds", "Time spent serializing prediction responses.", &ModelMetrics::serialize_latency},
+  };
+
+  for (const auto& histogram : histograms) {
+    AppendMetricHeader(histogram.name, "histogram", histogram.help, out);
+    for (const auto& model : models) {
+      (model.second->*histogram.histogram).Write(histogram.name, model.first, out);
+    }
+  }
+}
+
+void WriteMetrics(const ServerEnvironment& env, std::string& out) {
+  env.GetMetrics().Write(out);
+
+  Ort::MemoryInfo cpu_memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  std::string bytes_in_use;
+  std::string total_allocated_bytes;
+  std::string max_bytes_in_use;
+  for (const auto& model : env.GetModels()) {
+    size_t in_use = 0;
+    size_t allocated = 0;
+    size_t max_in_use = 0;
+    try {
+      model.model->session.GetArenaStats(cpu_memory_info, in_use, allocated, max_in_use);
+    } catch (const Ort::Exception&) {
+      // The session does not use an arena for CPU memory
+      continue;
+    }
+
+    auto labels = "model=\"" + EscapeLabelValue(model.name) + "\",version=\"" + EscapeLabelValue(model.version) + "\"";
+    AppendSample("onnxruntime_server_arena_bytes_in_use", labels, in_use, bytes_in_use);
+    AppendSample("onnxruntime_server_arena_allocated_bytes", labels, allocated, total_allocated_bytes);
+    AppendSample("onnxruntime_server_arena_max_bytes_in_use", labels, max_in_use, max_bytes_in_use);
+  }
+
+  AppendMetricHeader("onnxruntime_server_arena_bytes_in_use", "gauge", "Bytes in use in the CPU arena of a model.", out);
+  out.append(bytes_in_use);
+  AppendMetricHeader("onnxruntime_server_arena_allocated_bytes", "gauge", "Bytes reserved by the CPU arena of a model.", out);
+  out.append(total_allocated_bytes);
+  AppendMetricHeader("onnxruntime_server_arena_max_bytes_in_use", "gauge", "Peak bytes in use in the CPU arena of a model.", out);
+  out.append(max_bytes_in_use);
+}
+
+RequestMetricsScope::RequestMetricsScope(ModelMetrics& metrics)
+    : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+  metrics_.requests.fetch_add(1, std::memory_order_relaxed);
+  metrics_.in_flight.fetch_add(1, std::memory_order_relaxed);
+}
+
+RequestMetricsScope::~RequestMetricsScope() {
+  metrics_.request_latency.Observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_));
+  if (!succeeded_) {
+    metrics_.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  metrics_.in_flight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
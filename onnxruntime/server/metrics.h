@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace onnxruntime {
+namespace server {
+
+class ServerEnvironment;
+
+// Latency histogram with fixed buckets from 100us to 10s.
+// Observations only use relaxed atomics, so they are safe and cheap on the request path.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 16;
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Observe(std::chrono::microseconds latency);
+
+  // Appends the histogram in the Prometheus text format. labels is a comma separated list of label="value" pairs.
+  void Write(const std::string& name, const std::string& labels, std::string& out) const;
+
+ private:
+  // The last bucket counts the observations above the largest bound
+  std::array<std::atomic<uint64_t>, kBucketCount + 1> buckets_{};
+  std::atomic<uint64_t> sum_us_{0};
+};
+
+// Counters for one model, across all of its versions.
+struct ModelMetrics {
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> errors{0};
+  // Requests turned away by the scheduler because the queue was full or they would miss their deadline
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<int64_t> in_flight{0};
+
+  LatencyHistogram request_latency;
+  LatencyHistogram parse_latency;
+  LatencyHistogram queue_latency;
+  LatencyHistogram inference_latency;
+  LatencyHistogram serialize_latency;
+};
+
+class ServerMetrics {
+ public:
+  ServerMetrics() = default;
+  ServerMetrics(const ServerMetrics&) = delete;
+  ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+  // Returns the counters for a model. The reference stays valid for the lifetime of this object.
+  // After kMaxModels names all new names share one entry.
+  ModelMetrics& GetModelMetrics(const std::string& model_name);
+
+  // Appends all counters in the Prometheus text format.
+  void Write(std::string& out) const;
+
+  static constexpr size_t kMaxModels = 256;
+
+  // Name that requests for models which are not served are counted under
+  static constexpr const char* kUnknownModel = "_unknown";
+
+ private:
+  // Only guards the map; the counters themselves are atomics.
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<ModelMetrics>> models_;
+};
+
+// Appends the counters of env and the arena memory usage of its loaded models in the Prometheus text format.
+void WriteMetrics(const ServerEnvironment& env, std::string& out);
+
+// Counts a request, tracks it as in flight and records its latency when it goes out of scope.
+// The request is counted as an error unless Succeeded is called.
+class RequestMetricsScope {
+ public:
+  explicit RequestMetricsScope(ModelMetrics& metrics);
+  ~RequestMetricsScope();
+  RequestMetricsScope(const RequestMetricsScope&) = delete;
+  RequestMetricsScope& operator=(const RequestMetricsScope&) = delete;
+
+  void Succeeded() { succeeded_ = true; }
+
+ private:
+  ModelMetrics& metrics_;
+  const std::chrono::steady_clock::time_point start_;
+  bool succeeded_ = false;
+};
+
+// Records the time until it goes out of scope in a histogram.
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() {
+    histogram_.Observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_));
+  }
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram& histogram_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
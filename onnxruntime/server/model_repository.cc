@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "model_repository.h"
+#include "serializing/tensorprotoutils.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace fs = boost::filesystem;
+
+static const char* const kModelFileName = "model.onnx";
+
+static bool IsVersion(const std::string& name) {
+  return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Runs the model once on zero-filled inputs so the first request does not pay for lazy
+// initialization such as weight packing and arena growth. Symbolic dimensions are set to 1.
+// Models with non-tensor inputs are not warmed up.
+static void WarmUp(ServableModel& model) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto input_count = model.session.GetInputCount();
+
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  for (size_t i = 0; i < input_count; ++i) {
+    auto type_info = model.session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return;
+    }
+
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    auto element_type = tensor_info.GetElementType();
+    auto shape = tensor_info.GetShape();
+    size_t element_count = 1;
+    for (auto& dim : shape) {
+      if (dim < 0) {
+        dim = 1;
+      }
+      element_count *= static_cast<size_t>(dim);
+    }
+
+    auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+    // String tensors are created holding empty strings
+    if (element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING && element_count > 0) {
+      memset(value.GetTensorMutableData<void>(), 0, element_count * GetElementSize(element_type));
+    }
+
+    auto name = model.session.GetInputName(i, allocator);
+    input_names.push_back(name);
+    allocator.Free(name);
+    input_values.push_back(std::move(value));
+  }
+
+  std::vector<const char*> input_ptrs;
+  for (const auto& name : input_names) {
+    input_ptrs.push_back(name.c_str());
+  }
+  std::vector<const char*> output_ptrs;
+  for (const auto& name : model.output_names) {
+    output_ptrs.push_back(name.c_str());
+  }
+
+  model.session.Run(Ort::RunOptions{}, input_ptrs.data(), input_values.data(), input_values.size(),
+                    output_ptrs.data(), output_ptrs.size());
+}
+
+ModelRepository::ModelRepository(std::shared_ptr<ServerEnvironment> env,
+                                 std::string base_path,
+                                 int default_intra_op_num_threads,
+                                 std::unordered_map<std::string, int> intra_op_num_threads)
+    : env_(std::move(env)),
+      base_path_(std::move(base_path)),
+      default_intra_op_num_threads_(default_intra_op_num_threads),
+      intra_op_num_threads_(std::move(intra_op_num_threads)) {}
+
+ModelRepository::~ModelRepository() {
+  StopPolling();
+}
+
+int ModelRepository::GetIntraOpNumThreads(const std::string& model_name) const {
+  auto it = intra_op_num_threads_.find(model_name);
+  return it == intra_op_num_threads_.end() ? default_intra_op_num_threads_ : it->second;
+}
+
+size_t ModelRepository::Poll() {
+  std::lock_guard<std::mutex> lock(poll_mutex_);
+  auto logger = env_->GetAppLogger();
+
+  // Find the latest version of every model in the repository
+  std::unordered_map<std::string, std::string> latest;
+  boost::system::error_code ec;
+  for (fs::directory_iterator model_it(base_path_, ec), end; !ec && model_it != end; model_it.increment(ec)) {
+    if (!fs::is_directory(model_it->status())) {
+      continue;
+    }
+
+    auto model_name = model_it->path().filename().string();
+    std::string latest_version;
+    for (fs::directory_iterator version_it(model_it->path(), ec); !ec && version_it != end; version_it.increment(ec)) {
+      auto version = version_it->path().filename().string();
+      boost::system::error_code file_ec;
+      if (IsVersion(version) && fs::is_regular_file(version_it->path() / kModelFileName, file_ec) &&
+          (latest_version.empty() || ModelVersionLess()(latest_version, version))) {
+        latest_version = version;
+      }
+    }
+
+    if (ec) {
+      logger->warn("Failed to scan {}: {}", model_it->path().string(), ec.message());
+      ec.clear();
+    } else if (!latest_version.empty()) {
+      latest.emplace(model_name, latest_version);
+    }
+  }
+
+  if (ec) {
+    // Leave the served models alone rather than unloading everything on a transient error
+    logger->error("Failed to scan the model repository {}: {}", base_path_, ec.message());
+    return served_.size();
+  }
+
+  for (const auto& model : latest) {
+    const auto& model_name = model.first;
+    const auto& version = model.second;
+
+    auto served = served_.find(model_name);
+    if (served != served_.end() && served->second == version) {
+      continue;
+    }
+
+    auto failed = failed_.find(model_name);
+    if (failed != failed_.end() && failed->second == version) {
+      continue;
+    }
+
+    auto model_path = (fs::path(base_path_) / model_name / version / kModelFileName).string();
+    try {
+      LoadVersion(model_name, version, model_path);
+    } catch (const Ort::Exception& ex) {
+      logger->error("Failed to load model {} version {} from {}: {}", model_name, version, model_path, ex.what());
+      failed_[model_name] = version;
+      continue;
+    }
+
+    failed_.erase(model_name);
+    if (served != served_.end()) {
+      auto previous_version = served->second;
+      served->second = version;
+      UnloadVersion(model_name, previous_version);
+    } else {
+      served_.emplace(model_name, version);
+    }
+  }
+
+  // Unload models that were removed from the repository
+  for (auto it = served_.begin(); it != served_.end();) {
+    if (latest.count(it->first) == 0) {
+      UnloadVersion(it->first, it->second);
+      failed_.erase(it->first);
+      it = served_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return served_.size();
+}
+
+void ModelRepository::LoadVersion(const std::string& model_name, const std::string& version, const std::string& model_path) {
+  auto logger = env_->GetAppLogger();
+  auto model = env_->LoadModel(model_path, GetIntraOpNumThreads(model_name));
+
+  try {
+    WarmUp(*model);
+  } catch (const Ort::Exception& ex) {
+    // The zero-filled inputs may not be valid for the model, which does not make the model unusable
+    logger->warn("Warm up of model {} version {} failed: {}", model_name, version, ex.what());
+  }
+
+  env_->AddModel(model_name, version, std::move(model));
+  logger->info("Serving model {} version {}", model_name, version);
+}
+
+void ModelRepository::UnloadVersion(const std::string& model_name, const std::string& version) {
+  env_->UnloadModel(model_name, version);
+  env_->GetAppLogger()->info("Unloaded model {} version {}", model_name, version);
+}
+
+void ModelRepository::StartPolling(std::chrono::milliseconds interval) {
+  StopPolling();
+
+  stop_polling_ = false;
+  polling_thread_ = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> lock(polling_mutex_);
+    while (!polling_cv_.wait_for(lock, interval, [this]() { return stop_polling_; })) {
+      lock.unlock();
+      Poll();
+      lock.lock();
+    }
+  });
+}
+
+void ModelRepository::StopPolling() {
+  if (!polling_thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    stop_polling_ = true;
+  }
+  polling_cv_.notify_all();
+  polling_thread_.join();
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Serves the models found in a repository directory laid out as
+//   <base_path>/<model_name>/<version>/model.onnx
+// where version is a non-negative integer. The latest version of each model is served.
+// A new version is loaded and warmed up before it receives traffic; the version it replaces
+// is then unloaded and released once its in-flight requests have finished.
+class ModelRepository {
+ public:
+  // intra_op_num_threads maps model names to their thread budget. Models not listed use
+  // default_intra_op_num_threads, and 0 uses the runtime default.
+  ModelRepository(std::shared_ptr<ServerEnvironment> env,
+                  std::string base_path,
+                  int default_intra_op_num_threads = 0,
+                  std::unordered_map<std::string, int> intra_op_num_threads = {});
+  ~ModelRepository();
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Scans the repository once and loads or unloads models to match it.
+  // Returns the number of models being served afterwards.
+  size_t Poll();
+
+  // Calls Poll on a background thread every interval until StopPolling is called.
+  void StartPolling(std::chrono::milliseconds interval);
+  void StopPolling();
+
+ private:
+  int GetIntraOpNumThreads(const std::string& model_name) const;
+  void LoadVersion(const std::string& model_name, const std::string& version, const std::string& model_path);
+  void UnloadVersion(const std::string& model_name, const std::string& version);
+
+  const std::shared_ptr<ServerEnvironment> env_;
+  const std::string base_path_;
+  const int default_intra_op_num_threads_;
+  const std::unordered_map<std::string, int> intra_op_num_threads_;
+
+  // Serializes Poll calls. served_ and failed_ map model names to versions.
+  std::mutex poll_mutex_;
+  std::unordered_map<std::string, std::string> served_;
+  std::unordered_map<std::string, std::string> failed_;
+
+  std::mutex polling_mutex_;
+  std::condition_variable polling_cv_;
+  bool stop_polling_ = false;
+  std::thread polling_thread_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <exception>
+#include <utility>
+
+#include "request_scheduler.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+bool RequestScheduler::DispatchOrder::operator()(const Request* lhs, const Request* rhs) const {
+  if (lhs->priority != rhs->priority) {
+    return lhs->priority > rhs->priority;
+  }
+  if (lhs->deadline != rhs->deadline) {
+    return lhs->deadline < rhs->deadline;
+  }
+  return lhs->sequence < rhs->sequence;
+}
+
+RequestScheduler::RequestScheduler(size_t num_workers, size_t max_queue_size, size_t max_runs_per_model)
+    : max_queue_size_(max_queue_size), max_runs_per_model_(max_runs_per_model) {
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&RequestScheduler::WorkerLoop, this);
+  }
+}
+
+RequestScheduler::~RequestScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    for (auto* request : queue_) {
+      Complete(*request, protobufutil::Status(protobufutil::error::Code::UNAVAILABLE, "The server is shutting down"));
+    }
+    queue_.clear();
+  }
+
+  work_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t RequestScheduler::GetQueueSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+protobufutil::Status RequestScheduler::Run(const std::string& model_name, int priority, Clock::time_point deadline,
+                                           const Work& work) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stopping_) {
+    return protobufutil::Status(protobufutil::error::Code::UNAVAILABLE, "The server is shutting down");
+  }
+
+  auto& model = models_[model_name];
+  if (queue_.size() >= max_queue_size_) {
+    ReleaseIfUnused(model_name);
+    return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "The request queue is full");
+  }
+
+  if (!CanMeetDeadline(model, deadline, Clock::now(), model.queued)) {
+    ReleaseIfUnused(model_name);
+    return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "The request can not finish before its deadline");
+  }
+
+  Request request;
+  request.model_name = &model_name;
+  request.priority = priority;
+  request.deadline = deadline;
+  request.sequence = next_sequence_++;
+  request.work = &work;
+
+  queue_.insert(&request);
+  ++model.queued;
+  work_cv_.notify_one();
+
+  // Completion happens under mutex_, so request stays alive until the worker is done with it
+  request.done_cv.wait(lock, [&request]() { return request.done; });
+  return request.status;
+}
+
+bool RequestScheduler::CanMeetDeadline(const ModelState& model, Clock::time_point deadline, Clock::time_point now,
+                                       size_t ahead) const {
+  if (deadline == Clock::time_point::max()) {
+    return true;
+  }
+  if (now >= deadline) {
+    return false;
+  }
+
+  // The requests ahead of this one run max_runs_per_model_ at a time
+  auto rounds = 1 + ahead / max_runs_per_model_;
+  return model.average_run_time * rounds <= deadline - now;
+}
+
+RequestScheduler::Request* RequestScheduler::NextRequest(Clock::time_point now) {
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    auto* request = *it;
+    auto& model = models_[*request->model_name];
+
+    if (!CanMeetDeadline(model, request->deadline, now, 0)) {
+      it = queue_.erase(it);
+      --model.queued;
+      Complete(*request, protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED,
+                                              "The request can not finish before its deadline"));
+      ReleaseIfUnused(*request->model_name);
+      continue;
+    }
+
+    if (model.running < max_runs_per_model_) {
+      queue_.erase(it);
+      --model.queued;
+      ++model.running;
+      return request;
+    }
+
+    ++it;
+  }
+
+  return nullptr;
+}
+
+void RequestScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    Request* request = nullptr;
+    work_cv_.wait(lock, [this, &request]() { return stopping_ || (request = NextRequest(Clock::now())) != nullptr; });
+    if (request == nullptr) {
+      return;
+    }
+
+    lock.unlock();
+    auto start = Clock::now();
+    protobufutil::Status status;
+    try {
+      status = (*request->work)();
+    } catch (const std::exception& ex) {
+      status = protobufutil::Status(protobufutil::error::Code::INTERNAL, ex.what());
+    }
+    auto run_time = Clock::now() - start;
+    lock.lock();
+
+    auto& model = models_[*request->model_name];
+    --model.running;
+    // Failed runs, such as requests for unknown models, say little about how long a run takes
+    if (status.ok()) {
+      model.average_run_time = model.average_run_time == Clock::duration::zero()
+                                   ? run_time
+                                   : (model.average_run_time * 7 + run_time) / 8;
+    }
+
+    const std::string& model_name = *request->model_name;
+    Complete(*request, status);
+    ReleaseIfUnused(model_name);
+
+    // A run slot for the model is free, which may unblock requests queued behind it
+    work_cv_.notify_all();
+  }
+}
+
+void RequestScheduler::Complete(Request& request, protobufutil::Status status) {
+  request.status = std::move(status);
+  request.done = true;
+  request.done_cv.notify_one();
+}
+
+void RequestScheduler::ReleaseIfUnused(const std::string& model_name) {
+  // Model names come from request URLs. Only models that ran successfully keep their state
+  // while idle, so unknown names do not accumulate.
+  auto it = models_.find(model_name);
+  if (it != models_.end() && it->second.running == 0 && it->second.queued == 0 &&
+      it->second.average_run_time == Clock::duration::zero()) {
+    models_.erase(it);
+  }
+}
+
+bool ParseRequestPriority(const std::string& value, int& priority) {
+  try {
+    size_t parsed = 0;
+    priority = std::stoi(value, &parsed);
+    return parsed == value.size();
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+bool ParseRequestTimeout(const std::string& value, std::chrono::milliseconds& timeout) {
+  try {
+    size_t parsed = 0;
+    auto milliseconds = std::stoll(value, &parsed);
+    timeout = std::chrono::milliseconds(milliseconds);
+    return parsed == value.size() && milliseconds > 0;
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+RequestScheduler::Clock::time_point GetRequestDeadline(std::chrono::milliseconds timeout) {
+  if (timeout > std::chrono::hours(24 * 365)) {
+    return RequestScheduler::Clock::time_point::max();
+  }
+
+  return RequestScheduler::Clock::now() + timeout;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
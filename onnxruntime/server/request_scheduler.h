@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <google/protobuf/stubs/status.h>
+
+namespace onnxruntime {
+namespace server {
+
+// Bounded queue between the HTTP and GRPC front ends and a fixed pool of inference workers.
+//
+// Requests are dispatched by priority and then by earliest deadline. At most max_runs_per_model
+// requests run concurrently for one model, so a slow model can not take all the workers.
+// Requests are rejected with RESOURCE_EXHAUSTED when the queue is full or when the expected
+// finish time, estimated from the recent run times of the model, is past their deadline.
+class RequestScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Work = std::function<google::protobuf::util::Status()>;
+
+  RequestScheduler(size_t num_workers, size_t max_queue_size, size_t max_runs_per_model);
+
+  // Stops the workers. Requests still queued are failed with UNAVAILABLE.
+  ~RequestScheduler();
+
+  RequestScheduler(const RequestScheduler&) = delete;
+  RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+  // Queues work and blocks until a worker ran it or the request was rejected.
+  // Higher priorities are dispatched first. Clock::time_point::max() means no deadline.
+  // Returns the status of work, or RESOURCE_EXHAUSTED if work was not run.
+  google::protobuf::util::Status Run(const std::string& model_name, int priority, Clock::time_point deadline,
+                                     const Work& work);
+
+  size_t GetQueueSize() const;
+
+ private:
+  struct Request {
+    const std::string* model_name;
+    int priority;
+    Clock::time_point deadline;
+    uint64_t sequence;
+    const Work* work;
+
+    bool done = false;
+    google::protobuf::util::Status status;
+    std::condition_variable done_cv;
+  };
+
+  struct DispatchOrder {
+    bool operator()(const Request* lhs, const Request* rhs) const;
+  };
+
+  struct ModelState {
+    size_t running = 0;
+    size_t queued = 0;
+    // Moving average of the run time, zero until the first run finished
+    Clock::duration average_run_time{0};
+  };
+
+  void WorkerLoop();
+
+  // Returns the next request that can run, rejecting the queued requests that can no longer meet
+  // their deadline on the way. Returns nullptr if every queued request waits for a busy model.
+  Request* NextRequest(Clock::time_point now);
+
+  bool CanMeetDeadline(const ModelState& model, Clock::time_point deadline, Clock::time_point now, size_t ahead) const;
+  void Complete(Request& request, google::protobuf::util::Status status);
+  void ReleaseIfUnused(const std::string& model_name);
+
+  const size_t max_queue_size_;
+  const size_t max_runs_per_model_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::set<Request*, DispatchOrder> queue_;
+  std::unordered_map<std::string, ModelState> models_;
+  uint64_t next_sequence_ = 0;
+  bool stopping_ = false;
+
+  std::vector<std::thread> workers_;
+};
+
+// Parses the value of a request priority header or metadata entry, an integer where higher runs first.
+bool ParseRequestPriority(const std::string& value, int& priority);
+
+// Parses the value of a request timeout header or metadata entry, a positive number of milliseconds.
+bool ParseRequestTimeout(const std::string& value, std::chrono::milliseconds& timeout);
+
+// Returns the deadline of a request with the given timeout from now. Timeouts of more than a year mean no deadline,
+// Clock::time_point::max(), which also keeps Clock::now() + timeout from overflowing.
+RequestScheduler::Clock::time_point GetRequestDeadline(std::chrono::milliseconds timeout);
+
+}  // namespace server
+}  // namespace onnxruntime
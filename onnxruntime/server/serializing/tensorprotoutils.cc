@@ -352,6 +352,33 @@ ONNXTensorElementDataType GetTensorElementType(const onnx::TensorProto& tensor_p
   return CApiElementTypeFromProtoType(tensor_proto.data_type());
 }
 
+size_t GetElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64:
+      return 8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
 void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer& m, Ort::Value& value) {
   const OrtMemoryInfo& allocator = m.GetAllocInfo();
   ONNXTensorElementDataType ele_type = server::GetTensorElementType(tensor_proto);
@@ -424,6 +451,45 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+bool TryWrapRawDataAsMLValue(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& allocator, Ort::Value& value) {
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == onnx::TensorProto_DataType::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  size_t element_count = 1;
+  for (auto dim : tensor_proto.dims()) {
+    if (dim < 0 || !IAllocator::CalcMemSizeForArray(element_count, static_cast<size_t>(dim), &element_count)) {
+      return false;
+    }
+  }
+
+  size_t size_in_bytes = 0;
+  try {
+    GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes);
+  } catch (const Ort::Exception&) {
+    return false;
+  }
+
+  // The tensor aliases the request buffer, so it must be exactly the expected size and
+  // suitably aligned for the element type. Anything else goes through the copying path.
+  const auto& raw_data = tensor_proto.raw_data();
+  if (element_count == 0 || raw_data.size() != size_in_bytes) {
+    return false;
+  }
+  const size_t element_size = size_in_bytes / element_count;
+  if (reinterpret_cast<uintptr_t>(raw_data.data()) % element_size != 0) {
+    return false;
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  value = Ort::Value::CreateTensor(&allocator, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   (ONNXTensorElementDataType)tensor_proto.data_type());
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
@@ -27,11 +27,22 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Create an MLValue that uses the raw_data of a TensorProto in place, without copying.
+ * The TensorProto must outlive the returned value and must not be modified while it is in use.
+ * Returns false if the tensor cannot be used in place (no raw data, string type, size mismatch,
+ * misaligned data or a big-endian host); the caller should then fall back to TensorProtoToMLValue.
+ */
+bool TryWrapRawDataAsMLValue(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& allocator, /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
 
 ONNXTensorElementDataType CApiElementTypeFromProtoType(int type);
 ONNXTensorElementDataType GetTensorElementType(const onnx::TensorProto& tensor_proto);
+
+// Size in bytes of one element, or 0 for string and undefined types.
+size_t GetElementSize(ONNXTensorElementDataType type);
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
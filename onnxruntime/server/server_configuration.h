@@ -6,7 +6,9 @@
 #include <thread>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
 
+#include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "core/session/onnxruntime_cxx_api.h"
 
@@ -37,21 +39,37 @@ static std::unordered_map<std::string, OrtLoggingLevel> supported_log_levels{
 // Provides sane default values
 class ServerConfiguration {
  public:
-  const std::string full_desc = "ONNX Server: host an ONNX model with ONNX Runtime";
+  const std::string full_desc = "ONNX Server: host ONNX models with ONNX Runtime";
   std::string model_path;
+  std::string repository_path;
+  int repository_poll_seconds = 30;
+  int intra_op_threads = 0;
+  std::unordered_map<std::string, int> per_model_threads;
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int num_inference_threads = std::thread::hardware_concurrency();
+  int max_queue_size = 256;
+  int max_runs_per_model = 2;
+  bool enable_shared_memory = false;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model");
+    desc.add_options()("repository_path", po::value(&repository_path), "Path to a model repository laid out as <name>/<version>/model.onnx. Replaces model_path");
+    desc.add_options()("repository_poll_seconds", po::value(&repository_poll_seconds)->default_value(repository_poll_seconds), "Interval for checking the model repository for new versions. 0 disables reloading");
+    desc.add_options()("intra_op_threads", po::value(&intra_op_threads)->default_value(intra_op_threads), "Number of threads used by each model. 0 uses the runtime default");
+    desc.add_options()("per_model_threads", po::value(&per_model_threads_str)->composing(), "Number of threads used by one model, as <name>=<threads>. May be repeated");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
+    desc.add_options()("num_inference_threads", po::value(&num_inference_threads)->default_value(num_inference_threads), "Number of workers running inference requests");
+    desc.add_options()("max_queue_size", po::value(&max_queue_size)->default_value(max_queue_size), "Number of requests that can wait for a worker before new requests are rejected");
+    desc.add_options()("max_runs_per_model", po::value(&max_runs_per_model)->default_value(max_runs_per_model), "Number of requests that can run at the same time on one model");
+    desc.add_options()("enable_shared_memory", po::bool_switch(&enable_shared_memory), "Allow clients on the same host to register POSIX shared memory regions for inputs and outputs");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
   }
 
@@ -89,6 +107,7 @@ class ServerConfiguration {
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
   std::string log_level_str = "info";
+  std::vector<std::string> per_model_threads_str;
 
   // Print help and return if there is a bad value
   Result ValidateOptions() {
@@ -99,14 +118,52 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (num_inference_threads <= 0 || max_queue_size <= 0 || max_runs_per_model <= 0) {
+      PrintHelp(std::cerr, "num_inference_threads, max_queue_size and max_runs_per_model must be greater than 0");
+      return Result::ExitFailure;
+    } else if (model_path.empty() == repository_path.empty()) {
+      PrintHelp(std::cerr, "Exactly one of model_path or repository_path must be given");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
+    } else if (!repository_path.empty() && !boost::filesystem::is_directory(repository_path)) {
+      PrintHelp(std::cerr, "repository_path must be the location of a directory");
+      return Result::ExitFailure;
+    } else if (repository_poll_seconds < 0 || intra_op_threads < 0) {
+      PrintHelp(std::cerr, "repository_poll_seconds and intra_op_threads must not be negative");
+      return Result::ExitFailure;
+    } else if (!ParsePerModelThreads()) {
+      PrintHelp(std::cerr, "per_model_threads must be given as <name>=<threads> with threads greater than 0");
+      return Result::ExitFailure;
     } else {
       return Result::ContinueSuccess;
     }
   }
 
+  // Parses the <name>=<threads> entries of per_model_threads
+  bool ParsePerModelThreads() {
+    for (const auto& entry : per_model_threads_str) {
+      auto separator = entry.rfind('=');
+      if (separator == std::string::npos || separator == 0) {
+        return false;
+      }
+
+      try {
+        size_t parsed = 0;
+        auto threads = std::stoi(entry.substr(separator + 1), &parsed);
+        if (parsed != entry.size() - separator - 1 || threads <= 0) {
+          return false;
+        }
+        per_model_threads[entry.substr(0, separator)] = threads;
+      } catch (const std::exception&) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   // Checks if program options contains help
   bool ContainsHelp() const {
     return vm.count("help") || vm.count("h");
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "shared_memory.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+#ifndef _WIN32
+  munmap(data_, byte_size_);
+#endif
+}
+
+void* SharedMemoryRegion::GetData(uint64_t offset, uint64_t byte_size) const {
+  if (offset > byte_size_ || byte_size > byte_size_ - offset) {
+    return nullptr;
+  }
+
+  return static_cast<char*>(data_) + offset;
+}
+
+protobufutil::Status SharedMemoryManager::Register(const std::string& name, const std::string& key, uint64_t byte_size) {
+#ifdef _WIN32
+  (void)name;
+  (void)key;
+  (void)byte_size;
+  return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED, "Shared memory is not supported on this platform");
+#else
+  if (name.empty() || key.empty() || byte_size == 0) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "A shared memory region needs a name, a key and a size");
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (regions_.count(name) != 0) {
+      return protobufutil::Status(protobufutil::error::Code::ALREADY_EXISTS, "Shared memory region " + name + " is already registered");
+    }
+  }
+
+  int fd = shm_open(key.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    auto code = errno == ENOENT ? protobufutil::error::Code::NOT_FOUND : protobufutil::error::Code::PERMISSION_DENIED;
+    return protobufutil::Status(code, "Failed to open shared memory object " + key + ": " + strerror(errno));
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < 0 || static_cast<uint64_t>(info.st_size) < byte_size) {
+    close(fd);
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Shared memory object " + key + " is smaller than the registered size");
+  }
+
+  void* data = mmap(nullptr, byte_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // close may overwrite errno
+  int error = errno;
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+  if (data == MAP_FAILED) {
+    return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "Failed to map shared memory object " + key + ": " + strerror(error));
+  }
+
+  auto region = std::make_shared<const SharedMemoryRegion>(key, data, byte_size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!regions_.emplace(name, std::move(region)).second) {
+    return protobufutil::Status(protobufutil::error::Code::ALREADY_EXISTS, "Shared memory region " + name + " is already registered");
+  }
+
+  return protobufutil::Status::OK;
+#endif
+}
+
+protobufutil::Status SharedMemoryManager::Unregister(const std::string& name) {
+  std::shared_ptr<const SharedMemoryRegion> region;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = regions_.find(name);
+    if (it == regions_.end()) {
+      return protobufutil::Status(protobufutil::error::Code::NOT_FOUND, "Shared memory region " + name + " is not registered");
+    }
+
+    region = std::move(it->second);
+    regions_.erase(it);
+  }
+
+  // Unmapped outside the lock, unless a request still holds the region
+  region.reset();
+  return protobufutil::Status::OK;
+}
+
+std::shared_ptr<const SharedMemoryRegion> SharedMemoryManager::GetRegion(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = regions_.find(name);
+  return it == regions_.end() ? nullptr : it->second;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <google/protobuf/stubs/status.h>
+
+namespace onnxruntime {
+namespace server {
+
+// A POSIX shared memory object created by a client and mapped into the server.
+// The mapping is released when the last reference goes away, so a region that is unregistered
+// while requests use it stays valid until they finish.
+class SharedMemoryRegion {
+ public:
+  SharedMemoryRegion(std::string key, void* data, size_t byte_size)
+      : key_(std::move(key)), data_(data), byte_size_(byte_size) {}
+  ~SharedMemoryRegion();
+  SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+  SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+  const std::string& Key() const { return key_; }
+  size_t Size() const { return byte_size_; }
+
+  // Returns the address of byte_size bytes at offset, or nullptr if they are not inside the region.
+  void* GetData(uint64_t offset, uint64_t byte_size) const;
+
+ private:
+  const std::string key_;
+  void* const data_;
+  const size_t byte_size_;
+};
+
+// The shared memory regions registered by clients, by name.
+class SharedMemoryManager {
+ public:
+  SharedMemoryManager() = default;
+  SharedMemoryManager(const SharedMemoryManager&) = delete;
+  SharedMemoryManager& operator=(const SharedMemoryManager&) = delete;
+
+  // Maps the first byte_size bytes of the shared memory object key and registers them as name.
+  google::protobuf::util::Status Register(const std::string& name, const std::string& key, uint64_t byte_size);
+
+  google::protobuf::util::Status Unregister(const std::string& name);
+
+  // Returns nullptr if no region is registered as name.
+  std::shared_ptr<const SharedMemoryRegion> GetRegion(const std::string& name) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const SharedMemoryRegion>> regions_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/util/math.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A = [[1, 0,  1],    B = [[1, 2],
+//      [0, 1, -1]]         [3, 4],
+//                          [5, 6]]
+TEST(CompressedMatMulOpTest, Float16) {
+  std::vector<MLFloat16> b;
+  for (float value : {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}) {
+    b.push_back(MLFloat16(math::floatToHalf(value)));
+  }
+
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, {1.0f, 0.0f, 1.0f,
+                                     0.0f, 1.0f, -1.0f});
+  test.AddInput<MLFloat16>("B", {3, 2}, b);
+  test.AddOutput<float>("Y", {2, 2}, {6.0f, 8.0f,
+                                      -2.0f, -2.0f});
+  test.Run();
+}
+
+// The same product with B stored transposed and scaled by alpha.
+TEST(CompressedMatMulOpTest, BFloat16TransB) {
+  std::vector<BFloat16> b;
+  for (float value : {1.0f, 3.0f, 5.0f, 2.0f, 4.0f, 6.0f}) {
+    b.push_back(BFloat16(value));
+  }
+
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transB", int64_t{1});
+  test.AddAttribute("alpha", 0.5f);
+  test.AddInput<float>("A", {1, 2, 3}, {1.0f, 0.0f, 1.0f,
+                                        0.0f, 1.0f, -1.0f});
+  test.AddInput<BFloat16>("B", {2, 3}, b);
+  test.AddOutput<float>("Y", {1, 2, 2}, {3.0f, 4.0f,
+                                         -1.0f, -1.0f});
+  test.Run();
+}
+
+// B decodes to [[1, 1], [3, 2], [5, 3]] with a scale per column.
+TEST(CompressedMatMulOpTest, Int8WithBias) {
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, {1.0f, 0.0f, 1.0f,
+                                     0.0f, 1.0f, -1.0f});
+  test.AddInput<int8_t>("B", {3, 2}, {2, 4, 6, 8, 10, 12});
+  test.AddInput<float>("scales", {2}, {0.5f, 0.25f});
+  test.AddInput<float>("bias", {2}, {1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2, 2}, {7.0f, 3.0f,
+                                      -1.0f, -2.0f});
+  test.Run();
+}
+
+TEST(CompressedMatMulOpTest, Int8WithoutScales) {
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {1, 2}, {1.0f, 2.0f});
+  test.AddInput<int8_t>("B", {2, 2}, {1, 2, 3, 4});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "An int8 B requires 2 scales");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
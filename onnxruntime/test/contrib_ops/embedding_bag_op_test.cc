@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static const std::vector<float> kEmbeddingBagWeight{0.0f, 0.1f, 0.2f,
+                                                    1.0f, 1.1f, 1.2f,
+                                                    2.0f, 2.1f, 2.2f,
+                                                    3.0f, 3.1f, 3.2f};
+
+TEST(EmbeddingBagOpTest, Sum2DIndices) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagWeight);
+  test.AddInput<int64_t>("indices", {2, 2}, {0, 2, 3, -1});
+  test.AddOutput<float>("output", {2, 3}, {2.0f, 2.2f, 2.4f, 6.0f, 6.2f, 6.4f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, MeanWithOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagWeight);
+  test.AddInput<int32_t>("indices", {5}, {1, 3, 0, 1, 2});
+  test.AddInput<int32_t>("offsets", {3}, {0, 2, 2});
+  // the second bag is empty
+  test.AddOutput<float>("output", {3, 3}, {2.0f, 2.1f, 2.2f, 0.0f, 0.0f, 0.0f, 1.0f, 1.1f, 1.2f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, MaxWithOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "max");
+  test.AddInput<float>("weight", {4, 3}, {0.0f, 5.0f, 0.2f,
+                                          1.0f, 1.1f, 1.2f,
+                                          2.0f, -2.1f, 2.2f,
+                                          -3.0f, 3.1f, 3.2f});
+  test.AddInput<int64_t>("indices", {4}, {0, 1, 2, 3});
+  test.AddInput<int64_t>("offsets", {2}, {0, 3});
+  test.AddOutput<float>("output", {2, 3}, {2.0f, 5.0f, 2.2f, -3.0f, 3.1f, 3.2f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagWeight);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 4});
+  test.AddOutput<float>("output", {1, 3}, {0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+TEST(EmbeddingBagOpTest, InvalidOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagWeight);
+  test.AddInput<int64_t>("indices", {3}, {0, 1, 2});
+  test.AddInput<int64_t>("offsets", {2}, {2, 1});
+  test.AddOutput<float>("output", {2, 3}, std::vector<float>(6, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "offsets must be non-decreasing");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Y = (x + bias) * Sigmoid((x + bias) * c), with values 0 to 2 the inputs and 3 to 6 the results of the ops.
+TEST(FusedElementwiseOpTest, SigmoidGating) {
+  const std::vector<float> x{-2.0f, -0.5f, 0.0f, 0.5f, 1.0f, 3.0f};
+  const std::vector<float> bias{0.25f, -0.25f, 1.0f};
+  const float c = 1.702f;
+  std::vector<float> y;
+  for (size_t i = 0; i < x.size(); ++i) {
+    const float a = x[i] + bias[i % bias.size()];
+    y.push_back(a / (1.0f + std::exp(-a * c)));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Sigmoid", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1, 3, 5});
+  test.AddInput<float>("x", {2, 3}, x);
+  test.AddInput<float>("bias", {3}, bias);
+  test.AddInput<float>("c", {1}, {c});
+  test.AddOutput<float>("Y", {2, 3}, y);
+  test.Run();
+}
+
+// An output of several tasks of tiles, with a broadcast input whose rows straddle the tiles.
+TEST(FusedElementwiseOpTest, LargeInput) {
+  const int64_t rows = 3000, cols = 7;
+  std::vector<float> x(rows * cols);
+  std::vector<float> bias(cols);
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < bias.size(); ++i) {
+    bias[i] = static_cast<float>(i) - 3.0f;
+  }
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.5f;
+    const float a = x[i] + bias[i % cols];
+    y[i] = std::max(a >= 0.0f ? a : a * 0.1f, -0.5f);
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "LeakyRelu", "Max"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, -1, 4, 2});
+  test.AddAttribute("alphas", std::vector<float>{0.0f, 0.1f, 0.0f});
+  test.AddInput<float>("x", {rows, cols}, x);
+  test.AddInput<float>("bias", {1, cols}, bias);
+  test.AddInput<float>("floor", {}, {-0.5f});
+  test.AddOutput<float>("Y", {rows, cols}, y);
+  test.Run();
+}
+
+TEST(FusedElementwiseOpTest, InvalidBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+  test.AddInput<float>("x", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("mean", {2, 1}, {2.0f, 5.0f});
+  test.AddOutput<float>("Y", {2, 3}, {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "can't be broadcast");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
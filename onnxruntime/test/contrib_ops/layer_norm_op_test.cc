@@ -244,5 +244,29 @@ TEST(LayerNormTest, BERTLayerNorm) {
   test.Run();
 }
 
+// A row width that isn't a multiple of the vector width, and a constant row.
+TEST(LayerNormTest, RowsAndSavedStatistics) {
+  std::vector<float> scale(11);
+  std::vector<float> bias(11);
+  for (int i = 0; i < 11; ++i) {
+    scale[i] = 0.5f + 0.1f * i;
+    bias[i] = 0.25f * i - 1.0f;
+  }
+
+  OpTester test("LayerNormalization");
+  test.AddAttribute("axis", int64_t{-1});
+  test.AddAttribute("epsilon", 1e-5f);
+  test.AddInput<float>("X", {2, 11}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f,
+                                      2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f});
+  test.AddInput<float>("scale", {11}, scale);
+  test.AddInput<float>("B", {11}, bias);
+  test.AddOutput<float>("Y", {2, 11}, {-1.790569f, -1.508946f, -1.164078f, -0.755964f, -0.284605f, 0.25f,
+                                       0.847850f, 1.508946f, 2.233288f, 3.020875f, 3.871707f,
+                                       -1.0f, -0.75f, -0.5f, -0.25f, 0.0f, 0.25f, 0.5f, 0.75f, 1.0f, 1.25f, 1.5f});
+  test.AddOutput<float>("mean", {2, 1}, {6.0f, 2.0f});
+  test.AddOutput<float>("inv_std_var", {2, 1}, {0.316228f, 316.227766f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// B = [[1, 0, 0],
+//      [0, 0, 2],
+//      [0, 3, 0],
+//      [4, 0, 5]]
+// stored as the CSR rows of B^T.
+TEST(SparseMatMulOpTest, Csr) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("dense_shape", std::vector<int64_t>{4, 3});
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                     -1.0f, 0.0f, 1.0f, 0.5f});
+  test.AddInput<float>("values", {5, 1}, {1.0f, 4.0f, 3.0f, 2.0f, 5.0f});
+  test.AddInput<int32_t>("col_indices", {5}, {0, 3, 2, 1, 3});
+  test.AddInput<int32_t>("row_ptr", {4}, {0, 2, 3, 5});
+  test.AddOutput<float>("Y", {2, 3}, {17.0f, 9.0f, 24.0f,
+                                      1.0f, 3.0f, 2.5f});
+  test.Run();
+}
+
+// B^T = [[1, 1, 0, 0],
+//        [0, 0, 0, 0],
+//        [0, 0, 2, 3]]
+// in blocks of 2 elements, with a bias and a 3-D A.
+TEST(SparseMatMulOpTest, BlockSparseWithBias) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("dense_shape", std::vector<int64_t>{4, 3});
+  test.AddAttribute("block_size", int64_t{2});
+  test.AddInput<float>("A", {1, 2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                        0.0f, 1.0f, 0.0f, -1.0f});
+  test.AddInput<float>("values", {2, 2}, {1.0f, 1.0f, 2.0f, 3.0f});
+  test.AddInput<int32_t>("col_indices", {2}, {0, 1});
+  test.AddInput<int32_t>("row_ptr", {4}, {0, 1, 1, 2});
+  test.AddInput<float>("bias", {3}, {0.5f, 1.0f, -1.0f});
+  test.AddOutput<float>("Y", {1, 2, 3}, {3.5f, 1.0f, 17.0f,
+                                         1.5f, 1.0f, -4.0f});
+  test.Run();
+}
+
+// Block sizes with a vectorized kernel, compared with the dense product.
+TEST(SparseMatMulOpTest, BlockSizes) {
+  constexpr int64_t M = 5, K = 32, N = 6;
+  std::vector<float> a(M * K);
+  for (int64_t i = 0; i < M * K; ++i) {
+    a[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+
+  for (int64_t block_size : {4, 8, 16}) {
+    // row n of W has a single block at column n % (K / block_size), filled with n + 1
+    std::vector<float> values;
+    std::vector<int32_t> col_indices;
+    std::vector<int32_t> row_ptr{0};
+    std::vector<float> y(M * N, 0.0f);
+    for (int64_t n = 0; n < N; ++n) {
+      const int64_t col = n % (K / block_size);
+      col_indices.push_back(static_cast<int32_t>(col));
+      row_ptr.push_back(static_cast<int32_t>(n + 1));
+      for (int64_t i = 0; i < block_size; ++i) {
+        values.push_back(static_cast<float>(n + 1));
+        for (int64_t m = 0; m < M; ++m) {
+          y[m * N + n] += a[m * K + col * block_size + i] * static_cast<float>(n + 1);
+        }
+      }
+    }
+
+    OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+    test.AddAttribute("dense_shape", std::vector<int64_t>{K, N});
+    test.AddAttribute("block_size", block_size);
+    test.AddInput<float>("A", {M, K}, a);
+    test.AddInput<float>("values", {N, block_size}, values);
+    test.AddInput<int32_t>("col_indices", {N}, col_indices);
+    test.AddInput<int32_t>("row_ptr", {N + 1}, row_ptr);
+    test.AddOutput<float>("Y", {M, N}, y);
+    test.Run();
+  }
+}
+
+TEST(SparseMatMulOpTest, InvalidColumn) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("dense_shape", std::vector<int64_t>{2, 2});
+  test.AddInput<float>("A", {1, 2}, {1.0f, 2.0f});
+  test.AddInput<float>("values", {1, 1}, {1.0f});
+  test.AddInput<int32_t>("col_indices", {1}, {2});
+  test.AddInput<int32_t>("row_ptr", {3}, {0, 1, 1});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "col_indices element out of range");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -149,6 +149,8 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> strided_output_kernel_;  // a unary kernel whose output may be a view
+  std::unique_ptr<::onnxruntime::KernelDef> strided_input_kernel_;   // a unary kernel that accepts a view
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -166,6 +168,10 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    strided_output_kernel_ =
+        KernelDefBuilder().SetName("Identity").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayStridedOutput(0, 0).Build();
+    strided_input_kernel_ =
+        KernelDefBuilder().SetName("Sigmoid").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayStridedInput(0).Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -196,6 +202,27 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddStridedOutputNode(std::string& input, std::string& output) {
+    return AddNode(*strided_output_kernel_, input, output);
+  }
+
+  onnxruntime::Node* AddStridedInputNode(std::string& input, std::string& output) {
+    return AddNode(*strided_input_kernel_, input, output);
+  }
+
+  // add a node that is bound to the CPU kernel registered for op_type
+  onnxruntime::Node* AddCpuNode(const std::string& op_type, const std::vector<std::string>& inputs,
+                                const std::vector<std::string>& outputs, int64_t axis) {
+    std::vector<onnxruntime::NodeArg*> input_args, output_args;
+    for (auto& input : inputs) input_args.push_back(Arg(input));
+    for (auto& output : outputs) output_args.push_back(Arg(output));
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), op_type, "test op",
+                                   input_args, output_args);
+    p_node->AddAttribute("axis", axis);
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    return p_node;
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg) {
     auto info = onnxruntime::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node),
                                                state_.GetInitializedTensors(), state_.GetOrtValueNameIdxMap(),
@@ -413,6 +440,106 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// StridedViewTest: Check that an output is a view of the input only if all its consumers accept strided input.
+TEST_F(PlannerTest, StridedViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddStridedOutputNode(X1, X2);  // X2: view of X1
+  AddStridedInputNode(X2, X3);   // reads the view
+  AddNormalNode(X3, X4);         // X4: output
+  AddStridedOutputNode(X1, X5);  // X5: consumed by a kernel that needs contiguous data
+  AddStridedInputNode(X5, X6);   // X6: output
+  AddNormalNode(X5, X7);         // X7: output
+
+  // simulate shape-inference results:
+  Shape shape1w{"M", "N"};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{"M", "K"};
+  auto shape2 = &shape2w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape2}, {X4, shape2}, {X5, shape1}, {X6, shape1}, {X7, shape1}});
+
+  CreatePlan();
+
+  int x1_index, x2_index, x5_index;
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X1, x1_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X2, x2_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X5, x5_index).IsOK());
+
+  CheckAllocKind(X2, AllocKind::kReuse);
+  EXPECT_TRUE(GetPlan().allocation_plan[x2_index].is_strided_view);
+  EXPECT_EQ(GetPlan().allocation_plan[x2_index].reused_buffer, x1_index);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+
+  CheckAllocKind(X5, AllocKind::kAllocate);
+  EXPECT_FALSE(GetPlan().allocation_plan[x5_index].is_strided_view);
+}
+
+TEST_F(PlannerTest, SubBufferTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7"), X8("X8"), X9("X9"),
+      X10("X10"), X11("X11");
+
+  // graph structure:
+  AddNormalNode(X1, X3);
+  AddNormalNode(X2, X4);
+  AddCpuNode("Concat", {X3, X4}, {X5}, 0);  // X3 and X4: written directly into X5
+  AddNormalNode(X5, X6);                    // X6: output
+  AddNormalNode(X1, X7);
+  AddCpuNode("Split", {X7}, {X8, X9}, 0);   // X8 and X9: parts of X7
+  AddNormalNode(X8, X10);                   // X10: output
+  AddNormalNode(X9, X11);                   // X11: output
+
+  // simulate shape-inference results:
+  Shape shape1w{2, 3};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{1, 3};
+  auto shape2 = &shape2w.value;
+  Shape shape3w{3, 3};
+  auto shape3 = &shape3w.value;
+  Shape shape4w{1, 6};
+  auto shape4 = &shape4w.value;
+  SetShape({{X1, shape1}, {X2, shape2}, {X3, shape1}, {X4, shape2}, {X5, shape3}, {X6, shape3},
+            {X7, shape4}, {X8, shape2}, {X9, shape2}, {X10, shape2}, {X11, shape2}});
+
+  CreatePlan();
+
+  int x3_index, x4_index, x5_index, x7_index, x8_index, x9_index;
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X3, x3_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X4, x4_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X5, x5_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X7, x7_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X8, x8_index).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X9, x9_index).IsOK());
+  const auto& plan = GetPlan().allocation_plan;
+
+  CheckAllocKind(X5, AllocKind::kAllocate);
+  EXPECT_EQ(plan[x5_index].planned_shape, std::vector<int64_t>({3, 3}));
+  CheckAllocKind(X3, AllocKind::kSubBuffer);
+  EXPECT_EQ(plan[x3_index].reused_buffer, x5_index);
+  EXPECT_EQ(plan[x3_index].sub_buffer_offset, 0u);
+  CheckAllocKind(X4, AllocKind::kSubBuffer);
+  EXPECT_EQ(plan[x4_index].reused_buffer, x5_index);
+  EXPECT_EQ(plan[x4_index].sub_buffer_offset, 6 * sizeof(float));
+
+  CheckAllocKind(X8, AllocKind::kSubBuffer);
+  EXPECT_EQ(plan[x8_index].reused_buffer, x7_index);
+  EXPECT_EQ(plan[x8_index].sub_buffer_offset, 0u);
+  CheckAllocKind(X9, AllocKind::kSubBuffer);
+  EXPECT_EQ(plan[x9_index].reused_buffer, x7_index);
+  EXPECT_EQ(plan[x9_index].sub_buffer_offset, 3 * sizeof(float));
+
+  // only the parents are freed, which happens after their sub-buffers are used
+  const auto& to_be_freed = GetPlan().to_be_freed;
+  std::unordered_set<int> freed(to_be_freed.cbegin(), to_be_freed.cend());
+  EXPECT_EQ(freed.count(x5_index), 1u);
+  EXPECT_EQ(freed.count(x7_index), 1u);
+  for (int index : {x3_index, x4_index, x8_index, x9_index}) {
+    EXPECT_EQ(freed.count(index), 0u);
+  }
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
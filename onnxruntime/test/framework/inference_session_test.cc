@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/session/inference_session.h"
+#include "core/framework/bfc_arena.h"
 
 #include <algorithm>
 #include <cfloat>
@@ -630,6 +631,233 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerSamplingRate) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerSamplingRate";
+  so.profiling_sampling_rate = 2;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  session_object.StartProfiling("onnxruntime_profile_sampled");
+  for (int i = 0; i < 4; ++i) {
+    RunModel(session_object, run_options);
+  }
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  int kernel_events = 0;
+  int run_events = 0;
+  while (std::getline(profile, line)) {
+    if (line.find("mul_1_kernel_time") != string::npos) kernel_events++;
+    if (line.find("model_run") != string::npos) run_events++;
+  }
+
+  // every run is recorded, but only every second execution records the node events
+  ASSERT_EQ(run_events, 4);
+  ASSERT_EQ(kernel_events, 2);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilingSummary) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilingSummary";
+  so.enable_profiling_summary = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // the trace is not enabled, so no file should have been written
+  ASSERT_TRUE(session_object.EndProfiling().empty());
+
+  std::string summary = session_object.GetProfilingSummary();
+  ASSERT_TRUE(summary.find(R"({"op_type" : "Mul", "count" : 3,)") != string::npos) << summary;
+  ASSERT_TRUE(summary.find(R"({"name" : "mul_1", "op_type" : "Mul", "count" : 3,)") != string::npos) << summary;
+  ASSERT_TRUE(summary.find("p99_us") != string::npos);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilingHardwareCounters) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilingHardwareCounters";
+  so.enable_profiling_summary = true;
+  so.enable_profiling_hardware_counters = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the counters are only reported where perf events are available
+  std::string summary = session_object.GetProfilingSummary();
+  const bool has_counters = profiling::HardwareCounters::Get() != nullptr;
+  ASSERT_EQ(summary.find("\"ipc\"") != string::npos, has_counters) << summary;
+  if (has_counters) {
+    // X, the initializer W and Y are all 3x2 floats
+    ASSERT_TRUE(summary.find("\"bytes\" : 72,") != string::npos) << summary;
+    ASSERT_TRUE(summary.find("\"flops\" : 6,") != string::npos) << summary;
+  }
+}
+
+TEST(InferenceSessionTests, CheckArenaStats) {
+  SessionOptions so;
+  so.session_logid = "CheckArenaStats";
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  OrtMemoryInfo cpu_info(CPU, OrtArenaAllocator);
+  AllocatorStats stats;
+  auto status = session_object.GetArenaStats(cpu_info, stats);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_GT(stats.num_allocs, 0);
+  ASSERT_GT(stats.total_allocated_bytes, 0);
+  ASSERT_GE(stats.max_bytes_in_use, stats.bytes_in_use);
+
+  OrtMemoryInfo unknown_info("NotADevice", OrtArenaAllocator);
+  ASSERT_FALSE(session_object.GetArenaStats(unknown_info, stats).IsOK());
+}
+
+TEST(InferenceSessionTests, CloneSession) {
+  SessionOptions so;
+  so.session_logid = "CloneSession";
+
+  InferenceSession session_object(so);
+  std::unique_ptr<InferenceSession> clone;
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_FALSE(session_object.Clone(clone).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto status = session_object.Clone(clone);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(clone, nullptr);
+  ASSERT_EQ(clone->GetModelInputs().second->size(), session_object.GetModelInputs().second->size());
+
+  OrtMemoryInfo cpu_info(CPU, OrtArenaAllocator);
+  AllocatorStats source_stats;
+  ASSERT_TRUE(session_object.GetArenaStats(cpu_info, source_stats).IsOK());
+
+  // the clone runs on its own arena
+  RunOptions run_options;
+  RunModel(*clone, run_options);
+  AllocatorStats stats;
+  ASSERT_TRUE(clone->GetArenaStats(cpu_info, stats).IsOK());
+  ASSERT_GT(stats.num_allocs, 0);
+  ASSERT_TRUE(session_object.GetArenaStats(cpu_info, stats).IsOK());
+  ASSERT_EQ(stats.num_allocs, source_stats.num_allocs);
+
+  RunModel(session_object, run_options);
+}
+
+// Split and Transpose produce views that MatMul reads in place. The Slice with a step produces a view
+// MatMul has to copy.
+TEST(InferenceSessionTests, StridedViews) {
+  onnxruntime::Model model("strided_views");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& b_transposed = graph.GetOrCreateNodeArg("B_transposed", &tensor_float);
+  auto& sliced = graph.GetOrCreateNodeArg("X_sliced", &tensor_float);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &tensor_float);
+  auto& y2 = graph.GetOrCreateNodeArg("Y2", &tensor_float);
+
+  auto& split = graph.AddNode("split", "Split", "split", {&x}, {&a, &b});
+  split.AddAttribute("axis", int64_t{2});
+  auto& transpose = graph.AddNode("transpose", "Transpose", "transpose", {&b}, {&b_transposed});
+  transpose.AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+  graph.AddNode("matmul1", "MatMul", "matmul1", {&a, &b_transposed}, {&y1});
+
+  std::vector<onnxruntime::NodeArg*> slice_inputs{&x};
+  for (auto& initializer : std::vector<std::pair<std::string, int64_t>>{
+           {"starts", 0}, {"ends", 6}, {"axes", 2}, {"steps", 2}}) {
+    TensorProto tensor;
+    tensor.set_name(initializer.first);
+    tensor.set_data_type(TensorProto_DataType_INT64);
+    tensor.add_dims(1);
+    tensor.add_int64_data(initializer.second);
+    graph.AddInitializedTensor(tensor);
+
+    TypeProto tensor_int64;
+    tensor_int64.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    slice_inputs.push_back(&graph.GetOrCreateNodeArg(initializer.first, &tensor_int64));
+  }
+  graph.AddNode("slice", "Slice", "slice", slice_inputs, {&sliced});
+  graph.AddNode("matmul2", "MatMul", "matmul2", {&sliced, &b_transposed}, {&y2});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::string model_file_name = "strided_views_test_graph.onnx";
+  ASSERT_TRUE(onnxruntime::Model::Save(model, model_file_name).IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StridedViews";
+  InferenceSession session_object{so};
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::vector<int64_t> dims_x = {2, 4, 6};
+  std::vector<float> values_x(48);
+  for (size_t i = 0; i < values_x.size(); ++i) {
+    values_x[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  // Y1[n, i, j] = sum_k X[n, i, k] * X[n, j, 3 + k]
+  // Y2[n, i, j] = sum_k X[n, i, 2k] * X[n, j, 3 + k]
+  std::vector<float> expected_y1(32, 0.f);
+  std::vector<float> expected_y2(32, 0.f);
+  for (int n = 0; n < 2; ++n) {
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        for (int k = 0; k < 3; ++k) {
+          auto rhs = values_x[n * 24 + j * 6 + 3 + k];
+          expected_y1[n * 16 + i * 4 + j] += values_x[n * 24 + i * 6 + k] * rhs;
+          expected_y2[n * 16 + i * 4 + j] += values_x[n * 24 + i * 6 + 2 * k] * rhs;
+        }
+      }
+    }
+  }
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  status = session_object.Run(run_options, feeds, {"Y1"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2, 4, 4}, expected_y1);
+
+  fetches.clear();
+  status = session_object.Run(run_options, feeds, {"Y2"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2, 4, 4}, expected_y2);
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
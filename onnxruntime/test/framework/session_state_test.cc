@@ -2,18 +2,21 @@
 // Licensed under the MIT License.
 
 #include <iostream>
+#include <thread>
 
 #include "core/framework/execution_providers.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "gtest/gtest.h"
+#include "test_utils.h"
 
 using namespace ONNX_NAMESPACE;
 using namespace std;
@@ -149,6 +152,139 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
   }
 }
 
+// A SessionState for optional_inputs_ir4.onnx that shares its initializers as configured
+class SharingSessionState {
+ public:
+  SharingSessionState(const std::unordered_map<std::string, const OrtValue*>& user_initializers, bool share_by_content)
+      : tp_{"test", 1} {
+    std::string model_path = "testdata/optional_inputs_ir4.onnx";
+    status_ = Model::Load(model_path, model_);
+    if (status_.IsOK()) {
+      status_ = execution_providers_.Add(kCpuExecutionProvider,
+                                         onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{false}));
+    }
+    if (status_.IsOK()) {
+      status_ = krm_.RegisterKernels(execution_providers_);
+    }
+    if (!status_.IsOK()) {
+      return;
+    }
+
+    Graph& graph = model_->MainGraph();
+    session_state_ = onnxruntime::make_unique<SessionState>(execution_providers_, true, &tp_, nullptr);
+    model_location_ = ToWideString(model_path);
+    SessionStateInitializer session_initializer(true, model_location_, graph, *session_state_,
+                                                execution_providers_, krm_);
+    session_initializer.SetInitializerSharing(user_initializers, share_by_content);
+
+    GraphPartitioner partitioner(krm_, execution_providers_);
+    status_ = partitioner.Partition(graph, session_state_->ExportDll(), session_state_->GetMutableFuncMgr());
+    if (status_.IsOK()) {
+      status_ = session_initializer.CreatePlan(nullptr, nullptr, true);
+    }
+  }
+
+  const Status& GetStatus() const { return status_; }
+
+  const Tensor& GetInitializer(const std::string& name) const {
+    int idx;
+    ORT_ENFORCE(session_state_->GetOrtValueNameIdxMap().GetIdx(name, idx).IsOK());
+    return session_state_->GetInitializedTensors().at(idx).Get<Tensor>();
+  }
+
+ private:
+  concurrency::ThreadPool tp_;
+  std::basic_string<PATH_CHAR_TYPE> model_location_;
+  std::shared_ptr<Model> model_;
+  ExecutionProviders execution_providers_;
+  KernelRegistryManager krm_;
+  std::unique_ptr<SessionState> session_state_;
+  Status status_;
+};
+
+TEST(SessionStateTest, ShareInitializersByContent) {
+  auto& store = SharedInitializerStore::Instance();
+  size_t stored = store.Size();
+  {
+    SharingSessionState first({}, true);
+    ASSERT_TRUE(first.GetStatus().IsOK()) << first.GetStatus();
+    SharingSessionState second({}, true);
+    ASSERT_TRUE(second.GetStatus().IsOK()) << second.GetStatus();
+    SharingSessionState unshared({}, false);
+    ASSERT_TRUE(unshared.GetStatus().IsOK()) << unshared.GetStatus();
+
+    EXPECT_EQ(store.Size(), stored + 1);
+    const Tensor& initializer = first.GetInitializer("optional_input");
+    EXPECT_EQ(initializer.DataRaw(), second.GetInitializer("optional_input").DataRaw());
+    EXPECT_NE(initializer.DataRaw(), unshared.GetInitializer("optional_input").DataRaw());
+    EXPECT_EQ(*initializer.Data<float>(), 1.f);
+  }
+
+  // released with the last session that uses it
+  EXPECT_EQ(store.Size(), stored);
+}
+
+TEST(SessionStateTest, ShareInitializerWhileCollidingOneIsReleased) {
+  // Two tensors with the same FNV-1a hash in the store: the second word of the second tensor
+  // cancels the difference in the first word.
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  uint64_t prefix = 14695981039346656037ULL;
+  for (uint64_t value : {static_cast<uint64_t>(reinterpret_cast<uintptr_t>(DataTypeImpl::GetType<uint64_t>())), uint64_t{2}}) {
+    prefix = (prefix ^ value) * kPrime;
+  }
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  Tensor first(DataTypeImpl::GetType<uint64_t>(), TensorShape({2}), allocator);
+  Tensor second(DataTypeImpl::GetType<uint64_t>(), TensorShape({2}), allocator);
+  first.MutableData<uint64_t>()[0] = 1;
+  first.MutableData<uint64_t>()[1] = 2;
+  second.MutableData<uint64_t>()[0] = 3;
+  second.MutableData<uint64_t>()[1] = 2 ^ ((prefix ^ 1) * kPrime) ^ ((prefix ^ 3) * kPrime);
+
+  auto& store = SharedInitializerStore::Instance();
+  size_t stored = store.Size();
+  {
+    auto shared_first = store.Share(first);
+    auto shared_second = store.Share(second);
+    EXPECT_NE(shared_first, shared_second);
+    EXPECT_EQ(shared_second->Data<uint64_t>()[0], 3u);
+    EXPECT_EQ(store.Size(), stored + 2);
+  }
+
+  // Every Share of first drops the last reference to it, possibly while the other thread
+  // holds it to compare against second
+  std::thread releaser([&store, &first]() {
+    for (int i = 0; i < 10000; ++i) {
+      store.Share(first);
+    }
+  });
+  for (int i = 0; i < 10000; ++i) {
+    store.Share(second);
+  }
+  releaser.join();
+
+  EXPECT_EQ(store.Size(), stored);
+}
+
+TEST(SessionStateTest, UseUserSuppliedInitializer) {
+  CPUExecutionProviderInfo epi{false};
+  CPUExecutionProvider cpu_provider(epi);
+  auto allocator = cpu_provider.GetAllocator(0, OrtMemTypeDefault);
+
+  OrtValue value;
+  CreateMLValue<float>(allocator, {1}, {1.f}, &value);
+  std::unordered_map<std::string, const OrtValue*> user_initializers{{"optional_input", &value}};
+  SharingSessionState session(user_initializers, false);
+  ASSERT_TRUE(session.GetStatus().IsOK()) << session.GetStatus();
+  EXPECT_EQ(session.GetInitializer("optional_input").DataRaw(), value.Get<Tensor>().DataRaw());
+
+  OrtValue wrong_shape;
+  CreateMLValue<float>(allocator, {2}, {1.f, 1.f}, &wrong_shape);
+  user_initializers["optional_input"] = &wrong_shape;
+  SharingSessionState invalid(user_initializers, false);
+  EXPECT_FALSE(invalid.GetStatus().IsOK());
+}
+
 INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
 }  // namespace test
 }  // namespace onnxruntime
@@ -137,6 +137,29 @@ TEST(TensorTest, EmptyTensorTest) {
   EXPECT_EQ(location.type, OrtAllocatorType::OrtArenaAllocator);
 }
 
+TEST(TensorTest, StridedViewTest) {
+  std::vector<float> buffer(24);
+  auto location = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault)->Info();
+  Tensor t(DataTypeImpl::GetType<float>(), TensorShape({2, 3, 4}), buffer.data(), location);
+  EXPECT_TRUE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(12, 4, 1));
+
+  // transpose of the last two axes
+  t.SetShapeAndStrides(TensorShape({2, 4, 3}), {12, 1, 4}, 0);
+  EXPECT_FALSE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(12, 1, 4));
+  EXPECT_THROW(t.Reshape(TensorShape({24})), OnnxRuntimeException);
+
+  // second half of the outer axis is contiguous, and the stride of a dimension of one element is ignored
+  t.SetShapeAndStrides(TensorShape({1, 3, 4}), {0, 4, 1}, 12 * sizeof(float));
+  EXPECT_TRUE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(12, 4, 1));
+  EXPECT_EQ(t.ByteOffset(), static_cast<int64_t>(12 * sizeof(float)));
+  EXPECT_EQ(t.Data<float>(), buffer.data() + 12);
+
+  EXPECT_THROW(t.SetShapeAndStrides(TensorShape({2, 12}), {12}, 0), OnnxRuntimeException);
+}
+
 TEST(TensorTest, StringTensorTest) {
 //add scope to explicitly delete tensor
 #ifdef _MSC_VER
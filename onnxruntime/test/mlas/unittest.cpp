@@ -17,8 +17,11 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <random>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -459,6 +462,172 @@ public:
     }
 };
 
+class MlasCompressedSgemmTest : public MlasTestBase
+{
+private:
+    static
+    uint16_t
+    FloatToHalf(
+        float Value
+        )
+    {
+        //
+        // Only exact conversions of normal values and zero are needed here.
+        //
+
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+
+        uint16_t Sign = uint16_t((Bits >> 16) & 0x8000);
+
+        if ((Bits & 0x7FFFFFFF) == 0) {
+            return Sign;
+        }
+
+        return uint16_t(Sign | ((((Bits >> 23) & 0xFF) - 112) << 10) | ((Bits & 0x7FFFFF) >> 13));
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* BDecoded = BufferBDecoded.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        //
+        // The fill values of the buffers are small integers, which all of the
+        // formats represent exactly, so the results must match the single
+        // precision GEMM of the decoded matrix B.
+        //
+
+        std::vector<uint16_t> Half(N * K);
+        std::vector<uint16_t> BFloat(N * K);
+        std::vector<int8_t> Quantized(N * K);
+        std::vector<float> Scales(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Scales[n] = 1.0f / float(1 << (n % 3));
+        }
+
+        for (size_t i = 0; i < N * K; i++) {
+            uint32_t Bits;
+            memcpy(&Bits, &B[i], sizeof(Bits));
+            Half[i] = FloatToHalf(B[i]);
+            BFloat[i] = uint16_t(Bits >> 16);
+            Quantized[i] = int8_t(B[i]);
+        }
+
+        for (int Trans = 0; Trans < 2; Trans++) {
+
+            CBLAS_TRANSPOSE TransB = (Trans == 0) ? CblasNoTrans : CblasTrans;
+            size_t ldb = (Trans == 0) ? N : K;
+
+            MLAS_SGEMM_COMPRESSED_B CompressedB;
+
+            CompressedB.Format = MlasSgemmBFormatFloat16;
+            CompressedB.Data = Half.data();
+            CompressedB.Scales = nullptr;
+            Test(TransB, M, N, K, alpha, A, B, &CompressedB, ldb, beta, C, CReference);
+
+            CompressedB.Format = MlasSgemmBFormatBFloat16;
+            CompressedB.Data = BFloat.data();
+            Test(TransB, M, N, K, alpha, A, B, &CompressedB, ldb, beta, C, CReference);
+
+            for (size_t i = 0; i < N * K; i++) {
+                size_t n = (Trans == 0) ? (i % N) : (i / K);
+                BDecoded[i] = float(Quantized[i]) * Scales[n];
+            }
+
+            CompressedB.Format = MlasSgemmBFormatInt8;
+            CompressedB.Data = Quantized.data();
+            CompressedB.Scales = Scales.data();
+            Test(TransB, M, N, K, alpha, A, BDecoded, &CompressedB, ldb, beta, C, CReference);
+        }
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        const float* BDecoded,
+        const MLAS_SGEMM_COMPRESSED_B* CompressedB,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference
+        )
+    {
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasGemm(CblasNoTrans, TransB, M, N, K, alpha, A, K, CompressedB, ldb, beta, C, N, threadpool);
+        MlasGemm(CblasNoTrans, TransB, M, N, K, alpha, A, K, BDecoded, ldb, beta, CReference, N, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch Format=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n",
+                    CompressedB->Format, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBDecoded;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 20; b++) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+            Test(b + 1, b + 3, b, 0.5f, 1.0f);
+        }
+        Test(1, 1000, 300, 1.0f, 0.0f);
+        Test(3, 33, 517, -1.0f, 0.25f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const float multipliers[] = { 0.0f, -0.5f, 1.0f };
+
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 40; M += 3) {
+                    for (size_t N = 1; N < 80; N += 5) {
+                        for (size_t K = 1; K < 300; K += 37) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8X8
 
 template <typename xint8_t>
@@ -718,7 +887,35 @@ protected:
                         Bias,
                         OutputReference);
 
-        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+        bool Mismatch;
+
+        if (ApproximateAlgorithm) {
+
+            //
+            // The Winograd algorithm reassociates the computation, so compare
+            // against the reference relative to the largest output magnitude.
+            //
+
+            float MaximumMagnitude = 1.0f;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                MaximumMagnitude = std::max(MaximumMagnitude, std::fabs(OutputReference[i]));
+            }
+
+            Mismatch = false;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                if (std::fabs(Output[i] - OutputReference[i]) > MaximumMagnitude * 1e-5f) {
+                    Mismatch = true;
+                    break;
+                }
+            }
+
+        } else {
+            Mismatch = memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0;
+        }
+
+        if (Mismatch) {
             printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
                 BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
                 KernelHeight, KernelWidth);
@@ -781,6 +978,8 @@ protected:
                         &WorkingBufferSize,
                         nullptr);
 
+        ApproximateAlgorithm = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
         MlasConv(&Parameters,
                  Input,
                  Filter,
@@ -788,6 +987,37 @@ protected:
                  BufferWorking.GetBuffer(WorkingBufferSize),
                  Output,
                  nullptr);
+
+        if (ApproximateAlgorithm) {
+
+            //
+            // Verify that prepacked filters produce the same output as the
+            // filters transformed by MlasConv.
+            //
+
+            size_t PackedFilterSize = MlasConvWinogradGetPackedFilterSize(GroupCount, InputChannels, FilterCount);
+            float* PackedFilter = BufferPackedFilter.GetBuffer(PackedFilterSize);
+
+            MlasConvWinogradPackFilter(GroupCount, InputChannels, FilterCount, Filter, PackedFilter, nullptr);
+
+            Parameters.u.Winograd.PackedFilter = PackedFilter;
+
+            size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputHeight * OutputWidth;
+            float* OutputPacked = BufferOutputPacked.GetBuffer(OutputElements);
+
+            MlasConv(&Parameters,
+                     Input,
+                     Filter,
+                     Bias,
+                     BufferWorking.GetBuffer(WorkingBufferSize),
+                     OutputPacked,
+                     nullptr);
+
+            if (memcmp(Output, OutputPacked, OutputElements * sizeof(float)) != 0) {
+                printf("mismatch packed Winograd: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd!!!\n",
+                    BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount);
+            }
+        }
     }
 
     void
@@ -887,6 +1117,10 @@ protected:
     MatrixGuardBuffer<float> BufferOutputReference;
     MatrixGuardBuffer<float> BufferWorking;
     MatrixGuardBuffer<float> BufferIm2Col;
+    MatrixGuardBuffer<float> BufferPackedFilter;
+    MatrixGuardBuffer<float> BufferOutputPacked;
+
+    bool ApproximateAlgorithm = false;
 
 public:
     void
@@ -903,6 +1137,23 @@ public:
             Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
         }
+
+        // Depthwise convolutions.
+        for (unsigned i = 1; i < 64; i += 3) {
+            Test(1, 16, 1, i, i + 2, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i + 2, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i + 2, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i + 2, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i + 2, 1, 5, 5, 2, 2, 1, 1, 1, 1, 2, 2);
+            Test(2, 16, 1, i, i + 2, 1, 5, 5, 0, 1, 0, 1, 1, 1, 1, 1);
+        }
+
+        // Winograd convolutions.
+        for (unsigned i = 8; i < 40; i += 5) {
+            Test(1, 1, 32, i, i + 3, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 1, 48, i, i, 40, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(2, 2, 32, i + 1, i, 32, 3, 3, 1, 0, 1, 0, 1, 1, 1, 1);
+        }
     }
 
     void
@@ -1966,6 +2217,227 @@ public:
     }
 };
 
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+        }
+
+        Test(Input, Output, OutputReference, N, D, false);
+        Test(Input, Output, OutputReference, N, D, true);
+    }
+
+    void
+    Test(
+        const float* Input,
+        float* Output,
+        float* OutputReference,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
+        ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+
+        constexpr float AbsoluteTolerance = 1e-6f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            float diff = std::fabs(Output[nd] - OutputReference[nd]);
+            if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
+                printf("mismatch softmax(%d) N=%zd D=%zd value=%f expected=%f\n",
+                    int(LogSoftmax), N, D, Output[nd], OutputReference[nd]);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceSoftmax(
+        const float* Input,
+        float* Output,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        for (size_t n = 0; n < N; n++) {
+
+            float MaximumValue = std::numeric_limits<float>::lowest();
+
+            for (size_t d = 0; d < D; d++) {
+                MaximumValue = (std::max)(MaximumValue, Input[d]);
+            }
+
+            double Sum = 0.0;
+
+            for (size_t d = 0; d < D; d++) {
+                double e = std::exp(double(Input[d]) - double(MaximumValue));
+                Sum += e;
+                Output[d] = float(e);
+            }
+
+            if (LogSoftmax) {
+
+                float Scale = float(std::log(Sum));
+
+                for (size_t d = 0; d < D; d++) {
+                    Output[d] = Input[d] - MaximumValue - Scale;
+                }
+
+            } else {
+
+                float Scale = float(Sum);
+
+                for (size_t d = 0; d < D; d++) {
+                    Output[d] /= Scale;
+                }
+            }
+
+            Input += D;
+            Output += D;
+        }
+    }
+
+    void
+    TestSpecialValues(
+        const float* Input,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        float* Output = BufferOutput.GetBuffer(D);
+        float* OutputReference = BufferOutputReference.GetBuffer(D);
+
+        MlasComputeSoftmax(Input, Output, 1, D, LogSoftmax, threadpool);
+        ReferenceSoftmax(Input, OutputReference, 1, D, LogSoftmax);
+
+        for (size_t d = 0; d < D; d++) {
+            bool Matches;
+            if (std::isnan(OutputReference[d]) || std::isinf(OutputReference[d])) {
+                Matches = std::isnan(OutputReference[d]) ? std::isnan(Output[d]) : Output[d] == OutputReference[d];
+            } else {
+                float diff = std::fabs(Output[d] - OutputReference[d]);
+                Matches = diff <= 1e-6f || diff <= std::fabs(OutputReference[d]) * 1e-5f;
+            }
+            if (!Matches) {
+                printf("mismatch softmax(%d) special values D=%zd d=%zd value=%f expected=%f\n",
+                    int(LogSoftmax), D, d, Output[d], OutputReference[d]);
+                break;
+            }
+        }
+    }
+
+    void
+    CheckExp(
+        const float* Input,
+        const float* Output,
+        size_t N
+        )
+    {
+        for (size_t i = 0; i < N; i++) {
+            float expected = std::exp(Input[i]);
+            bool Matches;
+            if (std::isnan(expected)) {
+                Matches = std::isnan(Output[i]);
+            } else if (std::isinf(expected)) {
+                Matches = Output[i] == expected;
+            } else {
+                float diff = std::fabs(Output[i] - expected);
+                Matches = diff <= std::numeric_limits<float>::min() || diff <= expected * 2e-6f;
+            }
+            if (!Matches) {
+                printf("mismatch exp(%f) value=%g expected=%g\n", Input[i], Output[i], expected);
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 128; d++) {
+            Test(1, d, -10.f, 10.f);
+        }
+
+        Test(3, 128, 20.f, 30.f);
+        Test(63, 95, -150.f, 190.f);
+        Test(16, 211, 20.f, 30.f);
+
+        //
+        // Test rows with masked, infinite and NaN values against the reference,
+        // with the special value placed both in the vector body and in the tail.
+        //
+
+        const float Infinity = std::numeric_limits<float>::infinity();
+        const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+        for (float SpecialValue : {-Infinity, Infinity, NaN}) {
+            for (size_t d : {size_t(1), size_t(6), size_t(9)}) {
+                float* Input = BufferInput.GetBuffer(9);
+                for (size_t i = 0; i < 9; i++) {
+                    Input[i] = float(i) - 4.0f;
+                }
+                Input[d - 1] = SpecialValue;
+                TestSpecialValues(Input, 9, false);
+                TestSpecialValues(Input, 9, true);
+            }
+        }
+
+        //
+        // Test the exponential against the standard library, both through the
+        // vector path and one element at a time through the scalar path.
+        //
+
+        const float ExpTestData[] = {
+            0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 10.0f, -10.0f,
+            80.0f, -80.0f, 88.0f, -87.0f, -100.0f, -1000.0f, 3.14159f, -2.71828f, 0.001f,
+            88.3f, 88.5f, 88.7f, 88.72f, 88.7228f, 88.7229f, 88.8f, 100.0f, 1000.0f,
+            Infinity, -Infinity, NaN, -NaN,
+        };
+
+        float ExpOutput[_countof(ExpTestData)];
+
+        MlasComputeExp(ExpTestData, ExpOutput, _countof(ExpTestData));
+        CheckExp(ExpTestData, ExpOutput, _countof(ExpTestData));
+
+        for (size_t i = 0; i < _countof(ExpTestData); i++) {
+            MlasComputeExp(&ExpTestData[i], &ExpOutput[i], 1);
+        }
+        CheckExp(ExpTestData, ExpOutput, _countof(ExpTestData));
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
 int
 #if defined(_WIN32)
 __cdecl
@@ -1978,6 +2450,7 @@ main(
 
         printf("SGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasCompressedSgemmTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
         printf("DGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
@@ -2007,6 +2480,9 @@ main(
         printf("Activation tests.\n");
         onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Softmax tests.\n");
+        onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
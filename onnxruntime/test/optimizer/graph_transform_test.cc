@@ -28,8 +28,17 @@
 #include "gtest/gtest.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/shape_to_initializer.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/sparse_matmul_transformer.h"
+#include "core/optimizer/compressed_matmul_transformer.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
+#include "core/optimizer/zipmap_elimination.h"
 
 using namespace std;
 using namespace ONNX_NAMESPACE;
@@ -190,6 +199,79 @@ TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination");
+  auto& graph = model.MainGraph();
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {2, 3}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+
+  TensorProto index;
+  index.set_name("index");
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(0);
+  graph.AddInitializedTensor(index);
+  TensorProto w;
+  w.set_name("w");
+  w.set_data_type(TensorProto_DataType_FLOAT);
+  for (int i = 0; i < 9; ++i) {
+    w.add_float_data(static_cast<float>(i));
+  }
+  w.add_dims(3);
+  w.add_dims(3);
+  graph.AddInitializedTensor(w);
+
+  // two Shape->Gather->Unsqueeze chains, which are merged one node at a time
+  for (auto suffix : {"1", "2"}) {
+    graph.AddNode(std::string("shape") + suffix, "Shape", "", {&x}, {arg(std::string("shape") + suffix)});
+    graph.AddNode(std::string("gather") + suffix, "Gather", "", {arg(std::string("shape") + suffix), arg("index")},
+                  {arg(std::string("dim") + suffix)});
+    graph.AddNode(std::string("unsqueeze") + suffix, "Unsqueeze", "", {arg(std::string("dim") + suffix)},
+                  {arg(std::string("unsqueezed") + suffix)})
+        .AddAttribute("axes", std::vector<int64_t>{0});
+  }
+  graph.AddNode("concat", "Concat", "", {arg("unsqueezed1"), arg("unsqueezed2")}, {arg("dims")})
+      .AddAttribute("axis", int64_t{0});
+
+  // identical MatMuls, LeakyRelus with different attributes and non-deterministic nodes
+  graph.AddNode("matmul1", "MatMul", "", {&x, arg("w")}, {arg("matmul1")});
+  graph.AddNode("matmul2", "MatMul", "", {&x, arg("w")}, {arg("matmul2")});
+  graph.AddNode("add", "Add", "", {arg("matmul1"), arg("matmul2")}, {arg("y")});
+  graph.AddNode("leaky_relu1", "LeakyRelu", "", {&x}, {arg("leaky_relu1")}).AddAttribute("alpha", 0.1f);
+  graph.AddNode("leaky_relu2", "LeakyRelu", "", {&x}, {arg("leaky_relu2")}).AddAttribute("alpha", 0.2f);
+  graph.AddNode("sub", "Sub", "", {arg("leaky_relu1"), arg("leaky_relu2")}, {arg("z")});
+  graph.AddNode("random1", "RandomNormalLike", "", {&x}, {arg("random1")});
+  graph.AddNode("random2", "RandomNormalLike", "", {&x}, {arg("random2")});
+  graph.AddNode("random_sub", "Sub", "", {arg("random1"), arg("random2")}, {arg("noise")});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(),
+                                    TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Shape"], 1);
+  ASSERT_EQ(op_to_count["Gather"], 1);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["LeakyRelu"], 2);
+  ASSERT_EQ(op_to_count["RandomNormalLike"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Concat" || node.OpType() == "Add") {
+      ASSERT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+    } else if (node.OpType() == "Sub") {
+      ASSERT_NE(node.InputDefs()[0], node.InputDefs()[1]);
+    }
+  }
+}
+
 TEST(GraphTransformationTests, ShapeToInitializer) {
   string model_uri = MODEL_FOLDER + "shape-add.onnx";
   std::shared_ptr<Model> model;
@@ -236,6 +318,96 @@ TEST(GraphTransformationTests, SubgraphWithConstantInputs) {
   ASSERT_TRUE(session_object.Run(run_options, feeds, output_names, &fetches).IsOK());
 }
 
+TEST(GraphTransformationTests, TransposeOptimizer) {
+  Model model("TransposeOptimizer");
+  auto& graph = model.MainGraph();
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // three NHWC inputs of shape (1, 2, 3, 4)
+  TypeProto nhwc_type;
+  nhwc_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {1, 2, 3, 4}) {
+    nhwc_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  for (auto name : {"x", "x1", "x2"}) {
+    graph.AddNode(std::string(name) + "_to_nchw", "Transpose", "", {&graph.GetOrCreateNodeArg(name, &nhwc_type)},
+                  {arg(std::string(name) + "_nchw")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  }
+
+  // y = NHWC(Relu(NCHW(x)) + bias), with a bias of shape (4, 1, 1) broadcast over H and W
+  TensorProto bias;
+  bias.set_name("bias");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {4, 1, 1}) {
+    bias.add_dims(dim);
+  }
+  for (auto value : {0.5f, -1.0f, 2.0f, 0.25f}) {
+    bias.add_float_data(value);
+  }
+  graph.AddInitializedTensor(bias);
+  graph.AddNode("relu", "Relu", "", {arg("x_nchw")}, {arg("relu")});
+  graph.AddNode("add", "Add", "", {arg("relu"), arg("bias")}, {arg("add")});
+  graph.AddNode("to_nhwc", "Transpose", "", {arg("add")}, {arg("y")})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+
+  // z = ReduceMean(Concat(NCHW(x1), NCHW(x2), axis=1), axes=[2, 3], keepdims=0)
+  graph.AddNode("concat", "Concat", "", {arg("x1_nchw"), arg("x2_nchw")}, {arg("concat")})
+      .AddAttribute("axis", int64_t{1});
+  auto& reduce = graph.AddNode("reduce", "ReduceMean", "", {arg("concat")}, {arg("z")});
+  reduce.AddAttribute("axes", std::vector<int64_t>{2, 3});
+  reduce.AddAttribute("keepdims", int64_t{0});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Concat"], 1);
+  ASSERT_EQ(op_to_count["ReduceMean"], 1);
+
+  // the optimized graph computes the same outputs
+  NameMLValMap feeds;
+  for (auto name : {"x", "x1", "x2"}) {
+    std::vector<float> data(24);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<float>((static_cast<int>(i) * (name[1] + 3)) % 11) - 5.0f;
+    }
+    OrtValue value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2, 3, 4}, data,
+                         &value);
+    feeds.emplace(name, value);
+  }
+
+  std::vector<std::vector<OrtValue>> outputs;
+  for (auto level : {TransformerLevel::Default, TransformerLevel::Level1}) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    InferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session.Run(RunOptions(), feeds, {"y", "z"}, &fetches).IsOK());
+    outputs.push_back(fetches);
+  }
+  for (size_t n = 0; n < 2; ++n) {
+    const Tensor& expected = outputs[0][n].Get<Tensor>();
+    const Tensor& actual = outputs[1][n].Get<Tensor>();
+    ASSERT_EQ(expected.Shape(), actual.Shape());
+    for (int64_t i = 0; i < expected.Shape().Size(); ++i) {
+      EXPECT_NEAR(expected.Data<float>()[i], actual.Data<float>()[i], 1e-5f) << "output:" << n << " i:" << i;
+    }
+  }
+}
+
 TEST(GraphTransformationTests, FuseConvBNNoBias) {
   string model_uri = MODEL_FOLDER + "fusion/fuse-conv-bn-no-bias.onnx";
 
@@ -625,7 +797,657 @@ TEST(GraphTransformationTests, GeluFusionTest) {
   ASSERT_TRUE(op_to_count["Mul"] == 0);
   ASSERT_TRUE(op_to_count["Gelu"] == 1);
 }
+
+TEST(GraphTransformationTests, LayerNormFusion) {
+  Model model("LayerNormFusion");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& data) -> NodeArg& {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_float_data(value);
+    }
+    graph.AddInitializedTensor(tensor_proto);
+
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  // x - mean(x) / sqrt(mean((x - mean(x))^2) + epsilon) * scale + bias, squaring with Pow or Mul.
+  // A nonempty extra_consumer gives x - mean(x) another consumer of that type, which prevents the fusion.
+  auto add_layer_norm = [&](const std::string& prefix, bool use_pow, const std::string& extra_consumer) {
+    auto arg = [&](const std::string& name) -> NodeArg* {
+      return &graph.GetOrCreateNodeArg(prefix + name, nullptr);
+    };
+    auto& x = graph.GetOrCreateNodeArg(prefix + "x", &x_type);
+
+    graph.AddNode(prefix + "mean", "ReduceMean", "", {&x}, {arg("mean")})
+        .AddAttribute("axes", std::vector<int64_t>{-1});
+    graph.AddNode(prefix + "sub", "Sub", "", {&x, arg("mean")}, {arg("d")});
+    // added before the square and the division so it is visited first
+    if (extra_consumer == "Identity") {
+      graph.AddNode(prefix + "identity", "Identity", "", {arg("d")}, {arg("d_out")});
+    } else if (extra_consumer == "Div") {
+      graph.AddNode(prefix + "extra_div", "Div", "", {arg("d"), &x}, {arg("d_out")});
+    } else if (extra_consumer == "Mul") {
+      graph.AddNode(prefix + "extra_square", "Mul", "", {arg("d"), arg("d")}, {arg("d_out")});
+    }
+    if (use_pow) {
+      graph.AddNode(prefix + "pow", "Pow", "", {arg("d"), &add_initializer(prefix + "two", {}, {2.0f})},
+                    {arg("square")});
+    } else {
+      graph.AddNode(prefix + "square", "Mul", "", {arg("d"), arg("d")}, {arg("square")});
+    }
+    graph.AddNode(prefix + "variance", "ReduceMean", "", {arg("square")}, {arg("variance")})
+        .AddAttribute("axes", std::vector<int64_t>{-1});
+    graph.AddNode(prefix + "add_epsilon", "Add", "",
+                  {arg("variance"), &add_initializer(prefix + "epsilon", {}, {1e-12f})}, {arg("biased")});
+    graph.AddNode(prefix + "sqrt", "Sqrt", "", {arg("biased")}, {arg("std")});
+    graph.AddNode(prefix + "div", "Div", "", {arg("d"), arg("std")}, {arg("normalized")});
+    graph.AddNode(prefix + "mul", "Mul", "",
+                  {&add_initializer(prefix + "scale", {4}, {1.0f, 2.0f, 3.0f, 4.0f}), arg("normalized")},
+                  {arg("scaled")});
+    graph.AddNode(prefix + "add", "Add", "",
+                  {arg("scaled"), &add_initializer(prefix + "bias", {4}, {0.0f, 0.5f, 1.0f, 1.5f})}, {arg("y")});
+  };
+  add_layer_norm("pow_", true, "");
+  add_layer_norm("mul_", false, "");
+  add_layer_norm("kept_", true, "Identity");
+  add_layer_norm("div2_", true, "Div");
+  add_layer_norm("square2_", false, "Mul");
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["LayerNormalization"], 2);
+  ASSERT_EQ(op_to_count["ReduceMean"], 6);
+  ASSERT_EQ(op_to_count["Sqrt"], 3);
+  ASSERT_EQ(op_to_count["Div"], 4);
+  ASSERT_EQ(op_to_count["Mul"], 5);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "LayerNormalization") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "epsilon")->f(), 1e-12f);
+      const std::string& x_name = node.InputDefs()[0]->Name();
+      const std::string prefix = x_name.substr(0, x_name.size() - 1);
+      ASSERT_EQ(node.InputDefs()[1]->Name(), prefix + "scale");
+      ASSERT_EQ(node.InputDefs()[2]->Name(), prefix + "bias");
+    }
+  }
+}
+
+// Adds the subgraph of a self attention layer computing y from x with the additive mask
+// (1 - Unsqueeze(Unsqueeze(mask))) * -10000.
+static void AddAttentionSubgraph(Graph& graph, int64_t batch_size, int64_t sequence_length, int64_t hidden_size,
+                                 int64_t num_heads, const std::vector<int64_t>& first_unsqueeze_axes,
+                                 const std::vector<int64_t>& second_unsqueeze_axes) {
+  auto add_initializer = [&graph](const std::string& name, TensorProto_DataType data_type,
+                                  const std::vector<int64_t>& dims, const std::vector<float>& data) -> NodeArg& {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(data_type);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      if (data_type == TensorProto_DataType_INT64) {
+        tensor_proto.add_int64_data(static_cast<int64_t>(value));
+      } else {
+        tensor_proto.add_float_data(value);
+      }
+    }
+    graph.AddInitializedTensor(tensor_proto);
+    return *graph.GetNodeArg(name);
+  };
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {batch_size, sequence_length, hidden_size}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  TypeProto mask_type;
+  mask_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  for (auto dim : {batch_size, sequence_length}) {
+    mask_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+  auto& mask = graph.GetOrCreateNodeArg("mask", &mask_type);
+
+  auto& head_shape = add_initializer("head_shape", TensorProto_DataType_INT64, {4},
+                                     {0, 0, static_cast<float>(num_heads), 2});
+  auto& hidden_shape = add_initializer("hidden_shape", TensorProto_DataType_INT64, {3},
+                                       {0, 0, static_cast<float>(hidden_size)});
+
+  // Q, K and V, with K transposed for the MatMul with Q
+  auto add_projection = [&](const std::string& name, float offset, const std::vector<int64_t>& perm) {
+    std::vector<float> weight(hidden_size * hidden_size);
+    for (size_t i = 0; i < weight.size(); ++i) {
+      weight[i] = 0.1f * static_cast<float>(static_cast<int>(i) % 7 - 3) + offset;
+    }
+    graph.AddNode(name + "_matmul", "MatMul", "",
+                  {&x, &add_initializer(name + "_weight", TensorProto_DataType_FLOAT, {hidden_size, hidden_size},
+                                        weight)},
+                  {arg(name + "_projected")});
+    graph.AddNode(name + "_add", "Add", "",
+                  {&add_initializer(name + "_bias", TensorProto_DataType_FLOAT, {hidden_size},
+                                    {offset, -offset, 0.5f, 0.25f}),
+                   arg(name + "_projected")},
+                  {arg(name + "_biased")});
+    graph.AddNode(name + "_reshape", "Reshape", "", {arg(name + "_biased"), &head_shape}, {arg(name + "_heads")});
+    graph.AddNode(name + "_transpose", "Transpose", "", {arg(name + "_heads")}, {arg(name)})
+        .AddAttribute("perm", perm);
+  };
+  add_projection("q", 0.1f, {0, 2, 1, 3});
+  add_projection("k", -0.2f, {0, 2, 3, 1});
+  add_projection("v", 0.3f, {0, 2, 1, 3});
+
+  // the additive mask (1 - mask) * -10000 for the positions that are padding
+  graph.AddNode("unsqueeze1", "Unsqueeze", "", {&mask}, {arg("mask1")}).AddAttribute("axes", first_unsqueeze_axes);
+  graph.AddNode("unsqueeze2", "Unsqueeze", "", {arg("mask1")}, {arg("mask2")})
+      .AddAttribute("axes", second_unsqueeze_axes);
+  graph.AddNode("cast", "Cast", "", {arg("mask2")}, {arg("float_mask")})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("sub", "Sub", "", {&add_initializer("one", TensorProto_DataType_FLOAT, {}, {1.0f}), arg("float_mask")},
+                {arg("padding")});
+  graph.AddNode("mul", "Mul", "",
+                {arg("padding"), &add_initializer("minus", TensorProto_DataType_FLOAT, {}, {-10000.0f})},
+                {arg("additive_mask")});
+
+  graph.AddNode("qk", "MatMul", "", {arg("q"), arg("k")}, {arg("qk_out")});
+  graph.AddNode("div", "Div", "",
+                {arg("qk_out"), &add_initializer("sqrt_head_size", TensorProto_DataType_FLOAT, {}, {std::sqrt(2.0f)})},
+                {arg("scores")});
+  graph.AddNode("mask_add", "Add", "", {arg("scores"), arg("additive_mask")}, {arg("masked_scores")});
+  graph.AddNode("softmax", "Softmax", "", {arg("masked_scores")}, {arg("probabilities")})
+      .AddAttribute("axis", int64_t{3});
+  graph.AddNode("context", "MatMul", "", {arg("probabilities"), arg("v")}, {arg("context_out")});
+  graph.AddNode("transpose", "Transpose", "", {arg("context_out")}, {arg("context_transposed")})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  graph.AddNode("reshape", "Reshape", "", {arg("context_transposed"), &hidden_shape}, {arg("y")});
+}
+
+TEST(GraphTransformationTests, AttentionFusion) {
+  constexpr int64_t batch_size = 2, sequence_length = 3, hidden_size = 4, num_heads = 2;
+  Model model("AttentionFusion");
+  auto& graph = model.MainGraph();
+  AddAttentionSubgraph(graph, batch_size, sequence_length, hidden_size, num_heads, {1}, {2});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Attention"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["Softmax"], 0);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Reshape"], 0);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 0);
+
+  // the full mask is kept, cast to int32, with the value of the additive mask
+  ASSERT_EQ(op_to_count["Cast"], 1);
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Attention") {
+      const auto& mask_index = *node.InputDefs()[3];
+      ASSERT_NE(mask_index.Shape(), nullptr);
+      EXPECT_EQ(mask_index.Shape()->dim_size(), 2);
+      EXPECT_EQ(mask_index.TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_INT32);
+      const auto* mask_filter_value = graph_utils::GetNodeAttribute(node, "mask_filter_value");
+      ASSERT_NE(mask_filter_value, nullptr);
+      EXPECT_EQ(mask_filter_value->f(), -10000.0f);
+    }
+  }
+
+  // the fused graph computes the same output, with a mask that isn't a prefix of the first sequence
+  // and masks all of the second one
+  std::vector<float> x_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = 0.25f * static_cast<float>(static_cast<int>(i) % 5) - 0.5f;
+  }
+  OrtValue x_value, mask_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault),
+                       {batch_size, sequence_length, hidden_size}, x_data, &x_value);
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault),
+                         {batch_size, sequence_length}, {1, 0, 1, 0, 0, 0}, &mask_value);
+  NameMLValMap feeds{{"x", x_value}, {"mask", mask_value}};
+
+  std::vector<std::vector<float>> outputs;
+  for (auto level : {TransformerLevel::Level1, TransformerLevel::Level2}) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    InferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session.Run(RunOptions(), feeds, {"y"}, &fetches).IsOK());
+    const Tensor& y = fetches[0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({batch_size, sequence_length, hidden_size}));
+    outputs.emplace_back(y.Data<float>(), y.Data<float>() + y.Shape().Size());
+  }
+  for (size_t i = 0; i < outputs[0].size(); ++i) {
+    EXPECT_NEAR(outputs[0][i], outputs[1][i], 1e-4f) << "i:" << i;
+  }
+}
+
+TEST(GraphTransformationTests, AttentionFusionUnsqueezeOrder) {
+  // Unsqueeze(axes=[2]) then Unsqueeze(axes=[1]) gives a mask of shape (batch_size, 1, sequence_length, 1),
+  // which masks queries instead of keys
+  Model model("AttentionFusionUnsqueezeOrder");
+  auto& graph = model.MainGraph();
+  AddAttentionSubgraph(graph, 2, 3, 4, 2, {2}, {1});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Attention"], 0);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 2);
+  ASSERT_EQ(op_to_count["Softmax"], 1);
+}
 #endif
 
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, EmbeddingBagFusion) {
+  Model model("EmbeddingBagFusion");
+  auto& graph = model.MainGraph();
+
+  TypeProto weight_type;
+  weight_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(10);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  TypeProto indices_type;
+  indices_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& weight = graph.GetOrCreateNodeArg("weight", &weight_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& rows0 = graph.GetOrCreateNodeArg("rows0", nullptr);
+  auto& rows1 = graph.GetOrCreateNodeArg("rows1", nullptr);
+  auto& bags0 = graph.GetOrCreateNodeArg("bags0", nullptr);
+  auto& bags1 = graph.GetOrCreateNodeArg("bags1", nullptr);
+
+  // the first Gather and ReduceMean are fused, the second are not as the reduction keeps the bag dimension
+  graph.AddNode("gather0", "Gather", "Gather rows", {&weight, &indices}, {&rows0}).AddAttribute("axis", int64_t{0});
+  auto& reduce0 = graph.AddNode("reduce0", "ReduceMean", "Reduce bags", {&rows0}, {&bags0});
+  reduce0.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce0.AddAttribute("keepdims", int64_t{0});
+  graph.AddNode("gather1", "Gather", "Gather rows", {&weight, &indices}, {&rows1}).AddAttribute("axis", int64_t{0});
+  auto& reduce1 = graph.AddNode("reduce1", "ReduceSum", "Reduce bags", {&rows1}, {&bags1});
+  reduce1.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce1.AddAttribute("keepdims", int64_t{1});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Gather"], 1);
+  ASSERT_EQ(op_to_count["ReduceMean"], 0);
+  ASSERT_EQ(op_to_count["ReduceSum"], 1);
+  ASSERT_EQ(op_to_count["EmbeddingBag"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "mode")->s(), "mean");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "bags0");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, EmbeddingBagFusionUnknownBagSize) {
+  Model model("EmbeddingBagFusionUnknownBagSize");
+  auto& graph = model.MainGraph();
+
+  TypeProto weight_type;
+  weight_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(10);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  TypeProto indices_type;
+  indices_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("bag_size");
+
+  auto& weight = graph.GetOrCreateNodeArg("weight", &weight_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+
+  // the bags may be empty, which only ReduceSum reduces to 0 like EmbeddingBag
+  for (const std::string op_type : {"ReduceSum", "ReduceMean", "ReduceMax"}) {
+    auto& rows = graph.GetOrCreateNodeArg(op_type + "_rows", nullptr);
+    auto& bags = graph.GetOrCreateNodeArg(op_type + "_bags", nullptr);
+    graph.AddNode(op_type + "_gather", "Gather", "Gather rows", {&weight, &indices}, {&rows})
+        .AddAttribute("axis", int64_t{0});
+    auto& reduce = graph.AddNode(op_type + "_reduce", op_type, "Reduce bags", {&rows}, {&bags});
+    reduce.AddAttribute("axes", std::vector<int64_t>{1});
+    reduce.AddAttribute("keepdims", int64_t{0});
+  }
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Gather"], 2);
+  ASSERT_EQ(op_to_count["ReduceSum"], 0);
+  ASSERT_EQ(op_to_count["ReduceMean"], 1);
+  ASSERT_EQ(op_to_count["ReduceMax"], 1);
+  ASSERT_EQ(op_to_count["EmbeddingBag"], 1);
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, SparseMatMulTransformer) {
+  Model model("SparseMatMulTransformer");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& data) -> NodeArg& {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_float_data(value);
+    }
+    graph.AddInitializedTensor(tensor_proto);
+
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  // b0 (16, 4) has one nonzero per column, which is sparse as CSR but not in blocks of 8 rows
+  std::vector<float> b0(16 * 4, 0.0f);
+  for (int n = 0; n < 4; ++n) {
+    b0[(n * 5) * 4 + n] = 1.0f + n;
+  }
+  // b1 (4, 4) is dense
+  std::vector<float> b1(4 * 4, 1.0f);
+  // b2 is transposed (4, 16), and its only nonzeros are the first 8 elements of its first row
+  std::vector<float> b2(4 * 16, 0.0f);
+  std::fill_n(b2.begin(), 8, 0.5f);
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(16);
+
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& x = graph.GetOrCreateNodeArg("X", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("matmul0", "MatMul", "sparse weight", {&a, &add_initializer("b0", {16, 4}, b0)}, {&x});
+  graph.AddNode("matmul1", "MatMul", "dense weight", {&x, &add_initializer("b1", {4, 4}, b1)}, {&y});
+  auto& gemm = graph.AddNode("gemm", "Gemm", "block-sparse weight",
+                             {&a, &add_initializer("b2", {4, 16}, b2),
+                              &add_initializer("c", {4}, {1.0f, 2.0f, 3.0f, 4.0f})},
+                             {&z});
+  gemm.AddAttribute("transB", int64_t{1});
+  gemm.AddAttribute("beta", 2.0f);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SparseMatMulTransformer>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["Gemm"], 0);
+  ASSERT_EQ(op_to_count["SparseMatMul"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "SparseMatMul") {
+      const bool is_gemm = node.OutputDefs()[0]->Name() == "Z";
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "block_size")->i(), is_gemm ? 8 : 1);
+      ASSERT_EQ(node.InputDefs().size(), is_gemm ? 5u : 4u);
+    }
+  }
+
+  // the dense weights of the converted nodes are removed
+  const TensorProto* tensor_proto = nullptr;
+  ASSERT_FALSE(graph.GetInitializedTensor("b0", tensor_proto));
+  ASSERT_FALSE(graph.GetInitializedTensor("b2", tensor_proto));
+  ASSERT_TRUE(graph.GetInitializedTensor("b1", tensor_proto));
+}
+
+TEST(GraphTransformationTests, CompressedMatMulTransformer) {
+  Model model("CompressedMatMulTransformer");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& data) -> NodeArg& {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_float_data(value);
+    }
+    graph.AddInitializedTensor(tensor_proto);
+
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  // w0 (8, 4) and the transposed w2 (4, 8) are large enough to compress, w1 (4, 2) is not
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& x = graph.GetOrCreateNodeArg("X", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("matmul0", "MatMul", "", {&a, &add_initializer("w0", {8, 4}, std::vector<float>(32, 0.5f))}, {&x});
+  graph.AddNode("matmul1", "MatMul", "", {&x, &add_initializer("w1", {4, 2}, std::vector<float>(8, 1.0f))}, {&y});
+  auto& gemm = graph.AddNode("gemm", "Gemm", "",
+                             {&a, &add_initializer("w2", {4, 8}, std::vector<float>(32, -2.0f)),
+                              &add_initializer("c", {4}, {1.0f, 2.0f, 3.0f, 4.0f})},
+                             {&z});
+  gemm.AddAttribute("transB", int64_t{1});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      onnxruntime::make_unique<CompressedMatMulTransformer>(WeightStorageType::kInt8,
+                                                            std::unordered_set<std::string>{}, 16),
+      TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["Gemm"], 0);
+  ASSERT_EQ(op_to_count["CompressedMatMul"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "CompressedMatMul") {
+      const bool is_gemm = node.OutputDefs()[0]->Name() == "Z";
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "transB")->i(), is_gemm ? 1 : 0);
+      ASSERT_EQ(node.InputDefs().size(), is_gemm ? 4u : 3u);
+      ASSERT_EQ(node.InputDefs()[1]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_INT8);
+      ASSERT_TRUE(node.InputDefs()[2]->Exists());
+    }
+  }
+
+  // the float weights of the converted nodes are removed
+  const TensorProto* tensor_proto = nullptr;
+  ASSERT_FALSE(graph.GetInitializedTensor("w0", tensor_proto));
+  ASSERT_FALSE(graph.GetInitializedTensor("w2", tensor_proto));
+  ASSERT_TRUE(graph.GetInitializedTensor("w1", tensor_proto));
+}
+
+TEST(GraphTransformationTests, ElementwiseChainFusion) {
+  Model model("ElementwiseChainFusion");
+  auto& graph = model.MainGraph();
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& data) {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_float_data(value);
+    }
+    graph.AddInitializedTensor(tensor_proto);
+  };
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {2, 4}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+  add_initializer("bias", {4}, {0.5f, -1.0f, 2.0f, 0.25f});
+  add_initializer("scale", {}, {1.702f});
+  add_initializer("mean", {2, 1}, {1.0f, -1.0f});
+
+  // y = a * Sigmoid(a * 1.702) with a = x + bias. a has two consumers, so the Add isn't part of the chain.
+  graph.AddNode("add", "Add", "", {&x, arg("bias")}, {arg("a")});
+  graph.AddNode("scale_mul", "Mul", "", {arg("a"), arg("scale")}, {arg("scaled")});
+  graph.AddNode("sigmoid", "Sigmoid", "", {arg("scaled")}, {arg("gate")});
+  graph.AddNode("gate_mul", "Mul", "", {arg("a"), arg("gate")}, {arg("y")});
+
+  // z = Relu(x - mean) broadcasts mean along the last dimension, which the kernel doesn't support
+  graph.AddNode("sub", "Sub", "", {&x, arg("mean")}, {arg("centered")});
+  graph.AddNode("relu", "Relu", "", {arg("centered")}, {arg("z")});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseChainFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedElementwise"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["Sigmoid"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+
+  // the fused graph computes the same outputs
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 4},
+                       {-2.0f, -0.5f, 0.0f, 0.5f, 1.0f, 1.5f, 3.0f, -4.0f}, &x_value);
+  NameMLValMap feeds{{"x", x_value}};
+
+  std::vector<std::vector<OrtValue>> outputs;
+  for (auto level : {TransformerLevel::Level1, TransformerLevel::Level2}) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    InferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session.Run(RunOptions(), feeds, {"y", "z"}, &fetches).IsOK());
+    outputs.push_back(fetches);
+  }
+  for (size_t n = 0; n < 2; ++n) {
+    const Tensor& expected = outputs[0][n].Get<Tensor>();
+    const Tensor& actual = outputs[1][n].Get<Tensor>();
+    ASSERT_EQ(expected.Shape(), actual.Shape());
+    for (int64_t i = 0; i < expected.Shape().Size(); ++i) {
+      EXPECT_NEAR(expected.Data<float>()[i], actual.Data<float>()[i], 1e-5f) << "output:" << n << " i:" << i;
+    }
+  }
+}
+#endif
+
+TEST(GraphTransformationTests, ZipMapBypass) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  domain_to_version[kMLDomain] = 1;
+  Model model("zipmap", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("probabilities", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("output_probability", nullptr);
+  auto& zipmap = graph.AddNode("zipmap", "ZipMap", "", {&input_arg}, {&output_arg}, nullptr, kMLDomain);
+  zipmap.AddAttribute("classlabels_strings", std::vector<std::string>{"cat", "dog", "say \"hi\""});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions session_options;
+  session_options.enable_zipmap_bypass = true;
+  InferenceSession session{session_options, &DefaultLoggingManager()};
+  ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+
+  auto metadata = session.GetModelMetadata();
+  ASSERT_TRUE(metadata.first.IsOK());
+  ASSERT_EQ(metadata.second->custom_metadata_map.at("output_probability.labels"),
+            "[\"cat\",\"dog\",\"say \\\"hi\\\"\"]");
+
+  std::vector<float> values = {0.1f, 0.2f, 0.7f, 0.6f, 0.3f, 0.1f};
+  OrtValue input;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, values, &input);
+  NameMLValMap feeds{{"probabilities", input}};
+
+  std::vector<OrtValue> fetches;
+  ASSERT_TRUE(session.Run(RunOptions(), feeds, {"output_probability"}, &fetches).IsOK());
+  ASSERT_EQ(fetches.size(), 1u);
+  ASSERT_TRUE(fetches[0].IsTensor());
+  const Tensor& output = fetches[0].Get<Tensor>();
+  ASSERT_EQ(output.Shape(), TensorShape({2, 3}));
+  const float* output_data = output.Data<float>();
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(output_data[i], values[i]);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
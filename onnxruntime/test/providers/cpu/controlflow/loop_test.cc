@@ -713,6 +713,114 @@ TEST(Loop, Opset11WithNoVariadicInputsAndOutputs) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// test a Loop with a trip count that is known upfront, where the scan output is written directly to the Loop output
+// and the loop carried variable alternates between two buffers
+TEST(Loop, FixedTripCount) {
+  auto create_subgraph = []() {
+    Model model("Loop fixed trip count body graph");
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    // use a symbolic dimension so the Loop output is allocated when the first iteration provides the shape
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("n");
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& sum_in = graph.GetOrCreateNodeArg("sum_in", &float_tensor);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& sum_out = graph.GetOrCreateNodeArg("sum_out", &float_tensor);
+    auto& scan_out = graph.GetOrCreateNodeArg("scan_out", &float_tensor);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "Double sum_in", {&sum_in, &sum_in}, {&sum_out});
+    graph.AddNode("scan_out_identity", "Identity", "Copy sum_out to scan_out", {&sum_out}, {&scan_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &sum_in});
+    graph.SetOutputs({&cond_out, &sum_out, &scan_out});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("sum", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("sum_final", {2}, {32.f, 64.f});
+  test.AddOutput<float>("loop_scan_out", {5, 2}, {2.f, 4.f, 4.f, 8.f, 8.f, 16.f, 16.f, 32.f, 32.f, 64.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// test a Loop whose body returns a loop carried variable input as a scan output. The saved scan outputs must not
+// be overwritten by later iterations.
+TEST(Loop, PassThroughLoopCarriedVarAsScanOutput) {
+  auto create_subgraph = []() {
+    Model model("Loop pass through body graph");
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& sum_in = graph.GetOrCreateNodeArg("sum_in", &float_tensor);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& sum_out = graph.GetOrCreateNodeArg("sum_out", &float_tensor);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "Double sum_in", {&sum_in, &sum_in}, {&sum_out});
+
+    // sum_in is returned as is for the scan output
+    graph.SetInputs({&iter_num_in, &cond_in, &sum_in});
+    graph.SetOutputs({&cond_out, &sum_out, &sum_in});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("sum", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("sum_final", {2}, {32.f, 64.f});
+  test.AddOutput<float>("loop_scan_out", {5, 2}, {1.f, 2.f, 2.f, 4.f, 4.f, 8.f, 8.f, 16.f, 16.f, 32.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -575,5 +575,54 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+// 3x3 unit stride convolution with enough channels to use the Winograd algorithm
+// with constant (prepacked) weights.
+TEST(ConvTest, Conv2D_Winograd) {
+  const int64_t C = 32, M = 32, height = 10, width = 9;
+
+  vector<float> X(C * height * width);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.1f;
+  }
+  vector<float> W(M * C * 9);
+  for (size_t i = 0; i < W.size(); i++) {
+    W[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.05f;
+  }
+  vector<float> B(M);
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<float>(i) * 0.01f;
+  }
+
+  vector<float> Y(M * height * width);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t oh = 0; oh < height; oh++) {
+      for (int64_t ow = 0; ow < width; ow++) {
+        float sum = B[m];
+        for (int64_t c = 0; c < C; c++) {
+          for (int64_t kh = 0; kh < 3; kh++) {
+            for (int64_t kw = 0; kw < 3; kw++) {
+              int64_t ih = oh + kh - 1, iw = ow + kw - 1;
+              if (ih >= 0 && ih < height && iw >= 0 && iw < width) {
+                sum += X[(c * height + ih) * width + iw] * W[((m * C + c) * 3 + kh) * 3 + kw];
+              }
+            }
+          }
+        }
+        Y[(m * height + oh) * width + ow] = sum;
+      }
+    }
+  }
+
+  OpTester test("Conv");
+  test.AddAttribute("group", int64_t(1));
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+  test.AddInput<float>("X", {1, C, height, width}, X);
+  test.AddInput<float>("W", {M, C, 3, 3}, W, true);
+  test.AddInput<float>("B", {M}, B, true);
+  test.AddOutput<float>("Y", {1, M, height, width}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -306,6 +306,30 @@ TEST(GatherOpTest, Gather_perf) {
   test.Run();
 }
 
+TEST(GatherOpTest, Gather_axis0_rows) {
+  // enough rows to be split between tasks, with rows prefetched ahead of the one being copied
+  constexpr int64_t num_rows = 1000, row_size = 64, num_indices = 300;
+  std::vector<float> input(num_rows * row_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+
+  std::vector<int64_t> indices(num_indices);
+  std::vector<float> output;
+  for (int64_t i = 0; i < num_indices; ++i) {
+    int64_t row = (i * 37) % num_rows;
+    indices[i] = i % 3 == 0 ? row - num_rows : row;
+    output.insert(output.end(), input.begin() + row * row_size, input.begin() + (row + 1) * row_size);
+  }
+
+  OpTester test("Gather", 11);
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {num_rows, row_size}, input);
+  test.AddInput<int64_t>("indices", {num_indices / 3, 3}, indices);
+  test.AddOutput<float>("output", {num_indices / 3, 3, row_size}, output);
+  test.Run();
+}
+
 TEST(GatherOpTest, Gather_axis1_neg_indices2d_int8) {
   OpTester test("Gather", 11);
   test.AddAttribute<int64_t>("axis", 1LL);
@@ -3,6 +3,8 @@
 
 #include <fstream>
 #include <google/protobuf/stubs/status.h>
+#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/message_differencer.h>
 
 #include "gtest/gtest.h"
 
@@ -68,6 +70,71 @@ TEST(JsonSerializationTests, HappyPath) {
   EXPECT_EQ(expected_json_string, json_string);
 }
 
+TEST(JsonDeserializationTests, MatchesProtobufParser) {
+  std::string input_json = R"({ "inputs": { "A": { "dims": ["2", 2], "dataType": 1, "floatData": [1.5, -2, 0.1, 3e-5] },)"
+                           R"("B": {"dims":["3"],"data_type":7,"int64Data":["-9007199254740993", 2, "3"],"name":"B"},)"
+                           R"("C": {"dims":["2"],"dataType":1,"rawData":"AACAPwAAAEA="},)"
+                           R"("D": {"dims":["1"],"dataType":3,"raw_data":"fw"} },)"
+                           R"("outputFilter": ["Y", "Z"] })";
+
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  onnxruntime::server::PredictRequest expected;
+  protobufutil::JsonParseOptions options;
+  status = protobufutil::JsonStringToMessage(input_json, &expected, options);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected, request));
+  EXPECT_EQ(request.inputs().at("C").raw_data().size(), 8u);
+}
+
+TEST(JsonSerializationTests, MatchesProtobufPrinter) {
+  onnxruntime::server::PredictResponse response;
+  auto& float_output = (*response.mutable_outputs())["float_output"];
+  float_output.add_dims(5);
+  float_output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  for (float value : {0.1f, 1.f, -2.5f, 1e-20f, 16777216.f}) {
+    float_output.add_float_data(value);
+  }
+
+  auto& int64_output = (*response.mutable_outputs())["int64_output"];
+  int64_output.add_dims(2);
+  int64_output.set_data_type(onnx::TensorProto_DataType_INT64);
+  int64_output.add_int64_data(-9007199254740993);
+  int64_output.add_int64_data(42);
+
+  auto& raw_output = (*response.mutable_outputs())["raw_output"];
+  raw_output.add_dims(1);
+  raw_output.add_dims(3);
+  raw_output.set_data_type(onnx::TensorProto_DataType_UINT8);
+  raw_output.set_data_location(onnx::TensorProto_DataLocation_DEFAULT);
+  raw_output.set_raw_data(std::string("\x01\xfe\x7f", 3));
+
+  std::string json_string;
+  protobufutil::Status status = onnxruntime::server::GenerateResponseInJson(response, json_string);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  // compare the parsed result as the order of the map entries is not defined
+  onnxruntime::server::PredictResponse parsed;
+  status = protobufutil::JsonStringToMessage(json_string, &parsed, protobufutil::JsonParseOptions{});
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+  EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(response, parsed));
+
+  // each tensor should be written exactly as protobuf would write it
+  onnxruntime::server::PredictResponse single_output;
+  (*single_output.mutable_outputs())["float_output"] = float_output;
+  std::string expected_json_string;
+  protobufutil::JsonPrintOptions options;
+  status = protobufutil::MessageToJsonString(single_output, &expected_json_string, options);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  status = onnxruntime::server::GenerateResponseInJson(single_output, json_string);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+  EXPECT_EQ(expected_json_string, json_string);
+}
+
 TEST(StringEscapingTests, SimpleString) {
   std::string unescaped = "This is an error message \" \n ";
   EXPECT_EQ("This is an error message \\\" \\n ", escape_string(unescaped));
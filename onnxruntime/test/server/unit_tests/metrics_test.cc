@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+
+#include "server/metrics.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static bool Contains(const std::string& text, const std::string& line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+TEST(MetricsTests, HistogramBucketsAreCumulative) {
+  LatencyHistogram histogram;
+  histogram.Observe(std::chrono::microseconds(50));
+  histogram.Observe(std::chrono::microseconds(100));
+  histogram.Observe(std::chrono::microseconds(750));
+  histogram.Observe(std::chrono::seconds(20));
+
+  std::string out;
+  histogram.Write("latency_seconds", R"(model="m")", out);
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_bucket{model="m",le="0.0001"} 2)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_bucket{model="m",le="0.00025"} 2)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_bucket{model="m",le="0.001"} 3)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_bucket{model="m",le="10"} 3)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_bucket{model="m",le="+Inf"} 4)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_sum{model="m"} 20.0009)"));
+  EXPECT_TRUE(Contains(out, R"(latency_seconds_count{model="m"} 4)"));
+}
+
+TEST(MetricsTests, RequestScopeCountsErrors) {
+  ServerMetrics metrics;
+  auto& model = metrics.GetModelMetrics("mnist");
+  EXPECT_EQ(&model, &metrics.GetModelMetrics("mnist"));
+
+  {
+    RequestMetricsScope request(model);
+    EXPECT_EQ(model.in_flight.load(), 1);
+    request.Succeeded();
+  }
+  {
+    RequestMetricsScope request(model);
+  }
+
+  EXPECT_EQ(model.requests.load(), 2u);
+  EXPECT_EQ(model.errors.load(), 1u);
+  EXPECT_EQ(model.in_flight.load(), 0);
+
+  std::string out;
+  metrics.Write(out);
+  EXPECT_TRUE(Contains(out, "# TYPE onnxruntime_server_requests_total counter"));
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_requests_total{model="mnist"} 2)"));
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_request_errors_total{model="mnist"} 1)"));
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_requests_in_flight{model="mnist"} 0)"));
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_request_duration_seconds_count{model="mnist"} 2)"));
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_parse_duration_seconds_count{model="mnist"} 0)"));
+}
+
+TEST(MetricsTests, ModelCountIsBounded) {
+  ServerMetrics metrics;
+  for (size_t i = 0; i < ServerMetrics::kMaxModels; ++i) {
+    metrics.GetModelMetrics("model" + std::to_string(i));
+  }
+
+  auto& other = metrics.GetModelMetrics("one more");
+  EXPECT_EQ(&other, &metrics.GetModelMetrics("and another"));
+  EXPECT_EQ(&metrics.GetModelMetrics("model0"), &metrics.GetModelMetrics("model0"));
+  EXPECT_NE(&metrics.GetModelMetrics("model0"), &other);
+
+  std::string out;
+  metrics.Write(out);
+  EXPECT_TRUE(Contains(out, R"(onnxruntime_server_requests_total{model="_other"} 0)"));
+  EXPECT_EQ(out.find("one more"), std::string::npos);
+}
+
+TEST(MetricsTests, UnknownModelsShareOneEntry) {
+  auto env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "metrics", "1");
+
+  auto& unknown = env->GetModelMetrics("no such model");
+  EXPECT_EQ(&unknown, &env->GetModelMetrics("another missing model"));
+  EXPECT_EQ(&unknown, &env->GetMetrics().GetModelMetrics("_unknown"));
+  EXPECT_EQ(&env->GetModelMetrics("metrics"), &env->GetMetrics().GetModelMetrics("metrics"));
+  EXPECT_NE(&env->GetModelMetrics("metrics"), &unknown);
+
+  // Unloaded models are unknown again
+  env->UnloadModel("metrics", "1");
+  EXPECT_EQ(&env->GetModelMetrics("metrics"), &unknown);
+
+  std::string out;
+  env->GetMetrics().Write(out);
+  EXPECT_EQ(out.find("no such model"), std::string::npos);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
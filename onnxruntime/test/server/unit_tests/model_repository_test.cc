@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace fs = boost::filesystem;
+
+class ModelRepositoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    repository_path_ = fs::temp_directory_path() / fs::unique_path("model_repository_%%%%%%%%");
+    fs::create_directories(repository_path_);
+  }
+
+  void TearDown() override {
+    fs::remove_all(repository_path_);
+  }
+
+  void AddVersion(const std::string& model_name, const std::string& version) {
+    auto version_path = repository_path_ / model_name / version;
+    fs::create_directories(version_path);
+    fs::copy_file("testdata/mul_1.onnx", version_path / "model.onnx");
+  }
+
+  std::shared_ptr<ServerEnvironment> GetEnvironment() {
+    return std::shared_ptr<ServerEnvironment>(ServerEnv(), [](ServerEnvironment*) {});
+  }
+
+  fs::path repository_path_;
+};
+
+static bool RunMul(ServerEnvironment* env, const std::string& model_name, const std::string& model_version) {
+  PredictRequest request{};
+  request.add_output_filter("Y");
+  onnx::TensorProto proto{};
+  proto.add_dims(3);
+  proto.add_dims(2);
+  proto.set_data_type(1);
+  for (int i = 1; i <= 6; ++i) {
+    proto.add_float_data(static_cast<float>(i));
+  }
+  (*request.mutable_inputs())["X"] = proto;
+
+  Executor executor(env, "RequestId");
+  PredictResponse response{};
+  return executor.Predict(model_name, model_version, request, response).ok() &&
+         response.outputs().at("Y").float_data(5) == 36.f;
+}
+
+TEST_F(ModelRepositoryTest, ServesLatestVersion) {
+  AddVersion("mul", "2");
+  AddVersion("mul", "10");
+  AddVersion("other", "1");
+  fs::create_directories(repository_path_ / "mul" / "11");  // no model file, ignored
+
+  ModelRepository repository(GetEnvironment(), repository_path_.string());
+  EXPECT_EQ(repository.Poll(), 2u);
+  EXPECT_EQ(ServerEnv()->GetModelVersions("mul"), std::vector<std::string>{"10"});
+  EXPECT_EQ(ServerEnv()->GetModelVersions("other"), std::vector<std::string>{"1"});
+  EXPECT_TRUE(RunMul(ServerEnv(), "mul", ""));
+  EXPECT_TRUE(RunMul(ServerEnv(), "mul", "10"));
+  EXPECT_FALSE(RunMul(ServerEnv(), "mul", "2"));
+
+  fs::remove_all(repository_path_);
+  fs::create_directories(repository_path_);
+  EXPECT_EQ(repository.Poll(), 0u);
+  EXPECT_TRUE(ServerEnv()->GetModelVersions("mul").empty());
+}
+
+TEST_F(ModelRepositoryTest, ReloadsNewVersion) {
+  AddVersion("mul", "1");
+
+  ModelRepository repository(GetEnvironment(), repository_path_.string(), 1, {{"mul", 2}});
+  EXPECT_EQ(repository.Poll(), 1u);
+
+  // A request in flight keeps the version it started with
+  auto in_flight = ServerEnv()->GetModel("mul", "");
+
+  AddVersion("mul", "2");
+  EXPECT_EQ(repository.Poll(), 1u);
+  EXPECT_EQ(ServerEnv()->GetModelVersions("mul"), std::vector<std::string>{"2"});
+  EXPECT_NE(ServerEnv()->GetModel("mul", "").get(), in_flight.get());
+  EXPECT_EQ(in_flight->output_names, std::vector<std::string>{"Y"});
+  EXPECT_TRUE(RunMul(ServerEnv(), "mul", ""));
+
+  // A version that fails to load leaves the current version in place
+  auto broken_path = repository_path_ / "mul" / "3";
+  fs::create_directories(broken_path);
+  std::ofstream(broken_path.string() + "/model.onnx") << "not a model";
+  EXPECT_EQ(repository.Poll(), 1u);
+  EXPECT_EQ(ServerEnv()->GetModelVersions("mul"), std::vector<std::string>{"2"});
+
+  fs::remove_all(repository_path_ / "mul");
+  EXPECT_EQ(repository.Poll(), 0u);
+}
+
+TEST(ServerEnvironmentTests, LatestVersionIsNumericallyLargest) {
+  auto env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "versions", "9");
+  env->InitializeModel("testdata/mul_1.onnx", "versions", "10");
+  env->InitializeModel("testdata/mul_1.onnx", "versions", "name");
+
+  EXPECT_EQ(env->GetModelVersions("versions"), (std::vector<std::string>{"9", "10", "name"}));
+  EXPECT_EQ(env->GetModel("versions", "").get(), env->GetModel("versions", "name").get());
+
+  env->UnloadModel("versions", "name");
+  EXPECT_EQ(env->GetModel("versions", "").get(), env->GetModel("versions", "10").get());
+
+  env->UnloadModel("versions", "9");
+  env->UnloadModel("versions", "10");
+  EXPECT_THROW(env->GetModel("versions", ""), Ort::Exception);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -37,7 +37,7 @@ class PredictionServiceImplTest : public ::testing::Test {
     const static auto model_file = "testdata/mul_1.onnx";
 
     onnxruntime::server::ServerEnvironment* env = onnxruntime::server::test::ServerEnv();
-    // Implementation detail - currently predict is hardcoded to model "default" version 1.
+    // Requests without model metadata run the latest version of model "default".
     env->InitializeModel(model_file, "default", "1");
   }
   void TearDown() override {
@@ -130,6 +130,29 @@ TEST_F(PredictionServiceImplTest, InvalidInputClientID) {
   EXPECT_FALSE(status.ok());
 }
 
+TEST_F(PredictionServiceImplTest, ModelFromMetadata) {
+  auto env = GetEnvironment();
+  env->InitializeModel("testdata/mul_1.onnx", "mul", "2");
+  PredictionServiceImpl test{env};
+  auto request = GetRequest();
+
+  PredictResponse resp{};
+  ::grpc::ServerContext context;
+  ::grpc::testing::ServerContextTestSpouse spouse(&context);
+  spouse.AddClientMetadata("x-ms-model-name", "mul");
+  spouse.AddClientMetadata("x-ms-model-version", "2");
+  EXPECT_TRUE(test.Predict(&context, &request, &resp).ok());
+
+  PredictResponse missing_resp{};
+  ::grpc::ServerContext missing_context;
+  ::grpc::testing::ServerContextTestSpouse missing_spouse(&missing_context);
+  missing_spouse.AddClientMetadata("x-ms-model-name", "mul");
+  missing_spouse.AddClientMetadata("x-ms-model-version", "3");
+  EXPECT_FALSE(test.Predict(&missing_context, &request, &missing_resp).ok());
+
+  env->UnloadModel("mul", "2");
+}
+
 }  // namespace test
 }  // namespace grpc
 }  // namespace server
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "server/request_scheduler.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+using Clock = RequestScheduler::Clock;
+
+// Blocks the work that calls Wait until Release is called
+class Gate {
+ public:
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiting_;
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return open_; });
+  }
+
+  void WaitForWaiters(int count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, count]() { return waiting_ >= count; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int waiting_ = 0;
+  bool open_ = false;
+};
+
+static void WaitForQueueSize(const RequestScheduler& scheduler, size_t size) {
+  while (scheduler.GetQueueSize() != size) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(RequestSchedulerTests, RunsWork) {
+  RequestScheduler scheduler(2, 4, 1);
+  int runs = 0;
+  auto status = scheduler.Run("model", 0, Clock::time_point::max(), [&runs]() {
+    ++runs;
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "bad input");
+  });
+
+  EXPECT_EQ(runs, 1);
+  EXPECT_EQ(status.error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+}
+
+TEST(RequestSchedulerTests, DispatchesByPriorityThenDeadline) {
+  RequestScheduler scheduler(1, 8, 1);
+  Gate gate;
+  std::thread blocker([&]() {
+    scheduler.Run("model", 0, Clock::time_point::max(), [&gate]() {
+      gate.Wait();
+      return protobufutil::Status::OK;
+    });
+  });
+  gate.WaitForWaiters(1);
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto now = Clock::now();
+  struct {
+    int id;
+    int priority;
+    Clock::time_point deadline;
+  } requests[] = {
+      {0, 0, Clock::time_point::max()},
+      {1, 0, now + std::chrono::hours(2)},
+      {2, 1, Clock::time_point::max()},
+      {3, 0, now + std::chrono::hours(1)},
+  };
+
+  std::vector<std::thread> clients;
+  for (const auto& request : requests) {
+    auto queue_size = scheduler.GetQueueSize();
+    clients.emplace_back([&, request]() {
+      scheduler.Run("model", request.priority, request.deadline, [&, request]() {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(request.id);
+        return protobufutil::Status::OK;
+      });
+    });
+    WaitForQueueSize(scheduler, queue_size + 1);
+  }
+
+  gate.Release();
+  blocker.join();
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  EXPECT_EQ(order, (std::vector<int>{2, 3, 1, 0}));
+}
+
+TEST(RequestSchedulerTests, RejectsWhenQueueIsFull) {
+  RequestScheduler scheduler(1, 1, 1);
+  Gate gate;
+  std::thread blocker([&]() {
+    scheduler.Run("model", 0, Clock::time_point::max(), [&gate]() {
+      gate.Wait();
+      return protobufutil::Status::OK;
+    });
+  });
+  gate.WaitForWaiters(1);
+
+  std::thread queued([&]() {
+    EXPECT_TRUE(scheduler.Run("model", 0, Clock::time_point::max(), []() { return protobufutil::Status::OK; }).ok());
+  });
+  WaitForQueueSize(scheduler, 1);
+
+  bool ran = false;
+  auto status = scheduler.Run("model", 0, Clock::time_point::max(), [&ran]() {
+    ran = true;
+    return protobufutil::Status::OK;
+  });
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(status.error_code(), protobufutil::error::Code::RESOURCE_EXHAUSTED);
+
+  gate.Release();
+  blocker.join();
+  queued.join();
+}
+
+TEST(RequestSchedulerTests, RejectsRequestsThatWouldMissTheirDeadline) {
+  RequestScheduler scheduler(1, 4, 1);
+
+  // Teach the scheduler that the model takes about 50ms per run
+  ASSERT_TRUE(scheduler.Run("slow", 0, Clock::time_point::max(), []() {
+                         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                         return protobufutil::Status::OK;
+                       })
+                  .ok());
+
+  bool ran = false;
+  auto status = scheduler.Run("slow", 0, Clock::now() + std::chrono::milliseconds(5), [&ran]() {
+    ran = true;
+    return protobufutil::Status::OK;
+  });
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(status.error_code(), protobufutil::error::Code::RESOURCE_EXHAUSTED);
+
+  // A model without history is admitted as long as its deadline has not passed
+  EXPECT_TRUE(scheduler.Run("fast", 0, Clock::now() + std::chrono::seconds(10), []() { return protobufutil::Status::OK; }).ok());
+  EXPECT_EQ(scheduler.Run("fast", 0, Clock::now() - std::chrono::milliseconds(1), []() { return protobufutil::Status::OK; }).error_code(),
+            protobufutil::error::Code::RESOURCE_EXHAUSTED);
+}
+
+TEST(RequestSchedulerTests, LimitsRunsPerModel) {
+  RequestScheduler scheduler(4, 16, 2);
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 8; ++i) {
+    clients.emplace_back([&]() {
+      scheduler.Run("model", 0, Clock::time_point::max(), [&]() {
+        auto current = ++running;
+        auto max = max_running.load();
+        while (current > max && !max_running.compare_exchange_weak(max, current)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --running;
+        return protobufutil::Status::OK;
+      });
+    });
+  }
+
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  EXPECT_GE(max_running.load(), 1);
+  EXPECT_LE(max_running.load(), 2);
+}
+
+TEST(RequestSchedulerTests, ParsesSchedulingValues) {
+  int priority = 0;
+  EXPECT_TRUE(ParseRequestPriority("-3", priority));
+  EXPECT_EQ(priority, -3);
+  EXPECT_FALSE(ParseRequestPriority("high", priority));
+  EXPECT_FALSE(ParseRequestPriority("1x", priority));
+
+  std::chrono::milliseconds timeout{};
+  EXPECT_TRUE(ParseRequestTimeout("250", timeout));
+  EXPECT_EQ(timeout.count(), 250);
+  EXPECT_FALSE(ParseRequestTimeout("0", timeout));
+  EXPECT_FALSE(ParseRequestTimeout("", timeout));
+}
+
+TEST(RequestSchedulerTests, HugeTimeoutHasNoDeadline) {
+  std::chrono::milliseconds timeout{};
+  ASSERT_TRUE(ParseRequestTimeout("9223372036854775807", timeout));
+  EXPECT_EQ(GetRequestDeadline(timeout), Clock::time_point::max());
+
+  auto before = Clock::now();
+  auto deadline = GetRequestDeadline(std::chrono::milliseconds(250));
+  EXPECT_GE(deadline, before + std::chrono::milliseconds(250));
+  EXPECT_LE(deadline, Clock::now() + std::chrono::milliseconds(250));
+
+  // the request isn't rejected as past its deadline
+  RequestScheduler scheduler(1, 4, 1);
+  bool ran = false;
+  auto status = scheduler.Run("model", 0, GetRequestDeadline(timeout), [&ran]() {
+    ran = true;
+    return protobufutil::Status::OK;
+  });
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  EXPECT_TRUE(ran);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
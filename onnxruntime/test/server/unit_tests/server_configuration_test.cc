@@ -65,6 +65,76 @@ TEST(ConfigParsingTests, NoModelArg) {
   EXPECT_EQ(res, Result::ExitFailure);
 }
 
+TEST(ConfigParsingTests, RepositoryArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata"),
+      const_cast<char*>("--repository_poll_seconds"), const_cast<char*>("5"),
+      const_cast<char*>("--intra_op_threads"), const_cast<char*>("2"),
+      const_cast<char*>("--per_model_threads"), const_cast<char*>("mnist=4"),
+      const_cast<char*>("--per_model_threads"), const_cast<char*>("a=b=1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(11, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.repository_path, "testdata");
+  EXPECT_TRUE(config.model_path.empty());
+  EXPECT_EQ(config.repository_poll_seconds, 5);
+  EXPECT_EQ(config.intra_op_threads, 2);
+  EXPECT_EQ(config.per_model_threads.size(), 2u);
+  EXPECT_EQ(config.per_model_threads["mnist"], 4);
+  EXPECT_EQ(config.per_model_threads["a=b"], 1);
+}
+
+TEST(ConfigParsingTests, ModelAndRepositoryArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, WrongPerModelThreads) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata"),
+      const_cast<char*>("--per_model_threads"), const_cast<char*>("mnist=0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, SchedulingArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_inference_threads"), const_cast<char*>("3"),
+      const_cast<char*>("--max_queue_size"), const_cast<char*>("16"),
+      const_cast<char*>("--max_runs_per_model"), const_cast<char*>("1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(9, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_inference_threads, 3);
+  EXPECT_EQ(config.max_queue_size, 16);
+  EXPECT_EQ(config.max_runs_per_model, 1);
+}
+
+TEST(ConfigParsingTests, WrongMaxRunsPerModel) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_runs_per_model"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, ModelNotFound) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
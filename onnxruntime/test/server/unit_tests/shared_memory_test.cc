@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/shared_memory.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+// A POSIX shared memory object owned by the test, as a client would create it
+class ClientSharedMemory {
+ public:
+  explicit ClientSharedMemory(size_t byte_size)
+      : key_("/ort_server_test_" + std::to_string(getpid())), byte_size_(byte_size) {
+    int fd = shm_open(key_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    EXPECT_NE(fd, -1);
+    EXPECT_EQ(ftruncate(fd, byte_size_), 0);
+    data_ = mmap(nullptr, byte_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    EXPECT_NE(data_, MAP_FAILED);
+    close(fd);
+  }
+
+  ~ClientSharedMemory() {
+    munmap(data_, byte_size_);
+    shm_unlink(key_.c_str());
+  }
+
+  const std::string& Key() const { return key_; }
+
+  float* Floats(size_t offset) { return reinterpret_cast<float*>(static_cast<char*>(data_) + offset); }
+
+ private:
+  const std::string key_;
+  const size_t byte_size_;
+  void* data_;
+};
+
+TEST(SharedMemoryTests, RegisterAndUnregister) {
+  ClientSharedMemory client(4096);
+  SharedMemoryManager manager;
+
+  EXPECT_EQ(manager.Register("region", "/ort_server_test_missing", 4096).error_code(), protobufutil::error::Code::NOT_FOUND);
+  EXPECT_EQ(manager.Register("region", client.Key(), 8192).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+  ASSERT_TRUE(manager.Register("region", client.Key(), 4096).ok());
+  EXPECT_EQ(manager.Register("region", client.Key(), 4096).error_code(), protobufutil::error::Code::ALREADY_EXISTS);
+
+  auto region = manager.GetRegion("region");
+  ASSERT_NE(region, nullptr);
+  EXPECT_EQ(region->Size(), 4096u);
+  EXPECT_NE(region->GetData(4000, 96), nullptr);
+  EXPECT_EQ(region->GetData(4000, 97), nullptr);
+  EXPECT_EQ(region->GetData(5000, 0), nullptr);
+
+  // The server and the client see the same memory
+  client.Floats(16)[0] = 42.f;
+  EXPECT_EQ(*static_cast<float*>(region->GetData(16, sizeof(float))), 42.f);
+
+  // A region in use stays mapped after it is unregistered
+  ASSERT_TRUE(manager.Unregister("region").ok());
+  EXPECT_EQ(manager.GetRegion("region"), nullptr);
+  EXPECT_EQ(*static_cast<float*>(region->GetData(16, sizeof(float))), 42.f);
+  EXPECT_EQ(manager.Unregister("region").error_code(), protobufutil::error::Code::NOT_FOUND);
+}
+
+// Enables shared memory on the test server environment only for the duration of a test
+class SharedMemoryPredictTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto env = ServerEnv();
+    env->InitializeModel("testdata/mul_1.onnx", "shared_memory", "1");
+    env->EnableSharedMemory();
+  }
+
+  void TearDown() override {
+    auto env = ServerEnv();
+    env->DisableSharedMemory();
+    env->UnloadModel("shared_memory", "1");
+  }
+};
+
+TEST_F(SharedMemoryPredictTest, PredictWithSharedMemory) {
+  auto env = ServerEnv();
+  ClientSharedMemory client(4096);
+  ASSERT_TRUE(env->GetSharedMemory()->Register("io", client.Key(), 4096).ok());
+  for (int i = 0; i < 6; ++i) {
+    client.Floats(0)[i] = static_cast<float>(i + 1);
+  }
+
+  PredictRequest request{};
+  auto& input = (*request.mutable_shared_memory_inputs())["X"];
+  input.set_region("io");
+  input.add_dims(3);
+  input.add_dims(2);
+  input.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  // With a shape the output is computed in place
+  auto& output = (*request.mutable_shared_memory_outputs())["Y"];
+  output.set_region("io");
+  output.set_offset(64);
+  output.add_dims(3);
+  output.add_dims(2);
+  output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Executor executor(env, "RequestId");
+  PredictResponse response{};
+  auto status = executor.Predict("shared_memory", "", request, response);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_TRUE(response.outputs().empty());
+  EXPECT_EQ(client.Floats(64)[5], 36.f);
+  const auto& written = response.shared_memory_outputs().at("Y");
+  EXPECT_EQ(written.byte_size(), 24u);
+  EXPECT_EQ(written.dims_size(), 2);
+
+  // Without a shape the output is copied into the space given for it
+  output.clear_dims();
+  output.set_offset(128);
+  output.set_byte_size(24);
+  response.Clear();
+  status = executor.Predict("shared_memory", "", request, response);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_EQ(client.Floats(128)[4], 25.f);
+  EXPECT_EQ(response.shared_memory_outputs().at("Y").dims(1), 2);
+
+  output.set_byte_size(20);
+  response.Clear();
+  EXPECT_EQ(executor.Predict("shared_memory", "", request, response).error_code(), protobufutil::error::Code::OUT_OF_RANGE);
+
+  input.set_offset(2);
+  response.Clear();
+  EXPECT_EQ(executor.Predict("shared_memory", "", request, response).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+}
+
+TEST_F(SharedMemoryPredictTest, RejectsOverlappingOutputs) {
+  auto env = ServerEnv();
+  ClientSharedMemory client(4096);
+  ASSERT_TRUE(env->GetSharedMemory()->Register("io", client.Key(), 4096).ok());
+  // A second name for the same memory
+  ASSERT_TRUE(env->GetSharedMemory()->Register("alias", client.Key(), 4096).ok());
+
+  PredictRequest request{};
+  auto& input = (*request.mutable_shared_memory_inputs())["X"];
+  input.set_region("io");
+  input.add_dims(3);
+  input.add_dims(2);
+  input.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  auto& output = (*request.mutable_shared_memory_outputs())["Y"];
+  output.set_region("io");
+  output.set_offset(20);
+  output.add_dims(3);
+  output.add_dims(2);
+  output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Executor executor(env, "RequestId");
+  PredictResponse response{};
+  EXPECT_EQ(executor.Predict("shared_memory", "", request, response).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+
+  output.set_region("alias");
+  output.set_offset(0);
+  EXPECT_EQ(executor.Predict("shared_memory", "", request, response).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+
+  // Space for a copied output counts as well
+  output.clear_dims();
+  output.set_byte_size(24);
+  EXPECT_EQ(executor.Predict("shared_memory", "", request, response).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+
+  // Adjacent is fine
+  output.set_offset(24);
+  auto status = executor.Predict("shared_memory", "", request, response);
+  EXPECT_TRUE(status.ok()) << status.error_message();
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
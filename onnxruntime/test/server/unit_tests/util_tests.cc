@@ -116,6 +116,30 @@ TEST(ContentTypeTests, ContentTypeMissing) {
   EXPECT_EQ(result, SupportedContentType::PbByteArray);
 }
 
+TEST(HttpStatusCodeTests, OverloadIsServiceUnavailable) {
+  EXPECT_EQ(GetHttpStatusCode(protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "")), http::status::service_unavailable);
+  EXPECT_EQ(GetHttpStatusCode(protobufutil::Status(protobufutil::error::Code::UNAVAILABLE, "")), http::status::service_unavailable);
+  EXPECT_EQ(GetHttpStatusCode(protobufutil::Status(protobufutil::error::Code::INTERNAL, "")), http::status::internal_server_error);
+}
+
+TEST(RequestSchedulingTests, SchedulingHeaders) {
+  HttpContext context;
+  int priority = 0;
+  auto deadline = RequestScheduler::Clock::time_point::max();
+  EXPECT_TRUE(GetRequestScheduling(context, priority, deadline));
+  EXPECT_EQ(priority, 0);
+  EXPECT_EQ(deadline, RequestScheduler::Clock::time_point::max());
+
+  context.request.set("x-ms-request-priority", "2");
+  context.request.set("x-ms-request-timeout-ms", "100");
+  EXPECT_TRUE(GetRequestScheduling(context, priority, deadline));
+  EXPECT_EQ(priority, 2);
+  EXPECT_LE(deadline, RequestScheduler::Clock::now() + std::chrono::milliseconds(100));
+
+  context.request.set("x-ms-request-timeout-ms", "soon");
+  EXPECT_FALSE(GetRequestScheduling(context, priority, deadline));
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file